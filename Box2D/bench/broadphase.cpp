@@ -0,0 +1,273 @@
+/*
+* Copyright (c) 2006-2009 Erin Catto http://www.gphysics.com
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+// Runs the same scenes through the dynamic tree and the spatial hash broad-phases,
+// compares their timings and checks that they give the same results:
+// - a pile of circles and boxes falling into a container, stepped by b2World. The
+//   touching contacts, the body positions, and the results of AABB queries and ray
+//   casts are compared at the end.
+// - many small proxies moving through b2BroadPhase alone. The new pairs of every
+//   step are compared.
+// The program returns 1 if the results differ.
+//
+// g++ -O2 -I../include broadphase.cpp ../include/Box2d/*/*.cpp ../include/Box2d/*/*/*.cpp -lpthread -o broadphase
+// ./broadphase [scale]
+//
+// The sources include <Box2D/...>: on a case sensitive file system, -I must name a
+// directory holding a Box2D link to include/Box2d.
+
+#include <Box2D/Box2D.h>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <ctime>
+
+typedef std::vector<std::pair<int32, int32> > PairList;
+
+static double GetTime()
+{
+	return double(std::clock()) / CLOCKS_PER_SEC;
+}
+
+// Tags the bodies and fixtures with their creation index, so that the
+// results of the two worlds can be compared.
+static void* Tag(int32 i)
+{
+	return reinterpret_cast<void*>(size_t(i + 1));
+}
+
+static int32 Untag(void* userData)
+{
+	return int32(reinterpret_cast<size_t>(userData)) - 1;
+}
+
+static void BuildPile(b2World* world, int32 columns, int32 rows)
+{
+	b2BodyDef groundDef;
+	b2Body* ground = world->CreateBody(&groundDef);
+	b2PolygonShape wall;
+	float32 halfWidth = 0.6f * columns + 2.0f;
+	wall.SetAsBox(halfWidth, 1.0f, b2Vec2(0.0f, -1.0f), 0.0f);
+	ground->CreateFixture(&wall, 0.0f)->SetUserData(Tag(0));
+	wall.SetAsBox(1.0f, 2.0f * rows, b2Vec2(-halfWidth, 2.0f * rows), 0.0f);
+	ground->CreateFixture(&wall, 0.0f)->SetUserData(Tag(1));
+	wall.SetAsBox(1.0f, 2.0f * rows, b2Vec2(halfWidth, 2.0f * rows), 0.0f);
+	ground->CreateFixture(&wall, 0.0f)->SetUserData(Tag(2));
+
+	b2CircleShape circle;
+	circle.m_radius = 0.5f;
+	b2PolygonShape box;
+	box.SetAsBox(0.45f, 0.45f);
+
+	for (int32 i = 0; i < rows; ++i)
+	{
+		for (int32 j = 0; j < columns; ++j)
+		{
+			int32 index = i * columns + j;
+			b2BodyDef bd;
+			bd.type = b2_dynamicBody;
+			// Offset the odd rows so that the bodies roll over each other.
+			bd.position.Set(1.2f * (j - 0.5f * columns) + 0.3f * (i & 1), 1.0f + 1.2f * i);
+			bd.userData = Tag(index);
+			b2Body* body = world->CreateBody(&bd);
+			b2Shape* shape = (index % 3 == 0) ? static_cast<b2Shape*>(&box) : static_cast<b2Shape*>(&circle);
+			body->CreateFixture(shape, 1.0f)->SetUserData(Tag(index + 3));
+		}
+	}
+}
+
+// Gathers the fixtures reported by queries and ray casts.
+class FixtureCollector : public b2QueryCallback, public b2RayCastCallback
+{
+public:
+	bool ReportFixture(b2Fixture* fixture)
+	{
+		tags.push_back(Untag(fixture->GetUserData()));
+		return true;
+	}
+
+	float32 ReportFixture(b2Fixture* fixture, const b2Vec2& point, const b2Vec2& normal, float32 fraction)
+	{
+		B2_NOT_USED(point);
+		B2_NOT_USED(normal);
+		B2_NOT_USED(fraction);
+		tags.push_back(Untag(fixture->GetUserData()));
+		return 1.0f;
+	}
+
+	std::vector<int32> tags;
+};
+
+struct PileResult
+{
+	double time;
+	PairList contacts;
+	std::vector<b2Vec2> positions;
+	std::vector<int32> queried;
+};
+
+static PileResult RunPile(b2BroadPhaseType type, int32 columns, int32 rows, int32 steps)
+{
+	b2World world(b2Vec2(0.0f, -10.0f), true);
+	world.SetBroadPhaseType(type, 1.0f);
+	BuildPile(&world, columns, rows);
+
+	PileResult result;
+	double start = GetTime();
+	for (int32 i = 0; i < steps; ++i)
+	{
+		world.Step(1.0f / 60.0f, 8, 3);
+	}
+	result.time = GetTime() - start;
+
+	for (b2Contact* c = world.GetContactList(); c; c = c->GetNext())
+	{
+		if (c->IsTouching())
+		{
+			int32 a = Untag(c->GetFixtureA()->GetUserData());
+			int32 b = Untag(c->GetFixtureB()->GetUserData());
+			result.contacts.push_back(std::make_pair(b2Min(a, b), b2Max(a, b)));
+		}
+	}
+	std::sort(result.contacts.begin(), result.contacts.end());
+
+	result.positions.resize(columns * rows);
+	for (b2Body* b = world.GetBodyList(); b; b = b->GetNext())
+	{
+		if (b->GetType() == b2_dynamicBody)
+		{
+			result.positions[Untag(b->GetUserData())] = b->GetPosition();
+		}
+	}
+
+	// Query and ray cast across the pile.
+	FixtureCollector collector;
+	float32 width = 0.6f * columns;
+	for (int32 i = 0; i < 32; ++i)
+	{
+		float32 x = width * (i / 16.0f - 1.0f);
+		b2AABB aabb;
+		aabb.lowerBound.Set(x, 0.0f);
+		aabb.upperBound.Set(x + 3.0f, 0.5f * rows);
+		world.QueryAABB(&collector, aabb);
+		std::sort(collector.tags.begin(), collector.tags.end());
+		result.queried.insert(result.queried.end(), collector.tags.begin(), collector.tags.end());
+		collector.tags.clear();
+
+		world.RayCast(&collector, b2Vec2(-width - 5.0f, 0.1f * i * rows), b2Vec2(width + 5.0f, 0.05f * i * rows));
+		std::sort(collector.tags.begin(), collector.tags.end());
+		result.queried.insert(result.queried.end(), collector.tags.begin(), collector.tags.end());
+		collector.tags.clear();
+	}
+	return result;
+}
+
+// Moves square proxies bouncing in a square and gathers the new pairs of every step, as
+// user data indices.
+static double RunProxies(b2BroadPhaseType type, int32 count, int32 steps, PairList* pairs)
+{
+	b2BroadPhase broadPhase;
+	broadPhase.SetType(type, 1.5f);
+
+	float32 extent = 1.2f * b2Sqrt(float32(count));
+	std::vector<b2Vec2> positions(count);
+	std::vector<b2Vec2> velocities(count);
+	std::vector<int32> proxies(count);
+	std::srand(1);
+	for (int32 i = 0; i < count; ++i)
+	{
+		positions[i].Set(extent * std::rand() / RAND_MAX, extent * std::rand() / RAND_MAX);
+		velocities[i].Set(0.1f * std::rand() / RAND_MAX - 0.05f, 0.1f * std::rand() / RAND_MAX - 0.05f);
+		b2AABB aabb;
+		aabb.lowerBound = positions[i] - b2Vec2(0.5f, 0.5f);
+		aabb.upperBound = positions[i] + b2Vec2(0.5f, 0.5f);
+		proxies[i] = broadPhase.CreateProxy(aabb, Tag(i));
+	}
+
+	double time = 0.0;
+	for (int32 step = 0; step < steps; ++step)
+	{
+		double start = GetTime();
+		for (int32 i = 0; i < count; ++i)
+		{
+			b2Vec2 p = positions[i] + velocities[i];
+			if (p.x < 0.0f || p.x > extent) velocities[i].x = -velocities[i].x;
+			if (p.y < 0.0f || p.y > extent) velocities[i].y = -velocities[i].y;
+			positions[i] = p;
+			b2AABB aabb;
+			aabb.lowerBound = p - b2Vec2(0.5f, 0.5f);
+			aabb.upperBound = p + b2Vec2(0.5f, 0.5f);
+			broadPhase.MoveProxy(proxies[i], aabb, velocities[i]);
+		}
+		int32 pairCount = broadPhase.UpdatePairs();
+		time += GetTime() - start;
+
+		const b2Pair* buffer = broadPhase.GetPairBuffer();
+		size_t first = pairs->size();
+		for (int32 i = 0; i < pairCount; ++i)
+		{
+			int32 a = Untag(broadPhase.GetUserData(buffer[i].proxyIdA));
+			int32 b = Untag(broadPhase.GetUserData(buffer[i].proxyIdB));
+			pairs->push_back(std::make_pair(b2Min(a, b), b2Max(a, b)));
+		}
+		std::sort(pairs->begin() + first, pairs->end());
+	}
+	return time;
+}
+
+static bool SamePositions(const std::vector<b2Vec2>& a, const std::vector<b2Vec2>& b)
+{
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		if (a[i].x != b[i].x || a[i].y != b[i].y)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	int32 scale = argc > 1 ? std::atoi(argv[1]) : 1;
+	bool ok = true;
+
+	int32 columns = 40 * scale, rows = 50;
+	PileResult tree = RunPile(b2_dynamicTreeBroadPhase, columns, rows, 300);
+	PileResult hash = RunPile(b2_spatialHashBroadPhase, columns, rows, 300);
+	bool sameContacts = tree.contacts == hash.contacts;
+	bool samePositions = SamePositions(tree.positions, hash.positions);
+	bool sameQueries = tree.queried == hash.queried;
+	ok = ok && sameContacts && samePositions && sameQueries;
+	std::printf("pile of %d bodies, 300 steps: tree %.3fs, hash %.3fs\n", columns * rows, tree.time, hash.time);
+	std::printf("  %d touching contacts: %s, positions: %s, queries and ray casts: %s\n", int32(tree.contacts.size()),
+		sameContacts ? "same" : "DIFFERENT", samePositions ? "same" : "DIFFERENT", sameQueries ? "same" : "DIFFERENT");
+
+	int32 count = 50000 * scale;
+	PairList treePairs, hashPairs;
+	double treeTime = RunProxies(b2_dynamicTreeBroadPhase, count, 200, &treePairs);
+	double hashTime = RunProxies(b2_spatialHashBroadPhase, count, 200, &hashPairs);
+	bool samePairs = treePairs == hashPairs;
+	ok = ok && samePairs;
+	std::printf("%d moving proxies, 200 steps: tree %.3fs, hash %.3fs\n", count, treeTime, hashTime);
+	std::printf("  %d new pairs: %s\n", int32(treePairs.size()), samePairs ? "same" : "DIFFERENT");
+
+	return ok ? 0 : 1;
+}
@@ -18,11 +18,19 @@
 
 #include <Box2D/Collision/b2BroadPhase.h>
 #include <cstring>
+#include <new>
 
 b2BroadPhase::b2BroadPhase()
 {
 	m_proxyCount = 0;
 
+	m_hash = NULL;
+
+	m_keyCapacity = 16;
+	m_keyCount = 0;
+	m_keyBuffer = (uint64*)b2Alloc(m_keyCapacity * sizeof(uint64));
+	m_keySwap = (uint64*)b2Alloc(m_keyCapacity * sizeof(uint64));
+
 	m_pairCapacity = 16;
 	m_pairCount = 0;
 	m_pairBuffer = (b2Pair*)b2Alloc(m_pairCapacity * sizeof(b2Pair));
@@ -34,28 +42,95 @@ b2BroadPhase::b2BroadPhase()
 
 b2BroadPhase::~b2BroadPhase()
 {
+	if (m_hash)
+	{
+		m_hash->~b2SpatialHash();
+		b2Free(m_hash);
+	}
 	b2Free(m_moveBuffer);
+	b2Free(m_keyBuffer);
+	b2Free(m_keySwap);
 	b2Free(m_pairBuffer);
 }
 
+void b2BroadPhase::SetType(b2BroadPhaseType type, float32 cellSize)
+{
+	b2Assert(m_proxyCount == 0);
+
+	if (m_hash)
+	{
+		m_hash->~b2SpatialHash();
+		b2Free(m_hash);
+		m_hash = NULL;
+	}
+
+	if (type == b2_spatialHashBroadPhase)
+	{
+		void* mem = b2Alloc(sizeof(b2SpatialHash));
+		m_hash = new (mem) b2SpatialHash(cellSize);
+	}
+}
+
 int32 b2BroadPhase::CreateProxy(const b2AABB& aabb, void* userData)
 {
-	int32 proxyId = m_tree.CreateProxy(aabb, userData);
+	int32 proxyId;
+	if (m_hash)
+	{
+		proxyId = m_hash->CreateProxy(aabb, userData);
+	}
+	else
+	{
+		proxyId = m_tree.CreateProxy(aabb, userData);
+	}
 	++m_proxyCount;
 	BufferMove(proxyId);
 	return proxyId;
 }
 
+void b2BroadPhase::CreateProxies(const b2AABB* aabbs, void* const* userData, int32 count, int32* proxyIds)
+{
+	if (m_hash)
+	{
+		for (int32 i = 0; i < count; ++i)
+		{
+			proxyIds[i] = m_hash->CreateProxy(aabbs[i], userData[i]);
+		}
+	}
+	else
+	{
+		m_tree.CreateProxies(aabbs, userData, count, proxyIds);
+	}
+
+	m_proxyCount += count;
+	for (int32 i = 0; i < count; ++i)
+	{
+		BufferMove(proxyIds[i]);
+	}
+}
+
 void b2BroadPhase::DestroyProxy(int32 proxyId)
 {
 	UnBufferMove(proxyId);
 	--m_proxyCount;
+	if (m_hash)
+	{
+		m_hash->DestroyProxy(proxyId);
+		return;
+	}
 	m_tree.DestroyProxy(proxyId);
 }
 
 void b2BroadPhase::MoveProxy(int32 proxyId, const b2AABB& aabb, const b2Vec2& displacement)
 {
-	bool buffer = m_tree.MoveProxy(proxyId, aabb, displacement);
+	bool buffer;
+	if (m_hash)
+	{
+		buffer = m_hash->MoveProxy(proxyId, aabb, displacement);
+	}
+	else
+	{
+		buffer = m_tree.MoveProxy(proxyId, aabb, displacement);
+	}
 	if (buffer)
 	{
 		BufferMove(proxyId);
@@ -98,19 +173,147 @@ bool b2BroadPhase::QueryCallback(int32 proxyId)
 		return true;
 	}
 
-	// Grow the pair buffer as needed.
-	if (m_pairCount == m_pairCapacity)
+	// Grow the key buffers as needed. The scratch buffer holds no live data.
+	if (m_keyCount == m_keyCapacity)
 	{
-		b2Pair* oldBuffer = m_pairBuffer;
-		m_pairCapacity *= 2;
-		m_pairBuffer = (b2Pair*)b2Alloc(m_pairCapacity * sizeof(b2Pair));
-		memcpy(m_pairBuffer, oldBuffer, m_pairCount * sizeof(b2Pair));
+		uint64* oldBuffer = m_keyBuffer;
+		m_keyCapacity *= 2;
+		m_keyBuffer = (uint64*)b2Alloc(m_keyCapacity * sizeof(uint64));
+		memcpy(m_keyBuffer, oldBuffer, m_keyCount * sizeof(uint64));
 		b2Free(oldBuffer);
+
+		b2Free(m_keySwap);
+		m_keySwap = (uint64*)b2Alloc(m_keyCapacity * sizeof(uint64));
 	}
 
-	m_pairBuffer[m_pairCount].proxyIdA = b2Min(proxyId, m_queryProxyId);
-	m_pairBuffer[m_pairCount].proxyIdB = b2Max(proxyId, m_queryProxyId);
-	++m_pairCount;
+	m_keyBuffer[m_keyCount] = b2PairKey(proxyId, m_queryProxyId);
+	++m_keyCount;
 
 	return true;
 }
+
+// LSD radix sort of the key buffer, one byte per pass. Proxy ids are
+// small so most bytes are equal across all keys; those passes are skipped.
+void b2BroadPhase::SortKeys()
+{
+	const int32 k_radixThreshold = 64;
+	if (m_keyCount < k_radixThreshold)
+	{
+		std::sort(m_keyBuffer, m_keyBuffer + m_keyCount);
+		return;
+	}
+
+	int32 histograms[8][256];
+	memset(histograms, 0, sizeof(histograms));
+
+	for (int32 i = 0; i < m_keyCount; ++i)
+	{
+		uint64 key = m_keyBuffer[i];
+		for (int32 pass = 0; pass < 8; ++pass)
+		{
+			++histograms[pass][(key >> (8 * pass)) & 0xFF];
+		}
+	}
+
+	uint64* src = m_keyBuffer;
+	uint64* dst = m_keySwap;
+	for (int32 pass = 0; pass < 8; ++pass)
+	{
+		int32* histogram = histograms[pass];
+		int32 shift = 8 * pass;
+
+		// All keys share this byte.
+		if (histogram[(src[0] >> shift) & 0xFF] == m_keyCount)
+		{
+			continue;
+		}
+
+		int32 offset = 0;
+		for (int32 i = 0; i < 256; ++i)
+		{
+			int32 count = histogram[i];
+			histogram[i] = offset;
+			offset += count;
+		}
+
+		for (int32 i = 0; i < m_keyCount; ++i)
+		{
+			uint64 key = src[i];
+			dst[histogram[(key >> shift) & 0xFF]++] = key;
+		}
+
+		b2Swap(src, dst);
+	}
+
+	if (src != m_keyBuffer)
+	{
+		m_keySwap = m_keyBuffer;
+		m_keyBuffer = src;
+	}
+}
+
+int32 b2BroadPhase::UpdatePairs()
+{
+	// Reset key buffer
+	m_keyCount = 0;
+
+	// Perform tree queries for all moving proxies.
+	for (int32 i = 0; i < m_moveCount; ++i)
+	{
+		m_queryProxyId = m_moveBuffer[i];
+		if (m_queryProxyId == e_nullProxy)
+		{
+			continue;
+		}
+
+		// We have to query the tree with the fat AABB so that
+		// we don't fail to create a pair that may touch later.
+		const b2AABB& fatAABB = GetFatAABB(m_queryProxyId);
+
+		// Query tree or grid, create pairs and add their keys to the key buffer.
+		Query(this, fatAABB);
+	}
+
+	// Reset move buffer
+	m_moveCount = 0;
+
+	// Sort the keys to expose duplicates.
+	SortKeys();
+
+	// Make sure the pair buffer can hold every key.
+	if (m_keyCount > m_pairCapacity)
+	{
+		b2Free(m_pairBuffer);
+		while (m_pairCapacity < m_keyCount)
+		{
+			m_pairCapacity *= 2;
+		}
+		m_pairBuffer = (b2Pair*)b2Alloc(m_pairCapacity * sizeof(b2Pair));
+	}
+
+	// Unpack the unique keys.
+	m_pairCount = 0;
+	uint64 previousKey = b2_nullPairKey;
+	for (int32 i = 0; i < m_keyCount; ++i)
+	{
+		uint64 key = m_keyBuffer[i];
+		if (key == previousKey)
+		{
+			continue;
+		}
+		previousKey = key;
+
+		b2Pair* pair = m_pairBuffer + m_pairCount;
+		pair->proxyIdA = (int32)(key >> 32);
+		pair->proxyIdB = (int32)(key & 0xFFFFFFFF);
+		++m_pairCount;
+	}
+
+	// Try to keep the tree balanced.
+	if (m_hash == NULL)
+	{
+		m_tree.Rebalance(4);
+	}
+
+	return m_pairCount;
+}
@@ -22,6 +22,8 @@
 #include <Box2D/Common/b2Settings.h>
 #include <Box2D/Collision/b2Collision.h>
 #include <Box2D/Collision/b2DynamicTree.h>
+#include <Box2D/Collision/b2SpatialHash.h>
+#include <Box2D/Common/b2PairSet.h>
 #include <algorithm>
 
 struct b2Pair
@@ -31,6 +33,15 @@ struct b2Pair
 	int32 next;
 };
 
+/// The broad-phase acceleration structures.
+/// b2_dynamicTreeBroadPhase: an AABB tree, good for any mix of sizes.
+/// b2_spatialHashBroadPhase: a uniform grid, good for many proxies of similar size.
+enum b2BroadPhaseType
+{
+	b2_dynamicTreeBroadPhase = 0,
+	b2_spatialHashBroadPhase,
+};
+
 /// The broad-phase is used for computing pairs and performing volume queries and ray casts.
 /// This broad-phase does not persist pairs. Instead, this reports potentially new pairs.
 /// It is up to the client to consume the new pairs and to track subsequent overlap.
@@ -46,10 +57,24 @@ public:
 	b2BroadPhase();
 	~b2BroadPhase();
 
+	/// Select the acceleration structure. This can only be done while
+	/// there are no proxies.
+	/// @param cellSize the grid cell size used by the spatial hash. Pick it close
+	/// to the typical object size.
+	void SetType(b2BroadPhaseType type, float32 cellSize);
+
+	/// Get the acceleration structure type.
+	b2BroadPhaseType GetType() const;
+
 	/// Create a proxy with an initial AABB. Pairs are not reported until
 	/// UpdatePairs is called.
 	int32 CreateProxy(const b2AABB& aabb, void* userData);
 
+	/// Create many proxies at once. This is faster than calling CreateProxy
+	/// for each proxy. Pairs are not reported until UpdatePairs is called.
+	/// @param proxyIds receives the proxy ids.
+	void CreateProxies(const b2AABB* aabbs, void* const* userData, int32 count, int32* proxyIds);
+
 	/// Destroy a proxy. It is up to the client to remove any pairs.
 	void DestroyProxy(int32 proxyId);
 
@@ -73,6 +98,15 @@ public:
 	template <typename T>
 	void UpdatePairs(T* callback);
 
+	/// Update the pairs without callbacks. The new pairs are gathered into the
+	/// pair buffer, sorted with b2PairLessThan and free of duplicates. The buffer
+	/// is valid until the next call. This can only add pairs.
+	/// @return the number of pairs in the pair buffer.
+	int32 UpdatePairs();
+
+	/// Get the pairs found by the last call to UpdatePairs.
+	const b2Pair* GetPairBuffer() const;
+
 	/// Query an AABB for overlapping proxies. The callback class
 	/// is called for each proxy that overlaps the supplied AABB.
 	template <typename T>
@@ -88,26 +122,39 @@ public:
 	template <typename T>
 	void RayCast(T* callback, const b2RayCastInput& input) const;
 
-	/// Compute the height of the embedded tree.
+	/// Compute the height of the embedded tree. This is zero for the spatial hash.
 	int32 ComputeHeight() const;
 
 private:
 
 	friend class b2DynamicTree;
+	friend class b2SpatialHash;
 
 	void BufferMove(int32 proxyId);
 	void UnBufferMove(int32 proxyId);
 
+	void SortKeys();
+
 	bool QueryCallback(int32 proxyId);
 
 	b2DynamicTree m_tree;
 
+	// Replaces the tree when not NULL.
+	b2SpatialHash* m_hash;
+
 	int32 m_proxyCount;
 
 	int32* m_moveBuffer;
 	int32 m_moveCapacity;
 	int32 m_moveCount;
 
+	// Pair keys gathered from the tree queries, with a scratch
+	// buffer of the same capacity for the radix sort.
+	uint64* m_keyBuffer;
+	uint64* m_keySwap;
+	int32 m_keyCapacity;
+	int32 m_keyCount;
+
 	b2Pair* m_pairBuffer;
 	int32 m_pairCapacity;
 	int32 m_pairCount;
@@ -131,20 +178,33 @@ inline bool b2PairLessThan(const b2Pair& pair1, const b2Pair& pair2)
 	return false;
 }
 
+inline b2BroadPhaseType b2BroadPhase::GetType() const
+{
+	return m_hash ? b2_spatialHashBroadPhase : b2_dynamicTreeBroadPhase;
+}
+
 inline void* b2BroadPhase::GetUserData(int32 proxyId) const
 {
+	if (m_hash)
+	{
+		return m_hash->GetUserData(proxyId);
+	}
 	return m_tree.GetUserData(proxyId);
 }
 
 inline bool b2BroadPhase::TestOverlap(int32 proxyIdA, int32 proxyIdB) const
 {
-	const b2AABB& aabbA = m_tree.GetFatAABB(proxyIdA);
-	const b2AABB& aabbB = m_tree.GetFatAABB(proxyIdB);
+	const b2AABB& aabbA = GetFatAABB(proxyIdA);
+	const b2AABB& aabbB = GetFatAABB(proxyIdB);
 	return b2TestOverlap(aabbA, aabbB);
 }
 
 inline const b2AABB& b2BroadPhase::GetFatAABB(int32 proxyId) const
 {
+	if (m_hash)
+	{
+		return m_hash->GetFatAABB(proxyId);
+	}
 	return m_tree.GetFatAABB(proxyId);
 }
 
@@ -155,74 +215,53 @@ inline int32 b2BroadPhase::GetProxyCount() const
 
 inline int32 b2BroadPhase::ComputeHeight() const
 {
+	if (m_hash)
+	{
+		return 0;
+	}
 	return m_tree.ComputeHeight();
 }
 
+inline const b2Pair* b2BroadPhase::GetPairBuffer() const
+{
+	return m_pairBuffer;
+}
+
 template <typename T>
 void b2BroadPhase::UpdatePairs(T* callback)
 {
-	// Reset pair buffer
-	m_pairCount = 0;
-
-	// Perform tree queries for all moving proxies.
-	for (int32 i = 0; i < m_moveCount; ++i)
-	{
-		m_queryProxyId = m_moveBuffer[i];
-		if (m_queryProxyId == e_nullProxy)
-		{
-			continue;
-		}
-
-		// We have to query the tree with the fat AABB so that
-		// we don't fail to create a pair that may touch later.
-		const b2AABB& fatAABB = m_tree.GetFatAABB(m_queryProxyId);
-
-		// Query tree, create pairs and add them pair buffer.
-		m_tree.Query(this, fatAABB);
-	}
-
-	// Reset move buffer
-	m_moveCount = 0;
-
-	// Sort the pair buffer to expose duplicates.
-	std::sort(m_pairBuffer, m_pairBuffer + m_pairCount, b2PairLessThan);
+	int32 pairCount = UpdatePairs();
 
 	// Send the pairs back to the client.
-	int32 i = 0;
-	while (i < m_pairCount)
+	for (int32 i = 0; i < pairCount; ++i)
 	{
-		b2Pair* primaryPair = m_pairBuffer + i;
-		void* userDataA = m_tree.GetUserData(primaryPair->proxyIdA);
-		void* userDataB = m_tree.GetUserData(primaryPair->proxyIdB);
+		const b2Pair* pair = m_pairBuffer + i;
+		void* userDataA = GetUserData(pair->proxyIdA);
+		void* userDataB = GetUserData(pair->proxyIdB);
 
 		callback->AddPair(userDataA, userDataB);
-		++i;
-
-		// Skip any duplicate pairs.
-		while (i < m_pairCount)
-		{
-			b2Pair* pair = m_pairBuffer + i;
-			if (pair->proxyIdA != primaryPair->proxyIdA || pair->proxyIdB != primaryPair->proxyIdB)
-			{
-				break;
-			}
-			++i;
-		}
 	}
-
-	// Try to keep the tree balanced.
-	m_tree.Rebalance(4);
 }
 
 template <typename T>
 inline void b2BroadPhase::Query(T* callback, const b2AABB& aabb) const
 {
+	if (m_hash)
+	{
+		m_hash->Query(callback, aabb);
+		return;
+	}
 	m_tree.Query(callback, aabb);
 }
 
 template <typename T>
 inline void b2BroadPhase::RayCast(T* callback, const b2RayCastInput& input) const
 {
+	if (m_hash)
+	{
+		m_hash->RayCast(callback, input);
+		return;
+	}
 	m_tree.RayCast(callback, input);
 }
 
@@ -19,6 +19,7 @@
 #include <Box2D/Collision/b2DynamicTree.h>
 #include <cstring>
 #include <cfloat>
+#include <algorithm>
 
 b2DynamicTree::b2DynamicTree()
 {
@@ -122,6 +123,107 @@ int32 b2DynamicTree::CreateProxy(const b2AABB& aabb, void* userData)
 	return proxyId;
 }
 
+// Orders leaves by the center of their AABB along one axis.
+struct b2NodeCenterLessThan
+{
+	bool operator()(int32 leaf1, int32 leaf2) const
+	{
+		const b2AABB& aabb1 = nodes[leaf1].aabb;
+		const b2AABB& aabb2 = nodes[leaf2].aabb;
+		if (axis == 0)
+		{
+			return aabb1.lowerBound.x + aabb1.upperBound.x < aabb2.lowerBound.x + aabb2.upperBound.x;
+		}
+		return aabb1.lowerBound.y + aabb1.upperBound.y < aabb2.lowerBound.y + aabb2.upperBound.y;
+	}
+
+	const b2DynamicTreeNode* nodes;
+	int32 axis;
+};
+
+// Build a sub-tree over the leaves by splitting at the median center
+// along the longest axis of the centers. Returns the sub-tree root.
+int32 b2DynamicTree::BuildTopDown(int32* leaves, int32 count)
+{
+	if (count == 1)
+	{
+		return leaves[0];
+	}
+
+	b2Vec2 lower = m_nodes[leaves[0]].aabb.GetCenter();
+	b2Vec2 upper = lower;
+	for (int32 i = 1; i < count; ++i)
+	{
+		b2Vec2 center = m_nodes[leaves[i]].aabb.GetCenter();
+		lower = b2Min(lower, center);
+		upper = b2Max(upper, center);
+	}
+
+	b2NodeCenterLessThan lessThan;
+	lessThan.nodes = m_nodes;
+	lessThan.axis = (upper.x - lower.x) >= (upper.y - lower.y) ? 0 : 1;
+
+	int32 half = count / 2;
+	std::nth_element(leaves, leaves + half, leaves + count, lessThan);
+
+	int32 child1 = BuildTopDown(leaves, half);
+	int32 child2 = BuildTopDown(leaves + half, count - half);
+
+	int32 node = AllocateNode();
+	m_nodes[node].userData = NULL;
+	m_nodes[node].child1 = child1;
+	m_nodes[node].child2 = child2;
+	m_nodes[node].aabb.Combine(m_nodes[child1].aabb, m_nodes[child2].aabb);
+	m_nodes[child1].parent = node;
+	m_nodes[child2].parent = node;
+	return node;
+}
+
+void b2DynamicTree::CreateProxies(const b2AABB* aabbs, void* const* userData, int32 count, int32* proxyIds)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	b2Vec2 r(b2_aabbExtension, b2_aabbExtension);
+	for (int32 i = 0; i < count; ++i)
+	{
+		int32 proxyId = AllocateNode();
+
+		// Fatten the aabb.
+		m_nodes[proxyId].aabb.lowerBound = aabbs[i].lowerBound - r;
+		m_nodes[proxyId].aabb.upperBound = aabbs[i].upperBound + r;
+		m_nodes[proxyId].userData = userData[i];
+		proxyIds[i] = proxyId;
+	}
+
+	int32* leaves = (int32*)b2Alloc(count * sizeof(int32));
+	memcpy(leaves, proxyIds, count * sizeof(int32));
+	int32 subRoot = BuildTopDown(leaves, count);
+	b2Free(leaves);
+
+	m_insertionCount += count;
+
+	if (m_root == b2_nullNode)
+	{
+		m_root = subRoot;
+		m_nodes[m_root].parent = b2_nullNode;
+		return;
+	}
+
+	// Join the existing tree and the new sub-tree under a new root.
+	int32 root = AllocateNode();
+	m_nodes[root].parent = b2_nullNode;
+	m_nodes[root].userData = NULL;
+	m_nodes[root].child1 = m_root;
+	m_nodes[root].child2 = subRoot;
+	m_nodes[root].aabb.Combine(m_nodes[m_root].aabb, m_nodes[subRoot].aabb);
+	m_nodes[m_root].parent = root;
+	m_nodes[subRoot].parent = root;
+	m_root = root;
+}
+
 void b2DynamicTree::DestroyProxy(int32 proxyId)
 {
 	b2Assert(0 <= proxyId && proxyId < m_nodeCapacity);
@@ -69,6 +69,15 @@ public:
 	/// Create a proxy. Provide a tight fitting AABB and a userData pointer.
 	int32 CreateProxy(const b2AABB& aabb, void* userData);
 
+	/// Create many proxies at once. The proxies are built into a sub-tree top-down
+	/// by median splits, which is faster and better balanced than inserting them
+	/// one at a time.
+	/// @param aabbs tight fitting AABBs, one per proxy.
+	/// @param userData user data pointers, one per proxy.
+	/// @param count the number of proxies.
+	/// @param proxyIds receives the proxy ids.
+	void CreateProxies(const b2AABB* aabbs, void* const* userData, int32 count, int32* proxyIds);
+
 	/// Destroy a proxy. This asserts if the id is invalid.
 	void DestroyProxy(int32 proxyId);
 
@@ -114,6 +123,8 @@ private:
 	void InsertLeaf(int32 node);
 	void RemoveLeaf(int32 node);
 
+	int32 BuildTopDown(int32* leaves, int32 count);
+
 	int32 ComputeHeight(int32 nodeId) const;
 
 	int32 m_root;
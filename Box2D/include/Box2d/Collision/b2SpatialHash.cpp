@@ -0,0 +1,358 @@
+/*
+* Copyright (c) 2006-2009 Erin Catto http://www.gphysics.com
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <Box2D/Collision/b2SpatialHash.h>
+#include <cstring>
+
+// Proxies covering more cells than this are kept out of the grid.
+const int32 b2_maxProxyCells = 64;
+
+b2SpatialHash::b2SpatialHash(float32 cellSize)
+{
+	b2Assert(cellSize > 0.0f);
+	m_cellSize = cellSize;
+	m_inverseCellSize = 1.0f / cellSize;
+
+	m_proxyCapacity = 16;
+	m_proxyCount = 0;
+	m_proxies = (b2SpatialHashProxy*)b2Alloc(m_proxyCapacity * sizeof(b2SpatialHashProxy));
+
+	// Build a linked list for the free list.
+	for (int32 i = 0; i < m_proxyCapacity - 1; ++i)
+	{
+		m_proxies[i].next = i + 1;
+	}
+	m_proxies[m_proxyCapacity-1].next = e_nullEntry;
+	m_freeProxy = 0;
+
+	m_entryCapacity = 64;
+	m_entryCount = 0;
+	m_entries = (b2SpatialHashEntry*)b2Alloc(m_entryCapacity * sizeof(b2SpatialHashEntry));
+	for (int32 i = 0; i < m_entryCapacity - 1; ++i)
+	{
+		m_entries[i].next = i + 1;
+	}
+	m_entries[m_entryCapacity-1].next = e_nullEntry;
+	m_freeEntry = 0;
+
+	m_bucketCount = 64;
+	m_buckets = (int32*)b2Alloc(m_bucketCount * sizeof(int32));
+	for (int32 i = 0; i < m_bucketCount; ++i)
+	{
+		m_buckets[i] = e_nullEntry;
+	}
+
+	m_oversizedCapacity = 4;
+	m_oversizedCount = 0;
+	m_oversized = (int32*)b2Alloc(m_oversizedCapacity * sizeof(int32));
+}
+
+b2SpatialHash::~b2SpatialHash()
+{
+	b2Free(m_oversized);
+	b2Free(m_buckets);
+	b2Free(m_entries);
+	b2Free(m_proxies);
+}
+
+// Allocate a proxy from the pool. Grow the pool if necessary.
+int32 b2SpatialHash::AllocateProxy()
+{
+	if (m_freeProxy == e_nullEntry)
+	{
+		b2Assert(m_proxyCount == m_proxyCapacity);
+
+		// The free list is empty. Rebuild a bigger pool.
+		b2SpatialHashProxy* oldProxies = m_proxies;
+		m_proxyCapacity *= 2;
+		m_proxies = (b2SpatialHashProxy*)b2Alloc(m_proxyCapacity * sizeof(b2SpatialHashProxy));
+		memcpy(m_proxies, oldProxies, m_proxyCount * sizeof(b2SpatialHashProxy));
+		b2Free(oldProxies);
+
+		for (int32 i = m_proxyCount; i < m_proxyCapacity - 1; ++i)
+		{
+			m_proxies[i].next = i + 1;
+		}
+		m_proxies[m_proxyCapacity-1].next = e_nullEntry;
+		m_freeProxy = m_proxyCount;
+	}
+
+	int32 proxyId = m_freeProxy;
+	m_freeProxy = m_proxies[proxyId].next;
+	m_proxies[proxyId].next = e_allocated;
+	++m_proxyCount;
+	return proxyId;
+}
+
+// Return a proxy to the pool.
+void b2SpatialHash::FreeProxy(int32 proxyId)
+{
+	b2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	b2Assert(0 < m_proxyCount);
+	m_proxies[proxyId].next = m_freeProxy;
+	m_freeProxy = proxyId;
+	--m_proxyCount;
+}
+
+// Allocate a cell entry from the pool. Grow the pool if necessary.
+int32 b2SpatialHash::AllocateEntry()
+{
+	if (m_freeEntry == e_nullEntry)
+	{
+		b2Assert(m_entryCount == m_entryCapacity);
+
+		b2SpatialHashEntry* oldEntries = m_entries;
+		m_entryCapacity *= 2;
+		m_entries = (b2SpatialHashEntry*)b2Alloc(m_entryCapacity * sizeof(b2SpatialHashEntry));
+		memcpy(m_entries, oldEntries, m_entryCount * sizeof(b2SpatialHashEntry));
+		b2Free(oldEntries);
+
+		for (int32 i = m_entryCount; i < m_entryCapacity - 1; ++i)
+		{
+			m_entries[i].next = i + 1;
+		}
+		m_entries[m_entryCapacity-1].next = e_nullEntry;
+		m_freeEntry = m_entryCount;
+	}
+
+	int32 entryId = m_freeEntry;
+	m_freeEntry = m_entries[entryId].next;
+	++m_entryCount;
+	return entryId;
+}
+
+void b2SpatialHash::ComputeCells(b2SpatialHashProxy* proxy) const
+{
+	proxy->lowerX = ComputeCell(proxy->aabb.lowerBound.x);
+	proxy->lowerY = ComputeCell(proxy->aabb.lowerBound.y);
+	proxy->upperX = ComputeCell(proxy->aabb.upperBound.x);
+	proxy->upperY = ComputeCell(proxy->aabb.upperBound.y);
+
+	float32 cellCount = float32(proxy->upperX - proxy->lowerX + 1) * float32(proxy->upperY - proxy->lowerY + 1);
+	proxy->oversized = cellCount > float32(b2_maxProxyCells);
+}
+
+// Keep the number of buckets at least the number of entries so that
+// the bucket chains stay short.
+void b2SpatialHash::Rehash()
+{
+	int32 bucketCount = m_bucketCount;
+	while (bucketCount < m_entryCount)
+	{
+		bucketCount *= 2;
+	}
+
+	if (bucketCount == m_bucketCount)
+	{
+		return;
+	}
+
+	int32* oldBuckets = m_buckets;
+	int32 oldBucketCount = m_bucketCount;
+
+	m_bucketCount = bucketCount;
+	m_buckets = (int32*)b2Alloc(m_bucketCount * sizeof(int32));
+	for (int32 i = 0; i < m_bucketCount; ++i)
+	{
+		m_buckets[i] = e_nullEntry;
+	}
+
+	for (int32 i = 0; i < oldBucketCount; ++i)
+	{
+		int32 entryId = oldBuckets[i];
+		while (entryId != e_nullEntry)
+		{
+			b2SpatialHashEntry* entry = m_entries + entryId;
+			int32 next = entry->next;
+
+			int32 bucket = ComputeBucket(entry->cellX, entry->cellY);
+			entry->next = m_buckets[bucket];
+			m_buckets[bucket] = entryId;
+
+			entryId = next;
+		}
+	}
+
+	b2Free(oldBuckets);
+}
+
+void b2SpatialHash::InsertProxy(int32 proxyId)
+{
+	b2SpatialHashProxy* proxy = m_proxies + proxyId;
+	ComputeCells(proxy);
+
+	if (proxy->oversized)
+	{
+		if (m_oversizedCount == m_oversizedCapacity)
+		{
+			int32* oldOversized = m_oversized;
+			m_oversizedCapacity *= 2;
+			m_oversized = (int32*)b2Alloc(m_oversizedCapacity * sizeof(int32));
+			memcpy(m_oversized, oldOversized, m_oversizedCount * sizeof(int32));
+			b2Free(oldOversized);
+		}
+
+		m_oversized[m_oversizedCount] = proxyId;
+		++m_oversizedCount;
+		return;
+	}
+
+	for (int32 y = proxy->lowerY; y <= proxy->upperY; ++y)
+	{
+		for (int32 x = proxy->lowerX; x <= proxy->upperX; ++x)
+		{
+			int32 entryId = AllocateEntry();
+			b2SpatialHashEntry* entry = m_entries + entryId;
+			entry->proxyId = proxyId;
+			entry->cellX = x;
+			entry->cellY = y;
+
+			int32 bucket = ComputeBucket(x, y);
+			entry->next = m_buckets[bucket];
+			m_buckets[bucket] = entryId;
+		}
+	}
+
+	Rehash();
+}
+
+void b2SpatialHash::RemoveProxy(int32 proxyId)
+{
+	b2SpatialHashProxy* proxy = m_proxies + proxyId;
+
+	if (proxy->oversized)
+	{
+		for (int32 i = 0; i < m_oversizedCount; ++i)
+		{
+			if (m_oversized[i] == proxyId)
+			{
+				m_oversized[i] = m_oversized[m_oversizedCount - 1];
+				--m_oversizedCount;
+				return;
+			}
+		}
+
+		b2Assert(false);
+		return;
+	}
+
+	for (int32 y = proxy->lowerY; y <= proxy->upperY; ++y)
+	{
+		for (int32 x = proxy->lowerX; x <= proxy->upperX; ++x)
+		{
+			int32* link = m_buckets + ComputeBucket(x, y);
+			while (*link != e_nullEntry)
+			{
+				b2SpatialHashEntry* entry = m_entries + *link;
+				if (entry->proxyId == proxyId && entry->cellX == x && entry->cellY == y)
+				{
+					// Unlink and return the entry to the pool.
+					int32 entryId = *link;
+					*link = entry->next;
+					entry->next = m_freeEntry;
+					m_freeEntry = entryId;
+					--m_entryCount;
+					break;
+				}
+
+				link = &entry->next;
+			}
+		}
+	}
+}
+
+int32 b2SpatialHash::CreateProxy(const b2AABB& aabb, void* userData)
+{
+	int32 proxyId = AllocateProxy();
+
+	// Fatten the aabb.
+	b2Vec2 r(b2_aabbExtension, b2_aabbExtension);
+	m_proxies[proxyId].aabb.lowerBound = aabb.lowerBound - r;
+	m_proxies[proxyId].aabb.upperBound = aabb.upperBound + r;
+	m_proxies[proxyId].userData = userData;
+
+	InsertProxy(proxyId);
+
+	return proxyId;
+}
+
+void b2SpatialHash::DestroyProxy(int32 proxyId)
+{
+	b2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	b2Assert(m_proxies[proxyId].next == e_allocated);
+
+	RemoveProxy(proxyId);
+	FreeProxy(proxyId);
+}
+
+bool b2SpatialHash::MoveProxy(int32 proxyId, const b2AABB& aabb, const b2Vec2& displacement)
+{
+	b2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	b2Assert(m_proxies[proxyId].next == e_allocated);
+
+	b2SpatialHashProxy* proxy = m_proxies + proxyId;
+	if (proxy->aabb.Contains(aabb))
+	{
+		return false;
+	}
+
+	// Extend AABB.
+	b2AABB b = aabb;
+	b2Vec2 r(b2_aabbExtension, b2_aabbExtension);
+	b.lowerBound = b.lowerBound - r;
+	b.upperBound = b.upperBound + r;
+
+	// Predict AABB displacement.
+	b2Vec2 d = b2_aabbMultiplier * displacement;
+
+	if (d.x < 0.0f)
+	{
+		b.lowerBound.x += d.x;
+	}
+	else
+	{
+		b.upperBound.x += d.x;
+	}
+
+	if (d.y < 0.0f)
+	{
+		b.lowerBound.y += d.y;
+	}
+	else
+	{
+		b.upperBound.y += d.y;
+	}
+
+	// Only touch the grid if the proxy changed cells.
+	b2SpatialHashProxy moved = *proxy;
+	moved.aabb = b;
+	ComputeCells(&moved);
+
+	if (moved.lowerX == proxy->lowerX && moved.lowerY == proxy->lowerY &&
+		moved.upperX == proxy->upperX && moved.upperY == proxy->upperY)
+	{
+		proxy->aabb = b;
+		return true;
+	}
+
+	RemoveProxy(proxyId);
+	proxy->aabb = b;
+	InsertProxy(proxyId);
+
+	return true;
+}
@@ -0,0 +1,455 @@
+/*
+* Copyright (c) 2006-2009 Erin Catto http://www.gphysics.com
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef B2_SPATIAL_HASH_H
+#define B2_SPATIAL_HASH_H
+
+#include <Box2D/Collision/b2Collision.h>
+
+/// A proxy in the spatial hash. The client does not interact with this directly.
+struct b2SpatialHashProxy
+{
+	/// This is the fattened AABB.
+	b2AABB aabb;
+
+	void* userData;
+
+	/// The range of grid cells covered by the fat AABB.
+	int32 lowerX, lowerY;
+	int32 upperX, upperY;
+
+	/// Free list link, or e_allocated.
+	int32 next;
+
+	/// Proxies that cover too many cells are kept in a separate list.
+	bool oversized;
+};
+
+/// An entry of a proxy in one grid cell. Entries of all the cells that hash
+/// to the same bucket are chained together.
+struct b2SpatialHashEntry
+{
+	int32 proxyId;
+	int32 cellX, cellY;
+	int32 next;
+};
+
+/// A uniform grid broad-phase with the same proxy interface as b2DynamicTree.
+/// The grid is unbounded: cells are hashed into a bucket table, so memory only
+/// depends on the number of occupied cells. This works best when the proxies
+/// have roughly equal size, close to the cell size. A proxy then only needs to
+/// change cells when it moves out of its fat AABB, which is cheaper than the
+/// remove and insert in the tree. Proxies covering many cells are not entered
+/// in the grid but are tested by every query.
+class b2SpatialHash
+{
+public:
+
+	/// Constructing the spatial hash initializes the proxy and bucket pools.
+	/// @param cellSize the edge length of a grid cell, in meters.
+	b2SpatialHash(float32 cellSize);
+
+	/// Destroy the spatial hash, freeing the pools.
+	~b2SpatialHash();
+
+	/// Create a proxy. Provide a tight fitting AABB and a userData pointer.
+	int32 CreateProxy(const b2AABB& aabb, void* userData);
+
+	/// Destroy a proxy. This asserts if the id is invalid.
+	void DestroyProxy(int32 proxyId);
+
+	/// Move a proxy with a swepted AABB. If the proxy has moved outside of its fattened AABB,
+	/// then the proxy is moved to the cells of its new fattened AABB. Otherwise
+	/// the function returns immediately.
+	/// @return true if the fattened AABB changed.
+	bool MoveProxy(int32 proxyId, const b2AABB& aabb1, const b2Vec2& displacement);
+
+	/// Get proxy user data.
+	/// @return the proxy user data or 0 if the id is invalid.
+	void* GetUserData(int32 proxyId) const;
+
+	/// Get the fat AABB for a proxy.
+	const b2AABB& GetFatAABB(int32 proxyId) const;
+
+	/// Get the cell size.
+	float32 GetCellSize() const;
+
+	/// Query an AABB for overlapping proxies. The callback class
+	/// is called once for each proxy that overlaps the supplied AABB.
+	template <typename T>
+	void Query(T* callback, const b2AABB& aabb) const;
+
+	/// Ray-cast against the proxies in the grid. This relies on the callback
+	/// to perform a exact ray-cast in the case were the proxy contains a shape.
+	/// The callback also performs the any collision filtering. The cells are
+	/// visited in order along the ray, so the cost is proportional to the ray
+	/// length over the cell size.
+	/// @param input the ray-cast input data. The ray extends from p1 to p1 + maxFraction * (p2 - p1).
+	/// @param callback a callback class that is called for each proxy that is hit by the ray.
+	template <typename T>
+	void RayCast(T* callback, const b2RayCastInput& input) const;
+
+private:
+
+	enum
+	{
+		e_nullEntry = -1,
+		e_allocated = -2,
+
+		/// Cell coordinates are clamped to [-e_maxCell, e_maxCell], so that the
+		/// conversion from float is defined and cell ranges do not overflow.
+		e_maxCell = 1 << 29,
+	};
+
+	int32 AllocateProxy();
+	void FreeProxy(int32 proxyId);
+
+	int32 AllocateEntry();
+
+	void InsertProxy(int32 proxyId);
+	void RemoveProxy(int32 proxyId);
+
+	void ComputeCells(b2SpatialHashProxy* proxy) const;
+	int32 ComputeCell(float32 x) const;
+	int32 ComputeBucket(int32 cellX, int32 cellY) const;
+	void Rehash();
+
+	template <typename T>
+	bool RayCastProxy(T* callback, const b2RayCastInput& input, int32 proxyId,
+					  const b2Vec2& v, const b2Vec2& abs_v,
+					  float32* maxFraction, b2AABB* segmentAABB) const;
+
+	float32 m_cellSize;
+	float32 m_inverseCellSize;
+
+	b2SpatialHashProxy* m_proxies;
+	int32 m_proxyCount;
+	int32 m_proxyCapacity;
+	int32 m_freeProxy;
+
+	b2SpatialHashEntry* m_entries;
+	int32 m_entryCount;
+	int32 m_entryCapacity;
+	int32 m_freeEntry;
+
+	int32* m_buckets;
+	int32 m_bucketCount;
+
+	int32* m_oversized;
+	int32 m_oversizedCount;
+	int32 m_oversizedCapacity;
+};
+
+inline void* b2SpatialHash::GetUserData(int32 proxyId) const
+{
+	b2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	return m_proxies[proxyId].userData;
+}
+
+inline const b2AABB& b2SpatialHash::GetFatAABB(int32 proxyId) const
+{
+	b2Assert(0 <= proxyId && proxyId < m_proxyCapacity);
+	return m_proxies[proxyId].aabb;
+}
+
+inline float32 b2SpatialHash::GetCellSize() const
+{
+	return m_cellSize;
+}
+
+inline int32 b2SpatialHash::ComputeCell(float32 x) const
+{
+	float32 cell = floorf(x * m_inverseCellSize);
+
+	// The negated test also sends NaN to the lower bound.
+	if (!(cell > -float32(e_maxCell)))
+	{
+		return -e_maxCell;
+	}
+	if (cell > float32(e_maxCell))
+	{
+		return e_maxCell;
+	}
+	return (int32)cell;
+}
+
+inline int32 b2SpatialHash::ComputeBucket(int32 cellX, int32 cellY) const
+{
+	uint32 h = ((uint32)cellX * 73856093u) ^ ((uint32)cellY * 19349663u);
+	return (int32)(h & (uint32)(m_bucketCount - 1));
+}
+
+template <typename T>
+inline void b2SpatialHash::Query(T* callback, const b2AABB& aabb) const
+{
+	for (int32 i = 0; i < m_oversizedCount; ++i)
+	{
+		int32 proxyId = m_oversized[i];
+		if (b2TestOverlap(m_proxies[proxyId].aabb, aabb))
+		{
+			bool proceed = callback->QueryCallback(proxyId);
+			if (proceed == false)
+			{
+				return;
+			}
+		}
+	}
+
+	int32 lowerX = ComputeCell(aabb.lowerBound.x);
+	int32 lowerY = ComputeCell(aabb.lowerBound.y);
+	int32 upperX = ComputeCell(aabb.upperBound.x);
+	int32 upperY = ComputeCell(aabb.upperBound.y);
+
+	// Huge queries are cheaper as a scan over the proxies.
+	float32 cellCount = float32(upperX - lowerX + 1) * float32(upperY - lowerY + 1);
+	if (cellCount > float32(m_proxyCapacity))
+	{
+		for (int32 proxyId = 0; proxyId < m_proxyCapacity; ++proxyId)
+		{
+			const b2SpatialHashProxy* proxy = m_proxies + proxyId;
+			if (proxy->next != e_allocated || proxy->oversized)
+			{
+				continue;
+			}
+
+			if (b2TestOverlap(proxy->aabb, aabb))
+			{
+				bool proceed = callback->QueryCallback(proxyId);
+				if (proceed == false)
+				{
+					return;
+				}
+			}
+		}
+		return;
+	}
+
+	for (int32 y = lowerY; y <= upperY; ++y)
+	{
+		for (int32 x = lowerX; x <= upperX; ++x)
+		{
+			int32 entryId = m_buckets[ComputeBucket(x, y)];
+			while (entryId != e_nullEntry)
+			{
+				const b2SpatialHashEntry* entry = m_entries + entryId;
+				entryId = entry->next;
+
+				if (entry->cellX != x || entry->cellY != y)
+				{
+					continue;
+				}
+
+				// A proxy covering several cells of the query is only
+				// reported from the first of those cells.
+				const b2SpatialHashProxy* proxy = m_proxies + entry->proxyId;
+				if (x != b2Max(proxy->lowerX, lowerX) || y != b2Max(proxy->lowerY, lowerY))
+				{
+					continue;
+				}
+
+				if (b2TestOverlap(proxy->aabb, aabb))
+				{
+					bool proceed = callback->QueryCallback(entry->proxyId);
+					if (proceed == false)
+					{
+						return;
+					}
+				}
+			}
+		}
+	}
+}
+
+template <typename T>
+inline bool b2SpatialHash::RayCastProxy(T* callback, const b2RayCastInput& input, int32 proxyId,
+										const b2Vec2& v, const b2Vec2& abs_v,
+										float32* maxFraction, b2AABB* segmentAABB) const
+{
+	const b2AABB& aabb = m_proxies[proxyId].aabb;
+	if (b2TestOverlap(aabb, *segmentAABB) == false)
+	{
+		return true;
+	}
+
+	// Separating axis for segment (Gino, p80).
+	// |dot(v, p1 - c)| > dot(|v|, h)
+	b2Vec2 p1 = input.p1;
+	b2Vec2 c = aabb.GetCenter();
+	b2Vec2 h = aabb.GetExtents();
+	float32 separation = b2Abs(b2Dot(v, p1 - c)) - b2Dot(abs_v, h);
+	if (separation > 0.0f)
+	{
+		return true;
+	}
+
+	b2RayCastInput subInput;
+	subInput.p1 = input.p1;
+	subInput.p2 = input.p2;
+	subInput.maxFraction = *maxFraction;
+
+	float32 value = callback->RayCastCallback(subInput, proxyId);
+
+	if (value == 0.0f)
+	{
+		// The client has terminated the ray cast.
+		return false;
+	}
+
+	if (value > 0.0f)
+	{
+		// Update segment bounding box.
+		*maxFraction = value;
+		b2Vec2 t = p1 + value * (input.p2 - p1);
+		segmentAABB->lowerBound = b2Min(p1, t);
+		segmentAABB->upperBound = b2Max(p1, t);
+	}
+
+	return true;
+}
+
+template <typename T>
+inline void b2SpatialHash::RayCast(T* callback, const b2RayCastInput& input) const
+{
+	b2Vec2 p1 = input.p1;
+	b2Vec2 p2 = input.p2;
+	b2Vec2 d = p2 - p1;
+	b2Vec2 r = d;
+	b2Assert(r.LengthSquared() > 0.0f);
+	r.Normalize();
+
+	// v is perpendicular to the segment.
+	b2Vec2 v = b2Cross(1.0f, r);
+	b2Vec2 abs_v = b2Abs(v);
+
+	float32 maxFraction = input.maxFraction;
+
+	// Build a bounding box for the segment.
+	b2AABB segmentAABB;
+	{
+		b2Vec2 t = p1 + maxFraction * d;
+		segmentAABB.lowerBound = b2Min(p1, t);
+		segmentAABB.upperBound = b2Max(p1, t);
+	}
+
+	for (int32 i = 0; i < m_oversizedCount; ++i)
+	{
+		if (RayCastProxy(callback, input, m_oversized[i], v, abs_v, &maxFraction, &segmentAABB) == false)
+		{
+			return;
+		}
+	}
+
+	// A ray reaching the clamped cells would walk too far, or forever, through
+	// cells that all map to the bound. Test every proxy instead.
+	if (ComputeCell(segmentAABB.lowerBound.x) == -e_maxCell || ComputeCell(segmentAABB.upperBound.x) == e_maxCell ||
+		ComputeCell(segmentAABB.lowerBound.y) == -e_maxCell || ComputeCell(segmentAABB.upperBound.y) == e_maxCell)
+	{
+		for (int32 proxyId = 0; proxyId < m_proxyCapacity; ++proxyId)
+		{
+			const b2SpatialHashProxy* proxy = m_proxies + proxyId;
+			if (proxy->next != e_allocated || proxy->oversized)
+			{
+				continue;
+			}
+
+			if (RayCastProxy(callback, input, proxyId, v, abs_v, &maxFraction, &segmentAABB) == false)
+			{
+				return;
+			}
+		}
+		return;
+	}
+
+	// Walk the cells along the ray (Amanatides and Woo).
+	int32 cellX = ComputeCell(p1.x);
+	int32 cellY = ComputeCell(p1.y);
+	int32 stepX = d.x > 0.0f ? 1 : (d.x < 0.0f ? -1 : 0);
+	int32 stepY = d.y > 0.0f ? 1 : (d.y < 0.0f ? -1 : 0);
+
+	float32 tDeltaX = stepX != 0 ? m_cellSize / b2Abs(d.x) : b2_maxFloat;
+	float32 tDeltaY = stepY != 0 ? m_cellSize / b2Abs(d.y) : b2_maxFloat;
+	float32 tMaxX = b2_maxFloat;
+	float32 tMaxY = b2_maxFloat;
+	if (stepX != 0)
+	{
+		float32 boundary = float32(stepX > 0 ? cellX + 1 : cellX) * m_cellSize;
+		tMaxX = (boundary - p1.x) / d.x;
+	}
+	if (stepY != 0)
+	{
+		float32 boundary = float32(stepY > 0 ? cellY + 1 : cellY) * m_cellSize;
+		tMaxY = (boundary - p1.y) / d.y;
+	}
+
+	bool firstCell = true;
+	int32 previousX = cellX;
+	int32 previousY = cellY;
+
+	for (;;)
+	{
+		int32 entryId = m_buckets[ComputeBucket(cellX, cellY)];
+		while (entryId != e_nullEntry)
+		{
+			const b2SpatialHashEntry* entry = m_entries + entryId;
+			entryId = entry->next;
+
+			if (entry->cellX != cellX || entry->cellY != cellY)
+			{
+				continue;
+			}
+
+			// The walk is monotone in x and y, so it stays in the cell range of
+			// a proxy once it enters. Skip proxies tested in the previous cell.
+			const b2SpatialHashProxy* proxy = m_proxies + entry->proxyId;
+			if (firstCell == false &&
+				proxy->lowerX <= previousX && previousX <= proxy->upperX &&
+				proxy->lowerY <= previousY && previousY <= proxy->upperY)
+			{
+				continue;
+			}
+
+			if (RayCastProxy(callback, input, entry->proxyId, v, abs_v, &maxFraction, &segmentAABB) == false)
+			{
+				return;
+			}
+		}
+
+		// Stop in the cell where the (possibly clipped) ray ends.
+		if (b2Min(tMaxX, tMaxY) > maxFraction)
+		{
+			return;
+		}
+
+		firstCell = false;
+		previousX = cellX;
+		previousY = cellY;
+
+		if (tMaxX < tMaxY)
+		{
+			cellX += stepX;
+			tMaxX += tDeltaX;
+		}
+		else
+		{
+			cellY += stepY;
+			tMaxY += tDeltaY;
+		}
+	}
+}
+
+#endif
@@ -45,6 +45,7 @@ bool b2BlockAllocator::s_blockSizeLookupInitialized;
 struct b2Chunk
 {
 	int32 blockSize;
+	int32 chunkSize;
 	b2Block* blocks;
 };
 
@@ -113,39 +114,69 @@ void* b2BlockAllocator::Allocate(int32 size)
 	}
 	else
 	{
-		if (m_chunkCount == m_chunkSpace)
-		{
-			b2Chunk* oldChunks = m_chunks;
-			m_chunkSpace += b2_chunkArrayIncrement;
-			m_chunks = (b2Chunk*)b2Alloc(m_chunkSpace * sizeof(b2Chunk));
-			memcpy(m_chunks, oldChunks, m_chunkCount * sizeof(b2Chunk));
-			memset(m_chunks + m_chunkCount, 0, b2_chunkArrayIncrement * sizeof(b2Chunk));
-			b2Free(oldChunks);
-		}
+		b2Chunk* chunk = AddChunk(s_blockSizes[index], b2_chunkSize);
+		m_freeLists[index] = chunk->blocks->next;
+		return chunk->blocks;
+	}
+}
 
-		b2Chunk* chunk = m_chunks + m_chunkCount;
-		chunk->blocks = (b2Block*)b2Alloc(b2_chunkSize);
+// Allocate a chunk and link its blocks into a list. The last block
+// links to NULL.
+b2Chunk* b2BlockAllocator::AddChunk(int32 blockSize, int32 chunkSize)
+{
+	if (m_chunkCount == m_chunkSpace)
+	{
+		b2Chunk* oldChunks = m_chunks;
+		m_chunkSpace += b2_chunkArrayIncrement;
+		m_chunks = (b2Chunk*)b2Alloc(m_chunkSpace * sizeof(b2Chunk));
+		memcpy(m_chunks, oldChunks, m_chunkCount * sizeof(b2Chunk));
+		memset(m_chunks + m_chunkCount, 0, b2_chunkArrayIncrement * sizeof(b2Chunk));
+		b2Free(oldChunks);
+	}
+
+	b2Chunk* chunk = m_chunks + m_chunkCount;
+	chunk->blocks = (b2Block*)b2Alloc(chunkSize);
 #if defined(_DEBUG)
-		memset(chunk->blocks, 0xcd, b2_chunkSize);
+	memset(chunk->blocks, 0xcd, chunkSize);
 #endif
-		int32 blockSize = s_blockSizes[index];
-		chunk->blockSize = blockSize;
-		int32 blockCount = b2_chunkSize / blockSize;
-		b2Assert(blockCount * blockSize <= b2_chunkSize);
-		for (int32 i = 0; i < blockCount - 1; ++i)
-		{
-			b2Block* block = (b2Block*)((int8*)chunk->blocks + blockSize * i);
-			b2Block* next = (b2Block*)((int8*)chunk->blocks + blockSize * (i + 1));
-			block->next = next;
-		}
-		b2Block* last = (b2Block*)((int8*)chunk->blocks + blockSize * (blockCount - 1));
-		last->next = NULL;
+	chunk->blockSize = blockSize;
+	chunk->chunkSize = chunkSize;
+	int32 blockCount = chunkSize / blockSize;
+	b2Assert(blockCount * blockSize <= chunkSize);
+	for (int32 i = 0; i < blockCount - 1; ++i)
+	{
+		b2Block* block = (b2Block*)((int8*)chunk->blocks + blockSize * i);
+		b2Block* next = (b2Block*)((int8*)chunk->blocks + blockSize * (i + 1));
+		block->next = next;
+	}
+	b2Block* last = (b2Block*)((int8*)chunk->blocks + blockSize * (blockCount - 1));
+	last->next = NULL;
 
-		m_freeLists[index] = chunk->blocks->next;
-		++m_chunkCount;
+	++m_chunkCount;
 
-		return chunk->blocks;
+	return chunk;
+}
+
+void b2BlockAllocator::Reserve(int32 size, int32 count)
+{
+	if (size == 0 || count == 0)
+	{
+		return;
 	}
+
+	b2Assert(0 < size && size <= b2_maxBlockSize);
+	b2Assert(count > 0);
+
+	int32 index = s_blockSizeLookup[size];
+	b2Assert(0 <= index && index < b2_blockSizes);
+
+	int32 blockSize = s_blockSizes[index];
+	b2Chunk* chunk = AddChunk(blockSize, count * blockSize);
+
+	// Put the new blocks in front of the existing free blocks.
+	b2Block* last = (b2Block*)((int8*)chunk->blocks + blockSize * (count - 1));
+	last->next = m_freeLists[index];
+	m_freeLists[index] = chunk->blocks;
 }
 
 void b2BlockAllocator::Free(void* p, int32 size)
@@ -170,11 +201,11 @@ void b2BlockAllocator::Free(void* p, int32 size)
 		if (chunk->blockSize != blockSize)
 		{
 			b2Assert(	(int8*)p + blockSize <= (int8*)chunk->blocks ||
-						(int8*)chunk->blocks + b2_chunkSize <= (int8*)p);
+						(int8*)chunk->blocks + chunk->chunkSize <= (int8*)p);
 		}
 		else
 		{
-			if ((int8*)chunk->blocks <= (int8*)p && (int8*)p + blockSize <= (int8*)chunk->blocks + b2_chunkSize)
+			if ((int8*)chunk->blocks <= (int8*)p && (int8*)p + blockSize <= (int8*)chunk->blocks + chunk->chunkSize)
 			{
 				found = true;
 			}
@@ -41,10 +41,17 @@ public:
 	void* Allocate(int32 size);
 	void Free(void* p, int32 size);
 
+	/// Carve count blocks of the given size out of a single chunk and put them
+	/// at the head of the free list. The next count calls to Allocate with this
+	/// size then return consecutive blocks without touching the system heap.
+	void Reserve(int32 size, int32 count);
+
 	void Clear();
 
 private:
 
+	b2Chunk* AddChunk(int32 blockSize, int32 chunkSize);
+
 	b2Chunk* m_chunks;
 	int32 m_chunkCount;
 	int32 m_chunkSpace;
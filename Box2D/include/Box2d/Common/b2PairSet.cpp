@@ -0,0 +1,136 @@
+/*
+* Copyright (c) 2006-2009 Erin Catto http://www.gphysics.com
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <Box2D/Common/b2PairSet.h>
+
+// Fibonacci hashing spreads the sequential proxy ids over the table.
+inline uint32 b2HashPairKey(uint64 key)
+{
+	key *= 0x9E3779B97F4A7C15ULL;
+	return (uint32)(key >> 32);
+}
+
+b2PairSet::b2PairSet()
+{
+	m_capacity = 16;
+	m_count = 0;
+	m_keys = (uint64*)b2Alloc(m_capacity * sizeof(uint64));
+	for (int32 i = 0; i < m_capacity; ++i)
+	{
+		m_keys[i] = b2_nullPairKey;
+	}
+}
+
+b2PairSet::~b2PairSet()
+{
+	b2Free(m_keys);
+}
+
+// Returns the slot holding the key, or the empty slot where it would go.
+int32 b2PairSet::FindSlot(uint64 key) const
+{
+	int32 mask = m_capacity - 1;
+	int32 index = b2HashPairKey(key) & mask;
+	while (m_keys[index] != b2_nullPairKey && m_keys[index] != key)
+	{
+		index = (index + 1) & mask;
+	}
+	return index;
+}
+
+void b2PairSet::Grow()
+{
+	uint64* oldKeys = m_keys;
+	int32 oldCapacity = m_capacity;
+
+	m_capacity *= 2;
+	m_keys = (uint64*)b2Alloc(m_capacity * sizeof(uint64));
+	for (int32 i = 0; i < m_capacity; ++i)
+	{
+		m_keys[i] = b2_nullPairKey;
+	}
+
+	for (int32 i = 0; i < oldCapacity; ++i)
+	{
+		if (oldKeys[i] != b2_nullPairKey)
+		{
+			m_keys[FindSlot(oldKeys[i])] = oldKeys[i];
+		}
+	}
+
+	b2Free(oldKeys);
+}
+
+bool b2PairSet::Add(uint64 key)
+{
+	b2Assert(key != b2_nullPairKey);
+
+	// Keep the load factor at or below one half.
+	if (2 * (m_count + 1) > m_capacity)
+	{
+		Grow();
+	}
+
+	int32 index = FindSlot(key);
+	if (m_keys[index] == key)
+	{
+		return false;
+	}
+
+	m_keys[index] = key;
+	++m_count;
+	return true;
+}
+
+bool b2PairSet::Remove(uint64 key)
+{
+	int32 index = FindSlot(key);
+	if (m_keys[index] != key)
+	{
+		return false;
+	}
+
+	// Shift back the following keys of the probe run so that lookups
+	// never stop early at the hole.
+	int32 mask = m_capacity - 1;
+	int32 hole = index;
+	int32 next = (index + 1) & mask;
+	while (m_keys[next] != b2_nullPairKey)
+	{
+		int32 home = b2HashPairKey(m_keys[next]) & mask;
+
+		// Move the key if its home slot is not in the cyclic range (hole, next].
+		bool inRange = hole <= next ? (hole < home && home <= next) : (hole < home || home <= next);
+		if (inRange == false)
+		{
+			m_keys[hole] = m_keys[next];
+			hole = next;
+		}
+
+		next = (next + 1) & mask;
+	}
+
+	m_keys[hole] = b2_nullPairKey;
+	--m_count;
+	return true;
+}
+
+bool b2PairSet::Contains(uint64 key) const
+{
+	return m_keys[FindSlot(key)] == key;
+}
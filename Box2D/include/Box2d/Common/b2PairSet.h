@@ -0,0 +1,74 @@
+/*
+* Copyright (c) 2006-2009 Erin Catto http://www.gphysics.com
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef B2_PAIR_SET_H
+#define B2_PAIR_SET_H
+
+#include <Box2D/Common/b2Settings.h>
+
+/// This key is never produced by b2PairKey because proxy ids are non-negative.
+#define b2_nullPairKey (~uint64(0))
+
+/// Build a key for an unordered pair of proxies. The smaller id is stored in
+/// the high word so that sorting keys sorts pairs like b2PairLessThan.
+inline uint64 b2PairKey(int32 proxyIdA, int32 proxyIdB)
+{
+	uint64 a = (uint64)(uint32)(proxyIdA < proxyIdB ? proxyIdA : proxyIdB);
+	uint64 b = (uint64)(uint32)(proxyIdA < proxyIdB ? proxyIdB : proxyIdA);
+	return (a << 32) | b;
+}
+
+/// An open addressing hash set of pair keys. This is used to find out whether
+/// a pair already has a contact in constant time. Removal uses backward shifting
+/// so the table never accumulates tombstones.
+class b2PairSet
+{
+public:
+	b2PairSet();
+	~b2PairSet();
+
+	/// Add a key.
+	/// @return false if the key was already present.
+	bool Add(uint64 key);
+
+	/// Remove a key.
+	/// @return false if the key was not present.
+	bool Remove(uint64 key);
+
+	/// Is the key present?
+	bool Contains(uint64 key) const;
+
+	/// Get the number of keys in the set.
+	int32 GetCount() const;
+
+private:
+
+	int32 FindSlot(uint64 key) const;
+	void Grow();
+
+	uint64* m_keys;
+	int32 m_capacity;
+	int32 m_count;
+};
+
+inline int32 b2PairSet::GetCount() const
+{
+	return m_count;
+}
+
+#endif
@@ -0,0 +1,107 @@
+/*
+* Copyright (c) 2006-2009 Erin Catto http://www.gphysics.com
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <Box2D/Common/b2Thread.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+struct b2ThreadStart
+{
+	b2ThreadFunction function;
+	void* data;
+};
+
+#if defined(_WIN32)
+
+static DWORD WINAPI b2ThreadEntry(LPVOID param)
+{
+	b2ThreadStart start = *(b2ThreadStart*)param;
+	b2Free(param);
+	start.function(start.data);
+	return 0;
+}
+
+#else
+
+static void* b2ThreadEntry(void* param)
+{
+	b2ThreadStart start = *(b2ThreadStart*)param;
+	b2Free(param);
+	start.function(start.data);
+	return NULL;
+}
+
+#endif
+
+b2Thread::b2Thread()
+{
+	m_handle = NULL;
+	m_running = false;
+}
+
+b2Thread::~b2Thread()
+{
+	if (m_running)
+	{
+		Wait();
+	}
+}
+
+void b2Thread::Launch(b2ThreadFunction function, void* data)
+{
+	b2Assert(m_running == false);
+
+	// The entry point frees the start block.
+	b2ThreadStart* start = (b2ThreadStart*)b2Alloc(sizeof(b2ThreadStart));
+	start->function = function;
+	start->data = data;
+
+#if defined(_WIN32)
+	m_handle = CreateThread(NULL, 0, b2ThreadEntry, start, 0, NULL);
+	b2Assert(m_handle != NULL);
+#else
+	pthread_t* thread = (pthread_t*)b2Alloc(sizeof(pthread_t));
+	int error = pthread_create(thread, NULL, b2ThreadEntry, start);
+	B2_NOT_USED(error);
+	b2Assert(error == 0);
+	m_handle = thread;
+#endif
+
+	m_running = true;
+}
+
+void b2Thread::Wait()
+{
+	b2Assert(m_running);
+
+#if defined(_WIN32)
+	WaitForSingleObject((HANDLE)m_handle, INFINITE);
+	CloseHandle((HANDLE)m_handle);
+#else
+	pthread_t* thread = (pthread_t*)m_handle;
+	pthread_join(*thread, NULL);
+	b2Free(thread);
+#endif
+
+	m_handle = NULL;
+	m_running = false;
+}
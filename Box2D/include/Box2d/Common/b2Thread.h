@@ -0,0 +1,57 @@
+/*
+* Copyright (c) 2006-2009 Erin Catto http://www.gphysics.com
+*
+* This software is provided 'as-is', without any express or implied
+* warranty.  In no event will the authors be held liable for any damages
+* arising from the use of this software.
+* Permission is granted to anyone to use this software for any purpose,
+* including commercial applications, and to alter it and redistribute it
+* freely, subject to the following restrictions:
+* 1. The origin of this software must not be misrepresented; you must not
+* claim that you wrote the original software. If you use this software
+* in a product, an acknowledgment in the product documentation would be
+* appreciated but is not required.
+* 2. Altered source versions must be plainly marked as such, and must not be
+* misrepresented as being the original software.
+* 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef B2_THREAD_H
+#define B2_THREAD_H
+
+#include <Box2D/Common/b2Settings.h>
+
+typedef void (*b2ThreadFunction)(void* data);
+
+/// A minimal worker thread that runs one function at a time. This wraps
+/// pthreads, or the Win32 API on Windows.
+class b2Thread
+{
+public:
+	b2Thread();
+
+	/// Waits for a running function to finish.
+	~b2Thread();
+
+	/// Run a function on a new thread. The previous function must have been
+	/// waited for.
+	void Launch(b2ThreadFunction function, void* data);
+
+	/// Block until the function launched last has returned.
+	void Wait();
+
+	/// Is a function launched and not waited for?
+	bool IsRunning() const;
+
+private:
+
+	void* m_handle;
+	bool m_running;
+};
+
+inline bool b2Thread::IsRunning() const
+{
+	return m_running;
+}
+
+#endif
@@ -26,6 +26,7 @@
 #include <Box2D/Collision/b2TimeOfImpact.h>
 #include <Box2D/Collision/Shapes/b2Shape.h>
 #include <Box2D/Common/b2BlockAllocator.h>
+#include <Box2D/Common/b2PairSet.h>
 #include <Box2D/Dynamics/b2Body.h>
 #include <Box2D/Dynamics/b2Fixture.h>
 #include <Box2D/Dynamics/b2World.h>
@@ -119,6 +120,9 @@ b2Contact::b2Contact(b2Fixture* fA, b2Fixture* fB)
 
 	m_manifold.pointCount = 0;
 
+	m_pairKey = b2_nullPairKey;
+	m_index = -1;
+
 	m_prev = NULL;
 	m_next = NULL;
 
@@ -135,11 +139,36 @@ b2Contact::b2Contact(b2Fixture* fA, b2Fixture* fB)
 	m_toiCount = 0;
 }
 
-// Update the contact manifold and touching status.
+// The solver only keeps the impulses in the contact manager's compact array,
+// so they are copied to the manifold when the user asks for it.
+b2Manifold* b2Contact::GetManifold()
+{
+	const b2ContactImpulse* impulse = m_fixtureA->GetBody()->GetWorld()->m_contactManager.m_impulses + m_index;
+	for (int32 i = 0; i < m_manifold.pointCount; ++i)
+	{
+		m_manifold.points[i].normalImpulse = impulse->normalImpulses[i];
+		m_manifold.points[i].tangentImpulse = impulse->tangentImpulses[i];
+	}
+	return &m_manifold;
+}
+
+const b2Manifold* b2Contact::GetManifold() const
+{
+	return const_cast<b2Contact*>(this)->GetManifold();
+}
+
+// Update the contact manifold and touching status. The old impulses are read
+// from the compact impulse array, and the matched ones are stored back there
+// to warm start the solver.
 // Note: do not assume the fixture AABBs are overlapping or are valid.
-void b2Contact::Update(b2ContactListener* listener)
+void b2Contact::Update(b2ContactListener* listener, b2ContactImpulse* impulse)
 {
 	b2Manifold oldManifold = m_manifold;
+	for (int32 i = 0; i < oldManifold.pointCount; ++i)
+	{
+		oldManifold.points[i].normalImpulse = impulse->normalImpulses[i];
+		oldManifold.points[i].tangentImpulse = impulse->tangentImpulses[i];
+	}
 
 	// Re-enable this contact.
 	m_flags |= e_enabledFlag;
@@ -175,10 +204,9 @@ void b2Contact::Update(b2ContactListener* listener)
 		// stored impulses to warm start the solver.
 		for (int32 i = 0; i < m_manifold.pointCount; ++i)
 		{
-			b2ManifoldPoint* mp2 = m_manifold.points + i;
-			mp2->normalImpulse = 0.0f;
-			mp2->tangentImpulse = 0.0f;
-			b2ContactID id2 = mp2->id;
+			b2ContactID id2 = m_manifold.points[i].id;
+			impulse->normalImpulses[i] = 0.0f;
+			impulse->tangentImpulses[i] = 0.0f;
 
 			for (int32 j = 0; j < oldManifold.pointCount; ++j)
 			{
@@ -186,8 +214,8 @@ void b2Contact::Update(b2ContactListener* listener)
 
 				if (mp1->id.key == id2.key)
 				{
-					mp2->normalImpulse = mp1->normalImpulse;
-					mp2->tangentImpulse = mp1->tangentImpulse;
+					impulse->normalImpulses[i] = mp1->normalImpulse;
+					impulse->tangentImpulses[i] = mp1->tangentImpulse;
 					break;
 				}
 			}
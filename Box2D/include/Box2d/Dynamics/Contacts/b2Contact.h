@@ -32,6 +32,7 @@ class b2World;
 class b2BlockAllocator;
 class b2StackAllocator;
 class b2ContactListener;
+struct b2ContactImpulse;
 
 typedef b2Contact* b2ContactCreateFcn(b2Fixture* fixtureA, b2Fixture* fixtureB, b2BlockAllocator* allocator);
 typedef void b2ContactDestroyFcn(b2Contact* contact, b2BlockAllocator* allocator);
@@ -64,7 +65,8 @@ class b2Contact
 public:
 
 	/// Get the contact manifold. Do not modify the manifold unless you understand the
-	/// internals of Box2D.
+	/// internals of Box2D. The point impulses are copied from the solver by this call,
+	/// so changing them does not affect the solver.
 	b2Manifold* GetManifold();
 	const b2Manifold* GetManifold() const;
 
@@ -101,8 +103,10 @@ protected:
 	friend class b2ContactManager;
 	friend class b2World;
 	friend class b2ContactSolver;
+	friend class b2Island;
 	friend class b2Body;
 	friend class b2Fixture;
+	friend class b2TOISolver;
 
 	// Flags stored in m_flags
 	enum
@@ -138,7 +142,7 @@ protected:
 	b2Contact(b2Fixture* fixtureA, b2Fixture* fixtureB);
 	virtual ~b2Contact() {}
 
-	void Update(b2ContactListener* listener);
+	void Update(b2ContactListener* listener, b2ContactImpulse* impulse);
 
 	static b2ContactRegister s_registers[b2Shape::e_typeCount][b2Shape::e_typeCount];
 	static bool s_initialized;
@@ -158,20 +162,17 @@ protected:
 
 	b2Manifold m_manifold;
 
+	// Broad-phase pair key, see b2PairKey.
+	uint64 m_pairKey;
+
+	// Index in the contact manager's dense arrays. The accumulated impulses
+	// used for warm starting live there, see b2ContactManager::m_impulses.
+	int32 m_index;
+
 	int32 m_toiCount;
 //	float32 m_toi;
 };
 
-inline b2Manifold* b2Contact::GetManifold()
-{
-	return &m_manifold;
-}
-
-inline const b2Manifold* b2Contact::GetManifold() const
-{
-	return &m_manifold;
-}
-
 inline void b2Contact::GetWorldManifold(b2WorldManifold* worldManifold) const
 {
 	const b2Body* bodyA = m_fixtureA->GetBody();
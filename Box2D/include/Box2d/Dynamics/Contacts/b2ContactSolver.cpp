@@ -25,10 +25,11 @@
 
 #define B2_DEBUG_SOLVER 0
 
-b2ContactSolver::b2ContactSolver(b2Contact** contacts, int32 contactCount,
+b2ContactSolver::b2ContactSolver(b2Contact** contacts, int32 contactCount, b2ContactImpulse* impulses,
 								b2StackAllocator* allocator, float32 impulseRatio)
 {
 	m_allocator = allocator;
+	m_impulses = impulses;
 
 	m_constraintCount = contactCount;
 	m_constraints = (b2ContactConstraint*)m_allocator->Allocate(m_constraintCount * sizeof(b2ContactConstraint));
@@ -45,7 +46,7 @@ b2ContactSolver::b2ContactSolver(b2Contact** contacts, int32 contactCount,
 		float32 radiusB = shapeB->m_radius;
 		b2Body* bodyA = fixtureA->GetBody();
 		b2Body* bodyB = fixtureB->GetBody();
-		b2Manifold* manifold = contact->GetManifold();
+		b2Manifold* manifold = &contact->m_manifold;
 
 		float32 friction = b2MixFriction(fixtureA->GetFriction(), fixtureB->GetFriction());
 		float32 restitution = b2MixRestitution(fixtureA->GetRestitution(), fixtureB->GetRestitution());
@@ -63,7 +64,7 @@ b2ContactSolver::b2ContactSolver(b2Contact** contacts, int32 contactCount,
 		b2ContactConstraint* cc = m_constraints + i;
 		cc->bodyA = bodyA;
 		cc->bodyB = bodyB;
-		cc->manifold = manifold;
+		cc->index = contact->m_index;
 		cc->normal = worldManifold.normal;
 		cc->pointCount = manifold->pointCount;
 		cc->friction = friction;
@@ -73,13 +74,15 @@ b2ContactSolver::b2ContactSolver(b2Contact** contacts, int32 contactCount,
 		cc->radius = radiusA + radiusB;
 		cc->type = manifold->type;
 
+		const b2ContactImpulse* impulse = m_impulses + cc->index;
+
 		for (int32 j = 0; j < cc->pointCount; ++j)
 		{
 			b2ManifoldPoint* cp = manifold->points + j;
 			b2ContactConstraintPoint* ccp = cc->points + j;
 
-			ccp->normalImpulse = impulseRatio * cp->normalImpulse;
-			ccp->tangentImpulse = impulseRatio * cp->tangentImpulse;
+			ccp->normalImpulse = impulseRatio * impulse->normalImpulses[j];
+			ccp->tangentImpulse = impulseRatio * impulse->tangentImpulses[j];
 
 			ccp->localPoint = cp->localPoint;
 
@@ -493,12 +496,12 @@ void b2ContactSolver::StoreImpulses()
 	for (int32 i = 0; i < m_constraintCount; ++i)
 	{
 		b2ContactConstraint* c = m_constraints + i;
-		b2Manifold* m = c->manifold;
+		b2ContactImpulse* impulse = m_impulses + c->index;
 
 		for (int32 j = 0; j < c->pointCount; ++j)
 		{
-			m->points[j].normalImpulse = c->points[j].normalImpulse;
-			m->points[j].tangentImpulse = c->points[j].tangentImpulse;
+			impulse->normalImpulses[j] = c->points[j].normalImpulse;
+			impulse->tangentImpulses[j] = c->points[j].tangentImpulse;
 		}
 	}
 }
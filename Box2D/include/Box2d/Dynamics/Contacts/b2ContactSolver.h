@@ -26,6 +26,7 @@
 class b2Contact;
 class b2Body;
 class b2StackAllocator;
+struct b2ContactImpulse;
 
 struct b2ContactConstraintPoint
 {
@@ -53,13 +54,15 @@ struct b2ContactConstraint
 	float32 radius;
 	float32 friction;
 	int32 pointCount;
-	b2Manifold* manifold;
+	int32 index;
 };
 
 class b2ContactSolver
 {
 public:
-	b2ContactSolver(b2Contact** contacts, int32 contactCount,
+	/// The accumulated impulses are read from and stored to the compact
+	/// impulse array at b2Contact::m_index.
+	b2ContactSolver(b2Contact** contacts, int32 contactCount, b2ContactImpulse* impulses,
 					b2StackAllocator* allocator, float32 impulseRatio);
 
 	~b2ContactSolver();
@@ -71,6 +74,7 @@ public:
 	bool SolvePositionConstraints(float32 baumgarte);
 
 	b2StackAllocator* m_allocator;
+	b2ContactImpulse* m_impulses;
 	b2ContactConstraint* m_constraints;
 	int m_constraintCount;
 };
@@ -77,7 +77,7 @@ void b2TOISolver::Initialize(b2Contact** contacts, int32 count, b2Body* toiBody)
 		float32 radiusB = shapeB->m_radius;
 		b2Body* bodyA = fixtureA->GetBody();
 		b2Body* bodyB = fixtureB->GetBody();
-		b2Manifold* manifold = contact->GetManifold();
+		b2Manifold* manifold = &contact->m_manifold;
 
 		b2Assert(manifold->pointCount > 0);
 
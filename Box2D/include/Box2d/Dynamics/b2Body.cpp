@@ -109,6 +109,7 @@ b2Body::~b2Body()
 
 void b2Body::SetType(b2BodyType type)
 {
+	b2Assert(m_world->IsStepping() == false);
 	if (m_type == type)
 	{
 		return;
@@ -258,6 +259,7 @@ void b2Body::DestroyFixture(b2Fixture* fixture)
 
 void b2Body::ResetMassData()
 {
+	b2Assert(m_world->IsStepping() == false);
 	// Compute mass data from shapes. Each shape has its own density.
 	m_mass = 0.0f;
 	m_invMass = 0.0f;
@@ -428,6 +430,7 @@ void b2Body::SynchronizeFixtures()
 
 void b2Body::SetActive(bool flag)
 {
+	b2Assert(m_world->IsStepping() == false);
 	if (flag == IsActive())
 	{
 		return;
@@ -21,6 +21,7 @@
 #include <Box2D/Dynamics/b2Fixture.h>
 #include <Box2D/Dynamics/b2WorldCallbacks.h>
 #include <Box2D/Dynamics/Contacts/b2Contact.h>
+#include <cstring>
 
 b2ContactFilter b2_defaultFilter;
 b2ContactListener b2_defaultListener;
@@ -29,11 +30,20 @@ b2ContactManager::b2ContactManager()
 {
 	m_contactList = NULL;
 	m_contactCount = 0;
+	m_contacts = NULL;
+	m_impulses = NULL;
+	m_contactCapacity = 0;
 	m_contactFilter = &b2_defaultFilter;
 	m_contactListener = &b2_defaultListener;
 	m_allocator = NULL;
 }
 
+b2ContactManager::~b2ContactManager()
+{
+	b2Free(m_contacts);
+	b2Free(m_impulses);
+}
+
 void b2ContactManager::Destroy(b2Contact* c)
 {
 	b2Fixture* fixtureA = c->GetFixtureA();
@@ -46,6 +56,8 @@ void b2ContactManager::Destroy(b2Contact* c)
 		m_contactListener->EndContact(c);
 	}
 
+	m_pairSet.Remove(c->m_pairKey);
+
 	// Remove from the world.
 	if (c->m_prev)
 	{
@@ -94,6 +106,17 @@ void b2ContactManager::Destroy(b2Contact* c)
 		bodyB->m_contactList = c->m_nodeB.next;
 	}
 
+	// Move the last contact into the freed slot of the dense arrays.
+	int32 index = c->m_index;
+	int32 lastIndex = m_contactCount - 1;
+	if (index != lastIndex)
+	{
+		b2Contact* last = m_contacts[lastIndex];
+		m_contacts[index] = last;
+		m_impulses[index] = m_impulses[lastIndex];
+		last->m_index = index;
+	}
+
 	// Call the factory.
 	b2Contact::Destroy(c, m_allocator);
 	--m_contactCount;
@@ -158,14 +181,15 @@ void b2ContactManager::Collide()
 		}
 
 		// The contact persists.
-		c->Update(m_contactListener);
+		c->Update(m_contactListener, m_impulses + c->m_index);
 		c = c->GetNext();
 	}
 }
 
 void b2ContactManager::FindNewContacts()
 {
-	m_broadPhase.UpdatePairs(this);
+	int32 pairCount = m_broadPhase.UpdatePairs();
+	AddPairs(m_broadPhase.GetPairBuffer(), pairCount);
 }
 
 void b2ContactManager::AddPair(void* proxyUserDataA, void* proxyUserDataB)
@@ -173,37 +197,44 @@ void b2ContactManager::AddPair(void* proxyUserDataA, void* proxyUserDataB)
 	b2Fixture* fixtureA = (b2Fixture*)proxyUserDataA;
 	b2Fixture* fixtureB = (b2Fixture*)proxyUserDataB;
 
-	b2Body* bodyA = fixtureA->GetBody();
-	b2Body* bodyB = fixtureB->GetBody();
-
-	// Are the fixtures on the same body?
-	if (bodyA == bodyB)
+	// Does a contact already exist?
+	uint64 pairKey = b2PairKey(fixtureA->m_proxyId, fixtureB->m_proxyId);
+	if (m_pairSet.Contains(pairKey))
 	{
 		return;
 	}
 
-	// Does a contact already exist?
-	b2ContactEdge* edge = bodyB->GetContactList();
-	while (edge)
+	Create(fixtureA, fixtureB, pairKey);
+}
+
+void b2ContactManager::AddPairs(const b2Pair* pairs, int32 count)
+{
+	for (int32 i = 0; i < count; ++i)
 	{
-		if (edge->other == bodyA)
-		{
-			b2Fixture* fA = edge->contact->GetFixtureA();
-			b2Fixture* fB = edge->contact->GetFixtureB();
-			if (fA == fixtureA && fB == fixtureB)
-			{
-				// A contact already exists.
-				return;
-			}
+		const b2Pair* pair = pairs + i;
 
-			if (fA == fixtureB && fB == fixtureA)
-			{
-				// A contact already exists.
-				return;
-			}
+		// Existing contacts are rejected by key without touching the fixtures.
+		uint64 pairKey = b2PairKey(pair->proxyIdA, pair->proxyIdB);
+		if (m_pairSet.Contains(pairKey))
+		{
+			continue;
 		}
 
-		edge = edge->next;
+		b2Fixture* fixtureA = (b2Fixture*)m_broadPhase.GetUserData(pair->proxyIdA);
+		b2Fixture* fixtureB = (b2Fixture*)m_broadPhase.GetUserData(pair->proxyIdB);
+		Create(fixtureA, fixtureB, pairKey);
+	}
+}
+
+void b2ContactManager::Create(b2Fixture* fixtureA, b2Fixture* fixtureB, uint64 pairKey)
+{
+	b2Body* bodyA = fixtureA->GetBody();
+	b2Body* bodyB = fixtureB->GetBody();
+
+	// Are the fixtures on the same body?
+	if (bodyA == bodyB)
+	{
+		return;
 	}
 
 	// Does a joint override collision? Is at least one body dynamic?
@@ -221,6 +252,9 @@ void b2ContactManager::AddPair(void* proxyUserDataA, void* proxyUserDataB)
 	// Call the factory.
 	b2Contact* c = b2Contact::Create(fixtureA, fixtureB, m_allocator);
 
+	c->m_pairKey = pairKey;
+	m_pairSet.Add(pairKey);
+
 	// Contact creation may swap fixtures.
 	fixtureA = c->GetFixtureA();
 	fixtureB = c->GetFixtureB();
@@ -262,5 +296,26 @@ void b2ContactManager::AddPair(void* proxyUserDataA, void* proxyUserDataB)
 	}
 	bodyB->m_contactList = &c->m_nodeB;
 
+	// Append to the dense arrays.
+	if (m_contactCount == m_contactCapacity)
+	{
+		b2Contact** oldContacts = m_contacts;
+		b2ContactImpulse* oldImpulses = m_impulses;
+		m_contactCapacity = m_contactCapacity > 0 ? 2 * m_contactCapacity : 64;
+		m_contacts = (b2Contact**)b2Alloc(m_contactCapacity * sizeof(b2Contact*));
+		m_impulses = (b2ContactImpulse*)b2Alloc(m_contactCapacity * sizeof(b2ContactImpulse));
+		if (m_contactCount > 0)
+		{
+			memcpy(m_contacts, oldContacts, m_contactCount * sizeof(b2Contact*));
+			memcpy(m_impulses, oldImpulses, m_contactCount * sizeof(b2ContactImpulse));
+		}
+		b2Free(oldContacts);
+		b2Free(oldImpulses);
+	}
+
+	c->m_index = m_contactCount;
+	m_contacts[m_contactCount] = c;
+	memset(m_impulses + m_contactCount, 0, sizeof(b2ContactImpulse));
+
 	++m_contactCount;
 }
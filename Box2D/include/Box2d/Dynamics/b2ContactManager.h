@@ -20,30 +20,48 @@
 #define B2_CONTACT_MANAGER_H
 
 #include <Box2D/Collision/b2BroadPhase.h>
+#include <Box2D/Common/b2PairSet.h>
 
 class b2Contact;
+class b2Fixture;
 class b2ContactFilter;
 class b2ContactListener;
 class b2BlockAllocator;
+struct b2ContactImpulse;
 
 // Delegate of b2World.
 class b2ContactManager
 {
 public:
 	b2ContactManager();
+	~b2ContactManager();
 
 	// Broad-phase callback.
 	void AddPair(void* proxyUserDataA, void* proxyUserDataB);
 
+	// Create contacts for a sorted, duplicate free pair array.
+	void AddPairs(const b2Pair* pairs, int32 count);
+
 	void FindNewContacts();
 
 	void Destroy(b2Contact* c);
 
 	void Collide();
-            
+
+	void Create(b2Fixture* fixtureA, b2Fixture* fixtureB, uint64 pairKey);
+
 	b2BroadPhase m_broadPhase;
+	b2PairSet m_pairSet;
 	b2Contact* m_contactList;
 	int32 m_contactCount;
+
+	// Dense arrays indexed by b2Contact::m_index. The solver reads and writes the
+	// warm starting impulses here instead of chasing the contact manifolds, which
+	// only receive a copy in b2Contact::GetManifold.
+	b2Contact** m_contacts;
+	b2ContactImpulse* m_impulses;
+	int32 m_contactCapacity;
+
 	b2ContactFilter* m_contactFilter;
 	b2ContactListener* m_contactListener;
 	b2BlockAllocator* m_allocator;
@@ -148,7 +148,8 @@ b2Island::b2Island(
 	int32 contactCapacity,
 	int32 jointCapacity,
 	b2StackAllocator* allocator,
-	b2ContactListener* listener)
+	b2ContactListener* listener,
+	b2ContactImpulse* impulses)
 {
 	m_bodyCapacity = bodyCapacity;
 	m_contactCapacity = contactCapacity;
@@ -159,6 +160,7 @@ b2Island::b2Island(
 
 	m_allocator = allocator;
 	m_listener = listener;
+	m_impulses = impulses;
 
 	m_bodies = (b2Body**)m_allocator->Allocate(bodyCapacity * sizeof(b2Body*));
 	m_contacts = (b2Contact**)m_allocator->Allocate(contactCapacity	 * sizeof(b2Contact*));
@@ -222,7 +224,7 @@ void b2Island::Solve(const b2TimeStep& step, const b2Vec2& gravity, bool allowSl
 	}
 
 	// Initialize velocity constraints.
-	b2ContactSolver contactSolver(m_contacts, m_contactCount, m_allocator, step.dtRatio);
+	b2ContactSolver contactSolver(m_contacts, m_contactCount, m_impulses, m_allocator, step.dtRatio);
 	contactSolver.WarmStart();
 	for (int32 i = 0; i < m_jointCount; ++i)
 	{
@@ -301,7 +303,7 @@ void b2Island::Solve(const b2TimeStep& step, const b2Vec2& gravity, bool allowSl
 		}
 	}
 
-	Report(contactSolver.m_constraints);
+	Report();
 
 	if (allowSleep)
 	{
@@ -349,26 +351,17 @@ void b2Island::Solve(const b2TimeStep& step, const b2Vec2& gravity, bool allowSl
 	}
 }
 
-void b2Island::Report(const b2ContactConstraint* constraints)
+void b2Island::Report()
 {
 	if (m_listener == NULL)
 	{
 		return;
 	}
 
+	// The solver stored the impulses in the compact array.
 	for (int32 i = 0; i < m_contactCount; ++i)
 	{
 		b2Contact* c = m_contacts[i];
-
-		const b2ContactConstraint* cc = constraints + i;
-		
-		b2ContactImpulse impulse;
-		for (int32 j = 0; j < cc->pointCount; ++j)
-		{
-			impulse.normalImpulses[j] = cc->points[j].normalImpulse;
-			impulse.tangentImpulses[j] = cc->points[j].tangentImpulse;
-		}
-
-		m_listener->PostSolve(c, &impulse);
+		m_listener->PostSolve(c, m_impulses + c->m_index);
 	}
 }
@@ -27,6 +27,7 @@ class b2Contact;
 class b2Joint;
 class b2StackAllocator;
 class b2ContactListener;
+struct b2ContactImpulse;
 struct b2ContactConstraint;
 
 /// This is an internal structure.
@@ -48,7 +49,7 @@ class b2Island
 {
 public:
 	b2Island(int32 bodyCapacity, int32 contactCapacity, int32 jointCapacity,
-			b2StackAllocator* allocator, b2ContactListener* listener);
+			b2StackAllocator* allocator, b2ContactListener* listener, b2ContactImpulse* impulses);
 	~b2Island();
 
 	void Clear()
@@ -79,10 +80,11 @@ public:
 		m_joints[m_jointCount++] = joint;
 	}
 
-	void Report(const b2ContactConstraint* constraints);
+	void Report();
 
 	b2StackAllocator* m_allocator;
 	b2ContactListener* m_listener;
+	b2ContactImpulse* m_impulses;
 
 	b2Body** m_bodies;
 	b2Contact** m_contacts;
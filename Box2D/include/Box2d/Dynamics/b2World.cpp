@@ -52,30 +52,54 @@ b2World::b2World(const b2Vec2& gravity, bool doSleep)
 
 	m_inv_dt0 = 0.0f;
 
+	m_stepping = false;
+	m_asyncTimeStep = 0.0f;
+	m_asyncVelocityIterations = 0;
+	m_asyncPositionIterations = 0;
+
+	for (int32 i = 0; i < 2; ++i)
+	{
+		m_states[i] = NULL;
+		m_stateCounts[i] = 0;
+		m_stateCapacities[i] = 0;
+	}
+	m_frontStates = 0;
+
 	m_contactManager.m_allocator = &m_blockAllocator;
 }
 
 b2World::~b2World()
 {
+	if (m_stepping)
+	{
+		WaitStep();
+	}
+
+	b2Free(m_states[0]);
+	b2Free(m_states[1]);
 }
 
 void b2World::SetDestructionListener(b2DestructionListener* listener)
 {
+	b2Assert(IsStepping() == false);
 	m_destructionListener = listener;
 }
 
 void b2World::SetContactFilter(b2ContactFilter* filter)
 {
+	b2Assert(IsStepping() == false);
 	m_contactManager.m_contactFilter = filter;
 }
 
 void b2World::SetContactListener(b2ContactListener* listener)
 {
+	b2Assert(IsStepping() == false);
 	m_contactManager.m_contactListener = listener;
 }
 
 void b2World::SetDebugDraw(b2DebugDraw* debugDraw)
 {
+	b2Assert(IsStepping() == false);
 	m_debugDraw = debugDraw;
 }
 
@@ -103,6 +127,102 @@ b2Body* b2World::CreateBody(const b2BodyDef* def)
 	return b;
 }
 
+void b2World::CreateBodies(const b2BodyDef* bodyDefs, int32 bodyCount,
+						   const b2FixtureDef* fixtureDefs, const int32* fixtureCounts,
+						   b2Body** bodies)
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return;
+	}
+
+	// Count the objects so each type comes from a single allocation.
+	int32 fixtureCount = 0;
+	int32 proxyCount = 0;
+	for (int32 i = 0; i < bodyCount; ++i)
+	{
+		fixtureCount += fixtureCounts[i];
+		if (bodyDefs[i].active)
+		{
+			proxyCount += fixtureCounts[i];
+		}
+	}
+
+	int32 shapeCounts[b2Shape::e_typeCount] = {0};
+	for (int32 i = 0; i < fixtureCount; ++i)
+	{
+		b2Shape::Type type = fixtureDefs[i].shape->GetType();
+		b2Assert(b2Shape::e_unknown < type && type < b2Shape::e_typeCount);
+		++shapeCounts[type];
+	}
+
+	m_blockAllocator.Reserve(sizeof(b2Body), bodyCount);
+	m_blockAllocator.Reserve(sizeof(b2Fixture), fixtureCount);
+	m_blockAllocator.Reserve(sizeof(b2CircleShape), shapeCounts[b2Shape::e_circle]);
+	m_blockAllocator.Reserve(sizeof(b2PolygonShape), shapeCounts[b2Shape::e_polygon]);
+
+	b2AABB* aabbs = (b2AABB*)m_stackAllocator.Allocate(proxyCount * sizeof(b2AABB));
+	void** userData = (void**)m_stackAllocator.Allocate(proxyCount * sizeof(void*));
+	int32* proxyIds = (int32*)m_stackAllocator.Allocate(proxyCount * sizeof(int32));
+
+	const b2FixtureDef* fixtureDef = fixtureDefs;
+	int32 proxyIndex = 0;
+	for (int32 i = 0; i < bodyCount; ++i)
+	{
+		b2Body* b = CreateBody(bodyDefs + i);
+		if (bodies)
+		{
+			bodies[i] = b;
+		}
+
+		bool hasMass = false;
+		for (int32 j = 0; j < fixtureCounts[i]; ++j, ++fixtureDef)
+		{
+			void* memory = m_blockAllocator.Allocate(sizeof(b2Fixture));
+			b2Fixture* fixture = new (memory) b2Fixture;
+			fixture->Create(&m_blockAllocator, b, fixtureDef);
+
+			if (b->m_flags & b2Body::e_activeFlag)
+			{
+				fixture->m_shape->ComputeAABB(&fixture->m_aabb, b->m_xf);
+				aabbs[proxyIndex] = fixture->m_aabb;
+				userData[proxyIndex] = fixture;
+				++proxyIndex;
+			}
+
+			fixture->m_next = b->m_fixtureList;
+			b->m_fixtureList = fixture;
+			++b->m_fixtureCount;
+
+			hasMass = hasMass || fixture->m_density > 0.0f;
+		}
+
+		// Adjust mass properties once per body.
+		if (hasMass)
+		{
+			b->ResetMassData();
+		}
+	}
+	b2Assert(proxyIndex == proxyCount);
+
+	m_contactManager.m_broadPhase.CreateProxies(aabbs, userData, proxyCount, proxyIds);
+	for (int32 i = 0; i < proxyCount; ++i)
+	{
+		((b2Fixture*)userData[i])->m_proxyId = proxyIds[i];
+	}
+
+	m_stackAllocator.Free(proxyIds);
+	m_stackAllocator.Free(userData);
+	m_stackAllocator.Free(aabbs);
+
+	// New contacts are created at the beginning of the next time step.
+	if (fixtureCount > 0)
+	{
+		m_flags |= e_newFixture;
+	}
+}
+
 void b2World::DestroyBody(b2Body* b)
 {
 	b2Assert(m_bodyCount > 0);
@@ -342,7 +462,8 @@ void b2World::Solve(const b2TimeStep& step)
 					m_contactManager.m_contactCount,
 					m_jointCount,
 					&m_stackAllocator,
-					m_contactManager.m_contactListener);
+					m_contactManager.m_contactListener,
+					m_contactManager.m_impulses);
 
 	// Clear all the island flags.
 	for (b2Body* b = m_bodyList; b; b = b->m_next)
@@ -622,7 +743,7 @@ void b2World::SolveTOI(b2Body* body)
 
 	b2Sweep backup = body->m_sweep;
 	body->Advance(toi);
-	toiContact->Update(m_contactManager.m_contactListener);
+	toiContact->Update(m_contactManager.m_contactListener, m_contactManager.m_impulses + toiContact->m_index);
 	if (toiContact->IsEnabled() == false)
 	{
 		// Contact disabled. Backup and recurse.
@@ -667,7 +788,7 @@ void b2World::SolveTOI(b2Body* body)
 		// gives the user a chance to disable the contact.
 		if (contact != toiContact)
 		{
-			contact->Update(m_contactManager.m_contactListener);
+			contact->Update(m_contactManager.m_contactListener, m_contactManager.m_impulses + contact->m_index);
 		}
 
 		// Did the user disable the contact?
@@ -776,6 +897,19 @@ void b2World::SolveTOI()
 }
 
 void b2World::Step(float32 dt, int32 velocityIterations, int32 positionIterations)
+{
+	// A step launched by StepAsync must be waited for first.
+	b2Assert(IsStepping() == false);
+	if (IsStepping())
+	{
+		return;
+	}
+
+	RunStep(dt, velocityIterations, positionIterations);
+}
+
+// Runs on the calling thread for Step, and on the worker thread for StepAsync.
+void b2World::RunStep(float32 dt, int32 velocityIterations, int32 positionIterations)
 {
 	// If new fixtures were added, we need to find the new contacts.
 	if (m_flags & e_newFixture)
@@ -825,13 +959,82 @@ void b2World::Step(float32 dt, int32 velocityIterations, int32 positionIteration
 
 	if (m_flags & e_clearForces)
 	{
-		ClearForces();
+		ClearBodyForces();
 	}
 
 	m_flags &= ~e_locked;
 }
 
+void b2World::StepAsync(float32 dt, int32 velocityIterations, int32 positionIterations)
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return;
+	}
+
+	m_asyncTimeStep = dt;
+	m_asyncVelocityIterations = velocityIterations;
+	m_asyncPositionIterations = positionIterations;
+
+	// The thread launch orders these writes before the worker runs.
+	m_stepping = true;
+	m_stepThread.Launch(StepTask, this);
+}
+
+void b2World::WaitStep()
+{
+	b2Assert(m_stepping);
+	if (m_stepping == false)
+	{
+		return;
+	}
+
+	m_stepThread.Wait();
+	m_stepping = false;
+
+	// Publish the states written by the worker.
+	m_frontStates = 1 - m_frontStates;
+}
+
+// Runs on the worker thread.
+void b2World::StepTask(void* data)
+{
+	b2World* world = (b2World*)data;
+	world->RunStep(world->m_asyncTimeStep, world->m_asyncVelocityIterations, world->m_asyncPositionIterations);
+	world->StoreBodyStates(1 - world->m_frontStates);
+}
+
+void b2World::StoreBodyStates(int32 buffer)
+{
+	if (m_stateCapacities[buffer] < m_bodyCount)
+	{
+		b2Free(m_states[buffer]);
+		m_stateCapacities[buffer] = b2Max(2 * m_stateCapacities[buffer], m_bodyCount);
+		m_states[buffer] = (b2BodyState*)b2Alloc(m_stateCapacities[buffer] * sizeof(b2BodyState));
+	}
+
+	b2BodyState* state = m_states[buffer];
+	for (b2Body* b = m_bodyList; b; b = b->GetNext())
+	{
+		state->body = b;
+		state->userData = b->m_userData;
+		state->xf = b->m_xf;
+		state->linearVelocity = b->m_linearVelocity;
+		state->angularVelocity = b->m_angularVelocity;
+		++state;
+	}
+
+	m_stateCounts[buffer] = m_bodyCount;
+}
+
 void b2World::ClearForces()
+{
+	b2Assert(IsStepping() == false);
+	ClearBodyForces();
+}
+
+void b2World::ClearBodyForces()
 {
 	for (b2Body* body = m_bodyList; body; body = body->GetNext())
 	{
@@ -854,6 +1057,8 @@ struct b2WorldQueryWrapper
 
 void b2World::QueryAABB(b2QueryCallback* callback, const b2AABB& aabb) const
 {
+	// The broad-phase is updated by the worker of StepAsync.
+	b2Assert(IsStepping() == false);
 	b2WorldQueryWrapper wrapper;
 	wrapper.broadPhase = &m_contactManager.m_broadPhase;
 	wrapper.callback = callback;
@@ -885,6 +1090,7 @@ struct b2WorldRayCastWrapper
 
 void b2World::RayCast(b2RayCastCallback* callback, const b2Vec2& point1, const b2Vec2& point2) const
 {
+	b2Assert(IsStepping() == false);
 	b2WorldRayCastWrapper wrapper;
 	wrapper.broadPhase = &m_contactManager.m_broadPhase;
 	wrapper.callback = callback;
@@ -972,6 +1178,7 @@ void b2World::DrawJoint(b2Joint* joint)
 
 void b2World::DrawDebugData()
 {
+	b2Assert(IsStepping() == false);
 	if (m_debugDraw == NULL)
 	{
 		return;
@@ -1070,6 +1277,18 @@ void b2World::DrawDebugData()
 	}
 }
 
+void b2World::SetBroadPhaseType(b2BroadPhaseType type, float32 cellSize)
+{
+	b2Assert(IsLocked() == false);
+	b2Assert(m_contactManager.m_broadPhase.GetProxyCount() == 0);
+	if (IsLocked())
+	{
+		return;
+	}
+
+	m_contactManager.m_broadPhase.SetType(type, cellSize);
+}
+
 int32 b2World::GetProxyCount() const
 {
 	return m_contactManager.m_broadPhase.GetProxyCount();
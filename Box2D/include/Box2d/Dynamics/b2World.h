@@ -22,17 +22,39 @@
 #include <Box2D/Common/b2Math.h>
 #include <Box2D/Common/b2BlockAllocator.h>
 #include <Box2D/Common/b2StackAllocator.h>
+#include <Box2D/Common/b2Thread.h>
 #include <Box2D/Dynamics/b2ContactManager.h>
 #include <Box2D/Dynamics/b2WorldCallbacks.h>
 
 struct b2AABB;
 struct b2BodyDef;
+struct b2FixtureDef;
 struct b2JointDef;
 struct b2TimeStep;
 class b2Body;
 class b2Fixture;
 class b2Joint;
 
+/// A copy of the body state taken at the end of an asynchronous time step.
+/// @see b2World::StepAsync
+struct b2BodyState
+{
+	/// The body this state was taken from. The body may have been destroyed since.
+	const b2Body* body;
+
+	/// The body user data.
+	void* userData;
+
+	/// The body origin transform.
+	b2Transform xf;
+
+	/// The linear velocity of the center of mass.
+	b2Vec2 linearVelocity;
+
+	/// The angular velocity.
+	float32 angularVelocity;
+};
+
 /// The world class manages all physics entities, dynamic simulation,
 /// and asynchronous queries. The world also contains efficient memory
 /// management facilities.
@@ -70,6 +92,22 @@ public:
 	/// @warning This function is locked during callbacks.
 	b2Body* CreateBody(const b2BodyDef* def);
 
+	/// Create many rigid bodies and their fixtures in one call. This is meant for
+	/// level loading: the bodies, fixtures and shapes are carved out of one block
+	/// per object type and the broad-phase proxies are built in one top-down pass.
+	/// The objects are otherwise the same as those made by CreateBody and
+	/// b2Body::CreateFixture and can be destroyed individually.
+	/// No reference to the definitions is retained.
+	/// @param bodyDefs the body definitions.
+	/// @param bodyCount the number of bodies.
+	/// @param fixtureDefs the fixture definitions of all the bodies, body by body.
+	/// @param fixtureCounts the number of fixtures of each body.
+	/// @param bodies receives the created bodies. May be NULL.
+	/// @warning This function is locked during callbacks.
+	void CreateBodies(const b2BodyDef* bodyDefs, int32 bodyCount,
+					  const b2FixtureDef* fixtureDefs, const int32* fixtureCounts,
+					  b2Body** bodies);
+
 	/// Destroy a rigid body given a definition. No reference to the definition
 	/// is retained. This function is locked during callbacks.
 	/// @warning This automatically deletes all associated shapes and joints.
@@ -94,6 +132,36 @@ public:
 				int32 velocityIterations,
 				int32 positionIterations);
 
+	/// Take a time step on a worker thread. The world is locked until WaitStep is
+	/// called: do not access the world, its bodies, fixtures, joints or contacts in
+	/// the meantime. Callbacks are issued on the worker thread. Use GetBodyStates
+	/// to read the body transforms and velocities of the previous step while the
+	/// step runs. Step, the functions locked during callbacks, the world setters,
+	/// ClearForces and the queries assert that no asynchronous step is pending.
+	/// @param timeStep the amount of time to simulate, this should not vary.
+	/// @param velocityIterations for the velocity constraint solver.
+	/// @param positionIterations for the position constraint solver.
+	void StepAsync(	float32 timeStep,
+					int32 velocityIterations,
+					int32 positionIterations);
+
+	/// Wait for the step launched by StepAsync to finish. This publishes the body
+	/// states of that step and unlocks the world. This must be called before the
+	/// next step and before the world is modified or destroyed.
+	void WaitStep();
+
+	/// Is a step launched by StepAsync running or not waited for?
+	bool IsStepping() const;
+
+	/// Get the body states taken at the end of the last asynchronous step, one per
+	/// body in body list order. The states are double-buffered: the running step
+	/// writes the other buffer, so these may be read while the step runs. They are
+	/// valid until the next call to WaitStep.
+	const b2BodyState* GetBodyStates() const;
+
+	/// Get the number of body states.
+	int32 GetBodyStateCount() const;
+
 	/// Call this after you are done with time steps to clear the forces. You normally
 	/// call this after each call to Step, unless you are performing sub-steps. By default,
 	/// forces will be automatically cleared, so you don't need to call this function.
@@ -134,10 +202,21 @@ public:
 	b2Contact* GetContactList();
 
 	/// Enable/disable warm starting. For testing.
-	void SetWarmStarting(bool flag) { m_warmStarting = flag; }
+	void SetWarmStarting(bool flag) { b2Assert(IsStepping() == false); m_warmStarting = flag; }
 
 	/// Enable/disable continuous physics. For testing.
-	void SetContinuousPhysics(bool flag) { m_continuousPhysics = flag; }
+	void SetContinuousPhysics(bool flag) { b2Assert(IsStepping() == false); m_continuousPhysics = flag; }
+
+	/// Select the broad-phase acceleration structure. The spatial hash is faster
+	/// for many bodies of similar size, such as debris. This must be called
+	/// before any fixture is created.
+	/// @param type the broad-phase type.
+	/// @param cellSize the grid cell size for the spatial hash, close to the typical
+	/// fixture size. This is ignored by the dynamic tree.
+	void SetBroadPhaseType(b2BroadPhaseType type, float32 cellSize);
+
+	/// Get the broad-phase acceleration structure type.
+	b2BroadPhaseType GetBroadPhaseType() const;
 
 	/// Get the number of broad-phase proxies.
 	int32 GetProxyCount() const;
@@ -157,7 +236,7 @@ public:
 	/// Get the global gravity vector.
 	b2Vec2 GetGravity() const;
 
-	/// Is the world locked (in the middle of a time step).
+	/// Is the world locked (in the middle of a time step, or stepping asynchronously).
 	bool IsLocked() const;
 
 	/// Set flag to control automatic clearing of forces after each time step.
@@ -179,6 +258,14 @@ private:
 	friend class b2Body;
 	friend class b2ContactManager;
 	friend class b2Controller;
+	friend class b2Contact;
+
+	static void StepTask(void* data);
+	void StoreBodyStates(int32 buffer);
+
+	// The time step of Step and StepAsync, and the force clearing it ends with.
+	void RunStep(float32 dt, int32 velocityIterations, int32 positionIterations);
+	void ClearBodyForces();
 
 	void Solve(const b2TimeStep& step);
 	void SolveTOI();
@@ -217,6 +304,20 @@ private:
 
 	// This is for debugging the solver.
 	bool m_continuousPhysics;
+
+	// Asynchronous stepping. m_stepping is only written by the calling thread.
+	b2Thread m_stepThread;
+	bool m_stepping;
+	float32 m_asyncTimeStep;
+	int32 m_asyncVelocityIterations;
+	int32 m_asyncPositionIterations;
+
+	// Double-buffered body states. The caller reads the front buffer while
+	// the worker writes the other one.
+	b2BodyState* m_states[2];
+	int32 m_stateCounts[2];
+	int32 m_stateCapacities[2];
+	int32 m_frontStates;
 };
 
 inline b2Body* b2World::GetBodyList()
@@ -234,6 +335,11 @@ inline b2Contact* b2World::GetContactList()
 	return m_contactManager.m_contactList;
 }
 
+inline b2BroadPhaseType b2World::GetBroadPhaseType() const
+{
+	return m_contactManager.m_broadPhase.GetType();
+}
+
 inline int32 b2World::GetBodyCount() const
 {
 	return m_bodyCount;
@@ -251,6 +357,7 @@ inline int32 b2World::GetContactCount() const
 
 inline void b2World::SetGravity(const b2Vec2& gravity)
 {
+	b2Assert(IsStepping() == false);
 	m_gravity = gravity;
 }
 
@@ -261,11 +368,28 @@ inline b2Vec2 b2World::GetGravity() const
 
 inline bool b2World::IsLocked() const
 {
-	return (m_flags & e_locked) == e_locked;
+	// Test m_stepping first so the flags are not read while the worker writes them.
+	return m_stepping || (m_flags & e_locked) == e_locked;
+}
+
+inline bool b2World::IsStepping() const
+{
+	return m_stepping;
+}
+
+inline const b2BodyState* b2World::GetBodyStates() const
+{
+	return m_states[m_frontStates];
+}
+
+inline int32 b2World::GetBodyStateCount() const
+{
+	return m_stateCounts[m_frontStates];
 }
 
 inline void b2World::SetAutoClearForces(bool flag)
 {
+	b2Assert(IsStepping() == false);
 	if (flag)
 	{
 		m_flags |= e_clearForces;
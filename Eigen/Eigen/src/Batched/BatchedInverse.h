@@ -0,0 +1,261 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_BATCHEDINVERSE_H
+#define EIGEN_BATCHEDINVERSE_H
+
+namespace internal {
+
+/* The inverses and determinants are computed on local arrays of packets holding the coefficients of a
+   group of matrices in column-major order. Up to 4x4, they use the cofactor formulas, like the
+   fixed-size MatrixBase::inverse(). Larger matrices use Gauss-Jordan elimination with partial pivoting,
+   where the row exchanges differ between the lanes and are performed by masked selects. */
+
+template<typename Packet, int Size>
+struct batched_inverse_impl
+{
+  static Packet run(Packet* a, Packet* inv, bool computeInverse)
+  {
+    typedef typename unpacket_traits<Packet>::type Scalar;
+    const Packet one = pset1<Packet>(Scalar(1));
+    const Packet zero = pset1<Packet>(Scalar(0));
+    if(computeInverse)
+      for(int j = 0; j < Size; ++j)
+        for(int i = 0; i < Size; ++i)
+          inv[i+j*Size] = i==j ? one : zero;
+
+    Packet det = one;
+    for(int k = 0; k < Size; ++k)
+    {
+      // bring the largest pivot of each lane to row k
+      for(int r = k+1; r < Size; ++r)
+      {
+        Packet swap = pcmp_lt(pabs(a[k+k*Size]), pabs(a[r+k*Size]));
+        for(int j = k; j < Size; ++j)
+        {
+          Packet t = a[k+j*Size];
+          a[k+j*Size] = pselect(swap, a[r+j*Size], t);
+          a[r+j*Size] = pselect(swap, t, a[r+j*Size]);
+        }
+        if(computeInverse)
+          for(int j = 0; j < Size; ++j)
+          {
+            Packet t = inv[k+j*Size];
+            inv[k+j*Size] = pselect(swap, inv[r+j*Size], t);
+            inv[r+j*Size] = pselect(swap, t, inv[r+j*Size]);
+          }
+        det = pselect(swap, pnegate(det), det);
+      }
+
+      Packet pivot = a[k+k*Size];
+      det = pmul(det, pivot);
+      if(!computeInverse)
+      {
+        // only the upper triangular factor is needed for the determinant
+        Packet ipivot = pdiv(one, pivot);
+        for(int r = k+1; r < Size; ++r)
+        {
+          Packet f = pmul(a[r+k*Size], ipivot);
+          for(int j = k+1; j < Size; ++j)
+            a[r+j*Size] = psub(a[r+j*Size], pmul(f, a[k+j*Size]));
+        }
+        continue;
+      }
+
+      Packet ipivot = pdiv(one, pivot);
+      for(int j = k+1; j < Size; ++j)
+        a[k+j*Size] = pmul(a[k+j*Size], ipivot);
+      for(int j = 0; j < Size; ++j)
+        inv[k+j*Size] = pmul(inv[k+j*Size], ipivot);
+      for(int r = 0; r < Size; ++r)
+      {
+        if(r == k) continue;
+        Packet f = a[r+k*Size];
+        for(int j = k+1; j < Size; ++j)
+          a[r+j*Size] = psub(a[r+j*Size], pmul(f, a[k+j*Size]));
+        for(int j = 0; j < Size; ++j)
+          inv[r+j*Size] = psub(inv[r+j*Size], pmul(f, inv[k+j*Size]));
+      }
+    }
+    return det;
+  }
+};
+
+template<typename Packet>
+struct batched_inverse_impl<Packet,1>
+{
+  static Packet run(Packet* a, Packet* inv, bool computeInverse)
+  {
+    typedef typename unpacket_traits<Packet>::type Scalar;
+    if(computeInverse)
+      inv[0] = pdiv(pset1<Packet>(Scalar(1)), a[0]);
+    return a[0];
+  }
+};
+
+template<typename Packet>
+struct batched_inverse_impl<Packet,2>
+{
+  static Packet run(Packet* a, Packet* inv, bool computeInverse)
+  {
+    typedef typename unpacket_traits<Packet>::type Scalar;
+    Packet det = psub(pmul(a[0], a[3]), pmul(a[2], a[1]));
+    if(computeInverse)
+    {
+      Packet idet = pdiv(pset1<Packet>(Scalar(1)), det);
+      inv[0] = pmul(a[3], idet);
+      inv[1] = pnegate(pmul(a[1], idet));
+      inv[2] = pnegate(pmul(a[2], idet));
+      inv[3] = pmul(a[0], idet);
+    }
+    return det;
+  }
+};
+
+template<typename Packet>
+struct batched_inverse_impl<Packet,3>
+{
+  static Packet run(Packet* a, Packet* inv, bool computeInverse)
+  {
+    typedef typename unpacket_traits<Packet>::type Scalar;
+    // cofactors of the first column
+    Packet c0 = psub(pmul(a[4], a[8]), pmul(a[7], a[5]));
+    Packet c1 = psub(pmul(a[7], a[2]), pmul(a[1], a[8]));
+    Packet c2 = psub(pmul(a[1], a[5]), pmul(a[4], a[2]));
+    Packet det = pmadd(a[0], c0, pmadd(a[3], c1, pmul(a[6], c2)));
+    if(computeInverse)
+    {
+      Packet idet = pdiv(pset1<Packet>(Scalar(1)), det);
+      inv[0] = pmul(c0, idet);
+      inv[1] = pmul(c1, idet);
+      inv[2] = pmul(c2, idet);
+      inv[3] = pmul(psub(pmul(a[6], a[5]), pmul(a[3], a[8])), idet);
+      inv[4] = pmul(psub(pmul(a[0], a[8]), pmul(a[6], a[2])), idet);
+      inv[5] = pmul(psub(pmul(a[3], a[2]), pmul(a[0], a[5])), idet);
+      inv[6] = pmul(psub(pmul(a[3], a[7]), pmul(a[6], a[4])), idet);
+      inv[7] = pmul(psub(pmul(a[6], a[1]), pmul(a[0], a[7])), idet);
+      inv[8] = pmul(psub(pmul(a[0], a[4]), pmul(a[3], a[1])), idet);
+    }
+    return det;
+  }
+};
+
+template<typename Packet>
+struct batched_inverse_impl<Packet,4>
+{
+  static Packet run(Packet* m, Packet* inv, bool computeInverse)
+  {
+    typedef typename unpacket_traits<Packet>::type Scalar;
+    #define EIGEN_BATCHED_A(i,j) m[(i)+(j)*4]
+    // 2x2 minors of the two first and the two last rows
+    Packet s0 = psub(pmul(EIGEN_BATCHED_A(0,0), EIGEN_BATCHED_A(1,1)), pmul(EIGEN_BATCHED_A(1,0), EIGEN_BATCHED_A(0,1)));
+    Packet s1 = psub(pmul(EIGEN_BATCHED_A(0,0), EIGEN_BATCHED_A(1,2)), pmul(EIGEN_BATCHED_A(1,0), EIGEN_BATCHED_A(0,2)));
+    Packet s2 = psub(pmul(EIGEN_BATCHED_A(0,0), EIGEN_BATCHED_A(1,3)), pmul(EIGEN_BATCHED_A(1,0), EIGEN_BATCHED_A(0,3)));
+    Packet s3 = psub(pmul(EIGEN_BATCHED_A(0,1), EIGEN_BATCHED_A(1,2)), pmul(EIGEN_BATCHED_A(1,1), EIGEN_BATCHED_A(0,2)));
+    Packet s4 = psub(pmul(EIGEN_BATCHED_A(0,1), EIGEN_BATCHED_A(1,3)), pmul(EIGEN_BATCHED_A(1,1), EIGEN_BATCHED_A(0,3)));
+    Packet s5 = psub(pmul(EIGEN_BATCHED_A(0,2), EIGEN_BATCHED_A(1,3)), pmul(EIGEN_BATCHED_A(1,2), EIGEN_BATCHED_A(0,3)));
+    Packet c5 = psub(pmul(EIGEN_BATCHED_A(2,2), EIGEN_BATCHED_A(3,3)), pmul(EIGEN_BATCHED_A(3,2), EIGEN_BATCHED_A(2,3)));
+    Packet c4 = psub(pmul(EIGEN_BATCHED_A(2,1), EIGEN_BATCHED_A(3,3)), pmul(EIGEN_BATCHED_A(3,1), EIGEN_BATCHED_A(2,3)));
+    Packet c3 = psub(pmul(EIGEN_BATCHED_A(2,1), EIGEN_BATCHED_A(3,2)), pmul(EIGEN_BATCHED_A(3,1), EIGEN_BATCHED_A(2,2)));
+    Packet c2 = psub(pmul(EIGEN_BATCHED_A(2,0), EIGEN_BATCHED_A(3,3)), pmul(EIGEN_BATCHED_A(3,0), EIGEN_BATCHED_A(2,3)));
+    Packet c1 = psub(pmul(EIGEN_BATCHED_A(2,0), EIGEN_BATCHED_A(3,2)), pmul(EIGEN_BATCHED_A(3,0), EIGEN_BATCHED_A(2,2)));
+    Packet c0 = psub(pmul(EIGEN_BATCHED_A(2,0), EIGEN_BATCHED_A(3,1)), pmul(EIGEN_BATCHED_A(3,0), EIGEN_BATCHED_A(2,1)));
+
+    Packet det = padd(psub(pmul(s0, c5), pmul(s1, c4)), padd(pmul(s2, c3), pmul(s3, c2)));
+    det = padd(det, psub(pmul(s5, c0), pmul(s4, c1)));
+    if(computeInverse)
+    {
+      Packet idet = pdiv(pset1<Packet>(Scalar(1)), det);
+      #define EIGEN_BATCHED_COF(i,j,a,x,b,y,c,z) \
+        inv[(i)+(j)*4] = pmul(padd(psub(pmul(a,x), pmul(b,y)), pmul(c,z)), idet)
+      EIGEN_BATCHED_COF(0,0, EIGEN_BATCHED_A(1,1),c5, EIGEN_BATCHED_A(1,2),c4, EIGEN_BATCHED_A(1,3),c3);
+      EIGEN_BATCHED_COF(0,1, EIGEN_BATCHED_A(0,2),c4, EIGEN_BATCHED_A(0,1),c5, pnegate(EIGEN_BATCHED_A(0,3)),c3);
+      EIGEN_BATCHED_COF(0,2, EIGEN_BATCHED_A(3,1),s5, EIGEN_BATCHED_A(3,2),s4, EIGEN_BATCHED_A(3,3),s3);
+      EIGEN_BATCHED_COF(0,3, EIGEN_BATCHED_A(2,2),s4, EIGEN_BATCHED_A(2,1),s5, pnegate(EIGEN_BATCHED_A(2,3)),s3);
+      EIGEN_BATCHED_COF(1,0, EIGEN_BATCHED_A(1,2),c2, EIGEN_BATCHED_A(1,0),c5, pnegate(EIGEN_BATCHED_A(1,3)),c1);
+      EIGEN_BATCHED_COF(1,1, EIGEN_BATCHED_A(0,0),c5, EIGEN_BATCHED_A(0,2),c2, EIGEN_BATCHED_A(0,3),c1);
+      EIGEN_BATCHED_COF(1,2, EIGEN_BATCHED_A(3,2),s2, EIGEN_BATCHED_A(3,0),s5, pnegate(EIGEN_BATCHED_A(3,3)),s1);
+      EIGEN_BATCHED_COF(1,3, EIGEN_BATCHED_A(2,0),s5, EIGEN_BATCHED_A(2,2),s2, EIGEN_BATCHED_A(2,3),s1);
+      EIGEN_BATCHED_COF(2,0, EIGEN_BATCHED_A(1,0),c4, EIGEN_BATCHED_A(1,1),c2, EIGEN_BATCHED_A(1,3),c0);
+      EIGEN_BATCHED_COF(2,1, EIGEN_BATCHED_A(0,1),c2, EIGEN_BATCHED_A(0,0),c4, pnegate(EIGEN_BATCHED_A(0,3)),c0);
+      EIGEN_BATCHED_COF(2,2, EIGEN_BATCHED_A(3,0),s4, EIGEN_BATCHED_A(3,1),s2, EIGEN_BATCHED_A(3,3),s0);
+      EIGEN_BATCHED_COF(2,3, EIGEN_BATCHED_A(2,1),s2, EIGEN_BATCHED_A(2,0),s4, pnegate(EIGEN_BATCHED_A(2,3)),s0);
+      EIGEN_BATCHED_COF(3,0, EIGEN_BATCHED_A(1,1),c1, EIGEN_BATCHED_A(1,0),c3, pnegate(EIGEN_BATCHED_A(1,2)),c0);
+      EIGEN_BATCHED_COF(3,1, EIGEN_BATCHED_A(0,0),c3, EIGEN_BATCHED_A(0,1),c1, EIGEN_BATCHED_A(0,2),c0);
+      EIGEN_BATCHED_COF(3,2, EIGEN_BATCHED_A(3,1),s1, EIGEN_BATCHED_A(3,0),s3, pnegate(EIGEN_BATCHED_A(3,2)),s0);
+      EIGEN_BATCHED_COF(3,3, EIGEN_BATCHED_A(2,0),s3, EIGEN_BATCHED_A(2,1),s1, EIGEN_BATCHED_A(2,2),s0);
+      #undef EIGEN_BATCHED_COF
+    }
+    #undef EIGEN_BATCHED_A
+    return det;
+  }
+};
+
+} // end namespace internal
+
+/** Computes the inverses of all the matrices of \c *this and stores them in \a result, which is resized
+  * if needed and may be \c *this itself. The matrices must be square.
+  *
+  * No check is made for singular matrices, whose inverses have infinite or NaN coefficients;
+  * use determinants() to detect them.
+  */
+template<typename _Scalar, int _Rows, int _Cols>
+void BatchedMatrix<_Scalar,_Rows,_Cols>::computeInverse(BatchedMatrix& result) const
+{
+  EIGEN_STATIC_ASSERT(_Rows==_Cols, THIS_METHOD_IS_ONLY_FOR_MATRICES_OF_A_SPECIFIC_SIZE)
+  if(result.size() != m_size)
+    result.resize(m_size);
+  Packet a[Rows*Cols];
+  Packet inv[Rows*Cols];
+  for(Index g = 0; g < m_groups; ++g)
+  {
+    for(Index j = 0; j < Cols; ++j)
+      for(Index i = 0; i < Rows; ++i)
+        a[i+j*Rows] = packet(g,i,j);
+    internal::batched_inverse_impl<Packet,Rows>::run(a, inv, true);
+    for(Index j = 0; j < Cols; ++j)
+      for(Index i = 0; i < Rows; ++i)
+        result.writePacket(g, i, j, inv[i+j*Rows]);
+  }
+}
+
+/** \returns the vector of the determinants of all the matrices of \c *this, which must be square. */
+template<typename _Scalar, int _Rows, int _Cols>
+Matrix<_Scalar,Dynamic,1> BatchedMatrix<_Scalar,_Rows,_Cols>::determinants() const
+{
+  EIGEN_STATIC_ASSERT(_Rows==_Cols, THIS_METHOD_IS_ONLY_FOR_MATRICES_OF_A_SPECIFIC_SIZE)
+  Matrix<Scalar,Dynamic,1> dets(m_size);
+  Packet a[Rows*Cols];
+  EIGEN_ALIGN16 Scalar lanes[PacketSize];
+  for(Index g = 0; g < m_groups; ++g)
+  {
+    for(Index j = 0; j < Cols; ++j)
+      for(Index i = 0; i < Rows; ++i)
+        a[i+j*Rows] = packet(g,i,j);
+    internal::pstore(lanes, internal::batched_inverse_impl<Packet,Rows>::run(a, 0, false));
+    for(Index l = 0; l < PacketSize && g*PacketSize+l < m_size; ++l)
+      dets.coeffRef(g*PacketSize+l) = lanes[l];
+  }
+  return dets;
+}
+
+#endif // EIGEN_BATCHEDINVERSE_H
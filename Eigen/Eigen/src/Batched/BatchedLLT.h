@@ -0,0 +1,194 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_BATCHEDLLT_H
+#define EIGEN_BATCHEDLLT_H
+
+/** \ingroup Batched_Module
+  * \brief Standard Cholesky decompositions of a set of selfadjoint positive definite matrices
+  *
+  * This class performs the LL^T Cholesky decompositions of all the matrices A of a BatchedMatrix,
+  * reading their lower triangular parts, and solves the systems A x = b for sets of right hand sides.
+  * Like LLT, no pivoting is performed. The inverses of the diagonal coefficients of the factors are
+  * stored to save the divisions of the solves.
+  *
+  * \tparam _BatchedMatrixType the type of the set of matrices, a square BatchedMatrix
+  *
+  * \sa class LLT, class BatchedMatrix
+  */
+template<typename _BatchedMatrixType> class BatchedLLT
+{
+  public:
+    typedef _BatchedMatrixType BatchedMatrixType;
+    typedef typename BatchedMatrixType::Scalar Scalar;
+    typedef typename BatchedMatrixType::Packet Packet;
+    typedef typename BatchedMatrixType::Index Index;
+    enum {
+      Size = BatchedMatrixType::Rows,
+      PacketSize = BatchedMatrixType::PacketSize
+    };
+    typedef Matrix<Scalar,Size,Size> MatrixType;
+
+    BatchedLLT() : m_isInitialized(false), m_info(Success) {}
+
+    BatchedLLT(const BatchedMatrixType& matrices) : m_isInitialized(false), m_info(Success)
+    {
+      compute(matrices);
+    }
+
+    BatchedLLT& compute(const BatchedMatrixType& matrices);
+
+    /** Solves the systems A[k] x[k] = b[k] for all the matrices, \a x may be the same object as \a b.
+      *
+      * \sa compute()
+      */
+    template<int RhsCols>
+    void solve(const BatchedMatrix<Scalar,Size,RhsCols>& b, BatchedMatrix<Scalar,Size,RhsCols>& x) const;
+
+    /** \returns the lower triangular factor L of the matrix \a k */
+    MatrixType matrixL(Index k) const
+    {
+      eigen_assert(m_isInitialized && "BatchedLLT is not initialized.");
+      MatrixType l = m_matrix.matrix(k).template triangularView<Lower>();
+      l.diagonal() = l.diagonal().cwiseInverse();
+      return l;
+    }
+
+    /** \returns the factors L stored in the lower triangular parts of a set of matrices, the diagonal
+      * coefficients being replaced by their inverses. */
+    const BatchedMatrixType& matrixLLT() const
+    {
+      eigen_assert(m_isInitialized && "BatchedLLT is not initialized.");
+      return m_matrix;
+    }
+
+    /** \brief Reports whether previous computation was successful.
+      *
+      * \returns \c Success if all the matrices were positive definite, and \c NumericalIssue otherwise.
+      */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_isInitialized && "BatchedLLT is not initialized.");
+      return m_info;
+    }
+
+    /** \returns the number of matrices */
+    Index size() const { return m_matrix.size(); }
+
+  protected:
+    BatchedMatrixType m_matrix;
+    bool m_isInitialized;
+    ComputationInfo m_info;
+};
+
+/** Computes the Cholesky decompositions of all the matrices of \a matrices
+  *
+  * \returns a reference to *this
+  */
+template<typename BatchedMatrixType>
+BatchedLLT<BatchedMatrixType>& BatchedLLT<BatchedMatrixType>::compute(const BatchedMatrixType& matrices)
+{
+  EIGEN_STATIC_ASSERT(int(BatchedMatrixType::Rows)==int(BatchedMatrixType::Cols), THIS_METHOD_IS_ONLY_FOR_MATRICES_OF_A_SPECIFIC_SIZE)
+  using namespace internal;
+  if(m_matrix.size() != matrices.size())
+    m_matrix.resize(matrices.size());
+
+  const Packet zero = pset1<Packet>(Scalar(0));
+  const Packet one = pset1<Packet>(Scalar(1));
+  Packet l[Size*Size];
+  EIGEN_ALIGN16 Scalar lanes[PacketSize];
+  m_info = Success;
+  for(Index g = 0; g < matrices.groups(); ++g)
+  {
+    // the smallest pivot of each lane, non positive and NaN pivots counting as zero
+    Packet minPivot = one;
+    for(Index j = 0; j < Size; ++j)
+    {
+      Packet d = matrices.packet(g,j,j);
+      for(Index k = 0; k < j; ++k)
+        d = psub(d, pmul(l[j+k*Size], l[j+k*Size]));
+      minPivot = pmin(minPivot, pselect(pcmp_lt(zero, d), d, zero));
+      Packet inv = pdiv(one, psqrt(d));
+      l[j+j*Size] = inv;
+      for(Index i = j+1; i < Size; ++i)
+      {
+        Packet s = matrices.packet(g,i,j);
+        for(Index k = 0; k < j; ++k)
+          s = psub(s, pmul(l[i+k*Size], l[j+k*Size]));
+        l[i+j*Size] = pmul(s, inv);
+      }
+    }
+    for(Index j = 0; j < Size; ++j)
+      for(Index i = j; i < Size; ++i)
+        m_matrix.writePacket(g, i, j, l[i+j*Size]);
+
+    pstore(lanes, minPivot);
+    for(Index k = 0; k < PacketSize && g*PacketSize+k < matrices.size(); ++k)
+      if(!(lanes[k] > Scalar(0)))
+        m_info = NumericalIssue;
+  }
+  m_isInitialized = true;
+  return *this;
+}
+
+template<typename BatchedMatrixType>
+template<int RhsCols>
+void BatchedLLT<BatchedMatrixType>::solve(const BatchedMatrix<Scalar,Size,RhsCols>& b, BatchedMatrix<Scalar,Size,RhsCols>& x) const
+{
+  eigen_assert(m_isInitialized && "BatchedLLT is not initialized.");
+  eigen_assert(b.size() == m_matrix.size() && "BatchedLLT::solve(): invalid number of right hand sides");
+  using namespace internal;
+  if(x.size() != b.size())
+    x.resize(b.size());
+
+  Packet l[Size*Size];
+  Packet y[Size];
+  for(Index g = 0; g < m_matrix.groups(); ++g)
+  {
+    for(Index j = 0; j < Size; ++j)
+      for(Index i = j; i < Size; ++i)
+        l[i+j*Size] = m_matrix.packet(g,i,j);
+    for(Index c = 0; c < RhsCols; ++c)
+    {
+      // L y = b
+      for(Index i = 0; i < Size; ++i)
+      {
+        Packet s = b.packet(g,i,c);
+        for(Index k = 0; k < i; ++k)
+          s = psub(s, pmul(l[i+k*Size], y[k]));
+        y[i] = pmul(s, l[i+i*Size]);
+      }
+      // L^T x = y
+      for(Index i = Size-1; i >= 0; --i)
+      {
+        Packet s = y[i];
+        for(Index k = i+1; k < Size; ++k)
+          s = psub(s, pmul(l[k+i*Size], y[k]));
+        y[i] = pmul(s, l[i+i*Size]);
+      }
+      for(Index i = 0; i < Size; ++i)
+        x.writePacket(g, i, c, y[i]);
+    }
+  }
+}
+
+#endif // EIGEN_BATCHEDLLT_H
@@ -0,0 +1,205 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_BATCHEDMATRIX_H
+#define EIGEN_BATCHEDMATRIX_H
+
+/** \ingroup Batched_Module
+  * \brief A set of fixed-size matrices stored in lane-interleaved order
+  *
+  * The matrices are stored by groups of \c PacketSize matrices, the size of a packet of \c Scalar.
+  * Within a group, the \c PacketSize values of a given coefficient are contiguous, and the
+  * coefficients follow in column-major order:
+  * \code
+  * data[((g * Rows*Cols) + i + j*Rows) * PacketSize + l] == matrix(g*PacketSize + l)(i,j)
+  * \endcode
+  * so that packet(g,i,j) loads the coefficient (i,j) of all the matrices of the group g at once.
+  * The last group is padded with identity (or zero for non square types) matrices.
+  *
+  * \tparam _Scalar the type of the coefficients
+  * \tparam _Rows the number of rows of each matrix
+  * \tparam _Cols the number of columns of each matrix
+  *
+  * \sa batchedProduct(), class BatchedLLT, class BatchedQuaternion
+  */
+template<typename _Scalar, int _Rows, int _Cols>
+class BatchedMatrix
+{
+  public:
+    typedef _Scalar Scalar;
+    typedef DenseIndex Index;
+    typedef typename internal::packet_traits<Scalar>::type Packet;
+    typedef Matrix<Scalar,_Rows,_Cols> MatrixType;
+    enum {
+      Rows = _Rows,
+      Cols = _Cols,
+      PacketSize = internal::packet_traits<Scalar>::size,
+      GroupSize = _Rows * _Cols * PacketSize
+    };
+
+    BatchedMatrix() : m_data(0), m_size(0), m_groups(0)
+    {
+      EIGEN_STATIC_ASSERT(_Rows>0 && _Cols>0, THIS_METHOD_IS_ONLY_FOR_MATRICES_OF_A_SPECIFIC_SIZE)
+    }
+
+    /** Constructs a set of \a size matrices, initialized to the identity. */
+    explicit BatchedMatrix(Index size) : m_data(0), m_size(0), m_groups(0)
+    {
+      EIGEN_STATIC_ASSERT(_Rows>0 && _Cols>0, THIS_METHOD_IS_ONLY_FOR_MATRICES_OF_A_SPECIFIC_SIZE)
+      resize(size);
+    }
+
+    BatchedMatrix(const BatchedMatrix& other) : m_data(0), m_size(0), m_groups(0)
+    {
+      *this = other;
+    }
+
+    ~BatchedMatrix()
+    {
+      internal::aligned_delete(m_data, m_groups * GroupSize);
+    }
+
+    BatchedMatrix& operator=(const BatchedMatrix& other)
+    {
+      if(this != &other)
+      {
+        resize(other.size());
+        std::copy(other.m_data, other.m_data + m_groups * GroupSize, m_data);
+      }
+      return *this;
+    }
+
+    /** Resizes to \a size matrices. The previous coefficients are lost, and the matrices are set to the identity. */
+    void resize(Index size)
+    {
+      eigen_assert(size >= 0);
+      Index groups = (size + PacketSize - 1) / PacketSize;
+      if(groups != m_groups)
+      {
+        internal::aligned_delete(m_data, m_groups * GroupSize);
+        m_data = groups ? internal::aligned_new<Scalar>(groups * GroupSize) : 0;
+        m_groups = groups;
+      }
+      m_size = size;
+      setIdentity();
+    }
+
+    /** \returns the number of matrices */
+    inline Index size() const { return m_size; }
+    /** \returns the number of groups of \c PacketSize matrices, including the padded last one */
+    inline Index groups() const { return m_groups; }
+
+    inline Index rows() const { return Rows; }
+    inline Index cols() const { return Cols; }
+
+    /** \returns a pointer to the interleaved coefficients */
+    inline Scalar* data() { return m_data; }
+    inline const Scalar* data() const { return m_data; }
+
+    /** \returns the coefficient (\a i,\a j) of the matrix \a k */
+    inline Scalar coeff(Index k, Index i, Index j) const
+    {
+      eigen_internal_assert(k >= 0 && k < m_size && i >= 0 && i < Rows && j >= 0 && j < Cols);
+      return m_data[index(k / PacketSize, i, j) + k % PacketSize];
+    }
+
+    /** \returns a reference to the coefficient (\a i,\a j) of the matrix \a k */
+    inline Scalar& coeffRef(Index k, Index i, Index j)
+    {
+      eigen_internal_assert(k >= 0 && k < m_size && i >= 0 && i < Rows && j >= 0 && j < Cols);
+      return m_data[index(k / PacketSize, i, j) + k % PacketSize];
+    }
+
+    /** \returns the coefficient (\a i,\a j) of all the matrices of the group \a g */
+    inline Packet packet(Index g, Index i, Index j) const
+    {
+      return internal::pload<Packet>(m_data + index(g, i, j));
+    }
+
+    /** Stores \a p as the coefficient (\a i,\a j) of all the matrices of the group \a g */
+    inline void writePacket(Index g, Index i, Index j, const Packet& p)
+    {
+      internal::pstore(m_data + index(g, i, j), p);
+    }
+
+    /** \returns a copy of the matrix \a k */
+    MatrixType matrix(Index k) const
+    {
+      MatrixType m;
+      for(Index j = 0; j < Cols; ++j)
+        for(Index i = 0; i < Rows; ++i)
+          m.coeffRef(i,j) = coeff(k,i,j);
+      return m;
+    }
+
+    /** Sets the matrix \a k to \a m */
+    template<typename Derived>
+    void setMatrix(Index k, const MatrixBase<Derived>& m)
+    {
+      eigen_assert(m.rows() == Rows && m.cols() == Cols);
+      for(Index j = 0; j < Cols; ++j)
+        for(Index i = 0; i < Rows; ++i)
+          coeffRef(k,i,j) = m.coeff(i,j);
+    }
+
+    /** Sets all the matrices, including the padding ones, to the identity (or zero for non square matrices). */
+    void setIdentity()
+    {
+      const Packet zero = internal::pset1<Packet>(Scalar(0));
+      const Packet one = internal::pset1<Packet>(Scalar(1));
+      for(Index g = 0; g < m_groups; ++g)
+        for(Index j = 0; j < Cols; ++j)
+          for(Index i = 0; i < Rows; ++i)
+            writePacket(g, i, j, (i == j && Rows == Cols) ? one : zero);
+    }
+
+    /** Sets all the coefficients to zero. The padding matrices are kept to the identity. */
+    void setZero()
+    {
+      setIdentity();
+      for(Index k = 0; k < m_size; ++k)
+        for(Index i = 0; i < (std::min)(Index(Rows), Index(Cols)); ++i)
+          coeffRef(k,i,i) = Scalar(0);
+    }
+
+    void computeInverse(BatchedMatrix& result) const;
+    Matrix<Scalar,Dynamic,1> determinants() const;
+
+    void swap(BatchedMatrix& other)
+    {
+      std::swap(m_data, other.m_data);
+      std::swap(m_size, other.m_size);
+      std::swap(m_groups, other.m_groups);
+    }
+
+  protected:
+    static inline Index index(Index g, Index i, Index j)
+    {
+      return (g * (Rows*Cols) + i + j*Rows) * PacketSize;
+    }
+
+    Scalar* m_data;
+    Index m_size;
+    Index m_groups;
+};
+
+#endif // EIGEN_BATCHEDMATRIX_H
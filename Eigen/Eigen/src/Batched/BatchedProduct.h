@@ -0,0 +1,80 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_BATCHEDPRODUCT_H
+#define EIGEN_BATCHEDPRODUCT_H
+
+namespace internal {
+
+template<typename Scalar, int Rows, int Depth, int Cols>
+struct batched_product_impl
+{
+  typedef typename packet_traits<Scalar>::type Packet;
+  typedef DenseIndex Index;
+
+  static void run(const BatchedMatrix<Scalar,Rows,Depth>& lhs, const BatchedMatrix<Scalar,Depth,Cols>& rhs,
+                  BatchedMatrix<Scalar,Rows,Cols>& dst)
+  {
+    Packet a[Rows*Depth];
+    Packet b[Depth*Cols];
+    for(Index g = 0; g < lhs.groups(); ++g)
+    {
+      // load both operands first, so that dst may alias one of them
+      for(Index k = 0; k < Depth; ++k)
+        for(Index i = 0; i < Rows; ++i)
+          a[i+k*Rows] = lhs.packet(g,i,k);
+      for(Index j = 0; j < Cols; ++j)
+        for(Index k = 0; k < Depth; ++k)
+          b[k+j*Depth] = rhs.packet(g,k,j);
+
+      for(Index j = 0; j < Cols; ++j)
+        for(Index i = 0; i < Rows; ++i)
+        {
+          Packet acc = pmul(a[i], b[j*Depth]);
+          for(Index k = 1; k < Depth; ++k)
+            acc = pmadd(a[i+k*Rows], b[k+j*Depth], acc);
+          dst.writePacket(g, i, j, acc);
+        }
+    }
+  }
+};
+
+} // end namespace internal
+
+/** \ingroup Batched_Module
+  *
+  * Computes the products \a dst[k] = \a lhs[k] * \a rhs[k] of all the matrices of two sets of the same size.
+  * \a dst is resized if needed, and may be the same object as \a lhs or \a rhs.
+  *
+  * \sa class BatchedMatrix
+  */
+template<typename Scalar, int Rows, int Depth, int Cols>
+void batchedProduct(const BatchedMatrix<Scalar,Rows,Depth>& lhs, const BatchedMatrix<Scalar,Depth,Cols>& rhs,
+                    BatchedMatrix<Scalar,Rows,Cols>& dst)
+{
+  eigen_assert(lhs.size() == rhs.size() && "batchedProduct: the two sets must have the same number of matrices");
+  if(dst.size() != lhs.size())
+    dst.resize(lhs.size());
+  internal::batched_product_impl<Scalar,Rows,Depth,Cols>::run(lhs, rhs, dst);
+}
+
+#endif // EIGEN_BATCHEDPRODUCT_H
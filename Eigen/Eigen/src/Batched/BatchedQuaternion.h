@@ -0,0 +1,178 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_BATCHEDQUATERNION_H
+#define EIGEN_BATCHEDQUATERNION_H
+
+/** \ingroup Batched_Module
+  * \brief A set of quaternions stored in lane-interleaved order
+  *
+  * The quaternions are stored as a BatchedMatrix of 4-vectors with the same coefficient order as
+  * Quaternion::coeffs(), that is (x, y, z, w).
+  *
+  * \sa class Quaternion, class BatchedMatrix
+  */
+template<typename _Scalar>
+class BatchedQuaternion : public BatchedMatrix<_Scalar,4,1>
+{
+    typedef BatchedMatrix<_Scalar,4,1> Base;
+  public:
+    typedef typename Base::Scalar Scalar;
+    typedef typename Base::Packet Packet;
+    typedef typename Base::Index Index;
+    typedef Quaternion<Scalar> QuaternionType;
+    typedef BatchedMatrix<Scalar,3,1> VectorSet;
+    typedef BatchedMatrix<Scalar,3,3> RotationMatrixSet;
+
+    BatchedQuaternion() {}
+
+    /** Constructs a set of \a size identity quaternions */
+    explicit BatchedQuaternion(Index size) { resize(size); }
+
+    /** Resizes to \a size quaternions, all set to the identity */
+    void resize(Index size)
+    {
+      Base::resize(size);
+      setIdentity();
+    }
+
+    /** Sets all the quaternions, including the padding ones, to the identity */
+    void setIdentity()
+    {
+      Base::setIdentity();
+      for(Index g = 0; g < this->groups(); ++g)
+        this->writePacket(g, 3, 0, internal::pset1<Packet>(Scalar(1)));
+    }
+
+    /** \returns a copy of the quaternion \a k */
+    QuaternionType quaternion(Index k) const
+    {
+      return QuaternionType(this->coeff(k,3,0), this->coeff(k,0,0), this->coeff(k,1,0), this->coeff(k,2,0));
+    }
+
+    /** Sets the quaternion \a k to \a q */
+    void setQuaternion(Index k, const QuaternionType& q)
+    {
+      this->setMatrix(k, q.coeffs());
+    }
+
+    /** Normalizes all the quaternions */
+    void normalize()
+    {
+      using namespace internal;
+      for(Index g = 0; g < this->groups(); ++g)
+      {
+        Packet q[4];
+        for(Index i = 0; i < 4; ++i)
+          q[i] = this->packet(g,i,0);
+        Packet n2 = pmadd(q[0],q[0], pmadd(q[1],q[1], pmadd(q[2],q[2], pmul(q[3],q[3]))));
+        Packet inv = pdiv(pset1<Packet>(Scalar(1)), psqrt(n2));
+        for(Index i = 0; i < 4; ++i)
+          this->writePacket(g, i, 0, pmul(q[i], inv));
+      }
+    }
+
+    /** Computes the rotation matrices of all the quaternions, assumed to be normalized
+      *
+      * \sa QuaternionBase::toRotationMatrix()
+      */
+    void toRotationMatrix(RotationMatrixSet& result) const
+    {
+      using namespace internal;
+      if(result.size() != this->size())
+        result.resize(this->size());
+      const Packet one = pset1<Packet>(Scalar(1));
+      for(Index g = 0; g < this->groups(); ++g)
+      {
+        const Packet x = this->packet(g,0,0), y = this->packet(g,1,0), z = this->packet(g,2,0), w = this->packet(g,3,0);
+        const Packet tx = padd(x,x), ty = padd(y,y), tz = padd(z,z);
+        const Packet twx = pmul(tx,w), twy = pmul(ty,w), twz = pmul(tz,w);
+        const Packet txx = pmul(tx,x), txy = pmul(ty,x), txz = pmul(tz,x);
+        const Packet tyy = pmul(ty,y), tyz = pmul(tz,y), tzz = pmul(tz,z);
+
+        result.writePacket(g,0,0, psub(one, padd(tyy,tzz)));
+        result.writePacket(g,0,1, psub(txy,twz));
+        result.writePacket(g,0,2, padd(txz,twy));
+        result.writePacket(g,1,0, padd(txy,twz));
+        result.writePacket(g,1,1, psub(one, padd(txx,tzz)));
+        result.writePacket(g,1,2, psub(tyz,twx));
+        result.writePacket(g,2,0, psub(txz,twy));
+        result.writePacket(g,2,1, padd(tyz,twx));
+        result.writePacket(g,2,2, psub(one, padd(txx,tyy)));
+      }
+    }
+
+    /** Rotates the vectors \a v by the quaternions, assumed to be normalized, and stores the
+      * results in \a result, which may be the same object as \a v.
+      *
+      * \sa QuaternionBase::_transformVector()
+      */
+    void transformVectors(const VectorSet& v, VectorSet& result) const
+    {
+      using namespace internal;
+      eigen_assert(v.size() == this->size() && "BatchedQuaternion::transformVectors(): invalid number of vectors");
+      if(result.size() != v.size())
+        result.resize(v.size());
+      for(Index g = 0; g < this->groups(); ++g)
+      {
+        const Packet x = this->packet(g,0,0), y = this->packet(g,1,0), z = this->packet(g,2,0), w = this->packet(g,3,0);
+        const Packet v0 = v.packet(g,0,0), v1 = v.packet(g,1,0), v2 = v.packet(g,2,0);
+        // t = 2 * (u x v), v' = v + w * t + u x t
+        Packet t0 = psub(pmul(y,v2), pmul(z,v1));
+        Packet t1 = psub(pmul(z,v0), pmul(x,v2));
+        Packet t2 = psub(pmul(x,v1), pmul(y,v0));
+        t0 = padd(t0,t0); t1 = padd(t1,t1); t2 = padd(t2,t2);
+        result.writePacket(g,0,0, padd(pmadd(w,t0,v0), psub(pmul(y,t2), pmul(z,t1))));
+        result.writePacket(g,1,0, padd(pmadd(w,t1,v1), psub(pmul(z,t0), pmul(x,t2))));
+        result.writePacket(g,2,0, padd(pmadd(w,t2,v2), psub(pmul(x,t1), pmul(y,t0))));
+      }
+    }
+};
+
+/** \ingroup Batched_Module
+  *
+  * Computes the quaternion products \a lhs[k] * \a rhs[k] of two sets of quaternions and stores them
+  * in \a dst, which may be the same object as one of the operands.
+  *
+  * \sa QuaternionBase::operator*()
+  */
+template<typename Scalar>
+void batchedProduct(const BatchedQuaternion<Scalar>& lhs, const BatchedQuaternion<Scalar>& rhs, BatchedQuaternion<Scalar>& dst)
+{
+  using namespace internal;
+  typedef typename BatchedQuaternion<Scalar>::Packet Packet;
+  typedef typename BatchedQuaternion<Scalar>::Index Index;
+  eigen_assert(lhs.size() == rhs.size() && "batchedProduct(): the sets of quaternions have different sizes");
+  if(dst.size() != lhs.size())
+    dst.resize(lhs.size());
+  for(Index g = 0; g < lhs.groups(); ++g)
+  {
+    const Packet ax = lhs.packet(g,0,0), ay = lhs.packet(g,1,0), az = lhs.packet(g,2,0), aw = lhs.packet(g,3,0);
+    const Packet bx = rhs.packet(g,0,0), by = rhs.packet(g,1,0), bz = rhs.packet(g,2,0), bw = rhs.packet(g,3,0);
+    dst.writePacket(g,0,0, psub(pmadd(aw,bx, pmadd(ax,bw, pmul(ay,bz))), pmul(az,by)));
+    dst.writePacket(g,1,0, psub(pmadd(aw,by, pmadd(ay,bw, pmul(az,bx))), pmul(ax,bz)));
+    dst.writePacket(g,2,0, psub(pmadd(aw,bz, pmadd(az,bw, pmul(ax,by))), pmul(ay,bx)));
+    dst.writePacket(g,3,0, psub(psub(psub(pmul(aw,bw), pmul(ax,bx)), pmul(ay,by)), pmul(az,bz)));
+  }
+}
+
+#endif // EIGEN_BATCHEDQUATERNION_H
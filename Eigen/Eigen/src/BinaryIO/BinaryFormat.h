@@ -0,0 +1,179 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_BINARYFORMAT_H
+#define EIGEN_BINARYFORMAT_H
+
+namespace internal {
+
+/** \internal \returns the code of a scalar type in the binary files, or 0 if it cannot be stored */
+template<typename Scalar> struct binary_scalar_type { enum { value = 0 }; };
+template<> struct binary_scalar_type<float> { enum { value = 1 }; };
+template<> struct binary_scalar_type<double> { enum { value = 2 }; };
+template<> struct binary_scalar_type<std::complex<float> > { enum { value = 3 }; };
+template<> struct binary_scalar_type<std::complex<double> > { enum { value = 4 }; };
+template<> struct binary_scalar_type<int> { enum { value = 5 }; };
+template<> struct binary_scalar_type<long double> { enum { value = 6 }; };
+
+enum {
+  BinaryFormatVersion = 1,
+  // alignment in bytes of the data arrays in the file, and thus in the memory mapping of the file
+  BinaryAlignment = 64,
+  // the bits of binary_header::flags
+  BinaryRowMajorBit = 0x1,
+  BinarySparseBit = 0x2,
+  BinaryArrayBit = 0x4
+};
+
+/** \internal
+  * The 64 bytes header of the binary files. It is followed by the data arrays, each of them starting at a
+  * multiple of BinaryAlignment bytes, padded with zeros:
+  *  - for a dense object, the rows*cols coefficients in the storage order given by the flags,
+  *  - for a sparse matrix, the outerSize+1 outer indices, the nonZeros inner indices and the nonZeros values
+  *    of its compressed storage, the indices taking indexSize bytes.
+  * All the values are stored in the native byte order, which is recorded by byteOrder.
+  */
+struct binary_header
+{
+  char magic[8];          // "EIGENBIN"
+  uint32_t byteOrder;     // 0x01020304 written in the native byte order
+  uint32_t version;
+  uint32_t scalarType;    // binary_scalar_type<Scalar>::value
+  uint32_t scalarSize;    // sizeof(Scalar)
+  uint32_t flags;
+  uint32_t alignment;
+  uint64_t rows;
+  uint64_t cols;
+  uint64_t nonZeros;      // for sparse matrices only
+  uint32_t indexSize;     // for sparse matrices only
+  uint32_t reserved;
+
+  void init(uint32_t _scalarType, uint32_t _scalarSize, uint32_t _flags, uint64_t _rows, uint64_t _cols,
+            uint64_t _nonZeros = 0, uint32_t _indexSize = 0)
+  {
+    std::memcpy(magic, "EIGENBIN", 8);
+    byteOrder = 0x01020304;
+    version = BinaryFormatVersion;
+    scalarType = _scalarType;
+    scalarSize = _scalarSize;
+    flags = _flags;
+    alignment = BinaryAlignment;
+    rows = _rows;
+    cols = _cols;
+    nonZeros = _nonZeros;
+    indexSize = _indexSize;
+    reserved = 0;
+  }
+
+  /** \internal \returns true if this is the header of a file written by this version on a machine of the same byte
+    * order, and whose sizes and offsets below do not overflow */
+  bool isValid() const
+  {
+    return std::memcmp(magic, "EIGENBIN", 8)==0 && byteOrder==0x01020304 && version==BinaryFormatVersion
+        && alignment==BinaryAlignment && (!(flags&BinarySparseBit) || indexSize==4 || indexSize==8)
+        && scalarSize!=0 && hasValidSizes();
+  }
+
+  template<typename Scalar> bool hasScalarType() const
+  {
+    return scalarType==uint32_t(binary_scalar_type<Scalar>::value) && scalarSize==sizeof(Scalar);
+  }
+
+  bool isRowMajor() const { return (flags&BinaryRowMajorBit)!=0; }
+  bool isSparse() const { return (flags&BinarySparseBit)!=0; }
+  uint64_t outerSize() const { return isRowMajor() ? rows : cols; }
+
+  static uint64_t align(uint64_t offset) { return (offset + BinaryAlignment - 1) / BinaryAlignment * BinaryAlignment; }
+
+  // offsets in bytes of the data arrays from the beginning of the file
+  uint64_t outerIndexOffset() const { return align(sizeof(binary_header)); }
+  uint64_t innerIndexOffset() const { return align(outerIndexOffset() + (outerSize()+1)*indexSize); }
+  uint64_t valueOffset() const
+  {
+    return isSparse() ? align(innerIndexOffset() + nonZeros*indexSize) : align(sizeof(binary_header));
+  }
+  uint64_t valueCount() const { return isSparse() ? nonZeros : rows*cols; }
+  uint64_t fileSize() const { return valueOffset() + valueCount()*scalarSize; }
+
+  private:
+    static bool mulFits(uint64_t a, uint64_t b) { return a==0 || b <= ~uint64_t(0) / a; }
+    // align(a+b) does not overflow
+    static bool addFits(uint64_t a, uint64_t b) { return b <= ~uint64_t(0) - (BinaryAlignment-1) - a; }
+
+    // the computations of the offsets and of fileSize() do not overflow, checked in the order they are done
+    bool hasValidSizes() const
+    {
+      if(!mulFits(rows, cols))
+        return false;
+      uint64_t offset = sizeof(binary_header);
+      if(isSparse())
+      {
+        if(nonZeros > rows*cols || outerSize()==~uint64_t(0) || !mulFits(outerSize()+1, indexSize) || !addFits(outerIndexOffset(), (outerSize()+1)*indexSize))
+          return false;
+        offset = innerIndexOffset();
+        if(!mulFits(nonZeros, indexSize) || !addFits(offset, nonZeros*indexSize))
+          return false;
+        offset = valueOffset();
+      }
+      return mulFits(valueCount(), scalarSize) && addFits(offset, valueCount()*scalarSize);
+    }
+};
+
+/** \internal writes \a size bytes to \a file, followed by zeros up to the next multiple of BinaryAlignment of \a offset,
+  * which is updated */
+inline bool binary_write(std::FILE* file, const void* data, size_t size, uint64_t& offset)
+{
+  static const char zeros[BinaryAlignment] = { 0 };
+  if(size && std::fwrite(data, 1, size, file)!=size)
+    return false;
+  offset += size;
+  size_t padding = size_t(binary_header::align(offset) - offset);
+  if(padding && std::fwrite(zeros, 1, padding, file)!=padding)
+    return false;
+  offset += padding;
+  return true;
+}
+
+/** \internal reads \a size bytes from \a file, and skips the padding up to the next multiple of BinaryAlignment of \a offset,
+  * which is updated */
+inline bool binary_read(std::FILE* file, void* data, size_t size, uint64_t& offset)
+{
+  char padding[BinaryAlignment];
+  if(size && std::fread(data, 1, size, file)!=size)
+    return false;
+  offset += size;
+  size_t count = size_t(binary_header::align(offset) - offset);
+  if(count && std::fread(padding, 1, count, file)!=count)
+    return false;
+  offset += count;
+  return true;
+}
+
+inline bool binary_read_header(std::FILE* file, binary_header& header)
+{
+  uint64_t offset = 0;
+  return binary_read(file, &header, sizeof(binary_header), offset) && header.isValid();
+}
+
+} // end namespace internal
+
+#endif // EIGEN_BINARYFORMAT_H
@@ -0,0 +1,341 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_BINARYIO_H
+#define EIGEN_BINARYIO_H
+
+namespace internal {
+
+// closes a file when leaving the scope of the functions below
+class binary_file
+{
+  public:
+    binary_file(const std::string& filename, const char* mode) : m_file(std::fopen(filename.c_str(), mode)) {}
+    ~binary_file() { if(m_file) std::fclose(m_file); }
+    operator std::FILE*() const { return m_file; }
+    bool close()
+    {
+      bool ok = std::fclose(m_file)==0;
+      m_file = 0;
+      return ok;
+    }
+  private:
+    binary_file(const binary_file&);
+    binary_file& operator=(const binary_file&);
+    std::FILE* m_file;
+};
+
+} // end namespace internal
+
+/** \ingroup BinaryIO_Module
+  *
+  * Writes the dense matrix or array \a m to the binary file \a filename, in its storage order.
+  *
+  * \returns false if the file cannot be written
+  *
+  * \sa loadBinary(), class MappedMatrixFile
+  */
+template<typename Derived>
+bool saveBinary(const std::string& filename, const DenseBase<Derived>& m)
+{
+  typedef typename Derived::Scalar Scalar;
+  typedef typename Derived::PlainObject PlainObject;
+  EIGEN_STATIC_ASSERT(internal::binary_scalar_type<Scalar>::value!=0, THIS_SCALAR_TYPE_IS_NOT_SUPPORTED_BY_THE_BINARY_FILE_FORMAT)
+
+  // evaluates expressions, plain objects are only referenced
+  const PlainObject& plain = m.derived();
+  const bool isArray = internal::is_same<typename internal::traits<Derived>::XprKind, ArrayXpr>::value;
+  internal::binary_header header;
+  header.init(internal::binary_scalar_type<Scalar>::value, sizeof(Scalar),
+              (PlainObject::IsRowMajor ? internal::BinaryRowMajorBit : 0) | (isArray ? internal::BinaryArrayBit : 0),
+              plain.rows(), plain.cols());
+
+  internal::binary_file file(filename, "wb");
+  uint64_t offset = 0;
+  return file
+      && internal::binary_write(file, &header, sizeof(header), offset)
+      && internal::binary_write(file, plain.data(), size_t(plain.size())*sizeof(Scalar), offset)
+      && file.close();
+}
+
+/** \ingroup BinaryIO_Module
+  *
+  * Reads the dense matrix or array stored in the binary file \a filename into \a m, which is resized. The
+  * coefficients are transposed if the storage order of \a m differs from the one of the file, and a row vector
+  * can be read into a column vector and conversely.
+  *
+  * \returns false if the file cannot be read, does not hold a dense object of the scalar type of \a m, or holds
+  * one whose dimensions do not fit the fixed dimensions of \a m. In this case \a m is left unchanged.
+  *
+  * \sa saveBinary(), class MappedMatrixFile
+  */
+template<typename Derived>
+bool loadBinary(const std::string& filename, PlainObjectBase<Derived>& m)
+{
+  typedef typename Derived::Scalar Scalar;
+  typedef typename Derived::Index Index;
+  EIGEN_STATIC_ASSERT(internal::binary_scalar_type<Scalar>::value!=0, THIS_SCALAR_TYPE_IS_NOT_SUPPORTED_BY_THE_BINARY_FILE_FORMAT)
+
+  internal::binary_file file(filename, "rb");
+  internal::binary_header header;
+  if(!file || !internal::binary_read_header(file, header) || header.isSparse() || !header.template hasScalarType<Scalar>())
+    return false;
+  Index rows = Index(header.rows), cols = Index(header.cols);
+  // a row vector can be read into a column vector and conversely
+  if(Derived::IsVectorAtCompileTime && (rows==1 || cols==1))
+  {
+    const Index size = rows*cols;
+    rows = Derived::RowsAtCompileTime==1 ? 1 : size;
+    cols = Derived::RowsAtCompileTime==1 ? size : 1;
+  }
+  if((Derived::RowsAtCompileTime!=Dynamic && rows!=Derived::RowsAtCompileTime)
+  || (Derived::ColsAtCompileTime!=Dynamic && cols!=Derived::ColsAtCompileTime)
+  || (Derived::MaxRowsAtCompileTime!=Dynamic && rows>Derived::MaxRowsAtCompileTime)
+  || (Derived::MaxColsAtCompileTime!=Dynamic && cols>Derived::MaxColsAtCompileTime))
+    return false;
+
+  uint64_t offset = sizeof(header);
+  const size_t size = size_t(header.rows*header.cols)*sizeof(Scalar);
+  if(header.isRowMajor()==bool(Derived::IsRowMajor) || rows==1 || cols==1)
+  {
+    Derived result;
+    result.resize(rows, cols);
+    if(!internal::binary_read(file, result.data(), size, offset))
+      return false;
+    m.derived().swap(result);
+  }
+  else
+  {
+    typedef Matrix<Scalar,Dynamic,Dynamic,Derived::IsRowMajor ? ColMajor : RowMajor> FileMatrix;
+    typedef Matrix<Scalar,Dynamic,Dynamic,Derived::IsRowMajor ? RowMajor : ColMajor> ResultMatrix;
+    FileMatrix tmp(rows, cols);
+    if(!internal::binary_read(file, tmp.data(), size, offset))
+      return false;
+    m.resize(rows, cols);
+    Map<ResultMatrix>(m.data(), rows, cols) = tmp;
+  }
+  return true;
+}
+
+#ifdef EIGEN_SPARSE_MODULE_H
+
+namespace internal {
+
+// writes the indices or values of the compressed storage of a sparse expression through a buffer
+template<typename T> class binary_buffered_writer
+{
+  public:
+    binary_buffered_writer(std::FILE* file, uint64_t& offset) : m_file(file), m_offset(offset), m_count(0), m_ok(true) {}
+    void push(const T& x)
+    {
+      m_buffer[m_count++] = x;
+      if(m_count==BufferSize)
+        flush();
+    }
+    bool finish()
+    {
+      flush();
+      // pads up to the alignment
+      return m_ok && binary_write(m_file, 0, 0, m_offset);
+    }
+  private:
+    enum { BufferSize = 4096 };
+    void flush()
+    {
+      if(m_count && std::fwrite(m_buffer, sizeof(T), m_count, m_file)!=m_count)
+        m_ok = false;
+      m_offset += m_count*sizeof(T);
+      m_count = 0;
+    }
+    std::FILE* m_file;
+    uint64_t& m_offset;
+    size_t m_count;
+    bool m_ok;
+    T m_buffer[BufferSize];
+};
+
+// reads count indices of indexSize bytes into dst
+template<typename Index>
+bool binary_read_indices(std::FILE* file, Index* dst, size_t count, uint32_t indexSize, uint64_t& offset)
+{
+  if(indexSize==sizeof(Index))
+    return binary_read(file, dst, count*sizeof(Index), offset);
+  enum { BufferSize = 4096 };
+  int64_t buffer64[BufferSize];
+  int32_t buffer32[BufferSize];
+  for(size_t i=0; i<count; i+=BufferSize)
+  {
+    size_t n = (std::min)(size_t(BufferSize), count-i);
+    if(indexSize==8)
+    {
+      if(std::fread(buffer64, 8, n, file)!=n) return false;
+      for(size_t k=0; k<n; ++k) dst[i+k] = Index(buffer64[k]);
+    }
+    else
+    {
+      if(std::fread(buffer32, 4, n, file)!=n) return false;
+      for(size_t k=0; k<n; ++k) dst[i+k] = Index(buffer32[k]);
+    }
+  }
+  offset += count*indexSize;
+  return binary_read(file, 0, 0, offset);
+}
+
+// checks the compressed storage read from a file, so that a corrupted one is not used: the outer indices are
+// nondecreasing from 0 up to at most nonZeros, and the inner indices are in [0,innerSize)
+template<typename Index>
+bool binary_check_compressed(const Index* outer, const Index* inner, Index outerSize, Index innerSize, Index nonZeros)
+{
+  if(outer[0]<0 || outer[outerSize]>nonZeros)
+    return false;
+  for(Index j=0; j<outerSize; ++j)
+    if(outer[j+1]<outer[j])
+      return false;
+  for(Index k=0; k<nonZeros; ++k)
+    if(inner[k]<0 || inner[k]>=innerSize)
+      return false;
+  return true;
+}
+
+// moves src into dst, without copy if they have the same type
+template<typename MatrixType> void binary_move(MatrixType& dst, MatrixType& src) { dst.swap(src); }
+template<typename Dst, typename Src> void binary_move(Dst& dst, Src& src) { dst = src; }
+
+} // end namespace internal
+
+/** \ingroup BinaryIO_Module
+  *
+  * Writes the sparse matrix or expression \a m to the binary file \a filename, in the compressed format of its
+  * storage order. Uncompressed matrices are compressed on the fly.
+  *
+  * \returns false if the file cannot be written
+  *
+  * \sa loadBinary(), class MappedMatrixFile
+  */
+template<typename Derived>
+bool saveBinary(const std::string& filename, const SparseMatrixBase<Derived>& m)
+{
+  typedef typename Derived::Scalar Scalar;
+  typedef typename Derived::Index Index;
+  typedef typename Derived::InnerIterator InnerIterator;
+  EIGEN_STATIC_ASSERT(internal::binary_scalar_type<Scalar>::value!=0, THIS_SCALAR_TYPE_IS_NOT_SUPPORTED_BY_THE_BINARY_FILE_FORMAT)
+
+  const Derived& mat = m.derived();
+  const Index outerSize = mat.outerSize();
+  Index nonZeros = 0;
+  for(Index j=0; j<outerSize; ++j)
+    for(InnerIterator it(mat,j); it; ++it)
+      ++nonZeros;
+
+  internal::binary_header header;
+  header.init(internal::binary_scalar_type<Scalar>::value, sizeof(Scalar),
+              internal::BinarySparseBit | (Derived::IsRowMajor ? internal::BinaryRowMajorBit : 0),
+              mat.rows(), mat.cols(), nonZeros, sizeof(Index));
+
+  internal::binary_file file(filename, "wb");
+  uint64_t offset = 0;
+  if(!file || !internal::binary_write(file, &header, sizeof(header), offset))
+    return false;
+
+  internal::binary_buffered_writer<Index> outer(file, offset);
+  Index count = 0;
+  outer.push(count);
+  for(Index j=0; j<outerSize; ++j)
+  {
+    for(InnerIterator it(mat,j); it; ++it)
+      ++count;
+    outer.push(count);
+  }
+  if(!outer.finish())
+    return false;
+
+  internal::binary_buffered_writer<Index> inner(file, offset);
+  for(Index j=0; j<outerSize; ++j)
+    for(InnerIterator it(mat,j); it; ++it)
+      inner.push(it.index());
+  if(!inner.finish())
+    return false;
+
+  internal::binary_buffered_writer<Scalar> values(file, offset);
+  for(Index j=0; j<outerSize; ++j)
+    for(InnerIterator it(mat,j); it; ++it)
+      values.push(it.value());
+  return values.finish() && file.close();
+}
+
+/** \ingroup BinaryIO_Module
+  *
+  * Reads the sparse matrix stored in the binary file \a filename into \a m. The matrix is transposed if the
+  * storage order of \a m differs from the one of the file, and the indices are converted if the file was written
+  * with another index type.
+  *
+  * \returns false if the file cannot be read, does not hold a sparse matrix of the scalar type of \a m, holds one
+  * too large for its index type, or holds an invalid compressed storage. In this case \a m is left unchanged.
+  *
+  * \sa saveBinary(), class MappedMatrixFile
+  */
+template<typename Scalar, int Options, typename Index>
+bool loadBinary(const std::string& filename, SparseMatrix<Scalar,Options,Index>& m)
+{
+  EIGEN_STATIC_ASSERT(internal::binary_scalar_type<Scalar>::value!=0, THIS_SCALAR_TYPE_IS_NOT_SUPPORTED_BY_THE_BINARY_FILE_FORMAT)
+
+  internal::binary_file file(filename, "rb");
+  internal::binary_header header;
+  if(!file || !internal::binary_read_header(file, header) || !header.isSparse() || !header.template hasScalarType<Scalar>())
+    return false;
+  const uint64_t maxIndex = uint64_t(NumTraits<Index>::highest());
+  if(header.rows>=maxIndex || header.cols>=maxIndex || header.nonZeros>maxIndex)
+    return false;
+
+  typedef SparseMatrix<Scalar,RowMajor,Index> RowMajorMatrix;
+  typedef SparseMatrix<Scalar,ColMajor,Index> ColMajorMatrix;
+  uint64_t offset = sizeof(header);
+  if(header.isRowMajor())
+  {
+    RowMajorMatrix tmp(Index(header.rows), Index(header.cols));
+    tmp.resizeNonZeros(Index(header.nonZeros));
+    if(!internal::binary_read_indices(file, tmp._outerIndexPtr(), size_t(header.rows+1), header.indexSize, offset)
+    || !internal::binary_read_indices(file, tmp._innerIndexPtr(), size_t(header.nonZeros), header.indexSize, offset)
+    || !internal::binary_read(file, tmp._valuePtr(), size_t(header.nonZeros)*sizeof(Scalar), offset)
+    || !internal::binary_check_compressed(tmp._outerIndexPtr(), tmp._innerIndexPtr(), Index(header.rows), Index(header.cols),
+                                          Index(header.nonZeros)))
+      return false;
+    internal::binary_move(m, tmp);
+  }
+  else
+  {
+    ColMajorMatrix tmp(Index(header.rows), Index(header.cols));
+    tmp.resizeNonZeros(Index(header.nonZeros));
+    if(!internal::binary_read_indices(file, tmp._outerIndexPtr(), size_t(header.cols+1), header.indexSize, offset)
+    || !internal::binary_read_indices(file, tmp._innerIndexPtr(), size_t(header.nonZeros), header.indexSize, offset)
+    || !internal::binary_read(file, tmp._valuePtr(), size_t(header.nonZeros)*sizeof(Scalar), offset)
+    || !internal::binary_check_compressed(tmp._outerIndexPtr(), tmp._innerIndexPtr(), Index(header.cols), Index(header.rows),
+                                          Index(header.nonZeros)))
+      return false;
+    internal::binary_move(m, tmp);
+  }
+  return true;
+}
+
+#endif // EIGEN_SPARSE_MODULE_H
+
+#endif // EIGEN_BINARYIO_H
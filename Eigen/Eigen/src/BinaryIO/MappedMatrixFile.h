@@ -0,0 +1,232 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_MAPPEDMATRIXFILE_H
+#define EIGEN_MAPPEDMATRIXFILE_H
+
+/** \ingroup BinaryIO_Module
+  * \brief A binary matrix file mapped in memory
+  *
+  * This class maps a file written by saveBinary() in memory, and gives access to its content as a Map or a
+  * MappedSparseMatrix without copying nor reading it: the pages of the file are read by the operating system
+  * when they are first accessed. The data arrays of the file are aligned on 64 bytes, so the dense maps are
+  * aligned maps.
+  *
+  * \code
+  * MappedMatrixFile file("weights.bin");
+  * if(file.isOpen() && file.canMap<MatrixXf>())
+  *   y = file.map<MatrixXf>() * x;
+  * \endcode
+  *
+  * In the default \c Private mode, the file is mapped copy-on-write: the maps can be modified but the changes
+  * are not written back to the file. In the \c Shared mode, the changes are written to the file, which must be
+  * writable. The maps must not be used after the file is closed or destroyed.
+  *
+  * \sa saveBinary(), loadBinary()
+  */
+class MappedMatrixFile
+{
+  public:
+    typedef DenseIndex Index;
+    enum Mode { Private, Shared };
+
+    MappedMatrixFile() { init(); }
+
+    /** Maps the file \a filename, check isOpen() for errors. \sa open() */
+    explicit MappedMatrixFile(const std::string& filename, Mode mode = Private)
+    {
+      init();
+      open(filename, mode);
+    }
+
+    ~MappedMatrixFile() { close(); }
+
+    /** Maps the file \a filename in memory, closing the previous one
+      * \returns false if the file cannot be mapped, or is not a valid binary matrix file */
+    bool open(const std::string& filename, Mode mode = Private);
+
+    /** Unmaps the file */
+    void close();
+
+    /** \returns true if a file is mapped */
+    bool isOpen() const { return m_data!=0; }
+
+    Index rows() const { return Index(header().rows); }
+    Index cols() const { return Index(header().cols); }
+    /** \returns the number of nonzero coefficients of a sparse matrix, or the number of coefficients of a dense one */
+    Index nonZeros() const { return Index(header().valueCount()); }
+    bool isSparse() const { return header().isSparse(); }
+    bool isRowMajor() const { return header().isRowMajor(); }
+
+    /** \returns true if the file holds a dense object which can be viewed as a \c PlainObjectType, that is with the
+      * same scalar type, a compatible storage order and compatible dimensions */
+    template<typename PlainObjectType> bool canMap() const
+    {
+      typedef typename PlainObjectType::Scalar Scalar;
+      const internal::binary_header& h = header();
+      return isOpen() && !h.isSparse() && h.template hasScalarType<Scalar>()
+          && (h.isRowMajor()==bool(PlainObjectType::IsRowMajor) || h.rows==1 || h.cols==1)
+          && (PlainObjectType::RowsAtCompileTime==Dynamic || h.rows==uint64_t(PlainObjectType::RowsAtCompileTime))
+          && (PlainObjectType::ColsAtCompileTime==Dynamic || h.cols==uint64_t(PlainObjectType::ColsAtCompileTime));
+    }
+
+    /** \returns a map of the dense object of the file as a \c PlainObjectType, without copy
+      * \sa canMap() */
+    template<typename PlainObjectType> Map<PlainObjectType,Aligned> map() const
+    {
+      eigen_assert(canMap<PlainObjectType>() && "MappedMatrixFile::map(): the file does not hold this type of object");
+      typedef typename PlainObjectType::Scalar Scalar;
+      return Map<PlainObjectType,Aligned>(reinterpret_cast<Scalar*>(m_data + header().valueOffset()), rows(), cols());
+    }
+
+#ifdef EIGEN_SPARSE_MODULE_H
+    /** \returns true if the file holds a sparse matrix which can be viewed as a \c SparseMatrixType, that is with
+      * the same scalar type, index type and storage order, and whose outer and inner indices are valid.
+      *
+      * Checking the indices reads all of them, which pages in their part of the file. Pass \a checkIndices = false
+      * to skip it when the file is trusted, e.g. when it was written by the application itself: the indices of a
+      * corrupted file would then be used as they are by the sparse algorithms. */
+    template<typename SparseMatrixType> bool canMapSparse(bool checkIndices = true) const
+    {
+      typedef typename SparseMatrixType::Scalar Scalar;
+      typedef typename SparseMatrixType::Index SparseIndex;
+      if(!isOpen())
+        return false;
+      const internal::binary_header& h = header();
+      if(!h.isSparse() || !h.template hasScalarType<Scalar>() || h.indexSize!=sizeof(SparseIndex)
+      || h.isRowMajor()!=bool(SparseMatrixType::IsRowMajor))
+        return false;
+      const uint64_t highest = uint64_t(NumTraits<SparseIndex>::highest());
+      if(h.rows>highest || h.cols>highest || h.nonZeros>highest)
+        return false;
+      if(!checkIndices)
+        return true;
+      return internal::binary_check_compressed(reinterpret_cast<const SparseIndex*>(m_data + h.outerIndexOffset()),
+                                               reinterpret_cast<const SparseIndex*>(m_data + h.innerIndexOffset()),
+                                               SparseIndex(h.outerSize()), SparseIndex(h.isRowMajor() ? h.cols : h.rows),
+                                               SparseIndex(h.nonZeros));
+    }
+
+    /** \returns a view of the sparse matrix of the file as a MappedSparseMatrix of the scalar type, storage order
+      * and index type of \c SparseMatrixType, without copy.
+      *
+      * The indices are not checked here: call canMapSparse() first unless the file is trusted.
+      * \sa canMapSparse() */
+    template<typename SparseMatrixType>
+    MappedSparseMatrix<typename SparseMatrixType::Scalar, SparseMatrixType::IsRowMajor ? RowMajor : ColMajor,
+                       typename SparseMatrixType::Index> mapSparse() const
+    {
+      eigen_assert(canMapSparse<SparseMatrixType>(false) && "MappedMatrixFile::mapSparse(): the file does not hold this type of matrix");
+      typedef typename SparseMatrixType::Scalar Scalar;
+      typedef typename SparseMatrixType::Index SparseIndex;
+      const internal::binary_header& h = header();
+      return MappedSparseMatrix<Scalar, SparseMatrixType::IsRowMajor ? RowMajor : ColMajor, SparseIndex>(
+               rows(), cols(), nonZeros(),
+               reinterpret_cast<SparseIndex*>(m_data + h.outerIndexOffset()),
+               reinterpret_cast<SparseIndex*>(m_data + h.innerIndexOffset()),
+               reinterpret_cast<Scalar*>(m_data + h.valueOffset()));
+    }
+#endif
+
+  protected:
+    void init()
+    {
+      m_data = 0;
+      m_size = 0;
+#if defined(_WIN32)
+      m_file = INVALID_HANDLE_VALUE;
+      m_mapping = 0;
+#endif
+    }
+
+    const internal::binary_header& header() const
+    {
+      eigen_assert(isOpen() && "MappedMatrixFile is not open");
+      return *reinterpret_cast<const internal::binary_header*>(m_data);
+    }
+
+    unsigned char* m_data;
+    size_t m_size;
+#if defined(_WIN32)
+    HANDLE m_file;
+    HANDLE m_mapping;
+#endif
+
+  private:
+    MappedMatrixFile(const MappedMatrixFile&);
+    MappedMatrixFile& operator=(const MappedMatrixFile&);
+};
+
+inline bool MappedMatrixFile::open(const std::string& filename, Mode mode)
+{
+  close();
+#if defined(_WIN32)
+  m_file = CreateFileA(filename.c_str(), mode==Shared ? GENERIC_READ|GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ,
+                       0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+  if(m_file==INVALID_HANDLE_VALUE)
+    return false;
+  LARGE_INTEGER size;
+  if(!GetFileSizeEx(m_file, &size) || size.QuadPart < LONGLONG(sizeof(internal::binary_header)))
+  {
+    close();
+    return false;
+  }
+  m_size = size_t(size.QuadPart);
+  m_mapping = CreateFileMappingA(m_file, 0, mode==Shared ? PAGE_READWRITE : PAGE_WRITECOPY, 0, 0, 0);
+  if(m_mapping)
+    m_data = static_cast<unsigned char*>(MapViewOfFile(m_mapping, mode==Shared ? FILE_MAP_WRITE : FILE_MAP_COPY, 0, 0, 0));
+#else
+  int fd = ::open(filename.c_str(), mode==Shared ? O_RDWR : O_RDONLY);
+  if(fd<0)
+    return false;
+  struct stat st;
+  if(::fstat(fd, &st)==0 && st.st_size >= off_t(sizeof(internal::binary_header)))
+  {
+    m_size = size_t(st.st_size);
+    void* data = ::mmap(0, m_size, PROT_READ|PROT_WRITE, mode==Shared ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+    if(data!=MAP_FAILED)
+      m_data = static_cast<unsigned char*>(data);
+  }
+  // the mapping keeps a reference to the file
+  ::close(fd);
+#endif
+  if(m_data==0 || !header().isValid() || header().fileSize() > m_size)
+  {
+    close();
+    return false;
+  }
+  return true;
+}
+
+inline void MappedMatrixFile::close()
+{
+#if defined(_WIN32)
+  if(m_data) UnmapViewOfFile(m_data);
+  if(m_mapping) CloseHandle(m_mapping);
+  if(m_file!=INVALID_HANDLE_VALUE) CloseHandle(m_file);
+#else
+  if(m_data) ::munmap(m_data, m_size);
+#endif
+  init();
+}
+
+#endif // EIGEN_MAPPEDMATRIXFILE_H
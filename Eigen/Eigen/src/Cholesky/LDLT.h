@@ -278,22 +278,7 @@ template<> struct ldlt_inplace<Lower>
 
       transpositions.coeffRef(k) = index_of_biggest_in_corner;
       if(k != index_of_biggest_in_corner)
-      {
-        // apply the transposition while taking care to consider only
-        // the lower triangular part
-        Index s = size-index_of_biggest_in_corner-1; // trailing size after the biggest element
-        mat.row(k).head(k).swap(mat.row(index_of_biggest_in_corner).head(k));
-        mat.col(k).tail(s).swap(mat.col(index_of_biggest_in_corner).tail(s));
-        std::swap(mat.coeffRef(k,k),mat.coeffRef(index_of_biggest_in_corner,index_of_biggest_in_corner));
-        for(int i=k+1;i<index_of_biggest_in_corner;++i)
-        {
-          Scalar tmp = mat.coeffRef(i,k);
-          mat.coeffRef(i,k) = conj(mat.coeffRef(index_of_biggest_in_corner,i));
-          mat.coeffRef(index_of_biggest_in_corner,i) = conj(tmp);
-        }
-        if(NumTraits<Scalar>::IsComplex)
-          mat.coeffRef(index_of_biggest_in_corner,k) = conj(mat.coeff(index_of_biggest_in_corner,k));
-      }
+        swap_lower(mat, k, index_of_biggest_in_corner);
 
       // partition the matrix:
       //       A00 |  -  |  -
@@ -317,6 +302,132 @@ template<> struct ldlt_inplace<Lower>
 
     return true;
   }
+
+  template<typename MatrixType, typename TranspositionType, typename Workspace>
+  static bool blocked(MatrixType& mat, TranspositionType& transpositions, Workspace& temp, int* sign=0)
+  {
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::RealScalar RealScalar;
+    typedef typename MatrixType::Index Index;
+    eigen_assert(mat.rows()==mat.cols());
+    const Index size = mat.rows();
+    if(size<64)
+      return unblocked(mat, transpositions, temp, sign);
+
+    // The pivots of unblocked() only depend on the diagonal of the input matrix which is
+    // not updated until its column is reached. Therefore all the transpositions can be
+    // determined and applied first, and the factorization itself does not need any pivoting.
+    Matrix<RealScalar,Dynamic,1> absDiag = mat.diagonal().cwiseAbs();
+    RealScalar cutoff = 0;
+    Index rank = size;
+    for (Index k = 0; k < size; ++k)
+    {
+      Index index_of_biggest_in_corner;
+      RealScalar biggest_in_corner = absDiag.tail(size-k).maxCoeff(&index_of_biggest_in_corner);
+      index_of_biggest_in_corner += k;
+
+      if(k == 0)
+      {
+        cutoff = abs(NumTraits<Scalar>::epsilon() * biggest_in_corner);
+        if(sign)
+          *sign = real(mat.diagonal().coeff(index_of_biggest_in_corner)) > 0 ? 1 : -1;
+      }
+
+      if(biggest_in_corner < cutoff)
+      {
+        for(Index i = k; i < size; i++) transpositions.coeffRef(i) = i;
+        rank = k;
+        break;
+      }
+
+      transpositions.coeffRef(k) = index_of_biggest_in_corner;
+      if(k != index_of_biggest_in_corner)
+      {
+        std::swap(absDiag.coeffRef(k), absDiag.coeffRef(index_of_biggest_in_corner));
+        swap_lower(mat, k, index_of_biggest_in_corner);
+      }
+    }
+
+    // The first rank columns are factorized by panels. As in unblocked(), the remaining
+    // columns are left untouched.
+    Index blockSize = size/8;
+    blockSize = (blockSize/16)*16;
+    blockSize = (std::min)((std::max)(blockSize,Index(8)), Index(128));
+
+    Matrix<Scalar,Dynamic,Dynamic> W;
+    for (Index k = 0; k < rank; k += blockSize)
+    {
+      // partition the matrix:
+      //       A00 |  -  |  -  |  -
+      // lu  = A10 | A11 |  -  |  -
+      //       A20 | A21 | A22 |  -
+      //       A30 | A31 | A32 | A33
+      // where A11 is the current panel, A22 holds the remaining columns to factorize,
+      // and A33 the columns beyond the rank.
+      Index bs = (std::min)(blockSize, rank-k);
+      Index rs = rank - k - bs;
+      Index ts = size - rank;
+
+      for (Index j = k; j < k+bs; ++j)
+      {
+        Index pj = j - k;
+        Block<MatrixType,Dynamic,1> A21(mat,j+1,j,size-j-1,1);
+        Block<MatrixType,1,Dynamic> A10(mat,j,k,1,pj);
+        Block<MatrixType,Dynamic,Dynamic> A20(mat,j+1,k,size-j-1,pj);
+
+        if(pj>0)
+        {
+          temp.head(pj) = mat.diagonal().segment(k,pj).asDiagonal() * A10.adjoint();
+          mat.coeffRef(j,j) -= (A10 * temp.head(pj)).value();
+          if(size-j-1>0)
+            A21.noalias() -= A20 * temp.head(pj);
+        }
+        if((size-j-1>0) && (abs(mat.coeffRef(j,j)) > cutoff))
+          A21 /= mat.coeffRef(j,j);
+      }
+
+      if(rs>0)
+      {
+        Block<MatrixType,Dynamic,Dynamic> A21(mat,k+bs,k,rs,bs);
+        Block<MatrixType,Dynamic,Dynamic> A22(mat,k+bs,k+bs,rs,rs);
+
+        // W = D1 A21^*, then A22 -= A21 W, of which the product kernel computes only the lower half, in
+        // place (TriangularView::operator-= on a product calls general_matrix_matrix_triangular_product)
+        W = mat.diagonal().segment(k,bs).asDiagonal() * A21.adjoint();
+        A22.template triangularView<Lower>() -= A21 * W;
+        if(ts>0)
+        {
+          Block<MatrixType,Dynamic,Dynamic> A31(mat,rank,k,ts,bs);
+          Block<MatrixType,Dynamic,Dynamic> A32(mat,rank,k+bs,ts,rs);
+          A32.noalias() -= A31 * W;
+        }
+      }
+    }
+
+    return true;
+  }
+
+  /** \internal swaps the rows and columns \a i < \a j of the selfadjoint matrix whose lower part is stored in \a mat */
+  template<typename MatrixType>
+  static void swap_lower(MatrixType& mat, typename MatrixType::Index i, typename MatrixType::Index j)
+  {
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::Index Index;
+    // apply the transposition while taking care to consider only
+    // the lower triangular part
+    Index s = mat.rows()-j-1; // trailing size after the biggest element
+    mat.row(i).head(i).swap(mat.row(j).head(i));
+    mat.col(i).tail(s).swap(mat.col(j).tail(s));
+    std::swap(mat.coeffRef(i,i),mat.coeffRef(j,j));
+    for(Index k=i+1;k<j;++k)
+    {
+      Scalar tmp = mat.coeffRef(k,i);
+      mat.coeffRef(k,i) = conj(mat.coeffRef(j,k));
+      mat.coeffRef(j,k) = conj(tmp);
+    }
+    if(NumTraits<Scalar>::IsComplex)
+      mat.coeffRef(j,i) = conj(mat.coeff(j,i));
+  }
 };
 
 template<> struct ldlt_inplace<Upper>
@@ -327,6 +438,12 @@ template<> struct ldlt_inplace<Upper>
     Transpose<MatrixType> matt(mat);
     return ldlt_inplace<Lower>::unblocked(matt, transpositions, temp, sign);
   }
+  template<typename MatrixType, typename TranspositionType, typename Workspace>
+  static EIGEN_STRONG_INLINE bool blocked(MatrixType& mat, TranspositionType& transpositions, Workspace& temp, int* sign=0)
+  {
+    Transpose<MatrixType> matt(mat);
+    return ldlt_inplace<Lower>::blocked(matt, transpositions, temp, sign);
+  }
 };
 
 template<typename MatrixType> struct LDLT_Traits<MatrixType,Lower>
@@ -361,7 +478,7 @@ LDLT<MatrixType,_UpLo>& LDLT<MatrixType,_UpLo>::compute(const MatrixType& a)
   m_isInitialized = false;
   m_temporary.resize(size);
 
-  internal::ldlt_inplace<UpLo>::unblocked(m_matrix, m_transpositions, m_temporary, &m_sign);
+  internal::ldlt_inplace<UpLo>::blocked(m_matrix, m_transpositions, m_temporary, &m_sign);
 
   m_isInitialized = true;
   return *this;
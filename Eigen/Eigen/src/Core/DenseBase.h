@@ -64,6 +64,8 @@ template<typename Derived> class DenseBase
     typedef typename internal::traits<Derived>::Index Index; 
 
     typedef typename internal::traits<Derived>::Scalar Scalar;
+    /** The type of the coefficients, for STL compatibility */
+    typedef Scalar value_type;
     typedef typename internal::packet_traits<Scalar>::type PacketScalar;
     typedef typename NumTraits<Scalar>::Real RealScalar;
 
@@ -437,6 +439,8 @@ template<typename Derived> class DenseBase
     typename internal::result_of<BinaryOp(typename internal::traits<Derived>::Scalar)>::type
     redux(const BinaryOp& func) const;
 
+    template<int Options> const Reductions<Scalar,Options> reductions() const;
+
     template<typename Visitor>
     void visit(Visitor& func) const;
 
@@ -0,0 +1,918 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_FUSEDREDUX_H
+#define EIGEN_FUSEDREDUX_H
+
+namespace internal {
+
+/***************************************************************************
+* Part 1 : the reductions and their accumulators
+***************************************************************************/
+
+/** \internal The operations of a reduction of #ReductionOptions: the scalar and packet accumulations, the
+  * merge of two partial results, and the initial value given the first coefficient of the reduced data. */
+template<typename Scalar, int Reduction> struct fused_redux_op;
+
+template<typename Scalar> struct fused_redux_op<Scalar,SumReduction>
+{
+  typedef Scalar ResultType;
+  typedef typename packet_traits<Scalar>::type Packet;
+  enum { Cost = NumTraits<Scalar>::AddCost, PacketAccess = packet_traits<Scalar>::HasAdd };
+  static EIGEN_STRONG_INLINE ResultType init(const Scalar&) { return Scalar(0); }
+  static EIGEN_STRONG_INLINE ResultType coeff(const ResultType& acc, const Scalar& x) { return acc + x; }
+  static EIGEN_STRONG_INLINE ResultType merge(const ResultType& a, const ResultType& b) { return a + b; }
+  static EIGEN_STRONG_INLINE Packet pinit(const Scalar&) { return pset1<Packet>(Scalar(0)); }
+  static EIGEN_STRONG_INLINE Packet packet(const Packet& acc, const Packet& x) { return padd(acc, x); }
+  static EIGEN_STRONG_INLINE Packet pmerge(const Packet& a, const Packet& b) { return padd(a, b); }
+  static EIGEN_STRONG_INLINE ResultType predux(const Packet& p) { return internal::predux(p); }
+};
+
+template<typename Scalar> struct fused_redux_op<Scalar,MinReduction>
+{
+  typedef Scalar ResultType;
+  typedef typename packet_traits<Scalar>::type Packet;
+  enum { Cost = NumTraits<Scalar>::AddCost, PacketAccess = packet_traits<Scalar>::HasMin };
+  static EIGEN_STRONG_INLINE ResultType init(const Scalar& first) { return first; }
+  static EIGEN_STRONG_INLINE ResultType coeff(const ResultType& acc, const Scalar& x) { return std::min(acc, x); }
+  static EIGEN_STRONG_INLINE ResultType merge(const ResultType& a, const ResultType& b) { return std::min(a, b); }
+  static EIGEN_STRONG_INLINE Packet pinit(const Scalar& first) { return pset1<Packet>(first); }
+  static EIGEN_STRONG_INLINE Packet packet(const Packet& acc, const Packet& x) { return pmin(acc, x); }
+  static EIGEN_STRONG_INLINE Packet pmerge(const Packet& a, const Packet& b) { return pmin(a, b); }
+  static EIGEN_STRONG_INLINE ResultType predux(const Packet& p) { return predux_min(p); }
+};
+
+template<typename Scalar> struct fused_redux_op<Scalar,MaxReduction>
+{
+  typedef Scalar ResultType;
+  typedef typename packet_traits<Scalar>::type Packet;
+  enum { Cost = NumTraits<Scalar>::AddCost, PacketAccess = packet_traits<Scalar>::HasMax };
+  static EIGEN_STRONG_INLINE ResultType init(const Scalar& first) { return first; }
+  static EIGEN_STRONG_INLINE ResultType coeff(const ResultType& acc, const Scalar& x) { return std::max(acc, x); }
+  static EIGEN_STRONG_INLINE ResultType merge(const ResultType& a, const ResultType& b) { return std::max(a, b); }
+  static EIGEN_STRONG_INLINE Packet pinit(const Scalar& first) { return pset1<Packet>(first); }
+  static EIGEN_STRONG_INLINE Packet packet(const Packet& acc, const Packet& x) { return pmax(acc, x); }
+  static EIGEN_STRONG_INLINE Packet pmerge(const Packet& a, const Packet& b) { return pmax(a, b); }
+  static EIGEN_STRONG_INLINE ResultType predux(const Packet& p) { return predux_max(p); }
+};
+
+// For complex scalars the packet accumulator holds conj(x)*x, whose imaginary parts are zero.
+template<typename Scalar> struct fused_redux_op<Scalar,SquaredNormReduction>
+{
+  typedef typename NumTraits<Scalar>::Real ResultType;
+  typedef typename packet_traits<Scalar>::type Packet;
+  enum {
+    Cost = NumTraits<Scalar>::AddCost + NumTraits<Scalar>::MulCost,
+    PacketAccess = packet_traits<Scalar>::HasAdd && packet_traits<Scalar>::HasMul
+                && (!NumTraits<Scalar>::IsComplex || packet_traits<Scalar>::HasConj)
+  };
+  static EIGEN_STRONG_INLINE ResultType init(const Scalar&) { return ResultType(0); }
+  static EIGEN_STRONG_INLINE ResultType coeff(const ResultType& acc, const Scalar& x) { return acc + abs2(x); }
+  static EIGEN_STRONG_INLINE ResultType merge(const ResultType& a, const ResultType& b) { return a + b; }
+  static EIGEN_STRONG_INLINE Packet pinit(const Scalar&) { return pset1<Packet>(Scalar(0)); }
+  static EIGEN_STRONG_INLINE Packet packet(const Packet& acc, const Packet& x) { return padd(acc, pmul(pconj(x), x)); }
+  static EIGEN_STRONG_INLINE Packet pmerge(const Packet& a, const Packet& b) { return padd(a, b); }
+  static EIGEN_STRONG_INLINE ResultType predux(const Packet& p) { return real(internal::predux(p)); }
+};
+
+/** \internal The scalar partial result of one reduction. The slots of the reductions which have not been
+  * requested are empty and are optimized away. */
+template<typename Scalar, int Reduction, bool Enabled = true>
+struct fused_redux_slot
+{
+  typedef fused_redux_op<Scalar,Reduction> Op;
+  typename Op::ResultType value;
+  EIGEN_STRONG_INLINE void init(const Scalar& first) { value = Op::init(first); }
+  EIGEN_STRONG_INLINE void coeff(const Scalar& x) { value = Op::coeff(value, x); }
+  EIGEN_STRONG_INLINE void merge(const fused_redux_slot& other) { value = Op::merge(value, other.value); }
+};
+
+template<typename Scalar, int Reduction>
+struct fused_redux_slot<Scalar,Reduction,false>
+{
+  typename fused_redux_op<Scalar,Reduction>::ResultType value;
+  EIGEN_STRONG_INLINE void init(const Scalar&) {}
+  EIGEN_STRONG_INLINE void coeff(const Scalar&) {}
+  EIGEN_STRONG_INLINE void merge(const fused_redux_slot&) {}
+};
+
+/** \internal The packet partial result of one reduction, folded into a scalar slot by finish(). */
+template<typename Scalar, int Reduction, bool Enabled = true>
+struct fused_redux_packet_slot
+{
+  typedef fused_redux_op<Scalar,Reduction> Op;
+  typename Op::Packet value;
+  EIGEN_STRONG_INLINE void init(const Scalar& first) { value = Op::pinit(first); }
+  EIGEN_STRONG_INLINE void packet(const typename Op::Packet& x) { value = Op::packet(value, x); }
+  EIGEN_STRONG_INLINE void merge(const fused_redux_packet_slot& other) { value = Op::pmerge(value, other.value); }
+  EIGEN_STRONG_INLINE void finish(fused_redux_slot<Scalar,Reduction>& slot) const
+  { slot.value = Op::merge(slot.value, Op::predux(value)); }
+};
+
+template<typename Scalar, int Reduction>
+struct fused_redux_packet_slot<Scalar,Reduction,false>
+{
+  typedef typename packet_traits<Scalar>::type Packet;
+  EIGEN_STRONG_INLINE void init(const Scalar&) {}
+  EIGEN_STRONG_INLINE void packet(const Packet&) {}
+  EIGEN_STRONG_INLINE void merge(const fused_redux_packet_slot&) {}
+  EIGEN_STRONG_INLINE void finish(fused_redux_slot<Scalar,Reduction,false>&) const {}
+};
+
+/** \internal The results of one reduction for each column (or row), stored in the vector \a data. */
+template<typename Scalar, int Reduction, bool Enabled = true>
+struct fused_redux_vector_slot
+{
+  typedef fused_redux_op<Scalar,Reduction> Op;
+  typedef typename Op::ResultType ResultType;
+  typedef typename Op::Packet Packet;
+  fused_redux_vector_slot(ResultType* data) : m_data(data) {}
+  EIGEN_STRONG_INLINE void init(DenseIndex i, const Scalar& first) { m_data[i] = Op::init(first); }
+  EIGEN_STRONG_INLINE void coeff(DenseIndex i, const Scalar& x) { m_data[i] = Op::coeff(m_data[i], x); }
+  EIGEN_STRONG_INLINE void packet(DenseIndex i, const Packet& x)
+  { pstoreu(m_data+i, Op::packet(ploadu<Packet>(m_data+i), x)); }
+  EIGEN_STRONG_INLINE void set(DenseIndex i, const fused_redux_slot<Scalar,Reduction>& slot) { m_data[i] = slot.value; }
+  ResultType* m_data;
+};
+
+template<typename Scalar, int Reduction>
+struct fused_redux_vector_slot<Scalar,Reduction,false>
+{
+  typedef typename fused_redux_op<Scalar,Reduction>::ResultType ResultType;
+  typedef typename packet_traits<Scalar>::type Packet;
+  fused_redux_vector_slot(ResultType*) {}
+  EIGEN_STRONG_INLINE void init(DenseIndex, const Scalar&) {}
+  EIGEN_STRONG_INLINE void coeff(DenseIndex, const Scalar&) {}
+  EIGEN_STRONG_INLINE void packet(DenseIndex, const Packet&) {}
+  EIGEN_STRONG_INLINE void set(DenseIndex, const fused_redux_slot<Scalar,Reduction,false>&) {}
+};
+
+/** \internal Scalar partial results of all the reductions of \a Options */
+template<typename Scalar, int Options>
+struct fused_redux_accumulator
+{
+  fused_redux_slot<Scalar,SumReduction,(Options&SumReduction)!=0> sum;
+  fused_redux_slot<Scalar,MinReduction,(Options&MinReduction)!=0> minCoeff;
+  fused_redux_slot<Scalar,MaxReduction,(Options&MaxReduction)!=0> maxCoeff;
+  fused_redux_slot<Scalar,SquaredNormReduction,(Options&SquaredNormReduction)!=0> squaredNorm;
+
+  EIGEN_STRONG_INLINE void init(const Scalar& first)
+  { sum.init(first); minCoeff.init(first); maxCoeff.init(first); squaredNorm.init(first); }
+  EIGEN_STRONG_INLINE void coeff(const Scalar& x)
+  { sum.coeff(x); minCoeff.coeff(x); maxCoeff.coeff(x); squaredNorm.coeff(x); }
+  EIGEN_STRONG_INLINE void merge(const fused_redux_accumulator& other)
+  {
+    sum.merge(other.sum); minCoeff.merge(other.minCoeff);
+    maxCoeff.merge(other.maxCoeff); squaredNorm.merge(other.squaredNorm);
+  }
+};
+
+/** \internal Packet partial results of all the reductions of \a Options */
+template<typename Scalar, int Options>
+struct fused_redux_packet_accumulator
+{
+  typedef typename packet_traits<Scalar>::type Packet;
+  fused_redux_packet_slot<Scalar,SumReduction,(Options&SumReduction)!=0> sum;
+  fused_redux_packet_slot<Scalar,MinReduction,(Options&MinReduction)!=0> minCoeff;
+  fused_redux_packet_slot<Scalar,MaxReduction,(Options&MaxReduction)!=0> maxCoeff;
+  fused_redux_packet_slot<Scalar,SquaredNormReduction,(Options&SquaredNormReduction)!=0> squaredNorm;
+
+  EIGEN_STRONG_INLINE void init(const Scalar& first)
+  { sum.init(first); minCoeff.init(first); maxCoeff.init(first); squaredNorm.init(first); }
+  EIGEN_STRONG_INLINE void packet(const Packet& x)
+  { sum.packet(x); minCoeff.packet(x); maxCoeff.packet(x); squaredNorm.packet(x); }
+  EIGEN_STRONG_INLINE void merge(const fused_redux_packet_accumulator& other)
+  {
+    sum.merge(other.sum); minCoeff.merge(other.minCoeff);
+    maxCoeff.merge(other.maxCoeff); squaredNorm.merge(other.squaredNorm);
+  }
+  EIGEN_STRONG_INLINE void finish(fused_redux_accumulator<Scalar,Options>& acc) const
+  {
+    sum.finish(acc.sum); minCoeff.finish(acc.minCoeff);
+    maxCoeff.finish(acc.maxCoeff); squaredNorm.finish(acc.squaredNorm);
+  }
+};
+
+/** \internal Results of all the reductions of \a Options for each column (or row) */
+template<typename Scalar, int Options>
+struct fused_redux_vector_accumulator
+{
+  typedef typename packet_traits<Scalar>::type Packet;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  fused_redux_vector_accumulator(Scalar* sumData, Scalar* minData, Scalar* maxData, RealScalar* squaredNormData)
+    : sum(sumData), minCoeff(minData), maxCoeff(maxData), squaredNorm(squaredNormData)
+  {}
+
+  fused_redux_vector_slot<Scalar,SumReduction,(Options&SumReduction)!=0> sum;
+  fused_redux_vector_slot<Scalar,MinReduction,(Options&MinReduction)!=0> minCoeff;
+  fused_redux_vector_slot<Scalar,MaxReduction,(Options&MaxReduction)!=0> maxCoeff;
+  fused_redux_vector_slot<Scalar,SquaredNormReduction,(Options&SquaredNormReduction)!=0> squaredNorm;
+
+  EIGEN_STRONG_INLINE void init(DenseIndex i, const Scalar& first)
+  { sum.init(i, first); minCoeff.init(i, first); maxCoeff.init(i, first); squaredNorm.init(i, first); }
+  EIGEN_STRONG_INLINE void coeff(DenseIndex i, const Scalar& x)
+  { sum.coeff(i, x); minCoeff.coeff(i, x); maxCoeff.coeff(i, x); squaredNorm.coeff(i, x); }
+  EIGEN_STRONG_INLINE void packet(DenseIndex i, const Packet& x)
+  { sum.packet(i, x); minCoeff.packet(i, x); maxCoeff.packet(i, x); squaredNorm.packet(i, x); }
+  EIGEN_STRONG_INLINE void set(DenseIndex i, const fused_redux_accumulator<Scalar,Options>& acc)
+  { sum.set(i, acc.sum); minCoeff.set(i, acc.minCoeff); maxCoeff.set(i, acc.maxCoeff); squaredNorm.set(i, acc.squaredNorm); }
+};
+
+/***************************************************************************
+* Part 2 : the logic deciding a strategy for vectorization
+***************************************************************************/
+
+template<typename Derived, int Options>
+struct fused_redux_traits
+{
+  typedef typename Derived::Scalar Scalar;
+  enum {
+    PacketSize = packet_traits<Scalar>::size,
+    InnerMaxSize = int(Derived::IsRowMajor)
+                 ? Derived::MaxColsAtCompileTime
+                 : Derived::MaxRowsAtCompileTime,
+    OpsPacketAccess = (!(Options&SumReduction) || fused_redux_op<Scalar,SumReduction>::PacketAccess)
+                   && (!(Options&MinReduction) || fused_redux_op<Scalar,MinReduction>::PacketAccess)
+                   && (!(Options&MaxReduction) || fused_redux_op<Scalar,MaxReduction>::PacketAccess)
+                   && (!(Options&SquaredNormReduction) || fused_redux_op<Scalar,SquaredNormReduction>::PacketAccess),
+    OpsCost = (Options&SumReduction ? int(fused_redux_op<Scalar,SumReduction>::Cost) : 0)
+            + (Options&MinReduction ? int(fused_redux_op<Scalar,MinReduction>::Cost) : 0)
+            + (Options&MaxReduction ? int(fused_redux_op<Scalar,MaxReduction>::Cost) : 0)
+            + (Options&SquaredNormReduction ? int(fused_redux_op<Scalar,SquaredNormReduction>::Cost) : 0)
+  };
+
+  enum {
+    MightVectorize = (int(Derived::Flags)&ActualPacketAccessBit) && OpsPacketAccess,
+    MayLinearVectorize = MightVectorize && (int(Derived::Flags)&LinearAccessBit),
+    MaySliceVectorize  = MightVectorize && (int(InnerMaxSize)==Dynamic || int(InnerMaxSize)>=3*int(PacketSize)),
+    // the partial reductions across the outer vectors accumulate packets of Scalar into the result vectors
+    MayVectorizeAcross = MightVectorize
+                      && !(NumTraits<Scalar>::IsComplex && (Options&SquaredNormReduction))
+  };
+
+  enum {
+    Traversal = int(MayLinearVectorize) ? int(LinearVectorizedTraversal)
+              : int(MaySliceVectorize)  ? int(SliceVectorizedTraversal)
+                                        : int(DefaultTraversal),
+    CoeffCost = (int(Derived::CoeffReadCost)==Dynamic ? 1 : int(Derived::CoeffReadCost)) + int(OpsCost)
+  };
+};
+
+/***************************************************************************
+* Part 3 : kernels
+***************************************************************************/
+
+/** \internal Accumulates the coefficients of the inner vector \a j of \a mat into \a acc. Two packet
+  * accumulators are used in turn to hide the latency of the packet operations. */
+template<typename Derived, int Options, bool Vectorize>
+struct fused_redux_inner
+{
+  typedef typename Derived::Scalar Scalar;
+  typedef typename Derived::Index Index;
+  typedef typename packet_traits<Scalar>::type Packet;
+  enum { PacketSize = packet_traits<Scalar>::size };
+
+  static EIGEN_STRONG_INLINE void run(const Derived& mat, Index j, const Scalar& first,
+                                      fused_redux_accumulator<Scalar,Options>& acc)
+  {
+    const Index innerSize = mat.innerSize();
+    const Index packetedInnerSize = (innerSize/PacketSize)*PacketSize;
+    if(packetedInnerSize)
+    {
+      fused_redux_packet_accumulator<Scalar,Options> acc0, acc1;
+      acc0.init(first);
+      acc1.init(first);
+      Index i = 0;
+      for(; i+2*PacketSize<=packetedInnerSize; i+=2*PacketSize)
+      {
+        acc0.packet(mat.template packetByOuterInner<Unaligned>(j, i));
+        acc1.packet(mat.template packetByOuterInner<Unaligned>(j, i+PacketSize));
+      }
+      if(i<packetedInnerSize)
+        acc0.packet(mat.template packetByOuterInner<Unaligned>(j, i));
+      acc0.merge(acc1);
+      acc0.finish(acc);
+    }
+    for(Index i=packetedInnerSize; i<innerSize; ++i)
+      acc.coeff(mat.coeffByOuterInner(j, i));
+  }
+};
+
+template<typename Derived, int Options>
+struct fused_redux_inner<Derived,Options,false>
+{
+  typedef typename Derived::Scalar Scalar;
+  typedef typename Derived::Index Index;
+
+  static EIGEN_STRONG_INLINE void run(const Derived& mat, Index j, const Scalar&,
+                                      fused_redux_accumulator<Scalar,Options>& acc)
+  {
+    const Index innerSize = mat.innerSize();
+    for(Index i=0; i<innerSize; ++i)
+      acc.coeff(mat.coeffByOuterInner(j, i));
+  }
+};
+
+/** \internal Accumulates the coefficients \a start to \a end of the inner vector \a j of \a mat into the
+  * results \a res of the corresponding inner indices. */
+template<typename Derived, int Options, bool Vectorize>
+struct fused_redux_across
+{
+  typedef typename Derived::Scalar Scalar;
+  typedef typename Derived::Index Index;
+  enum { PacketSize = packet_traits<Scalar>::size };
+
+  static EIGEN_STRONG_INLINE void run(const Derived& mat, Index j, Index start, Index end,
+                                      fused_redux_vector_accumulator<Scalar,Options>& res)
+  {
+    Index i = start;
+    for(; i+PacketSize<=end; i+=PacketSize)
+      res.packet(i, mat.template packetByOuterInner<Unaligned>(j, i));
+    for(; i<end; ++i)
+      res.coeff(i, mat.coeffByOuterInner(j, i));
+  }
+};
+
+template<typename Derived, int Options>
+struct fused_redux_across<Derived,Options,false>
+{
+  typedef typename Derived::Scalar Scalar;
+  typedef typename Derived::Index Index;
+
+  static EIGEN_STRONG_INLINE void run(const Derived& mat, Index j, Index start, Index end,
+                                      fused_redux_vector_accumulator<Scalar,Options>& res)
+  {
+    for(Index i=start; i<end; ++i)
+      res.coeff(i, mat.coeffByOuterInner(j, i));
+  }
+};
+
+/** \internal Shared part of the full reduction kernels: each thread reduces its range into its own
+  * partial result, and the partial results are merged once all threads are done. */
+template<typename Scalar, int Options>
+struct fused_redux_kernel_base
+{
+  typedef fused_redux_accumulator<Scalar,Options> Accumulator;
+
+  fused_redux_kernel_base() : m_partials(0), m_threads(0) {}
+  ~fused_redux_kernel_base() { delete[] m_partials; }
+
+  void initParallelSession(DenseIndex threads)
+  {
+    m_partials = new Accumulator[threads];
+    m_threads = threads;
+  }
+
+  void store(DenseIndex tid, const Accumulator& acc)
+  {
+    if(m_partials)
+      m_partials[tid] = acc;
+    else
+      m_result = acc;
+  }
+
+  Accumulator result() const
+  {
+    if(!m_partials)
+      return m_result;
+    Accumulator res = m_partials[0];
+    for(DenseIndex k=1; k<m_threads; ++k)
+      res.merge(m_partials[k]);
+    return res;
+  }
+
+  Accumulator* m_partials;
+  DenseIndex m_threads;
+  Accumulator m_result;
+};
+
+/** \internal Reduces the coefficients \a start to \a end, counted from the first aligned one. The first
+  * thread also takes the unaligned coefficients before it. */
+template<typename Derived, int Options>
+struct fused_redux_linear_kernel : fused_redux_kernel_base<typename Derived::Scalar,Options>
+{
+  typedef typename Derived::Scalar Scalar;
+  typedef typename Derived::Index Index;
+  typedef fused_redux_accumulator<Scalar,Options> Accumulator;
+  enum {
+    PacketSize = packet_traits<Scalar>::size,
+    Alignment = bool(Derived::Flags & DirectAccessBit) || bool(Derived::Flags & AlignedBit)
+              ? Aligned : Unaligned
+  };
+
+  fused_redux_linear_kernel(const Derived& mat, const Scalar& first, Index alignedStart)
+    : m_mat(mat), m_first(first), m_alignedStart(alignedStart)
+  {}
+
+  void operator()(Index start, Index end, Index tid)
+  {
+    Accumulator acc;
+    acc.init(m_first);
+    if(tid==0)
+      for(Index i=0; i<m_alignedStart; ++i)
+        acc.coeff(m_mat.coeff(i));
+
+    start += m_alignedStart;
+    end += m_alignedStart;
+    const Index alignedEnd = start + ((end-start)/PacketSize)*PacketSize;
+    if(alignedEnd>start)
+    {
+      fused_redux_packet_accumulator<Scalar,Options> acc0, acc1;
+      acc0.init(m_first);
+      acc1.init(m_first);
+      Index i = start;
+      for(; i+2*PacketSize<=alignedEnd; i+=2*PacketSize)
+      {
+        acc0.packet(m_mat.template packet<Alignment>(i));
+        acc1.packet(m_mat.template packet<Alignment>(i+PacketSize));
+      }
+      if(i<alignedEnd)
+        acc0.packet(m_mat.template packet<Alignment>(i));
+      acc0.merge(acc1);
+      acc0.finish(acc);
+    }
+    for(Index i=alignedEnd; i<end; ++i)
+      acc.coeff(m_mat.coeff(i));
+
+    this->store(tid, acc);
+  }
+
+  const Derived& m_mat;
+  const Scalar m_first;
+  const Index m_alignedStart;
+};
+
+/** \internal Reduces the inner vectors \a start to \a end */
+template<typename Derived, int Options, bool Vectorize>
+struct fused_redux_outer_kernel : fused_redux_kernel_base<typename Derived::Scalar,Options>
+{
+  typedef typename Derived::Scalar Scalar;
+  typedef typename Derived::Index Index;
+  typedef fused_redux_accumulator<Scalar,Options> Accumulator;
+
+  fused_redux_outer_kernel(const Derived& mat, const Scalar& first) : m_mat(mat), m_first(first) {}
+
+  void operator()(Index start, Index end, Index tid)
+  {
+    Accumulator acc;
+    acc.init(m_first);
+    for(Index j=start; j<end; ++j)
+      fused_redux_inner<Derived,Options,Vectorize>::run(m_mat, j, m_first, acc);
+    this->store(tid, acc);
+  }
+
+  const Derived& m_mat;
+  const Scalar m_first;
+};
+
+/** \internal Reduces each of the inner vectors \a start to \a end into its own result */
+template<typename Derived, int Options, bool Vectorize>
+struct fused_vectorwise_inner_kernel
+{
+  typedef typename Derived::Scalar Scalar;
+  typedef typename Derived::Index Index;
+  typedef fused_redux_vector_accumulator<Scalar,Options> VectorAccumulator;
+
+  fused_vectorwise_inner_kernel(const Derived& mat, VectorAccumulator& res) : m_mat(mat), m_res(res) {}
+
+  void initParallelSession(Index) {}
+
+  void operator()(Index start, Index end, Index)
+  {
+    const bool empty = m_mat.innerSize()==0;
+    for(Index j=start; j<end; ++j)
+    {
+      const Scalar first = empty ? Scalar(0) : m_mat.coeffByOuterInner(j, 0);
+      fused_redux_accumulator<Scalar,Options> acc;
+      acc.init(first);
+      fused_redux_inner<Derived,Options,Vectorize>::run(m_mat, j, first, acc);
+      m_res.set(j, acc);
+    }
+  }
+
+  const Derived& m_mat;
+  VectorAccumulator& m_res;
+};
+
+/** \internal Reduces the coefficients of inner indices \a start to \a end across all the inner vectors.
+  * The inner indices are processed by blocks whose results stay in the L1 cache while the inner vectors
+  * are streamed. */
+template<typename Derived, int Options, bool Vectorize>
+struct fused_vectorwise_outer_kernel
+{
+  typedef typename Derived::Scalar Scalar;
+  typedef typename Derived::Index Index;
+  typedef fused_redux_vector_accumulator<Scalar,Options> VectorAccumulator;
+  enum { BlockSize = 512 };
+
+  fused_vectorwise_outer_kernel(const Derived& mat, VectorAccumulator& res) : m_mat(mat), m_res(res) {}
+
+  void initParallelSession(Index) {}
+
+  void operator()(Index start, Index end, Index)
+  {
+    const Index outerSize = m_mat.outerSize();
+    for(Index blockStart=start; blockStart<end; blockStart+=BlockSize)
+    {
+      const Index blockEnd = (std::min)(end, blockStart+Index(BlockSize));
+      for(Index i=blockStart; i<blockEnd; ++i)
+        m_res.init(i, outerSize>0 ? m_mat.coeffByOuterInner(0, i) : Scalar(0));
+      for(Index j=0; j<outerSize; ++j)
+        fused_redux_across<Derived,Options,Vectorize>::run(m_mat, j, blockStart, blockEnd, m_res);
+    }
+  }
+
+  const Derived& m_mat;
+  VectorAccumulator& m_res;
+};
+
+/***************************************************************************
+* Part 4 : implementation of all cases
+***************************************************************************/
+
+template<typename Derived, int Options,
+         int Traversal = fused_redux_traits<Derived,Options>::Traversal>
+struct fused_redux_impl
+{
+  typedef typename Derived::Scalar Scalar;
+  typedef typename Derived::Index Index;
+  typedef fused_redux_traits<Derived,Options> Traits;
+
+  static void run(const Derived& mat, const Scalar& first, fused_redux_accumulator<Scalar,Options>& res)
+  {
+    fused_redux_outer_kernel<Derived,Options,Traversal==SliceVectorizedTraversal> kernel(mat, first);
+    const Index outerSize = mat.outerSize();
+    if(!parallelize_range(kernel, outerSize, Index(mat.innerSize() * Traits::CoeffCost)))
+      kernel(0, outerSize, 0);
+    res = kernel.result();
+  }
+};
+
+template<typename Derived, int Options>
+struct fused_redux_impl<Derived,Options,LinearVectorizedTraversal>
+{
+  typedef typename Derived::Scalar Scalar;
+  typedef typename Derived::Index Index;
+  typedef fused_redux_traits<Derived,Options> Traits;
+
+  static void run(const Derived& mat, const Scalar& first, fused_redux_accumulator<Scalar,Options>& res)
+  {
+    const Index alignedStart = first_aligned(mat);
+    const Index size = mat.size() - alignedStart;
+    fused_redux_linear_kernel<Derived,Options> kernel(mat, first, alignedStart);
+    if(!parallelize_range(kernel, size, Index(Traits::CoeffCost)))
+      kernel(0, size, 0);
+    res = kernel.result();
+  }
+};
+
+template<typename Derived, int Options, int Direction,
+         bool ReduceInner = (int(Direction)==Vertical) != bool(Derived::IsRowMajor)>
+struct fused_vectorwise_redux_impl
+{
+  typedef typename Derived::Index Index;
+  typedef fused_redux_traits<Derived,Options> Traits;
+
+  static void run(const Derived& mat, fused_redux_vector_accumulator<typename Derived::Scalar,Options>& res)
+  {
+    fused_vectorwise_inner_kernel<Derived,Options,Traits::MaySliceVectorize> kernel(mat, res);
+    const Index outerSize = mat.outerSize();
+    if(!parallelize_range(kernel, outerSize, Index(mat.innerSize() * Traits::CoeffCost)))
+      kernel(0, outerSize, 0);
+  }
+};
+
+template<typename Derived, int Options, int Direction>
+struct fused_vectorwise_redux_impl<Derived,Options,Direction,false>
+{
+  typedef typename Derived::Index Index;
+  typedef fused_redux_traits<Derived,Options> Traits;
+
+  static void run(const Derived& mat, fused_redux_vector_accumulator<typename Derived::Scalar,Options>& res)
+  {
+    fused_vectorwise_outer_kernel<Derived,Options,Traits::MayVectorizeAcross> kernel(mat, res);
+    const Index innerSize = mat.innerSize();
+    if(!parallelize_range(kernel, innerSize, Index(mat.outerSize() * Traits::CoeffCost)))
+      kernel(0, innerSize, 0);
+  }
+};
+
+} // end namespace internal
+
+/***************************************************************************
+* Part 5 : public API
+***************************************************************************/
+
+/** \class Reductions
+  * \ingroup Core_Module
+  *
+  * \brief Several reductions of all the coefficients of an expression computed in a single pass
+  *
+  * \param Scalar the scalar type of the reduced expression
+  * \param Options the reductions to compute, a combination of #SumReduction, #MinReduction, #MaxReduction
+  *                and #SquaredNormReduction
+  *
+  * DenseBase::sum(), DenseBase::minCoeff(), DenseBase::maxCoeff() and DenseBase::squaredNorm() each read
+  * all the coefficients of the expression. This class computes the requested reductions in a single
+  * traversal instead, with two packet accumulators per reduction, and splits large expressions into
+  * ranges reduced on several threads.
+  *
+  * \code
+  * Reductions<double,SumReduction|MaxReduction> r = m.reductions<SumReduction|MaxReduction>();
+  * std::cout << r.mean() << " " << r.maxCoeff() << std::endl;
+  * \endcode
+  *
+  * Asking for a reduction which is not in \a Options is a compile time error. #MinReduction and
+  * #MaxReduction require a real scalar type.
+  *
+  * \sa DenseBase::reductions(), class VectorwiseReductions
+  */
+template<typename _Scalar, int _Options> class Reductions
+{
+  public:
+    typedef _Scalar Scalar;
+    typedef typename NumTraits<Scalar>::Real RealScalar;
+    typedef DenseIndex Index;
+    enum { Options = _Options };
+
+    /** Default constructor, the reductions are computed by compute(). */
+    Reductions() : m_size(0), m_isInitialized(false) {}
+
+    /** Computes the reductions of \a other */
+    template<typename Derived>
+    explicit Reductions(const DenseBase<Derived>& other) : m_size(0), m_isInitialized(false)
+    {
+      compute(other);
+    }
+
+    template<typename Derived>
+    Reductions& compute(const DenseBase<Derived>& other);
+
+    /** \returns the sum of the coefficients */
+    Scalar sum() const
+    {
+      EIGEN_STATIC_ASSERT(Options&SumReduction, THIS_REDUCTION_WAS_NOT_REQUESTED_IN_THE_OPTIONS)
+      eigen_assert(m_isInitialized && "Reductions is not initialized.");
+      return m_acc.sum.value;
+    }
+
+    /** \returns the mean of the coefficients, this requires #SumReduction */
+    Scalar mean() const
+    {
+      EIGEN_STATIC_ASSERT(Options&SumReduction, THIS_REDUCTION_WAS_NOT_REQUESTED_IN_THE_OPTIONS)
+      eigen_assert(m_isInitialized && "Reductions is not initialized.");
+      return m_acc.sum.value / Scalar(m_size);
+    }
+
+    /** \returns the minimum of the coefficients */
+    Scalar minCoeff() const
+    {
+      EIGEN_STATIC_ASSERT(Options&MinReduction, THIS_REDUCTION_WAS_NOT_REQUESTED_IN_THE_OPTIONS)
+      eigen_assert(m_isInitialized && "Reductions is not initialized.");
+      return m_acc.minCoeff.value;
+    }
+
+    /** \returns the maximum of the coefficients */
+    Scalar maxCoeff() const
+    {
+      EIGEN_STATIC_ASSERT(Options&MaxReduction, THIS_REDUCTION_WAS_NOT_REQUESTED_IN_THE_OPTIONS)
+      eigen_assert(m_isInitialized && "Reductions is not initialized.");
+      return m_acc.maxCoeff.value;
+    }
+
+    /** \returns the sum of the squared absolute values of the coefficients */
+    RealScalar squaredNorm() const
+    {
+      EIGEN_STATIC_ASSERT(Options&SquaredNormReduction, THIS_REDUCTION_WAS_NOT_REQUESTED_IN_THE_OPTIONS)
+      eigen_assert(m_isInitialized && "Reductions is not initialized.");
+      return m_acc.squaredNorm.value;
+    }
+
+    /** \returns the l2 norm of the coefficients, this requires #SquaredNormReduction */
+    RealScalar norm() const
+    {
+      return internal::sqrt(squaredNorm());
+    }
+
+    /** \returns the number of reduced coefficients */
+    Index size() const
+    {
+      eigen_assert(m_isInitialized && "Reductions is not initialized.");
+      return m_size;
+    }
+
+  protected:
+    internal::fused_redux_accumulator<Scalar,Options> m_acc;
+    Index m_size;
+    bool m_isInitialized;
+};
+
+/** Computes the reductions of the coefficients of \a other in a single pass.
+  *
+  * Like redux(), products and other expressions with an evaluator are evaluated first.
+  *
+  * \returns a reference to *this
+  */
+template<typename Scalar, int Options>
+template<typename Derived>
+Reductions<Scalar,Options>& Reductions<Scalar,Options>::compute(const DenseBase<Derived>& other)
+{
+  EIGEN_STATIC_ASSERT((internal::is_same<Scalar, typename Derived::Scalar>::value),
+    YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+  EIGEN_STATIC_ASSERT(!NumTraits<Scalar>::IsComplex || !(Options&(MinReduction|MaxReduction)), NUMERIC_TYPE_MUST_BE_REAL)
+  typedef typename internal::remove_all<typename Derived::Nested>::type ThisNested;
+  const ThisNested& mat = other.derived();
+
+  m_size = mat.size();
+  eigen_assert((m_size>0 || !(Options&(MinReduction|MaxReduction))) && "you are using an empty matrix");
+  const Scalar first = m_size>0 ? Scalar(mat.coeffByOuterInner(0, 0)) : Scalar(0);
+  internal::fused_redux_impl<ThisNested,Options>::run(mat, first, m_acc);
+  m_isInitialized = true;
+  return *this;
+}
+
+/** \class VectorwiseReductions
+  * \ingroup Core_Module
+  *
+  * \brief Several reductions of each column (or row) of an expression computed in a single pass
+  *
+  * \param Scalar the scalar type of the reduced expression
+  * \param Options the reductions to compute, a combination of #SumReduction, #MinReduction, #MaxReduction
+  *                and #SquaredNormReduction
+  * \param Direction #Vertical to reduce each column, #Horizontal to reduce each row
+  *
+  * This is the counterpart of class Reductions for VectorwiseOp: the results are row vectors with one
+  * coefficient per column for #Vertical, and column vectors with one coefficient per row for #Horizontal.
+  * When the reduced columns (or rows) are not contiguous in memory, the results of a block of them are
+  * updated with packets while the expression is read once in its storage order.
+  *
+  * \code
+  * VectorwiseReductions<float,MinReduction|MaxReduction,Vertical> r = m.colwise().reductions<MinReduction|MaxReduction>();
+  * Eigen::RowVectorXf range = r.maxCoeff() - r.minCoeff();
+  * \endcode
+  *
+  * \sa VectorwiseOp::reductions(), class Reductions
+  */
+template<typename _Scalar, int _Options, int _Direction> class VectorwiseReductions
+{
+  public:
+    typedef _Scalar Scalar;
+    typedef typename NumTraits<Scalar>::Real RealScalar;
+    typedef DenseIndex Index;
+    enum { Options = _Options, Direction = _Direction };
+    typedef Matrix<Scalar, int(Direction)==Vertical ? 1 : Dynamic, int(Direction)==Vertical ? Dynamic : 1> VectorType;
+    typedef Matrix<RealScalar, int(Direction)==Vertical ? 1 : Dynamic, int(Direction)==Vertical ? Dynamic : 1> RealVectorType;
+
+    /** Default constructor, the reductions are computed by compute(). */
+    VectorwiseReductions() : m_size(0), m_isInitialized(false) {}
+
+    /** Computes the reductions of each column (or row) of \a other */
+    template<typename Derived>
+    explicit VectorwiseReductions(const DenseBase<Derived>& other) : m_size(0), m_isInitialized(false)
+    {
+      compute(other);
+    }
+
+    template<typename Derived>
+    VectorwiseReductions& compute(const DenseBase<Derived>& other);
+
+    /** \returns the sums of the columns (or rows) */
+    const VectorType& sum() const
+    {
+      EIGEN_STATIC_ASSERT(Options&SumReduction, THIS_REDUCTION_WAS_NOT_REQUESTED_IN_THE_OPTIONS)
+      eigen_assert(m_isInitialized && "VectorwiseReductions is not initialized.");
+      return m_sum;
+    }
+
+    /** \returns the means of the columns (or rows), this requires #SumReduction */
+    const VectorType mean() const
+    {
+      return sum() / Scalar(m_size);
+    }
+
+    /** \returns the minima of the columns (or rows) */
+    const VectorType& minCoeff() const
+    {
+      EIGEN_STATIC_ASSERT(Options&MinReduction, THIS_REDUCTION_WAS_NOT_REQUESTED_IN_THE_OPTIONS)
+      eigen_assert(m_isInitialized && "VectorwiseReductions is not initialized.");
+      return m_minCoeff;
+    }
+
+    /** \returns the maxima of the columns (or rows) */
+    const VectorType& maxCoeff() const
+    {
+      EIGEN_STATIC_ASSERT(Options&MaxReduction, THIS_REDUCTION_WAS_NOT_REQUESTED_IN_THE_OPTIONS)
+      eigen_assert(m_isInitialized && "VectorwiseReductions is not initialized.");
+      return m_maxCoeff;
+    }
+
+    /** \returns the squared norms of the columns (or rows) */
+    const RealVectorType& squaredNorm() const
+    {
+      EIGEN_STATIC_ASSERT(Options&SquaredNormReduction, THIS_REDUCTION_WAS_NOT_REQUESTED_IN_THE_OPTIONS)
+      eigen_assert(m_isInitialized && "VectorwiseReductions is not initialized.");
+      return m_squaredNorm;
+    }
+
+    /** \returns the l2 norms of the columns (or rows), this requires #SquaredNormReduction */
+    const RealVectorType norm() const
+    {
+      return squaredNorm().cwiseSqrt();
+    }
+
+    /** \returns the number of coefficients of each column (or row) */
+    Index size() const
+    {
+      eigen_assert(m_isInitialized && "VectorwiseReductions is not initialized.");
+      return m_size;
+    }
+
+  protected:
+    VectorType m_sum, m_minCoeff, m_maxCoeff;
+    RealVectorType m_squaredNorm;
+    Index m_size;
+    bool m_isInitialized;
+};
+
+/** Computes the reductions of each column (or row) of \a other in a single pass.
+  *
+  * \returns a reference to *this
+  */
+template<typename Scalar, int Options, int Direction>
+template<typename Derived>
+VectorwiseReductions<Scalar,Options,Direction>&
+VectorwiseReductions<Scalar,Options,Direction>::compute(const DenseBase<Derived>& other)
+{
+  EIGEN_STATIC_ASSERT((internal::is_same<Scalar, typename Derived::Scalar>::value),
+    YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+  EIGEN_STATIC_ASSERT(!NumTraits<Scalar>::IsComplex || !(Options&(MinReduction|MaxReduction)), NUMERIC_TYPE_MUST_BE_REAL)
+  typedef typename internal::remove_all<typename Derived::Nested>::type ThisNested;
+  const ThisNested& mat = other.derived();
+
+  const Index count = int(Direction)==Vertical ? mat.cols() : mat.rows();
+  m_size = int(Direction)==Vertical ? mat.rows() : mat.cols();
+  eigen_assert((m_size>0 || count==0 || !(Options&(MinReduction|MaxReduction))) && "you are using an empty matrix");
+  if(Options&SumReduction)         m_sum.resize(count);
+  if(Options&MinReduction)         m_minCoeff.resize(count);
+  if(Options&MaxReduction)         m_maxCoeff.resize(count);
+  if(Options&SquaredNormReduction) m_squaredNorm.resize(count);
+
+  internal::fused_redux_vector_accumulator<Scalar,Options>
+    res(m_sum.data(), m_minCoeff.data(), m_maxCoeff.data(), m_squaredNorm.data());
+  internal::fused_vectorwise_redux_impl<ThisNested,Options,Direction>::run(mat, res);
+  m_isInitialized = true;
+  return *this;
+}
+
+/** \returns the sum, minimum, maximum and squared norm of the coefficients of *this, those of them
+  * requested by \a Options, computed in a single pass.
+  *
+  * \a Options is a combination of #SumReduction, #MinReduction, #MaxReduction and #SquaredNormReduction:
+  * \code
+  * Reductions<float,SumReduction|SquaredNormReduction> r = v.reductions<SumReduction|SquaredNormReduction>();
+  * float variance = r.squaredNorm() / r.size() - r.mean() * r.mean();
+  * \endcode
+  *
+  * \sa class Reductions, sum(), minCoeff(), maxCoeff(), MatrixBase::squaredNorm(), VectorwiseOp::reductions()
+  */
+template<typename Derived>
+template<int Options>
+inline const Reductions<typename internal::traits<Derived>::Scalar,Options>
+DenseBase<Derived>::reductions() const
+{
+  return Reductions<Scalar,Options>(derived());
+}
+
+/** \returns the sum, minimum, maximum and squared norm of each column (or row), those of them
+  * requested by \a Options, computed in a single pass.
+  *
+  * \sa class VectorwiseReductions, DenseBase::reductions()
+  */
+template<typename ExpressionType, int Direction>
+template<int Options>
+inline const VectorwiseReductions<typename VectorwiseOp<ExpressionType,Direction>::Scalar,Options,Direction>
+VectorwiseOp<ExpressionType,Direction>::reductions() const
+{
+  return VectorwiseReductions<Scalar,Options,Direction>(_expression());
+}
+
+#endif // EIGEN_FUSEDREDUX_H
@@ -77,7 +77,9 @@ struct default_packet_traits
     HasTan    = 0,
     HasASin   = 0,
     HasACos   = 0,
-    HasATan   = 0
+    HasATan   = 0,
+    HasTanh   = 0,
+    HasLogistic = 0
   };
 };
 
@@ -161,6 +163,23 @@ pxor(const Packet& a, const Packet& b) { return a ^ b; }
 template<typename Packet> inline Packet
 pandnot(const Packet& a, const Packet& b) { return a & (!b); }
 
+/** \internal \returns a mask of the coefficients for which \a a < \a b, that is all bits set
+  * for vectorized types, and 1 for scalar types (coeff-wise) */
+template<typename Packet> inline Packet
+pcmp_lt(const Packet& a, const Packet& b) { return a < b ? Packet(1) : Packet(0); }
+
+/** \internal \returns a mask of the coefficients for which \a a <= \a b (coeff-wise) */
+template<typename Packet> inline Packet
+pcmp_le(const Packet& a, const Packet& b) { return a <= b ? Packet(1) : Packet(0); }
+
+/** \internal \returns a mask of the coefficients for which \a a == \a b (coeff-wise) */
+template<typename Packet> inline Packet
+pcmp_eq(const Packet& a, const Packet& b) { return a == b ? Packet(1) : Packet(0); }
+
+/** \internal \returns \a a where \a mask is set and \a b elsewhere (coeff-wise) */
+template<typename Packet> inline Packet
+pselect(const Packet& mask, const Packet& a, const Packet& b) { return mask != Packet(0) ? a : b; }
+
 /** \internal \returns a packet version of \a *from, from must be 16 bytes aligned */
 template<typename Packet> inline Packet
 pload(const typename unpacket_traits<Packet>::type* from) { return *from; }
@@ -254,6 +273,26 @@ Packet pasin(const Packet& a) { return asin(a); }
 template<typename Packet> EIGEN_DECLARE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS
 Packet pacos(const Packet& a) { return acos(a); }
 
+/** \internal \returns the arc tangent of \a a (coeff-wise) */
+template<typename Packet> EIGEN_DECLARE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS
+Packet patan(const Packet& a) { return atan(a); }
+
+/** \internal \returns the arc tangent of \a a / \a b using the signs of both arguments (coeff-wise) */
+template<typename Packet> EIGEN_DECLARE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS
+Packet patan2(const Packet& a, const Packet& b) { return atan2(a, b); }
+
+/** \internal \returns the hyperbolic tangent of \a a (coeff-wise) */
+template<typename Packet> EIGEN_DECLARE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS
+Packet ptanh(const Packet& a) { return tanh(a); }
+
+/** \internal \returns the logistic function 1/(1+exp(-a)) of \a a (coeff-wise) */
+template<typename Packet> EIGEN_DECLARE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS
+Packet plogistic(const Packet& a) { return logistic(a); }
+
+/** \internal \returns \a a to the power \a b (coeff-wise) */
+template<typename Packet> EIGEN_DECLARE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS
+Packet ppow(const Packet& a, const Packet& b) { return pow(a, b); }
+
 /** \internal \returns the exp of \a a (coeff-wise) */
 template<typename Packet> EIGEN_DECLARE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS
 Packet pexp(const Packet& a) { return exp(a); }
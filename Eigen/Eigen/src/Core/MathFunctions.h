@@ -492,6 +492,8 @@ EIGEN_MATHFUNC_STANDARD_REAL_UNARY(cos)
 EIGEN_MATHFUNC_STANDARD_REAL_UNARY(tan)
 EIGEN_MATHFUNC_STANDARD_REAL_UNARY(asin)
 EIGEN_MATHFUNC_STANDARD_REAL_UNARY(acos)
+EIGEN_MATHFUNC_STANDARD_REAL_UNARY(atan)
+EIGEN_MATHFUNC_STANDARD_REAL_UNARY(tanh)
 
 /****************************************************************************
 * Implementation of atan2                                                *
@@ -582,6 +584,48 @@ inline EIGEN_MATHFUNC_RETVAL(pow, Scalar) pow(const Scalar& x, const Scalar& y)
   return EIGEN_MATHFUNC_IMPL(pow, Scalar)::run(x, y);
 }
 
+/****************************************************************************
+* Implementation of logistic                                             *
+****************************************************************************/
+
+template<typename Scalar, bool IsInteger>
+struct logistic_default_impl
+{
+  static inline Scalar run(const Scalar& x)
+  {
+    using std::exp;
+    // exp(-|x|) never overflows, and the x<0 branch keeps full relative
+    // accuracy in the left tail.
+    Scalar e = exp(x < Scalar(0) ? x : -x);
+    return (x < Scalar(0) ? e : Scalar(1)) / (Scalar(1) + e);
+  }
+};
+
+template<typename Scalar>
+struct logistic_default_impl<Scalar, true>
+{
+  static inline Scalar run(const Scalar&)
+  {
+    EIGEN_STATIC_ASSERT_NON_INTEGER(Scalar)
+    return Scalar(0);
+  }
+};
+
+template<typename Scalar>
+struct logistic_impl : logistic_default_impl<Scalar, NumTraits<Scalar>::IsInteger> {};
+
+template<typename Scalar>
+struct logistic_retval
+{
+  typedef Scalar type;
+};
+
+template<typename Scalar>
+inline EIGEN_MATHFUNC_RETVAL(logistic, Scalar) logistic(const Scalar& x)
+{
+  return EIGEN_MATHFUNC_IMPL(logistic, Scalar)::run(x);
+}
+
 /****************************************************************************
 * Implementation of random                                               *
 ****************************************************************************/
@@ -381,6 +381,8 @@ template<typename ExpressionType, int Direction> class VectorwiseOp
     const typename ReturnType<internal::member_prod>::Type prod() const
     { return _expression(); }
 
+    template<int Options> const VectorwiseReductions<Scalar,Options,Direction> reductions() const;
+
 
     /** \returns a matrix expression
       * where each column (or row) are reversed.
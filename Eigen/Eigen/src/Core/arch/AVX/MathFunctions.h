@@ -0,0 +1,164 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_MATH_FUNCTIONS_AVX_H
+#define EIGEN_MATH_FUNCTIONS_AVX_H
+
+namespace internal {
+
+EIGEN_STRONG_INLINE Packet8f pcmp_lt(const Packet8f& a, const Packet8f& b) { return _mm256_cmp_ps(a,b,_CMP_LT_OQ); }
+EIGEN_STRONG_INLINE Packet4d pcmp_lt(const Packet4d& a, const Packet4d& b) { return _mm256_cmp_pd(a,b,_CMP_LT_OQ); }
+EIGEN_STRONG_INLINE Packet8f pcmp_le(const Packet8f& a, const Packet8f& b) { return _mm256_cmp_ps(a,b,_CMP_LE_OQ); }
+EIGEN_STRONG_INLINE Packet4d pcmp_le(const Packet4d& a, const Packet4d& b) { return _mm256_cmp_pd(a,b,_CMP_LE_OQ); }
+EIGEN_STRONG_INLINE Packet8f pcmp_eq(const Packet8f& a, const Packet8f& b) { return _mm256_cmp_ps(a,b,_CMP_EQ_OQ); }
+EIGEN_STRONG_INLINE Packet4d pcmp_eq(const Packet4d& a, const Packet4d& b) { return _mm256_cmp_pd(a,b,_CMP_EQ_OQ); }
+
+/* returns a where mask is set, and b elsewhere */
+EIGEN_STRONG_INLINE Packet8f pselect(const Packet8f& mask, const Packet8f& a, const Packet8f& b) { return _mm256_blendv_ps(b,a,mask); }
+EIGEN_STRONG_INLINE Packet4d pselect(const Packet4d& mask, const Packet4d& a, const Packet4d& b) { return _mm256_blendv_pd(b,a,mask); }
+
+// The transcendental functions are evaluated on the two 128 bits halves
+// with the SSE implementations of arch/SSE/MathFunctions.h.
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet8f plog<Packet8f>(const Packet8f& x)
+{
+  return pcombine(plog(plower(x)), plog(pupper(x)));
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet8f pexp<Packet8f>(const Packet8f& x)
+{
+  return pcombine(pexp(plower(x)), pexp(pupper(x)));
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet8f psin<Packet8f>(const Packet8f& x)
+{
+  return pcombine(psin(plower(x)), psin(pupper(x)));
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet8f pcos<Packet8f>(const Packet8f& x)
+{
+  return pcombine(pcos(plower(x)), pcos(pupper(x)));
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet8f psqrt<Packet8f>(const Packet8f& x)
+{
+  return _mm256_sqrt_ps(x);
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet8f patan<Packet8f>(const Packet8f& x)
+{
+  return pcombine(patan(plower(x)), patan(pupper(x)));
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet8f ptanh<Packet8f>(const Packet8f& x)
+{
+  return pcombine(ptanh(plower(x)), ptanh(pupper(x)));
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet8f plogistic<Packet8f>(const Packet8f& x)
+{
+  return pcombine(plogistic(plower(x)), plogistic(pupper(x)));
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet8f patan2<Packet8f>(const Packet8f& a, const Packet8f& b)
+{
+  return pcombine(patan2(plower(a), plower(b)), patan2(pupper(a), pupper(b)));
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet8f ppow<Packet8f>(const Packet8f& a, const Packet8f& b)
+{
+  return pcombine(ppow(plower(a), plower(b)), ppow(pupper(a), pupper(b)));
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet4d plog<Packet4d>(const Packet4d& x)
+{
+  return pcombine(plog(plower(x)), plog(pupper(x)));
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet4d pexp<Packet4d>(const Packet4d& x)
+{
+  return pcombine(pexp(plower(x)), pexp(pupper(x)));
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet4d psin<Packet4d>(const Packet4d& x)
+{
+  return pcombine(psin(plower(x)), psin(pupper(x)));
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet4d pcos<Packet4d>(const Packet4d& x)
+{
+  return pcombine(pcos(plower(x)), pcos(pupper(x)));
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet4d psqrt<Packet4d>(const Packet4d& x)
+{
+  return _mm256_sqrt_pd(x);
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet4d patan<Packet4d>(const Packet4d& x)
+{
+  return pcombine(patan(plower(x)), patan(pupper(x)));
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet4d ptanh<Packet4d>(const Packet4d& x)
+{
+  return pcombine(ptanh(plower(x)), ptanh(pupper(x)));
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet4d plogistic<Packet4d>(const Packet4d& x)
+{
+  return pcombine(plogistic(plower(x)), plogistic(pupper(x)));
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet4d patan2<Packet4d>(const Packet4d& a, const Packet4d& b)
+{
+  return pcombine(patan2(plower(a), plower(b)), patan2(pupper(a), pupper(b)));
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet4d ppow<Packet4d>(const Packet4d& a, const Packet4d& b)
+{
+  return pcombine(ppow(plower(a), plower(b)), ppow(pupper(a), pupper(b)));
+}
+
+} // end namespace internal
+
+#endif // EIGEN_MATH_FUNCTIONS_AVX_H
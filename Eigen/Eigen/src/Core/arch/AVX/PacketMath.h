@@ -0,0 +1,298 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_PACKET_MATH_AVX_H
+#define EIGEN_PACKET_MATH_AVX_H
+
+namespace internal {
+
+// This file is included after arch/SSE/PacketMath.h: the 128 bits packets
+// are still used for int and as the halves of the 256 bits packets.
+
+typedef __m256  Packet8f;
+typedef __m256d Packet4d;
+
+template<> struct is_arithmetic<__m256>  { enum { value = true }; };
+template<> struct is_arithmetic<__m256d> { enum { value = true }; };
+
+#define _EIGEN_DECLARE_CONST_Packet8f(NAME,X) \
+  const Packet8f p8f_##NAME = pset1<Packet8f>(X)
+
+#define _EIGEN_DECLARE_CONST_Packet4d(NAME,X) \
+  const Packet4d p4d_##NAME = pset1<Packet4d>(X)
+
+template<> struct packet_traits<float>  : default_packet_traits
+{
+  typedef Packet8f type;
+  enum {
+    Vectorizable = 1,
+    AlignedOnScalar = 1,
+    size=8,
+
+    HasDiv    = 1,
+    HasSin  = EIGEN_FAST_MATH,
+    HasCos  = EIGEN_FAST_MATH,
+    HasLog  = 1,
+    HasExp  = 1,
+    HasSqrt = 1,
+    HasPow  = 1,
+    HasATan = 1,
+    HasTanh = 1,
+    HasLogistic = 1
+  };
+};
+template<> struct packet_traits<double> : default_packet_traits
+{
+  typedef Packet4d type;
+  enum {
+    Vectorizable = 1,
+    AlignedOnScalar = 1,
+    size=4,
+
+    HasDiv    = 1,
+    HasSin  = EIGEN_FAST_MATH,
+    HasCos  = EIGEN_FAST_MATH,
+    HasLog  = 1,
+    HasExp  = 1,
+    HasSqrt = 1,
+    HasPow  = EIGEN_FAST_POW,
+    HasATan = 1,
+    HasTanh = 1,
+    HasLogistic = 1
+  };
+};
+
+template<> struct unpacket_traits<Packet8f> { typedef float  type; enum {size=8}; };
+template<> struct unpacket_traits<Packet4d> { typedef double type; enum {size=4}; };
+
+// Helpers to split a packet into its 128 bits halves and to join them back.
+EIGEN_STRONG_INLINE Packet4f plower(const Packet8f& a) { return _mm256_castps256_ps128(a); }
+EIGEN_STRONG_INLINE Packet4f pupper(const Packet8f& a) { return _mm256_extractf128_ps(a, 1); }
+EIGEN_STRONG_INLINE Packet2d plower(const Packet4d& a) { return _mm256_castpd256_pd128(a); }
+EIGEN_STRONG_INLINE Packet2d pupper(const Packet4d& a) { return _mm256_extractf128_pd(a, 1); }
+EIGEN_STRONG_INLINE Packet8f pcombine(const Packet4f& lo, const Packet4f& hi) { return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1); }
+EIGEN_STRONG_INLINE Packet4d pcombine(const Packet2d& lo, const Packet2d& hi) { return _mm256_insertf128_pd(_mm256_castpd128_pd256(lo), hi, 1); }
+
+template<> EIGEN_STRONG_INLINE Packet8f pset1<Packet8f>(const float&  from) { return _mm256_set1_ps(from); }
+template<> EIGEN_STRONG_INLINE Packet4d pset1<Packet4d>(const double& from) { return _mm256_set1_pd(from); }
+
+template<> EIGEN_STRONG_INLINE Packet8f plset<float>(const float& a) { return _mm256_add_ps(pset1<Packet8f>(a), _mm256_set_ps(7,6,5,4,3,2,1,0)); }
+template<> EIGEN_STRONG_INLINE Packet4d plset<double>(const double& a) { return _mm256_add_pd(pset1<Packet4d>(a), _mm256_set_pd(3,2,1,0)); }
+
+template<> EIGEN_STRONG_INLINE Packet8f padd<Packet8f>(const Packet8f& a, const Packet8f& b) { return _mm256_add_ps(a,b); }
+template<> EIGEN_STRONG_INLINE Packet4d padd<Packet4d>(const Packet4d& a, const Packet4d& b) { return _mm256_add_pd(a,b); }
+
+template<> EIGEN_STRONG_INLINE Packet8f psub<Packet8f>(const Packet8f& a, const Packet8f& b) { return _mm256_sub_ps(a,b); }
+template<> EIGEN_STRONG_INLINE Packet4d psub<Packet4d>(const Packet4d& a, const Packet4d& b) { return _mm256_sub_pd(a,b); }
+
+template<> EIGEN_STRONG_INLINE Packet8f pnegate(const Packet8f& a)
+{
+  return _mm256_xor_ps(a, _mm256_set1_ps(-0.0f));
+}
+template<> EIGEN_STRONG_INLINE Packet4d pnegate(const Packet4d& a)
+{
+  return _mm256_xor_pd(a, _mm256_set1_pd(-0.0));
+}
+
+template<> EIGEN_STRONG_INLINE Packet8f pmul<Packet8f>(const Packet8f& a, const Packet8f& b) { return _mm256_mul_ps(a,b); }
+template<> EIGEN_STRONG_INLINE Packet4d pmul<Packet4d>(const Packet4d& a, const Packet4d& b) { return _mm256_mul_pd(a,b); }
+
+template<> EIGEN_STRONG_INLINE Packet8f pdiv<Packet8f>(const Packet8f& a, const Packet8f& b) { return _mm256_div_ps(a,b); }
+template<> EIGEN_STRONG_INLINE Packet4d pdiv<Packet4d>(const Packet4d& a, const Packet4d& b) { return _mm256_div_pd(a,b); }
+
+#ifdef EIGEN_VECTORIZE_FMA
+template<> EIGEN_STRONG_INLINE Packet8f pmadd(const Packet8f& a, const Packet8f& b, const Packet8f& c) { return _mm256_fmadd_ps(a,b,c); }
+template<> EIGEN_STRONG_INLINE Packet4d pmadd(const Packet4d& a, const Packet4d& b, const Packet4d& c) { return _mm256_fmadd_pd(a,b,c); }
+#endif
+
+template<> EIGEN_STRONG_INLINE Packet8f pmin<Packet8f>(const Packet8f& a, const Packet8f& b) { return _mm256_min_ps(a,b); }
+template<> EIGEN_STRONG_INLINE Packet4d pmin<Packet4d>(const Packet4d& a, const Packet4d& b) { return _mm256_min_pd(a,b); }
+
+template<> EIGEN_STRONG_INLINE Packet8f pmax<Packet8f>(const Packet8f& a, const Packet8f& b) { return _mm256_max_ps(a,b); }
+template<> EIGEN_STRONG_INLINE Packet4d pmax<Packet4d>(const Packet4d& a, const Packet4d& b) { return _mm256_max_pd(a,b); }
+
+template<> EIGEN_STRONG_INLINE Packet8f pand<Packet8f>(const Packet8f& a, const Packet8f& b) { return _mm256_and_ps(a,b); }
+template<> EIGEN_STRONG_INLINE Packet4d pand<Packet4d>(const Packet4d& a, const Packet4d& b) { return _mm256_and_pd(a,b); }
+
+template<> EIGEN_STRONG_INLINE Packet8f por<Packet8f>(const Packet8f& a, const Packet8f& b) { return _mm256_or_ps(a,b); }
+template<> EIGEN_STRONG_INLINE Packet4d por<Packet4d>(const Packet4d& a, const Packet4d& b) { return _mm256_or_pd(a,b); }
+
+template<> EIGEN_STRONG_INLINE Packet8f pxor<Packet8f>(const Packet8f& a, const Packet8f& b) { return _mm256_xor_ps(a,b); }
+template<> EIGEN_STRONG_INLINE Packet4d pxor<Packet4d>(const Packet4d& a, const Packet4d& b) { return _mm256_xor_pd(a,b); }
+
+template<> EIGEN_STRONG_INLINE Packet8f pandnot<Packet8f>(const Packet8f& a, const Packet8f& b) { return _mm256_andnot_ps(a,b); }
+template<> EIGEN_STRONG_INLINE Packet4d pandnot<Packet4d>(const Packet4d& a, const Packet4d& b) { return _mm256_andnot_pd(a,b); }
+
+// The rest of Eigen only guarantees a 16 bytes alignment, so the "aligned" loads
+// and stores are performed with the unaligned instructions. On AVX hardware these
+// are as fast as the aligned ones when the address happens to be aligned.
+template<> EIGEN_STRONG_INLINE Packet8f pload<Packet8f>(const float*   from) { EIGEN_DEBUG_ALIGNED_LOAD return _mm256_loadu_ps(from); }
+template<> EIGEN_STRONG_INLINE Packet4d pload<Packet4d>(const double*  from) { EIGEN_DEBUG_ALIGNED_LOAD return _mm256_loadu_pd(from); }
+
+template<> EIGEN_STRONG_INLINE Packet8f ploadu<Packet8f>(const float*  from) { EIGEN_DEBUG_UNALIGNED_LOAD return _mm256_loadu_ps(from); }
+template<> EIGEN_STRONG_INLINE Packet4d ploadu<Packet4d>(const double* from) { EIGEN_DEBUG_UNALIGNED_LOAD return _mm256_loadu_pd(from); }
+
+// Loads 4 floats and duplicates each of them: (a0,a0,a1,a1,a2,a2,a3,a3)
+template<> EIGEN_STRONG_INLINE Packet8f ploaddup<Packet8f>(const float* from)
+{
+  Packet4f tmp = ploadu<Packet4f>(from);
+  return pcombine(_mm_unpacklo_ps(tmp,tmp), _mm_unpackhi_ps(tmp,tmp));
+}
+// Loads 2 doubles and duplicates each of them: (a0,a0,a1,a1)
+template<> EIGEN_STRONG_INLINE Packet4d ploaddup<Packet4d>(const double* from)
+{
+  return pcombine(pset1<Packet2d>(from[0]), pset1<Packet2d>(from[1]));
+}
+
+template<> EIGEN_STRONG_INLINE void pstore<float>(float*   to, const Packet8f& from) { EIGEN_DEBUG_ALIGNED_STORE _mm256_storeu_ps(to, from); }
+template<> EIGEN_STRONG_INLINE void pstore<double>(double* to, const Packet4d& from) { EIGEN_DEBUG_ALIGNED_STORE _mm256_storeu_pd(to, from); }
+
+template<> EIGEN_STRONG_INLINE void pstoreu<float>(float*   to, const Packet8f& from) { EIGEN_DEBUG_UNALIGNED_STORE _mm256_storeu_ps(to, from); }
+template<> EIGEN_STRONG_INLINE void pstoreu<double>(double* to, const Packet4d& from) { EIGEN_DEBUG_UNALIGNED_STORE _mm256_storeu_pd(to, from); }
+
+template<> EIGEN_STRONG_INLINE float  pfirst<Packet8f>(const Packet8f& a) { return pfirst(plower(a)); }
+template<> EIGEN_STRONG_INLINE double pfirst<Packet4d>(const Packet4d& a) { return pfirst(plower(a)); }
+
+template<> EIGEN_STRONG_INLINE Packet8f preverse(const Packet8f& a)
+{
+  Packet8f tmp = _mm256_shuffle_ps(a,a,0x1B);
+  return _mm256_permute2f128_ps(tmp, tmp, 1);
+}
+template<> EIGEN_STRONG_INLINE Packet4d preverse(const Packet4d& a)
+{
+  Packet4d tmp = _mm256_shuffle_pd(a,a,5);
+  return _mm256_permute2f128_pd(tmp, tmp, 1);
+}
+
+template<> EIGEN_STRONG_INLINE Packet8f pabs(const Packet8f& a)
+{
+  return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a);
+}
+template<> EIGEN_STRONG_INLINE Packet4d pabs(const Packet4d& a)
+{
+  return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a);
+}
+
+template<> EIGEN_STRONG_INLINE Packet8f preduxp<Packet8f>(const Packet8f* vecs)
+{
+  // pairwise sums within the lanes, then add the two lanes
+  Packet8f tmp0 = _mm256_hadd_ps(_mm256_hadd_ps(vecs[0], vecs[1]), _mm256_hadd_ps(vecs[2], vecs[3]));
+  Packet8f tmp1 = _mm256_hadd_ps(_mm256_hadd_ps(vecs[4], vecs[5]), _mm256_hadd_ps(vecs[6], vecs[7]));
+  return _mm256_add_ps(_mm256_permute2f128_ps(tmp0, tmp1, 0x20), _mm256_permute2f128_ps(tmp0, tmp1, 0x31));
+}
+template<> EIGEN_STRONG_INLINE Packet4d preduxp<Packet4d>(const Packet4d* vecs)
+{
+  Packet4d tmp0 = _mm256_hadd_pd(vecs[0], vecs[1]);
+  Packet4d tmp1 = _mm256_hadd_pd(vecs[2], vecs[3]);
+  return _mm256_add_pd(_mm256_permute2f128_pd(tmp0, tmp1, 0x20), _mm256_permute2f128_pd(tmp0, tmp1, 0x31));
+}
+
+// The reductions first combine the two halves, then reuse the SSE versions.
+template<> EIGEN_STRONG_INLINE float predux<Packet8f>(const Packet8f& a)
+{
+  return predux(_mm_add_ps(plower(a), pupper(a)));
+}
+template<> EIGEN_STRONG_INLINE double predux<Packet4d>(const Packet4d& a)
+{
+  return predux(_mm_add_pd(plower(a), pupper(a)));
+}
+
+template<> EIGEN_STRONG_INLINE float predux_mul<Packet8f>(const Packet8f& a)
+{
+  return predux_mul(_mm_mul_ps(plower(a), pupper(a)));
+}
+template<> EIGEN_STRONG_INLINE double predux_mul<Packet4d>(const Packet4d& a)
+{
+  return predux_mul(_mm_mul_pd(plower(a), pupper(a)));
+}
+
+template<> EIGEN_STRONG_INLINE float predux_min<Packet8f>(const Packet8f& a)
+{
+  return predux_min(_mm_min_ps(plower(a), pupper(a)));
+}
+template<> EIGEN_STRONG_INLINE double predux_min<Packet4d>(const Packet4d& a)
+{
+  return predux_min(_mm_min_pd(plower(a), pupper(a)));
+}
+
+template<> EIGEN_STRONG_INLINE float predux_max<Packet8f>(const Packet8f& a)
+{
+  return predux_max(_mm_max_ps(plower(a), pupper(a)));
+}
+template<> EIGEN_STRONG_INLINE double predux_max<Packet4d>(const Packet4d& a)
+{
+  return predux_max(_mm_max_pd(plower(a), pupper(a)));
+}
+
+// Shifts the concatenation of the 128 bits lanes of hi and lo by Bytes bytes,
+// independently for each lane (i.e., a per lane palignr).
+template<int Bytes>
+EIGEN_STRONG_INLINE __m256i palignr_lanes(const __m256i& hi, const __m256i& lo)
+{
+#ifdef EIGEN_VECTORIZE_AVX2
+  return _mm256_alignr_epi8(hi, lo, Bytes);
+#else
+  __m128i rlo = _mm_alignr_epi8(_mm256_castsi256_si128(hi), _mm256_castsi256_si128(lo), Bytes);
+  __m128i rhi = _mm_alignr_epi8(_mm256_extractf128_si256(hi, 1), _mm256_extractf128_si256(lo, 1), Bytes);
+  return _mm256_insertf128_si256(_mm256_castsi128_si256(rlo), rhi, 1);
+#endif
+}
+
+// first <- (first[Offset], ..., first[7], second[0], ..., second[Offset-1])
+template<int Offset>
+struct palign_impl<Offset,Packet8f>
+{
+  EIGEN_STRONG_INLINE static void run(Packet8f& first, const Packet8f& second)
+  {
+    if (Offset==0)
+      return;
+    // the upper lane of first followed by the lower lane of second
+    Packet8f mid = _mm256_permute2f128_ps(first, second, 0x21);
+    if (Offset==4)
+      first = mid;
+    else if (Offset<4)
+      first = _mm256_castsi256_ps(palignr_lanes<(Offset%4)*4>(_mm256_castps_si256(mid), _mm256_castps_si256(first)));
+    else
+      first = _mm256_castsi256_ps(palignr_lanes<(Offset%4)*4>(_mm256_castps_si256(second), _mm256_castps_si256(mid)));
+  }
+};
+
+template<int Offset>
+struct palign_impl<Offset,Packet4d>
+{
+  EIGEN_STRONG_INLINE static void run(Packet4d& first, const Packet4d& second)
+  {
+    if (Offset==0)
+      return;
+    Packet4d mid = _mm256_permute2f128_pd(first, second, 0x21);
+    if (Offset==2)
+      first = mid;
+    else if (Offset<2)
+      first = _mm256_castsi256_pd(palignr_lanes<(Offset%2)*8>(_mm256_castpd_si256(mid), _mm256_castpd_si256(first)));
+    else
+      first = _mm256_castsi256_pd(palignr_lanes<(Offset%2)*8>(_mm256_castpd_si256(second), _mm256_castpd_si256(mid)));
+  }
+};
+
+} // end namespace internal
+
+#endif // EIGEN_PACKET_MATH_AVX_H
@@ -390,6 +390,604 @@ Packet4f psqrt<Packet4f>(const Packet4f& _x)
   return pmul(_x,x);
 }
 
+/* Comparison masks, blending and rounding shared by the functions below. */
+
+EIGEN_STRONG_INLINE Packet4f pcmp_lt(const Packet4f& a, const Packet4f& b) { return _mm_cmplt_ps(a,b); }
+EIGEN_STRONG_INLINE Packet2d pcmp_lt(const Packet2d& a, const Packet2d& b) { return _mm_cmplt_pd(a,b); }
+EIGEN_STRONG_INLINE Packet4f pcmp_le(const Packet4f& a, const Packet4f& b) { return _mm_cmple_ps(a,b); }
+EIGEN_STRONG_INLINE Packet2d pcmp_le(const Packet2d& a, const Packet2d& b) { return _mm_cmple_pd(a,b); }
+EIGEN_STRONG_INLINE Packet4f pcmp_eq(const Packet4f& a, const Packet4f& b) { return _mm_cmpeq_ps(a,b); }
+EIGEN_STRONG_INLINE Packet2d pcmp_eq(const Packet2d& a, const Packet2d& b) { return _mm_cmpeq_pd(a,b); }
+EIGEN_STRONG_INLINE Packet4f pisnan(const Packet4f& a) { return _mm_cmpunord_ps(a,a); }
+EIGEN_STRONG_INLINE Packet2d pisnan(const Packet2d& a) { return _mm_cmpunord_pd(a,a); }
+
+/* returns a where mask is set, and b elsewhere */
+EIGEN_STRONG_INLINE Packet4f pselect(const Packet4f& mask, const Packet4f& a, const Packet4f& b)
+{ return _mm_or_ps(_mm_and_ps(mask,a), _mm_andnot_ps(mask,b)); }
+EIGEN_STRONG_INLINE Packet2d pselect(const Packet2d& mask, const Packet2d& a, const Packet2d& b)
+{ return _mm_or_pd(_mm_and_pd(mask,a), _mm_andnot_pd(mask,b)); }
+
+EIGEN_STRONG_INLINE Packet4f pfloor(const Packet4f& a)
+{
+  // truncate and fix negative non integers, values above 2^23 are already integers
+  Packet4f r = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+  r = psub(r, _mm_and_ps(_mm_cmpgt_ps(r, a), pset1<Packet4f>(1.0f)));
+  return pselect(_mm_cmplt_ps(pabs(a), pset1<Packet4f>(8388608.0f)), r, a);
+}
+
+EIGEN_STRONG_INLINE Packet2d pfloor(const Packet2d& a)
+{
+  // adding 1.5*2^52 rounds to the nearest integer, values above 2^52 are already integers
+  const Packet2d magic = pset1<Packet2d>(6755399441055744.0);
+  Packet2d r = psub(padd(a, magic), magic);
+  r = psub(r, _mm_and_pd(_mm_cmpgt_pd(r, a), pset1<Packet2d>(1.0)));
+  return pselect(_mm_cmplt_pd(pabs(a), pset1<Packet2d>(4503599627370496.0)), r, a);
+}
+
+/* 2^n for integral n in [-1022,1023], written directly in the exponent field */
+EIGEN_STRONG_INLINE Packet2d pexp2i(const Packet2d& n)
+{
+  // the low bits of 2^52+1023+n hold the biased exponent
+  const Packet2d bias = pset1<Packet2d>(4503599627371519.0);
+  return _mm_castsi128_pd(_mm_slli_epi64(_mm_castpd_si128(padd(n, bias)), 52));
+}
+
+/* The double precision functions below are the cephes exp, log, sin, cos,
+   atan and tanh, evaluated with rational approximations of the same degree.
+
+   Maximal errors measured against the long double C library on 2*10^6
+   random arguments:
+     pexp                 2 ulp
+     plog, patan, ptanh   1 ulp
+     psin, pcos           1 ulp for |x| < 10^6, the three parts reduction
+                          loses accuracy for larger arguments (hence they
+                          require EIGEN_FAST_MATH)
+     plogistic            3 ulp
+     patan2               2 ulp
+     ppow                 2 + 2|b log(a)| ulp, the rounding errors of b*log(a)
+                          being amplified by exp (hence it requires EIGEN_FAST_POW)
+   and for the float versions:
+     ptanh                1 ulp
+     plogistic            2 ulp
+     patan, patan2        3 ulp
+     ppow                 1 ulp, being evaluated in double precision
+   NaNs are propagated and infinite or zero arguments are handled as in the
+   C library, except for the sign of zero and for patan2 of two infinities.
+*/
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet2d pexp<Packet2d>(const Packet2d& _x)
+{
+  _EIGEN_DECLARE_CONST_Packet2d(1 , 1.0);
+  _EIGEN_DECLARE_CONST_Packet2d(2 , 2.0);
+  _EIGEN_DECLARE_CONST_Packet2d(half, 0.5);
+
+  // beyond these bounds the result is inf or 0
+  _EIGEN_DECLARE_CONST_Packet2d(exp_hi, 709.79);
+  _EIGEN_DECLARE_CONST_Packet2d(exp_lo, -745.2);
+
+  _EIGEN_DECLARE_CONST_Packet2d(round, 6755399441055744.0);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_LOG2E, 1.4426950408889634073599);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_exp_C1, 0.693145751953125);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_exp_C2, 1.42860682030941723212e-6);
+
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_exp_p0, 1.26177193074810590878e-4);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_exp_p1, 3.02994407707441961300e-2);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_exp_p2, 9.99999999999999999910e-1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_exp_q0, 3.00198505138664455042e-6);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_exp_q1, 2.52448340349684104192e-3);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_exp_q2, 2.27265548208155028766e-1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_exp_q3, 2.00000000000000000009e0);
+
+  Packet2d x = pmax(pmin(_x, p2d_exp_hi), p2d_exp_lo);
+
+  /* express exp(x) as exp(g + n*log(2)), n being rounded to the nearest
+     integer by adding and subtracting 1.5*2^52 */
+  Packet2d fx = psub(padd(pmul(x, p2d_cephes_LOG2E), p2d_round), p2d_round);
+  x = psub(x, pmul(fx, p2d_cephes_exp_C1));
+  x = psub(x, pmul(fx, p2d_cephes_exp_C2));
+
+  /* exp(g) = 1 + 2*P(g^2)*g / (Q(g^2) - P(g^2)*g) */
+  Packet2d x2 = pmul(x,x);
+  Packet2d px = p2d_cephes_exp_p0;
+  px = pmadd(px, x2, p2d_cephes_exp_p1);
+  px = pmadd(px, x2, p2d_cephes_exp_p2);
+  px = pmul(px, x);
+  Packet2d qx = p2d_cephes_exp_q0;
+  qx = pmadd(qx, x2, p2d_cephes_exp_q1);
+  qx = pmadd(qx, x2, p2d_cephes_exp_q2);
+  qx = pmadd(qx, x2, p2d_cephes_exp_q3);
+  x = pdiv(px, psub(qx, px));
+  x = pmadd(p2d_2, x, p2d_1);
+
+  /* multiply by 2^n in two steps so that n may lie outside of the normal exponent range */
+  Packet2d n1 = psub(padd(pmul(fx, p2d_half), p2d_round), p2d_round);
+  x = pmul(pmul(x, pexp2i(n1)), pexp2i(psub(fx, n1)));
+  return _mm_or_pd(x, pisnan(_x));
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet2d plog<Packet2d>(const Packet2d& _x)
+{
+  Packet2d x = _x;
+  _EIGEN_DECLARE_CONST_Packet2d(1 , 1.0);
+  _EIGEN_DECLARE_CONST_Packet2d(half, 0.5);
+  _EIGEN_DECLARE_CONST_Packet2d(inf, std::numeric_limits<double>::infinity());
+  _EIGEN_DECLARE_CONST_Packet2d(minus_inf, -std::numeric_limits<double>::infinity());
+
+  _EIGEN_DECLARE_CONST_Packet2d_FROM_INT64(inv_mant_mask, ~0x7ff0000000000000LL);
+
+  /* the smallest non denormalized double number, denormals are scaled by 2^54 */
+  _EIGEN_DECLARE_CONST_Packet2d_FROM_INT64(min_norm_pos, 0x0010000000000000LL);
+  _EIGEN_DECLARE_CONST_Packet2d(2p54, 18014398509481984.0);
+  _EIGEN_DECLARE_CONST_Packet2d(54, 54.0);
+
+  /* 2^52 and the exponent bias, to convert the exponent bits to a double */
+  _EIGEN_DECLARE_CONST_Packet2d(2p52, 4503599627370496.0);
+  _EIGEN_DECLARE_CONST_Packet2d(1022, 1022.0);
+
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_SQRTH, 0.70710678118654752440);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_log_p0, 1.01875663804580931796e-4);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_log_p1, 4.97494994976747001425e-1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_log_p2, 4.70579119878881725854e0);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_log_p3, 1.44989225341610930846e1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_log_p4, 1.79368678507819816313e1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_log_p5, 7.70838733755885391666e0);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_log_q0, 1.12873587189167450590e1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_log_q1, 4.52279145837532221105e1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_log_q2, 8.29875266912776603211e1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_log_q3, 7.11544750618563894466e1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_log_q4, 2.31251620126765340583e1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_log_C1, 2.121944400546905827679e-4);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_log_C2, 0.693359375);
+
+  /* negative arguments and NaNs give NaN */
+  Packet2d invalid_mask = _mm_cmpnge_pd(x, _mm_setzero_pd());
+  Packet2d zero_mask = _mm_cmpeq_pd(x, _mm_setzero_pd());
+  Packet2d inf_mask = _mm_cmpeq_pd(x, p2d_inf);
+
+  Packet2d denorm_mask = _mm_cmplt_pd(x, p2d_min_norm_pos);
+  x = pselect(denorm_mask, pmul(x, p2d_2p54), x);
+
+  Packet2d e = _mm_castsi128_pd(_mm_or_si128(_mm_srli_epi64(_mm_castpd_si128(x), 52), _mm_castpd_si128(p2d_2p52)));
+  e = psub(psub(e, p2d_2p52), p2d_1022);
+  e = psub(e, _mm_and_pd(denorm_mask, p2d_54));
+
+  /* keep only the fractional part, in [0.5,1[ */
+  x = _mm_or_pd(_mm_and_pd(x, p2d_inv_mant_mask), p2d_half);
+
+  /* if( x < SQRTH ) { e -= 1; x = x + x - 1.0; } else { x = x - 1.0; } */
+  Packet2d mask = _mm_cmplt_pd(x, p2d_cephes_SQRTH);
+  Packet2d tmp = _mm_and_pd(x, mask);
+  x = psub(x, p2d_1);
+  e = psub(e, _mm_and_pd(p2d_1, mask));
+  x = padd(x, tmp);
+
+  /* log(1+x) = x - x^2/2 + x^3 P(x)/Q(x) */
+  Packet2d x2 = pmul(x,x);
+  Packet2d p = p2d_cephes_log_p0;
+  p = pmadd(p, x, p2d_cephes_log_p1);
+  p = pmadd(p, x, p2d_cephes_log_p2);
+  p = pmadd(p, x, p2d_cephes_log_p3);
+  p = pmadd(p, x, p2d_cephes_log_p4);
+  p = pmadd(p, x, p2d_cephes_log_p5);
+  Packet2d q = padd(x, p2d_cephes_log_q0);
+  q = pmadd(q, x, p2d_cephes_log_q1);
+  q = pmadd(q, x, p2d_cephes_log_q2);
+  q = pmadd(q, x, p2d_cephes_log_q3);
+  q = pmadd(q, x, p2d_cephes_log_q4);
+  Packet2d y = pmul(pmul(x, x2), pdiv(p, q));
+
+  /* add e*log(2), split in two parts */
+  y = psub(y, pmul(e, p2d_cephes_log_C1));
+  y = psub(y, pmul(x2, p2d_half));
+  x = padd(x, y);
+  x = padd(x, pmul(e, p2d_cephes_log_C2));
+
+  x = pselect(inf_mask, p2d_inf, x);
+  x = pselect(zero_mask, p2d_minus_inf, x);
+  return _mm_or_pd(x, invalid_mask);
+}
+
+/* sine and cosine share the cephes reduction modulo Pi/4 with a
+   three parts Pi/4, the octant selecting the polynomial and the sign */
+template<bool Cosine>
+EIGEN_STRONG_INLINE Packet2d psincos_double(const Packet2d& _x)
+{
+  _EIGEN_DECLARE_CONST_Packet2d(1 , 1.0);
+  _EIGEN_DECLARE_CONST_Packet2d(2 , 2.0);
+  _EIGEN_DECLARE_CONST_Packet2d(4 , 4.0);
+  _EIGEN_DECLARE_CONST_Packet2d(8 , 8.0);
+  _EIGEN_DECLARE_CONST_Packet2d(half, 0.5);
+  _EIGEN_DECLARE_CONST_Packet2d(eighth, 0.125);
+  _EIGEN_DECLARE_CONST_Packet2d_FROM_INT64(sign_mask, 0x8000000000000000LL);
+
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_FOPI, 1.27323954473516268615); // 4 / M_PI
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_DP1, 7.85398125648498535156e-1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_DP2, 3.77489470793079817668e-8);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_DP3, 2.69515142907905952645e-15);
+
+  _EIGEN_DECLARE_CONST_Packet2d(sincof_p0,  1.58962301576546568060e-10);
+  _EIGEN_DECLARE_CONST_Packet2d(sincof_p1, -2.50507477628578072866e-8);
+  _EIGEN_DECLARE_CONST_Packet2d(sincof_p2,  2.75573136213857245213e-6);
+  _EIGEN_DECLARE_CONST_Packet2d(sincof_p3, -1.98412698295895385996e-4);
+  _EIGEN_DECLARE_CONST_Packet2d(sincof_p4,  8.33333333332211858878e-3);
+  _EIGEN_DECLARE_CONST_Packet2d(sincof_p5, -1.66666666666666307295e-1);
+  _EIGEN_DECLARE_CONST_Packet2d(coscof_p0, -1.13585365213876817300e-11);
+  _EIGEN_DECLARE_CONST_Packet2d(coscof_p1,  2.08757008419747316778e-9);
+  _EIGEN_DECLARE_CONST_Packet2d(coscof_p2, -2.75573141792967388112e-7);
+  _EIGEN_DECLARE_CONST_Packet2d(coscof_p3,  2.48015872888517045348e-5);
+  _EIGEN_DECLARE_CONST_Packet2d(coscof_p4, -1.38888888888730564116e-3);
+  _EIGEN_DECLARE_CONST_Packet2d(coscof_p5,  4.16666666666665929218e-2);
+
+  Packet2d x = pabs(_x);
+  Packet2d sign_bit = Cosine ? _mm_setzero_pd() : _mm_and_pd(_x, p2d_sign_mask);
+
+  /* j = floor(x*4/Pi) rounded up to an even octant, j mod 8 in {0,2,4,6} */
+  Packet2d y = pfloor(pmul(x, p2d_cephes_FOPI));
+  y = padd(y, psub(y, pmul(p2d_2, pfloor(pmul(y, p2d_half)))));
+  Packet2d j = psub(y, pmul(p2d_8, pfloor(pmul(y, p2d_eighth))));
+
+  Packet2d swap_mask = _mm_cmpge_pd(j, p2d_4);
+  j = psub(j, _mm_and_pd(swap_mask, p2d_4));
+  Packet2d poly_mask = _mm_cmpeq_pd(j, p2d_2);
+  // sin uses the cosine polynomial in octant 2, and cos the sine polynomial
+  if(Cosine)
+    swap_mask = _mm_xor_pd(swap_mask, poly_mask);
+  sign_bit = _mm_xor_pd(sign_bit, _mm_and_pd(swap_mask, p2d_sign_mask));
+
+  /* The magic pass: "Extended precision modular arithmetic"
+     x = ((x - y * DP1) - y * DP2) - y * DP3; */
+  x = psub(x, pmul(y, p2d_cephes_DP1));
+  x = psub(x, pmul(y, p2d_cephes_DP2));
+  x = psub(x, pmul(y, p2d_cephes_DP3));
+  Packet2d z = pmul(x,x);
+
+  /* cos(x) = 1 - x^2/2 + x^4 C(x^2) */
+  Packet2d yc = p2d_coscof_p0;
+  yc = pmadd(yc, z, p2d_coscof_p1);
+  yc = pmadd(yc, z, p2d_coscof_p2);
+  yc = pmadd(yc, z, p2d_coscof_p3);
+  yc = pmadd(yc, z, p2d_coscof_p4);
+  yc = pmadd(yc, z, p2d_coscof_p5);
+  yc = pmul(pmul(yc, z), z);
+  yc = psub(yc, pmul(z, p2d_half));
+  yc = padd(yc, p2d_1);
+
+  /* sin(x) = x + x^3 S(x^2) */
+  Packet2d ys = p2d_sincof_p0;
+  ys = pmadd(ys, z, p2d_sincof_p1);
+  ys = pmadd(ys, z, p2d_sincof_p2);
+  ys = pmadd(ys, z, p2d_sincof_p3);
+  ys = pmadd(ys, z, p2d_sincof_p4);
+  ys = pmadd(ys, z, p2d_sincof_p5);
+  ys = pmadd(pmul(ys, z), x, x);
+
+  y = Cosine ? pselect(poly_mask, ys, yc) : pselect(poly_mask, yc, ys);
+  return _mm_xor_pd(y, sign_bit);
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet2d psin<Packet2d>(const Packet2d& x)
+{
+  return psincos_double<false>(x);
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet2d pcos<Packet2d>(const Packet2d& x)
+{
+  return psincos_double<true>(x);
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet2d psqrt<Packet2d>(const Packet2d& x)
+{
+  return _mm_sqrt_pd(x);
+}
+
+/* cephes atanf: reduction to |x| <= tan(Pi/8) with the identities
+   atan(x) = Pi/2 - atan(1/x) and atan(x) = Pi/4 + atan((x-1)/(x+1)) */
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet4f patan<Packet4f>(const Packet4f& _x)
+{
+  _EIGEN_DECLARE_CONST_Packet4f(1 , 1.0f);
+  _EIGEN_DECLARE_CONST_Packet4f(minus_1 , -1.0f);
+  _EIGEN_DECLARE_CONST_Packet4f_FROM_INT(sign_mask, 0x80000000);
+  _EIGEN_DECLARE_CONST_Packet4f(cephes_T3P8, 2.414213562373095f);
+  _EIGEN_DECLARE_CONST_Packet4f(cephes_TP8, 0.4142135623730950f);
+  _EIGEN_DECLARE_CONST_Packet4f(cephes_PIO2, 1.5707963267948966f);
+  _EIGEN_DECLARE_CONST_Packet4f(cephes_PIO4, 0.7853981633974483f);
+  _EIGEN_DECLARE_CONST_Packet4f(cephes_atan_p0,  8.05374449538e-2f);
+  _EIGEN_DECLARE_CONST_Packet4f(cephes_atan_p1, -1.38776856032e-1f);
+  _EIGEN_DECLARE_CONST_Packet4f(cephes_atan_p2,  1.99777106478e-1f);
+  _EIGEN_DECLARE_CONST_Packet4f(cephes_atan_p3, -3.33329491539e-1f);
+
+  Packet4f sign_bit = _mm_and_ps(_x, p4f_sign_mask);
+  Packet4f x = pabs(_x);
+
+  Packet4f big_mask = _mm_cmpgt_ps(x, p4f_cephes_T3P8);
+  Packet4f mid_mask = _mm_andnot_ps(big_mask, _mm_cmpgt_ps(x, p4f_cephes_TP8));
+  Packet4f y = pselect(big_mask, p4f_cephes_PIO2, _mm_and_ps(mid_mask, p4f_cephes_PIO4));
+  Packet4f num = pselect(big_mask, p4f_minus_1, pselect(mid_mask, psub(x, p4f_1), x));
+  Packet4f den = pselect(big_mask, x, pselect(mid_mask, padd(x, p4f_1), p4f_1));
+  x = pdiv(num, den);
+
+  Packet4f z = pmul(x,x);
+  Packet4f p = p4f_cephes_atan_p0;
+  p = pmadd(p, z, p4f_cephes_atan_p1);
+  p = pmadd(p, z, p4f_cephes_atan_p2);
+  p = pmadd(p, z, p4f_cephes_atan_p3);
+  y = padd(y, pmadd(pmul(p, z), x, x));
+  return _mm_xor_ps(y, sign_bit);
+}
+
+/* cephes atan: same reduction with tan(3Pi/8) and 0.66 as thresholds,
+   and the rounding error of Pi/2 added back */
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet2d patan<Packet2d>(const Packet2d& _x)
+{
+  _EIGEN_DECLARE_CONST_Packet2d(1 , 1.0);
+  _EIGEN_DECLARE_CONST_Packet2d(minus_1 , -1.0);
+  _EIGEN_DECLARE_CONST_Packet2d_FROM_INT64(sign_mask, 0x8000000000000000LL);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_T3P8, 2.41421356237309504880);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_066, 0.66);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_PIO2, 1.57079632679489661923);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_PIO4, 7.85398163397448309616e-1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_MOREBITS, 6.123233995736765886130e-17);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_HALFMOREBITS, 3.061616997868382943065e-17);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_atan_p0, -8.750608600031904122785e-1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_atan_p1, -1.615753718733365076637e1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_atan_p2, -7.500855792314704667340e1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_atan_p3, -1.228866684490136173410e2);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_atan_p4, -6.485021904942025371773e1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_atan_q0,  2.485846490142306297962e1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_atan_q1,  1.650270098316988542046e2);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_atan_q2,  4.328810604912902668951e2);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_atan_q3,  4.853903996359136964868e2);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_atan_q4,  1.945506571482613964425e2);
+
+  Packet2d sign_bit = _mm_and_pd(_x, p2d_sign_mask);
+  Packet2d x = pabs(_x);
+
+  Packet2d big_mask = _mm_cmpgt_pd(x, p2d_cephes_T3P8);
+  Packet2d mid_mask = _mm_andnot_pd(big_mask, _mm_cmpgt_pd(x, p2d_cephes_066));
+  Packet2d y = pselect(big_mask, p2d_cephes_PIO2, _mm_and_pd(mid_mask, p2d_cephes_PIO4));
+  Packet2d morebits = pselect(big_mask, p2d_cephes_MOREBITS, _mm_and_pd(mid_mask, p2d_cephes_HALFMOREBITS));
+  Packet2d num = pselect(big_mask, p2d_minus_1, pselect(mid_mask, psub(x, p2d_1), x));
+  Packet2d den = pselect(big_mask, x, pselect(mid_mask, padd(x, p2d_1), p2d_1));
+  x = pdiv(num, den);
+
+  Packet2d z = pmul(x,x);
+  Packet2d p = p2d_cephes_atan_p0;
+  p = pmadd(p, z, p2d_cephes_atan_p1);
+  p = pmadd(p, z, p2d_cephes_atan_p2);
+  p = pmadd(p, z, p2d_cephes_atan_p3);
+  p = pmadd(p, z, p2d_cephes_atan_p4);
+  Packet2d q = padd(z, p2d_cephes_atan_q0);
+  q = pmadd(q, z, p2d_cephes_atan_q1);
+  q = pmadd(q, z, p2d_cephes_atan_q2);
+  q = pmadd(q, z, p2d_cephes_atan_q3);
+  q = pmadd(q, z, p2d_cephes_atan_q4);
+  z = pmadd(pmul(z, pdiv(p, q)), x, x);
+  y = padd(y, padd(z, morebits));
+  return _mm_xor_pd(y, sign_bit);
+}
+
+/* tanh(x) = 1 - 2/(exp(2x)+1) for |x| >= 0.625, and an odd polynomial below */
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet4f ptanh<Packet4f>(const Packet4f& _x)
+{
+  _EIGEN_DECLARE_CONST_Packet4f(1 , 1.0f);
+  _EIGEN_DECLARE_CONST_Packet4f(2 , 2.0f);
+  _EIGEN_DECLARE_CONST_Packet4f(0625, 0.625f);
+  _EIGEN_DECLARE_CONST_Packet4f_FROM_INT(sign_mask, 0x80000000);
+  _EIGEN_DECLARE_CONST_Packet4f(cephes_tanh_p0, -5.70498872745e-3f);
+  _EIGEN_DECLARE_CONST_Packet4f(cephes_tanh_p1,  2.06390887954e-2f);
+  _EIGEN_DECLARE_CONST_Packet4f(cephes_tanh_p2, -5.37397155531e-2f);
+  _EIGEN_DECLARE_CONST_Packet4f(cephes_tanh_p3,  1.33314422036e-1f);
+  _EIGEN_DECLARE_CONST_Packet4f(cephes_tanh_p4, -3.33332819422e-1f);
+
+  Packet4f sign_bit = _mm_and_ps(_x, p4f_sign_mask);
+  Packet4f x = pabs(_x);
+
+  Packet4f big = psub(p4f_1, pdiv(p4f_2, padd(pexp(padd(x,x)), p4f_1)));
+
+  Packet4f z = pmul(x,x);
+  Packet4f p = p4f_cephes_tanh_p0;
+  p = pmadd(p, z, p4f_cephes_tanh_p1);
+  p = pmadd(p, z, p4f_cephes_tanh_p2);
+  p = pmadd(p, z, p4f_cephes_tanh_p3);
+  p = pmadd(p, z, p4f_cephes_tanh_p4);
+  Packet4f small = pmadd(pmul(p, z), x, x);
+
+  Packet4f y = pselect(_mm_cmplt_ps(x, p4f_0625), small, big);
+  return _mm_or_ps(_mm_xor_ps(y, sign_bit), pisnan(_x));
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet2d ptanh<Packet2d>(const Packet2d& _x)
+{
+  _EIGEN_DECLARE_CONST_Packet2d(1 , 1.0);
+  _EIGEN_DECLARE_CONST_Packet2d(2 , 2.0);
+  _EIGEN_DECLARE_CONST_Packet2d(0625, 0.625);
+  _EIGEN_DECLARE_CONST_Packet2d_FROM_INT64(sign_mask, 0x8000000000000000LL);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_tanh_p0, -9.64399179425052238628e-1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_tanh_p1, -9.92877231001918586564e1);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_tanh_p2, -1.61468768441708447952e3);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_tanh_q0,  1.12811678491632931402e2);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_tanh_q1,  2.23548839060100448583e3);
+  _EIGEN_DECLARE_CONST_Packet2d(cephes_tanh_q2,  4.84406305325125486048e3);
+
+  Packet2d sign_bit = _mm_and_pd(_x, p2d_sign_mask);
+  Packet2d x = pabs(_x);
+
+  Packet2d big = psub(p2d_1, pdiv(p2d_2, padd(pexp(padd(x,x)), p2d_1)));
+
+  Packet2d z = pmul(x,x);
+  Packet2d p = p2d_cephes_tanh_p0;
+  p = pmadd(p, z, p2d_cephes_tanh_p1);
+  p = pmadd(p, z, p2d_cephes_tanh_p2);
+  Packet2d q = padd(z, p2d_cephes_tanh_q0);
+  q = pmadd(q, z, p2d_cephes_tanh_q1);
+  q = pmadd(q, z, p2d_cephes_tanh_q2);
+  Packet2d small = pmadd(pmul(z, pdiv(p, q)), x, x);
+
+  Packet2d y = pselect(_mm_cmplt_pd(x, p2d_0625), small, big);
+  return _mm_or_pd(_mm_xor_pd(y, sign_bit), pisnan(_x));
+}
+
+/* 1/(1+exp(-x)) computed from e = exp(-|x|) as 1/(1+e) or e/(1+e), so that
+   exp never overflows and the left tail keeps its relative accuracy */
+template<typename Packet>
+EIGEN_STRONG_INLINE Packet plogistic_sse(const Packet& x)
+{
+  typedef typename unpacket_traits<Packet>::type Scalar;
+  const Packet one = pset1<Packet>(Scalar(1));
+  const Packet zero = pset1<Packet>(Scalar(0));
+  Packet e = pexp(pnegate(pabs(x)));
+  Packet num = pselect(pcmp_lt(x, zero), e, one);
+  Packet res = pdiv(num, padd(one, e));
+  // the float pexp clamps its argument, which loses NaNs and gives exp(-inf) > 0
+  res = pselect(pcmp_eq(x, pset1<Packet>(-std::numeric_limits<Scalar>::infinity())), zero, res);
+  return por(res, pisnan(x));
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet4f plogistic<Packet4f>(const Packet4f& x)
+{
+  return plogistic_sse(x);
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet2d plogistic<Packet2d>(const Packet2d& x)
+{
+  return plogistic_sse(x);
+}
+
+/* atan(a/b) moved to the quadrant of (b,a) */
+template<typename Packet>
+EIGEN_STRONG_INLINE Packet patan2_sse(const Packet& a, const Packet& b)
+{
+  typedef typename unpacket_traits<Packet>::type Scalar;
+  const Packet zero = pset1<Packet>(Scalar(0));
+  const Packet pi = pset1<Packet>(Scalar(3.14159265358979323846));
+  const Packet pio2 = pset1<Packet>(Scalar(1.57079632679489661923));
+
+  Packet a_neg = pcmp_lt(a, zero);
+  Packet r = patan(pdiv(a, b));
+  r = padd(r, pselect(pcmp_lt(b, zero), pselect(a_neg, pnegate(pi), pi), zero));
+
+  // atan(a/0) does not know the sign of a zero b
+  Packet on_axis = pselect(a_neg, pnegate(pio2), pselect(pcmp_lt(zero, a), pio2, zero));
+  return pselect(pcmp_eq(b, zero), on_axis, r);
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet4f patan2<Packet4f>(const Packet4f& a, const Packet4f& b)
+{
+  return patan2_sse(a, b);
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet2d patan2<Packet2d>(const Packet2d& a, const Packet2d& b)
+{
+  return patan2_sse(a, b);
+}
+
+/* completes r = |a|^b with the sign and the special cases of a^b: negated
+   for negative a and odd integral b, NaN for negative a and non integral b */
+template<typename Packet>
+EIGEN_STRONG_INLINE Packet ppow_special_cases(const Packet& a, const Packet& b, const Packet& r)
+{
+  typedef typename unpacket_traits<Packet>::type Scalar;
+  const Packet zero = pset1<Packet>(Scalar(0));
+  const Packet one = pset1<Packet>(Scalar(1));
+  const Packet sign_mask = pset1<Packet>(Scalar(-0.0));
+  const Packet nan = pset1<Packet>(std::numeric_limits<Scalar>::quiet_NaN());
+  const Packet inf = pset1<Packet>(std::numeric_limits<Scalar>::infinity());
+
+  Packet neg_mask = pcmp_lt(a, zero);
+  Packet int_mask = pcmp_eq(pfloor(b), b);
+  Packet half_b = pmul(b, pset1<Packet>(Scalar(0.5)));
+  Packet odd_mask = pselect(pcmp_eq(pfloor(half_b), half_b), zero, int_mask);
+
+  Packet res = pxor(r, pand(pand(neg_mask, odd_mask), sign_mask));
+  res = pselect(pselect(int_mask, zero, neg_mask), nan, res);
+  res = pselect(pcmp_eq(a, zero), pselect(pcmp_lt(b, zero), inf, zero), res);
+  // (+-inf)^b is inf or 0 as 0^-b, negative for odd integral b, and (-1)^(+-inf) is 1
+  Packet inf_res = pxor(pselect(pcmp_lt(b, zero), zero, inf), pand(pand(neg_mask, odd_mask), sign_mask));
+  res = pselect(pcmp_eq(pabs(a), inf), inf_res, res);
+  res = pselect(pand(pcmp_eq(a, pnegate(one)), pcmp_eq(pabs(b), inf)), one, res);
+  res = por(res, por(pisnan(a), pisnan(b)));
+
+  // a^0 and 1^b are 1, even for NaN arguments
+  return pselect(por(pcmp_eq(b, zero), pcmp_eq(a, one)), one, res);
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet2d ppow<Packet2d>(const Packet2d& a, const Packet2d& b)
+{
+  return ppow_special_cases(a, b, pexp(pmul(b, plog(pabs(a)))));
+}
+
+/* |a|^b for float arguments converted to double, as exp(b*log|a|) with
+   truncated series of just the precision needed for a float result:
+   log(m) = 2 atanh((m-1)/(m+1)) for m in [sqrt(1/2),sqrt(2)[ and a degree
+   8 Taylor expansion of exp on [-log(2)/2,log(2)/2] */
+EIGEN_STRONG_INLINE Packet2d ppow_float_in_double(const Packet2d& x, const Packet2d& y)
+{
+  _EIGEN_DECLARE_CONST_Packet2d(1 , 1.0);
+  _EIGEN_DECLARE_CONST_Packet2d(half, 0.5);
+  _EIGEN_DECLARE_CONST_Packet2d(SQRT2, 1.41421356237309504880);
+  _EIGEN_DECLARE_CONST_Packet2d(LN2, 0.693147180559945309417);
+  _EIGEN_DECLARE_CONST_Packet2d(LOG2E, 1.44269504088896340736);
+  _EIGEN_DECLARE_CONST_Packet2d(round, 6755399441055744.0);
+  _EIGEN_DECLARE_CONST_Packet2d(2p52, 4503599627370496.0);
+  _EIGEN_DECLARE_CONST_Packet2d(1023, 1023.0);
+  // floats below 2^-150 and above 2^128 round to 0 and inf
+  _EIGEN_DECLARE_CONST_Packet2d(t_hi, 90.0);
+  _EIGEN_DECLARE_CONST_Packet2d(t_lo, -105.0);
+  _EIGEN_DECLARE_CONST_Packet2d_FROM_INT64(inv_exp_mask, ~0x7ff0000000000000LL);
+  _EIGEN_DECLARE_CONST_Packet2d_FROM_INT64(exp_of_one, 0x3ff0000000000000LL);
+
+  /* x = m*2^e with m in [1,2[, then in [sqrt(1/2),sqrt(2)[ */
+  Packet2d e = _mm_castsi128_pd(_mm_or_si128(_mm_srli_epi64(_mm_castpd_si128(x), 52), _mm_castpd_si128(p2d_2p52)));
+  e = psub(psub(e, p2d_2p52), p2d_1023);
+  Packet2d m = _mm_or_pd(_mm_and_pd(x, p2d_inv_exp_mask), p2d_exp_of_one);
+  Packet2d big = _mm_cmpge_pd(m, p2d_SQRT2);
+  m = pselect(big, pmul(m, p2d_half), m);
+  e = padd(e, _mm_and_pd(big, p2d_1));
+
+  Packet2d f = pdiv(psub(m, p2d_1), padd(m, p2d_1));
+  Packet2d s = pmul(f, f);
+  Packet2d s2 = pmul(s, s);
+
+  // the polynomials are evaluated with Estrin's scheme to shorten the dependency chains
+  Packet2d p = pmadd(s, pset1<Packet2d>(1.0/11.0), pset1<Packet2d>(1.0/9.0));
+  p = pmadd(s2, p, pmadd(s, pset1<Packet2d>(1.0/7.0), pset1<Packet2d>(1.0/5.0)));
+  p = pmadd(s2, p, pmadd(s, pset1<Packet2d>(1.0/3.0), p2d_1));
+  Packet2d t = pmadd(e, p2d_LN2, pmul(padd(f, f), p));
+
+  t = pmax(pmin(pmul(y, t), p2d_t_hi), p2d_t_lo);
+  Packet2d n = psub(padd(pmul(t, p2d_LOG2E), p2d_round), p2d_round);
+  Packet2d r = psub(t, pmul(n, p2d_LN2));
+  Packet2d r2 = pmul(r, r);
+  Packet2d r4 = pmul(r2, r2);
+  p = pmadd(r2, pset1<Packet2d>(1.0/40320.0), pmadd(r, pset1<Packet2d>(1.0/5040.0), pset1<Packet2d>(1.0/720.0)));
+  p = pmadd(r2, p, pmadd(r, pset1<Packet2d>(1.0/120.0), pset1<Packet2d>(1.0/24.0)));
+  p = pmadd(r4, p, pmadd(r2, pmadd(r, pset1<Packet2d>(1.0/6.0), p2d_half), padd(r, p2d_1)));
+  return pmul(p, pexp2i(n));
+}
+
+template<> EIGEN_DEFINE_FUNCTION_ALLOWING_MULTIPLE_DEFINITIONS EIGEN_UNUSED
+Packet4f ppow<Packet4f>(const Packet4f& a, const Packet4f& b)
+{
+  Packet4f x = pabs(a);
+  Packet2d lo = ppow_float_in_double(_mm_cvtps_pd(x), _mm_cvtps_pd(b));
+  Packet2d hi = ppow_float_in_double(_mm_cvtps_pd(_mm_movehl_ps(x,x)), _mm_cvtps_pd(_mm_movehl_ps(b,b)));
+  return ppow_special_cases(a, b, _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi)));
+}
+
 } // end namespace internal
 
 #endif // EIGEN_MATH_FUNCTIONS_SSE_H
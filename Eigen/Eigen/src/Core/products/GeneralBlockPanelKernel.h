@@ -33,29 +33,20 @@ class gebp_traits;
 /** \internal */
 inline void manage_caching_sizes(Action action, std::ptrdiff_t* l1=0, std::ptrdiff_t* l2=0)
 {
-  static std::ptrdiff_t m_l1CacheSize = 0;
-  static std::ptrdiff_t m_l2CacheSize = 0;
-  if(m_l1CacheSize==0)
-  {
-    m_l1CacheSize = queryL1CacheSize();
-    m_l2CacheSize = queryTopLevelCacheSize();
-
-    if(m_l1CacheSize<=0) m_l1CacheSize = 8 * 1024;
-    if(m_l2CacheSize<=0) m_l2CacheSize = 1 * 1024 * 1024;
-  }
+  product_tuning& tuning = product_tuning_parameters();
 
   if(action==SetAction)
   {
     // set the cpu cache size and cache all block sizes from a global cache size in byte
     eigen_internal_assert(l1!=0 && l2!=0);
-    m_l1CacheSize = *l1;
-    m_l2CacheSize = *l2;
+    tuning.l1CacheSize = *l1;
+    tuning.l2CacheSize = *l2;
   }
   else if(action==GetAction)
   {
     eigen_internal_assert(l1!=0 && l2!=0);
-    *l1 = m_l1CacheSize;
-    *l2 = m_l2CacheSize;
+    *l1 = tuning.l1CacheSize;
+    *l2 = tuning.l2CacheSize;
   }
   else
   {
@@ -75,9 +66,10 @@ inline void manage_caching_sizes(Action action, std::ptrdiff_t* l1=0, std::ptrdi
   * parameters:
   * - the L1 and L2 cache sizes,
   * - the register level blocking sizes defined by gebp_traits,
-  * - the number of scalars that fit into a packet (when vectorization is enabled).
+  * - the number of scalars that fit into a packet (when vectorization is enabled),
+  * - the upper bounds set by setMaxProductBlockingSizes() or a tuning profile.
   *
-  * \sa setCpuCacheSizes */
+  * \sa setCpuCacheSizes, loadTuningProfile */
 template<typename LhsScalar, typename RhsScalar, int KcFactor>
 void computeProductBlockingSizes(std::ptrdiff_t& k, std::ptrdiff_t& m, std::ptrdiff_t& n)
 {
@@ -100,9 +92,19 @@ void computeProductBlockingSizes(std::ptrdiff_t& k, std::ptrdiff_t& m, std::ptrd
   };
 
   manage_caching_sizes(GetAction, &l1, &l2);
-  k = std::min<std::ptrdiff_t>(k, l1/kdiv);
-  std::ptrdiff_t _m = k>0 ? l2/(4 * sizeof(LhsScalar) * k) : 0;
-  if(_m<m) m = _m & mr_mask;
+  // the blocking sizes must not be 0 whatever the cache sizes, or the product loops would not advance
+  std::ptrdiff_t maxKc = std::max<std::ptrdiff_t>(1, l1/kdiv), maxMc = 0;
+  // the blocking sizes set by a tuning profile take precedence over the ones derived from the cache sizes
+  const int tuningIndex = product_tuning_index<LhsScalar,RhsScalar>::value;
+  if(tuningIndex>=0)
+  {
+    const product_tuning& tuning = product_tuning_parameters();
+    if(tuning.kc[tuningIndex]>0) maxKc = std::max<std::ptrdiff_t>(1, tuning.kc[tuningIndex]/KcFactor);
+    maxMc = tuning.mc[tuningIndex];
+  }
+  k = std::min<std::ptrdiff_t>(k, maxKc);
+  std::ptrdiff_t _m = maxMc>0 ? std::max<std::ptrdiff_t>(maxMc, mr) : k>0 ? l2/(4 * sizeof(LhsScalar) * k) : 0;
+  if(_m<m) m = std::max<std::ptrdiff_t>(mr, _m & mr_mask);
 }
 
 template<typename LhsScalar, typename RhsScalar>
@@ -214,7 +216,12 @@ public:
 
   EIGEN_STRONG_INLINE void madd(const LhsPacket& a, const RhsPacket& b, AccPacket& c, AccPacket& tmp) const
   {
+#ifdef EIGEN_VECTORIZE_FMA
+    EIGEN_UNUSED_VARIABLE(tmp);
+    c = pmadd(a,b,c);
+#else
     tmp = b; tmp = pmul(a,tmp); c = padd(c,tmp);
+#endif
   }
 
   EIGEN_STRONG_INLINE void acc(const AccPacket& c, const ResPacket& alpha, ResPacket& r) const
@@ -290,7 +297,12 @@ public:
 
   EIGEN_STRONG_INLINE void madd_impl(const LhsPacket& a, const RhsPacket& b, AccPacket& c, RhsPacket& tmp, const true_type&) const
   {
+#ifdef EIGEN_VECTORIZE_FMA
+    EIGEN_UNUSED_VARIABLE(tmp);
+    c.v = pmadd(a.v,b,c.v);
+#else
     tmp = b; tmp = pmul(a.v,tmp); c.v = padd(c.v,tmp);
+#endif
   }
 
   EIGEN_STRONG_INLINE void madd_impl(const LhsScalar& a, const RhsScalar& b, ResScalar& c, RhsScalar& /*tmp*/, const false_type&) const
@@ -387,8 +399,13 @@ public:
 
   EIGEN_STRONG_INLINE void madd(const LhsPacket& a, const RhsPacket& b, DoublePacket& c, RhsPacket& /*tmp*/) const
   {
+#ifdef EIGEN_VECTORIZE_FMA
+    c.first   = pmadd(a,b.first, c.first);
+    c.second  = pmadd(a,b.second,c.second);
+#else
     c.first   = padd(pmul(a,b.first), c.first);
     c.second  = padd(pmul(a,b.second),c.second);
+#endif
   }
 
   EIGEN_STRONG_INLINE void madd(const LhsPacket& a, const RhsPacket& b, ResPacket& c, RhsPacket& /*tmp*/) const
@@ -495,7 +512,12 @@ public:
 
   EIGEN_STRONG_INLINE void madd_impl(const LhsPacket& a, const RhsPacket& b, AccPacket& c, RhsPacket& tmp, const true_type&) const
   {
+#ifdef EIGEN_VECTORIZE_FMA
+    EIGEN_UNUSED_VARIABLE(tmp);
+    c.v = pmadd(a,b.v,c.v);
+#else
     tmp = b; tmp.v = pmul(a,tmp.v); c = padd(c,tmp);
+#endif
   }
 
   EIGEN_STRONG_INLINE void madd_impl(const LhsScalar& a, const RhsScalar& b, ResScalar& c, RhsScalar& /*tmp*/, const false_type&) const
@@ -1279,6 +1301,7 @@ inline std::ptrdiff_t l2CacheSize()
   * \sa computeProductBlockingSizes */
 inline void setCpuCacheSizes(std::ptrdiff_t l1, std::ptrdiff_t l2)
 {
+  eigen_assert(l1>0 && l2>0);
   internal::manage_caching_sizes(SetAction, &l1, &l2);
 }
 
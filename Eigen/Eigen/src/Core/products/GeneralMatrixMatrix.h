@@ -44,14 +44,14 @@ struct general_matrix_matrix_product<Index,LhsScalar,LhsStorageOrder,ConjugateLh
     ResScalar* res, Index resStride,
     ResScalar alpha,
     level3_blocking<RhsScalar,LhsScalar>& blocking,
-    GemmParallelInfo<Index>* info = 0)
+    GemmParallelInfo<Index>* info = 0, Index tid = 0, Index threads = 1)
   {
     // transpose the product such that the result is column major
     general_matrix_matrix_product<Index,
       RhsScalar, RhsStorageOrder==RowMajor ? ColMajor : RowMajor, ConjugateRhs,
       LhsScalar, LhsStorageOrder==RowMajor ? ColMajor : RowMajor, ConjugateLhs,
       ColMajor>
-    ::run(cols,rows,depth,rhs,rhsStride,lhs,lhsStride,res,resStride,alpha,blocking,info);
+    ::run(cols,rows,depth,rhs,rhsStride,lhs,lhsStride,res,resStride,alpha,blocking,info,tid,threads);
   }
 };
 
@@ -70,7 +70,7 @@ static void run(Index rows, Index cols, Index depth,
   ResScalar* res, Index resStride,
   ResScalar alpha,
   level3_blocking<LhsScalar,RhsScalar>& blocking,
-  GemmParallelInfo<Index>* info = 0)
+  GemmParallelInfo<Index>* info = 0, Index tid = 0, Index threads = 1)
 {
   const_blas_data_mapper<LhsScalar, Index, LhsStorageOrder> lhs(_lhs,lhsStride);
   const_blas_data_mapper<RhsScalar, Index, RhsStorageOrder> rhs(_rhs,rhsStride);
@@ -85,13 +85,10 @@ static void run(Index rows, Index cols, Index depth,
   gemm_pack_rhs<RhsScalar, Index, Traits::nr, RhsStorageOrder> pack_rhs;
   gebp_kernel<LhsScalar, RhsScalar, Index, Traits::mr, Traits::nr, ConjugateLhs, ConjugateRhs> gebp;
 
-#ifdef EIGEN_HAS_OPENMP
+#ifndef EIGEN_NO_PARALLEL_PRODUCTS
   if(info)
   {
     // this is the parallel version!
-    Index tid = omp_get_thread_num();
-    Index threads = omp_get_num_threads();
-    
     std::size_t sizeA = kc*mc;
     std::size_t sizeW = kc*Traits::WorkSpaceFactor;
     ei_declare_aligned_stack_constructed_variable(LhsScalar, blockA, sizeA, 0);
@@ -115,24 +112,23 @@ static void run(Index rows, Index cols, Index depth,
       // However, before copying to B'_j, we have to make sure that no other thread is still using it,
       // i.e., we test that info[tid].users equals 0.
       // Then, we set info[tid].users to the number of threads to mark that all other threads are going to use it.
-      while(info[tid].users!=0) {}
-      info[tid].users += threads;
+      while(atomic_load(&info[tid].users)!=0) {}
+      atomic_add(&info[tid].users, int(threads));
 
       pack_rhs(blockB+info[tid].rhs_start*actual_kc, &rhs(k,info[tid].rhs_start), rhsStride, actual_kc, info[tid].rhs_length);
 
       // Notify the other threads that the part B'_j is ready to go.
-      info[tid].sync = k;
+      atomic_store(&info[tid].sync, int(k));
 
       // Computes C_i += A' * B' per B'_j
       for(Index shift=0; shift<threads; ++shift)
       {
         Index j = (tid+shift)%threads;
 
-        // At this point we have to make sure that B'_j has been updated by the thread j,
-        // we use testAndSetOrdered to mimic a volatile access.
+        // At this point we have to make sure that B'_j has been updated by the thread j.
         // However, no need to wait for the B' part which has been updated by the current thread!
         if(shift>0)
-          while(info[j].sync!=k) {}
+          while(atomic_load(&info[j].sync)!=k) {}
 
         gebp(res+info[j].rhs_start*resStride, resStride, blockA, blockB+info[j].rhs_start*actual_kc, mc, actual_kc, info[j].rhs_length, alpha, -1,-1,0,0, w);
       }
@@ -152,14 +148,15 @@ static void run(Index rows, Index cols, Index depth,
       // Release all the sub blocks B'_j of B' for the current thread,
       // i.e., we simply decrement the number of users by 1
       for(Index j=0; j<threads; ++j)
-        #pragma omp atomic
-        --(info[j].users);
+        atomic_add(&info[j].users, -1);
     }
   }
   else
-#endif // EIGEN_HAS_OPENMP
+#endif // EIGEN_NO_PARALLEL_PRODUCTS
   {
     EIGEN_UNUSED_VARIABLE(info);
+    EIGEN_UNUSED_VARIABLE(tid);
+    EIGEN_UNUSED_VARIABLE(threads);
 
     // this is the sequential version!
     std::size_t sizeA = kc*mc;
@@ -227,7 +224,8 @@ struct gemm_functor
     m_blocking.allocateB();
   }
 
-  void operator() (Index row, Index rows, Index col=0, Index cols=-1, GemmParallelInfo<Index>* info=0) const
+  void operator() (Index row, Index rows, Index col=0, Index cols=-1,
+                   GemmParallelInfo<Index>* info=0, Index tid=0, Index threads=1) const
   {
     if(cols==-1)
       cols = m_rhs.cols();
@@ -236,7 +234,7 @@ struct gemm_functor
               /*(const Scalar*)*/&m_lhs.coeffRef(row,0), m_lhs.outerStride(),
               /*(const Scalar*)*/&m_rhs.coeffRef(0,col), m_rhs.outerStride(),
               (Scalar*)&(m_dest.coeffRef(row,col)), m_dest.outerStride(),
-              m_actualAlpha, m_blocking, info);
+              m_actualAlpha, m_blocking, info, tid, threads);
   }
 
   protected:
@@ -356,19 +354,19 @@ class gemm_blocking_space<StorageOrder,_LhsScalar,_RhsScalar,MaxRows, MaxCols, M
     void allocateA()
     {
       if(this->m_blockA==0)
-        this->m_blockA = aligned_new<LhsScalar>(m_sizeA);
+        this->m_blockA = workspace_new<LhsScalar>(m_sizeA);
     }
 
     void allocateB()
     {
       if(this->m_blockB==0)
-        this->m_blockB = aligned_new<RhsScalar>(m_sizeB);
+        this->m_blockB = workspace_new<RhsScalar>(m_sizeB);
     }
 
     void allocateW()
     {
       if(this->m_blockW==0)
-        this->m_blockW = aligned_new<RhsScalar>(m_sizeW);
+        this->m_blockW = workspace_new<RhsScalar>(m_sizeW);
     }
 
     void allocateAll()
@@ -380,12 +378,32 @@ class gemm_blocking_space<StorageOrder,_LhsScalar,_RhsScalar,MaxRows, MaxCols, M
 
     ~gemm_blocking_space()
     {
-      aligned_delete(this->m_blockA, m_sizeA);
-      aligned_delete(this->m_blockB, m_sizeB);
-      aligned_delete(this->m_blockW, m_sizeW);
+      workspace_delete(this->m_blockA, m_sizeA);
+      workspace_delete(this->m_blockB, m_sizeB);
+      workspace_delete(this->m_blockW, m_sizeW);
     }
 };
 
+// Evaluates the products smaller than the crossover size set by setCoeffBasedProductThreshold() coefficient by
+// coefficient, since the packing of the operands costs more than it saves.
+template<bool Enable> struct gemm_coeff_based_fallback
+{
+  template<typename Dest, typename Lhs, typename Rhs, typename Scalar>
+  static bool run(Dest&, const Lhs&, const Rhs&, const Scalar&) { return false; }
+};
+
+template<> struct gemm_coeff_based_fallback<true>
+{
+  template<typename Dest, typename Lhs, typename Rhs, typename Scalar>
+  static bool run(Dest& dst, const Lhs& lhs, const Rhs& rhs, const Scalar& alpha)
+  {
+    if(dst.rows()+dst.cols()+lhs.cols() >= coeffBasedProductThreshold())
+      return false;
+    dst.noalias() += alpha * lhs.lazyProduct(rhs);
+    return true;
+  }
+};
+
 } // end namespace internal
 
 template<typename Lhs, typename Rhs>
@@ -418,6 +436,10 @@ class GeneralProduct<Lhs, Rhs, GemmProduct>
       Scalar actualAlpha = alpha * LhsBlasTraits::extractScalarFactor(m_lhs)
                                  * RhsBlasTraits::extractScalarFactor(m_rhs);
 
+      if(internal::gemm_coeff_based_fallback<!(LhsBlasTraits::NeedToConjugate || RhsBlasTraits::NeedToConjugate)
+                                             && internal::is_same<LhsScalar,RhsScalar>::value>::run(dst, lhs, rhs, actualAlpha))
+        return;
+
       typedef internal::gemm_blocking_space<(Dest::Flags&RowMajorBit) ? RowMajor : ColMajor,LhsScalar,RhsScalar,
               Dest::MaxRowsAtCompileTime,Dest::MaxColsAtCompileTime,MaxDepthAtCompileTime> BlockingType;
 
@@ -432,7 +454,7 @@ class GeneralProduct<Lhs, Rhs, GemmProduct>
 
       BlockingType blocking(dst.rows(), dst.cols(), lhs.cols());
 
-      internal::parallelize_gemm<(Dest::MaxRowsAtCompileTime>32 || Dest::MaxRowsAtCompileTime==Dynamic)>(GemmFunctor(lhs, rhs, dst, actualAlpha, blocking), this->rows(), this->cols(), Dest::Flags&RowMajorBit);
+      internal::parallelize_gemm<(Dest::MaxRowsAtCompileTime>32 || Dest::MaxRowsAtCompileTime==Dynamic)>(GemmFunctor(lhs, rhs, dst, actualAlpha, blocking), this->rows(), this->cols(), lhs.cols(), Dest::Flags&RowMajorBit);
     }
 };
 
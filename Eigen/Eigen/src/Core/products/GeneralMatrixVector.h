@@ -554,6 +554,56 @@ EIGEN_DONT_INLINE static void run(
 }
 };
 
+/* Multithreaded driver of general_matrix_vector_product:
+ * the rows of the result are split over the threads (see parallelize_gemv).
+ * Each thread computes its own slice of the result, so no synchronization is needed.
+ */
+template<typename Index, typename LhsScalar, int LhsStorageOrder, bool ConjugateLhs, typename RhsScalar, bool ConjugateRhs>
+struct parallel_matrix_vector_product
+{
+  typedef general_matrix_vector_product<Index,LhsScalar,LhsStorageOrder,ConjugateLhs,RhsScalar,ConjugateRhs> Gemv;
+  typedef typename scalar_product_traits<LhsScalar, RhsScalar>::ReturnType ResScalar;
+
+  template<typename AlphaScalar> struct functor
+  {
+    functor(Index rows, Index cols, const LhsScalar* lhs, Index lhsStride, const RhsScalar* rhs, Index rhsIncr,
+            ResScalar* res, Index resIncr, AlphaScalar alpha)
+      : m_cols(cols), m_lhs(lhs), m_lhsStride(lhsStride), m_rhs(rhs), m_rhsIncr(rhsIncr),
+        m_res(res), m_resIncr(resIncr), m_alpha(alpha)
+    { EIGEN_UNUSED_VARIABLE(rows); }
+
+    Index cost(Index) const { return m_cols; }
+    void initParallelSession(Index) const {}
+
+    void operator()(Index start, Index end, Index) const
+    {
+      if(end>start)
+        Gemv::run(end-start, m_cols,
+                  m_lhs + start * (LhsStorageOrder==RowMajor ? m_lhsStride : 1), m_lhsStride,
+                  m_rhs, m_rhsIncr, m_res + start*m_resIncr, m_resIncr, m_alpha);
+    }
+
+    Index m_cols;
+    const LhsScalar* m_lhs; Index m_lhsStride;
+    const RhsScalar* m_rhs; Index m_rhsIncr;
+    ResScalar* m_res; Index m_resIncr;
+    AlphaScalar m_alpha;
+  };
+
+  template<typename AlphaScalar>
+  static void run(
+    Index rows, Index cols,
+    const LhsScalar* lhs, Index lhsStride,
+    const RhsScalar* rhs, Index rhsIncr,
+    ResScalar* res, Index resIncr,
+    AlphaScalar alpha)
+  {
+    functor<AlphaScalar> func(rows, cols, lhs, lhsStride, rhs, rhsIncr, res, resIncr, alpha);
+    if(!parallelize_gemv(func, rows))
+      Gemv::run(rows, cols, lhs, lhsStride, rhs, rhsIncr, res, resIncr, alpha);
+  }
+};
+
 } // end namespace internal
 
 #endif // EIGEN_GENERAL_MATRIX_VECTOR_H
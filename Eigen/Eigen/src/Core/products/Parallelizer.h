@@ -25,6 +25,43 @@
 #ifndef EIGEN_PARALLELIZER_H
 #define EIGEN_PARALLELIZER_H
 
+/** \class ThreadPoolTask
+  * \brief A unit of work handed to a ThreadPoolInterface
+  *
+  * \sa ThreadPoolInterface */
+class ThreadPoolTask
+{
+  public:
+    virtual ~ThreadPoolTask() {}
+
+    /** Runs the \a i-th part of the work. */
+    virtual void operator()(int i) = 0;
+};
+
+/** \class ThreadPoolInterface
+  * \brief Interface to a user supplied pool of threads
+  *
+  * By default, Eigen only runs large matrix products in parallel when it is compiled with OpenMP.
+  * Applications owning their own threads can instead derive from this class and register
+  * their pool with setThreadPool(). The pool is then used in place of OpenMP.
+  *
+  * The parts of a task wait on each other, so all the parts given to parallelFor() must be able to
+  * run at the same time. Eigen never asks for more parts than numThreads(), and it never calls
+  * parallelFor() again before the previous call has returned.
+  *
+  * \sa setThreadPool(), setNbThreads() */
+class ThreadPoolInterface
+{
+  public:
+    virtual ~ThreadPoolInterface() {}
+
+    /** \returns the number of parts which can run at the same time, including the calling thread */
+    virtual int numThreads() const = 0;
+
+    /** Runs \a task(i) for each \a i in [0,\a count) and returns once all of them are done. */
+    virtual void parallelFor(int count, ThreadPoolTask& task) = 0;
+};
+
 namespace internal {
 
 /** \internal */
@@ -40,14 +77,9 @@ inline void manage_multi_threading(Action action, int* v)
   else if(action==GetAction)
   {
     eigen_internal_assert(v!=0);
-    #ifdef EIGEN_HAS_OPENMP
+    *v = -1;
     if(m_maxThreads>0)
       *v = m_maxThreads;
-    else
-      *v = omp_get_max_threads();
-    #else
-    *v = 1;
-    #endif
   }
   else
   {
@@ -55,22 +87,92 @@ inline void manage_multi_threading(Action action, int* v)
   }
 }
 
+/** \internal */
+inline void manage_thread_pool(Action action, ThreadPoolInterface** pool)
+{
+  static ThreadPoolInterface* m_pool = 0;
+
+  eigen_internal_assert(pool!=0);
+  if(action==SetAction)
+    m_pool = *pool;
+  else if(action==GetAction)
+    *pool = m_pool;
+  else
+    eigen_internal_assert(false);
+}
+
+/** \internal \returns the thread pool registered by setThreadPool(), or 0 */
+inline ThreadPoolInterface* threadPool()
+{
+  ThreadPoolInterface* ret;
+  manage_thread_pool(GetAction, &ret);
+  return ret;
+}
+
+} // end namespace internal
+
 /** \returns the max number of threads reserved for Eigen
   * \sa setNbThreads */
 inline int nbThreads()
 {
   int ret;
-  manage_multi_threading(GetAction, &ret);
-  return ret;
+  internal::manage_multi_threading(GetAction, &ret);
+
+  ThreadPoolInterface* pool = internal::threadPool();
+  if(pool)
+    return ret>0 ? (std::min)(ret, pool->numThreads()) : pool->numThreads();
+
+  #ifdef EIGEN_HAS_OPENMP
+  return ret>0 ? ret : omp_get_max_threads();
+  #else
+  return 1;
+  #endif
 }
 
 /** Sets the max number of threads reserved for Eigen
   * \sa nbThreads */
 inline void setNbThreads(int v)
 {
-  manage_multi_threading(SetAction, &v);
+  internal::manage_multi_threading(SetAction, &v);
+}
+
+/** Makes Eigen run its parallel products on \a pool instead of OpenMP.
+  * The pool must stay alive until it is replaced. Passing 0 restores the default behavior.
+  * \sa ThreadPoolInterface, setNbThreads */
+inline void setThreadPool(ThreadPoolInterface* pool)
+{
+  internal::manage_thread_pool(SetAction, &pool);
 }
 
+namespace internal {
+
+// These used to live in the internal namespace.
+using Eigen::nbThreads;
+using Eigen::setNbThreads;
+
+// The threads of a parallel product share their packed blocks through the flags of
+// GemmParallelInfo. Loads have acquire and stores have release semantic so that
+// a block is complete when its flag is seen.
+#if defined(__ATOMIC_ACQUIRE)
+inline int atomic_load(const int volatile* v) { return __atomic_load_n(v, __ATOMIC_ACQUIRE); }
+inline void atomic_store(int volatile* v, int x) { __atomic_store_n(v, x, __ATOMIC_RELEASE); }
+inline int atomic_add(int volatile* v, int x) { return __atomic_add_fetch(v, x, __ATOMIC_ACQ_REL); }
+inline bool atomic_compare_and_swap(int volatile* v, int from, int to) { return __atomic_compare_exchange_n(v, &from, to, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE); }
+#elif defined(__GNUC__) || defined(__INTEL_COMPILER)
+inline int atomic_load(const int volatile* v) { int r = *v; __sync_synchronize(); return r; }
+inline void atomic_store(int volatile* v, int x) { __sync_synchronize(); *v = x; }
+inline int atomic_add(int volatile* v, int x) { return __sync_add_and_fetch(v, x); }
+inline bool atomic_compare_and_swap(int volatile* v, int from, int to) { return __sync_bool_compare_and_swap(v, from, to); }
+#elif defined(_MSC_VER)
+inline int atomic_load(const int volatile* v) { int r = *v; _ReadWriteBarrier(); return r; }
+inline void atomic_store(int volatile* v, int x) { _ReadWriteBarrier(); *v = x; }
+inline int atomic_add(int volatile* v, int x) { return _InterlockedExchangeAdd((long volatile*)v, x) + x; }
+inline bool atomic_compare_and_swap(int volatile* v, int from, int to) { return _InterlockedCompareExchange((long volatile*)v, to, from)==from; }
+#else
+  // No atomic operations: products are never run in parallel.
+  #define EIGEN_NO_PARALLEL_PRODUCTS
+#endif
+
 template<typename Index> struct GemmParallelInfo
 {
   GemmParallelInfo() : sync(-1), users(0), rhs_start(0), rhs_length(0) {}
@@ -82,71 +184,296 @@ template<typename Index> struct GemmParallelInfo
   Index rhs_length;
 };
 
-template<bool Condition, typename Functor, typename Index>
-void parallelize_gemm(const Functor& func, Index rows, Index cols, bool transpose)
-{
-#ifndef EIGEN_HAS_OPENMP
-  // FIXME the transpose variable is only needed to properly split
-  // the matrix product when multithreading is enabled. This is a temporary
-  // fix to support row-major destination matrices. This whole
-  // parallelizer mechanism has to be redisigned anyway.
-  EIGEN_UNUSED_VARIABLE(transpose);
-  func(0,rows, 0,cols);
+/** \internal Makes sure that only one parallel product uses the threads at a time.
+  * The pool requires its tasks to run concurrently, so a product nested in another one,
+  * or running at the same time in another thread, must not use it. */
+inline int volatile& parallel_session_flag()
+{
+  static int volatile flag = 0;
+  return flag;
+}
+
+/** \internal Minimal number of multiply-adds a thread has to do to be worth starting it.
+  * Below that, the time spent to wake the threads and to synchronize the packed blocks dominates. */
+#ifndef EIGEN_GEMM_MIN_WORK_PER_THREAD
+#define EIGEN_GEMM_MIN_WORK_PER_THREAD (1<<18)
+#endif
+
+/** \internal \returns the number of threads worth using for a \a rows x \a cols x \a depth product
+  * split along \a size.
+  * Each thread gets at least 16 rows (resp. columns) so that the register blocking of the
+  * kernel stays efficient, and enough work to amortize the synchronization. */
+template<typename Index>
+Index gemm_max_threads(Index rows, Index cols, Index depth, Index size)
+{
+  double work = double(rows) * double(cols) * double(depth);
+  Index work_threads = Index((std::min)(work / double(EIGEN_GEMM_MIN_WORK_PER_THREAD), double(NumTraits<Index>::highest())));
+  Index size_threads = size / 16;
+  return (std::max<Index>)(1, (std::min)(work_threads, size_threads));
+}
+
+template<typename Functor, typename Index>
+struct gemm_parallel_task : ThreadPoolTask
+{
+  gemm_parallel_task(const Functor& func, Index rows, Index cols, Index threads, bool transpose, GemmParallelInfo<Index>* info)
+    : m_func(func), m_rows(rows), m_cols(cols), m_threads(threads), m_transpose(transpose), m_info(info)
+  {
+    m_blockCols = (cols / threads) & ~Index(0x3);
+    m_blockRows = (rows / threads) & ~Index(0x7);
+  }
+
+  void operator()(int task)
+  {
+    Index i = task;
+    Index r0 = i*m_blockRows;
+    Index actualBlockRows = (i+1==m_threads) ? m_rows-r0 : m_blockRows;
+
+    Index c0 = i*m_blockCols;
+    Index actualBlockCols = (i+1==m_threads) ? m_cols-c0 : m_blockCols;
+
+    m_info[i].rhs_start = c0;
+    m_info[i].rhs_length = actualBlockCols;
+
+    if(m_transpose)
+      m_func(0, m_cols, r0, actualBlockRows, m_info, i, m_threads);
+    else
+      m_func(r0, actualBlockRows, 0, m_cols, m_info, i, m_threads);
+  }
+
+  const Functor& m_func;
+  Index m_rows, m_cols, m_threads;
+  Index m_blockRows, m_blockCols;
+  bool m_transpose;
+  GemmParallelInfo<Index>* m_info;
+};
+
+/** \internal Runs \a task on \a threads threads, either on the user's pool or with OpenMP.
+  * \returns false if no threads are available, in which case nothing has been done. */
+inline bool run_parallel_task(ThreadPoolTask& task, int threads)
+{
+  if(ThreadPoolInterface* pool = threadPool())
+  {
+    pool->parallelFor(threads, task);
+    return true;
+  }
+#ifdef EIGEN_HAS_OPENMP
+  #pragma omp parallel for schedule(static,1) num_threads(threads)
+  for(int i=0; i<threads; ++i)
+    task(i);
+  return true;
+#else
+  EIGEN_UNUSED_VARIABLE(task);
+  EIGEN_UNUSED_VARIABLE(threads);
+  return false;
+#endif
+}
+
+/** \internal \returns the number of threads available for a new parallel session.
+  * On success, the caller owns the threads until end_parallel_session(). */
+inline int begin_parallel_session()
+{
+#ifdef EIGEN_NO_PARALLEL_PRODUCTS
+  return 1;
 #else
+  int threads = nbThreads();
+  if(threads<=1)
+    return 1;
+  #ifdef EIGEN_HAS_OPENMP
+  // are we already in an OpenMP parallel region?
+  if(threadPool()==0 && omp_get_num_threads()>1)
+    return 1;
+  #endif
+  if(!atomic_compare_and_swap(&parallel_session_flag(), 0, 1))
+    return 1;
+  return threads;
+#endif
+}
+
+inline void end_parallel_session()
+{
+#ifndef EIGEN_NO_PARALLEL_PRODUCTS
+  atomic_store(&parallel_session_flag(), 0);
+#endif
+}
 
-  // Dynamically check whether we should enable or disable OpenMP.
-  // The conditions are:
-  // - the max number of threads we can create is greater than 1
-  // - we are not already in a parallel code
+/** \internal Minimal number of multiply-adds a thread has to do in a matrix-vector product.
+  * These products are bound by the memory bandwidth and do not share any packed data,
+  * so the threshold is lower than for GEMM. */
+#ifndef EIGEN_GEMV_MIN_WORK_PER_THREAD
+#define EIGEN_GEMV_MIN_WORK_PER_THREAD (1<<16)
+#endif
+
+template<typename Functor, typename Index>
+struct gemv_parallel_task : ThreadPoolTask
+{
+  gemv_parallel_task(Functor& func, const Index* bounds) : m_func(func), m_bounds(bounds) {}
+
+  void operator()(int i)
+  {
+    m_func(m_bounds[i], m_bounds[i+1], Index(i));
+  }
+
+  Functor& m_func;
+  const Index* m_bounds;
+};
+
+/** \internal Runs a matrix-vector product on several threads if it is worth it.
+  *
+  * The product is split along \a size into one slice per thread such that each slice has
+  * about the same number of multiply-adds, as given by \a func.cost(i) for the i-th row
+  * (or column). The slices start on multiples of 16 to keep the packets aligned.
+  * Then \a func.initParallelSession(threads) is called, and \a func(start,end,tid) runs
+  * on each thread.
+  *
+  * \returns false if the product has to be done sequentially, in which case \a func has
+  * not been called. */
+template<typename Functor, typename Index>
+bool parallelize_gemv(Functor& func, Index size)
+{
+  if(size<32 || nbThreads()<=1)
+    return false;
+
+  double work = 0;
+  for(Index i=0; i<size; ++i)
+    work += double(func.cost(i));
+
+  Index max_threads = Index((std::min)(work / double(EIGEN_GEMV_MIN_WORK_PER_THREAD), double(size / 16)));
+  if(max_threads<=1)
+    return false;
+
+  Index threads = begin_parallel_session();
+  threads = (std::min)(threads, max_threads);
+  if(threads==1)
+  {
+    end_parallel_session();
+    return false;
+  }
+
+  Index* bounds = new Index[threads+1];
+  bounds[0] = 0;
+  double acc = 0;
+  Index i = 0;
+  for(Index t=1; t<threads; ++t)
+  {
+    double target = work * double(t) / double(threads);
+    while(i<size && acc<target)
+      acc += double(func.cost(i++));
+    Index end = (std::min)(size, (i+15) & ~Index(15));
+    while(i<end)
+      acc += double(func.cost(i++));
+    bounds[t] = i;
+  }
+  bounds[threads] = size;
+
+  func.initParallelSession(threads);
+  gemv_parallel_task<Functor,Index> task(func, bounds);
+  if(!run_parallel_task(task, int(threads)))
+  {
+    for(Index k=0; k<threads; ++k)
+      task(int(k));
+  }
+  delete[] bounds;
+
+  end_parallel_session();
+  return true;
+}
+
+/** \internal Minimal amount of work, in coefficient reads, of a thread running a coefficient-wise evaluation
+  * or a reduction. Like the matrix-vector products, these are bound by the memory bandwidth. */
+#ifndef EIGEN_COEFF_MIN_WORK_PER_THREAD
+#define EIGEN_COEFF_MIN_WORK_PER_THREAD (1<<16)
+#endif
+
+/** \internal Runs a loop over [0,\a size) on several threads if it is worth it, given the \a cost of one
+  * iteration.
+  *
+  * The range is split into one slice per thread of about the same size, starting on multiples of 16 to
+  * keep the packets aligned. Then \a func.initParallelSession(threads) is called, and \a func(start,end,tid)
+  * runs on each thread.
+  *
+  * \returns false if the loop has to be run sequentially, in which case \a func has not been called.
+  * \sa parallelize_gemv() for loops whose iterations have different costs */
+template<typename Functor, typename Index>
+bool parallelize_range(Functor& func, Index size, Index cost)
+{
+  if(size<32 || nbThreads()<=1)
+    return false;
+
+  Index max_threads = Index((std::min)(double(size) * double(cost) / double(EIGEN_COEFF_MIN_WORK_PER_THREAD),
+                                       double(size / 16)));
+  if(max_threads<=1)
+    return false;
+
+  Index threads = begin_parallel_session();
+  threads = (std::min)(threads, max_threads);
+  if(threads==1)
+  {
+    end_parallel_session();
+    return false;
+  }
+
+  Index* bounds = new Index[threads+1];
+  const Index chunk = (size / threads + 15) & ~Index(15);
+  for(Index t=0; t<threads; ++t)
+    bounds[t] = (std::min)(size, t*chunk);
+  bounds[threads] = size;
+
+  func.initParallelSession(threads);
+  gemv_parallel_task<Functor,Index> task(func, bounds);
+  if(!run_parallel_task(task, int(threads)))
+  {
+    for(Index k=0; k<threads; ++k)
+      task(int(k));
+  }
+  delete[] bounds;
+
+  end_parallel_session();
+  return true;
+}
+
+template<bool Condition, typename Functor, typename Index>
+void parallelize_gemm(const Functor& func, Index rows, Index cols, Index depth, bool transpose)
+{
+  // Dynamically check whether we should run in parallel. The conditions are:
+  // - the product can be large enough
+  // - the max number of threads we can use is greater than 1
+  // - no other product is already running in parallel
   // - the sizes are large enough
 
-  // 1- are we already in a parallel session?
-  // FIXME omp_get_num_threads()>1 only works for openmp, what if the user does not use openmp?
-  if((!Condition) || (omp_get_num_threads()>1))
+  if(!Condition)
     return func(0,rows, 0,cols);
 
+  // The transpose flag tells along which dimension the product is split, such that
+  // each thread gets a set of full columns of a row-major destination.
   Index size = transpose ? cols : rows;
+  Index max_threads = gemm_max_threads(rows, cols, depth, size);
+  if(max_threads==1)
+    return func(0,rows, 0,cols);
 
-  // 2- compute the maximal number of threads from the size of the product:
-  // FIXME this has to be fine tuned
-  Index max_threads = std::max<Index>(1,size / 32);
-
-  // 3 - compute the number of threads we are going to use
-  Index threads = std::min<Index>(nbThreads(), max_threads);
-
+  Index threads = begin_parallel_session();
+  threads = (std::min)(threads, max_threads);
   if(threads==1)
+  {
+    end_parallel_session();
     return func(0,rows, 0,cols);
+  }
 
   func.initParallelSession();
 
   if(transpose)
     std::swap(rows,cols);
 
-  Index blockCols = (cols / threads) & ~Index(0x3);
-  Index blockRows = (rows / threads) & ~Index(0x7);
-  
   GemmParallelInfo<Index>* info = new GemmParallelInfo<Index>[threads];
-
-  #pragma omp parallel for schedule(static,1) num_threads(threads)
-  for(Index i=0; i<threads; ++i)
+  gemm_parallel_task<Functor,Index> task(func, rows, cols, threads, transpose, info);
+  if(!run_parallel_task(task, int(threads)))
   {
-    Index r0 = i*blockRows;
-    Index actualBlockRows = (i+1==threads) ? rows-r0 : blockRows;
-
-    Index c0 = i*blockCols;
-    Index actualBlockCols = (i+1==threads) ? cols-c0 : blockCols;
-
-    info[i].rhs_start = c0;
-    info[i].rhs_length = actualBlockCols;
-
     if(transpose)
-      func(0, cols, r0, actualBlockRows, info);
-    else
-      func(r0, actualBlockRows, 0,cols, info);
+      std::swap(rows,cols);
+    func(0,rows, 0,cols);
   }
-
   delete[] info;
-#endif
+
+  end_parallel_session();
 }
 
 } // end namespace internal
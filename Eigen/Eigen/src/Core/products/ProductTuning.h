@@ -0,0 +1,229 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_PRODUCT_TUNING_H
+#define EIGEN_PRODUCT_TUNING_H
+
+namespace internal {
+
+/** \internal \returns the index of the blocking sizes of a product of \c LhsScalar by \c RhsScalar in product_tuning,
+  * or -1 if they cannot be tuned */
+template<typename LhsScalar, typename RhsScalar> struct product_tuning_index { enum { value = -1 }; };
+template<> struct product_tuning_index<float,float> { enum { value = 0 }; };
+template<> struct product_tuning_index<double,double> { enum { value = 1 }; };
+template<> struct product_tuning_index<std::complex<float>,std::complex<float> > { enum { value = 2 }; };
+template<> struct product_tuning_index<std::complex<double>,std::complex<double> > { enum { value = 3 }; };
+
+/** \internal The parameters of the matrix products which can be tuned at runtime.
+  * A value of 0 means that the parameter is derived from the cache sizes. */
+struct product_tuning
+{
+  enum { ScalarCount = 4 };
+
+  std::ptrdiff_t l1CacheSize;
+  std::ptrdiff_t l2CacheSize;
+  std::ptrdiff_t kc[ScalarCount];       // upper bound of the blocking size along the depth
+  std::ptrdiff_t mc[ScalarCount];       // upper bound of the blocking size along the rows of the lhs
+  std::ptrdiff_t coeffBasedThreshold;   // products with rows+cols+depth below this are coefficient based
+
+  static const char* scalarName(int i)
+  {
+    static const char* names[ScalarCount] = { "float", "double", "cfloat", "cdouble" };
+    return names[i];
+  }
+
+  /** \internal sets the cache sizes to the ones of the cpu and clears all the other parameters */
+  void setDefault()
+  {
+    l1CacheSize = queryL1CacheSize();
+    l2CacheSize = queryTopLevelCacheSize();
+    if(l1CacheSize<=0) l1CacheSize = 8 * 1024;
+    if(l2CacheSize<=0) l2CacheSize = 1 * 1024 * 1024;
+    for(int i = 0; i < ScalarCount; ++i)
+      kc[i] = mc[i] = 0;
+    coeffBasedThreshold = 0;
+  }
+
+  /** \internal Reads a profile written by write(). Each line holds a parameter name followed by its value,
+    * lines starting with '#' are comments, and missing parameters are left unchanged.
+    * \returns false if the file cannot be read or is not a valid profile, e.g. if it sets a cache size to 0 */
+  bool read(const char* filename)
+  {
+    std::FILE* file = std::fopen(filename, "r");
+    if(file==0)
+      return false;
+    product_tuning result = *this;
+    bool ok = true;
+    char key[64];
+    while(ok && std::fscanf(file, " %63s", key)==1)
+    {
+      if(key[0]=='#')
+      {
+        int c;
+        do { c = std::fgetc(file); } while(c!='\n' && c!=EOF);
+        continue;
+      }
+      long value;
+      if(std::fscanf(file, "%ld", &value)!=1 || value<0)
+      {
+        ok = false;
+        break;
+      }
+      std::ptrdiff_t* param = result.find(key);
+      if(param)
+        *param = std::ptrdiff_t(value);
+    }
+    std::fclose(file);
+    // the blocking sizes are derived from the cache sizes, which thus cannot be 0
+    if(result.l1CacheSize<=0 || result.l2CacheSize<=0)
+      ok = false;
+    if(ok)
+      *this = result;
+    return ok;
+  }
+
+  /** \internal writes the parameters to \a filename
+    * \returns false if the file cannot be written */
+  bool write(const char* filename) const
+  {
+    std::FILE* file = std::fopen(filename, "w");
+    if(file==0)
+      return false;
+    std::fprintf(file, "# Eigen product tuning profile\n");
+    std::fprintf(file, "l1_cache_size %ld\n", long(l1CacheSize));
+    std::fprintf(file, "l2_cache_size %ld\n", long(l2CacheSize));
+    for(int i = 0; i < ScalarCount; ++i)
+    {
+      std::fprintf(file, "kc_%s %ld\n", scalarName(i), long(kc[i]));
+      std::fprintf(file, "mc_%s %ld\n", scalarName(i), long(mc[i]));
+    }
+    std::fprintf(file, "coeff_based_product_threshold %ld\n", long(coeffBasedThreshold));
+    return std::fclose(file)==0;
+  }
+
+  /** \internal \returns a pointer to the parameter named \a key, or 0 if there is no such parameter */
+  std::ptrdiff_t* find(const char* key)
+  {
+    if(std::strcmp(key, "l1_cache_size")==0) return &l1CacheSize;
+    if(std::strcmp(key, "l2_cache_size")==0) return &l2CacheSize;
+    if(std::strcmp(key, "coeff_based_product_threshold")==0) return &coeffBasedThreshold;
+    for(int i = 0; i < ScalarCount; ++i)
+    {
+      if(std::strncmp(key, "kc_", 3)==0 && std::strcmp(key+3, scalarName(i))==0) return &kc[i];
+      if(std::strncmp(key, "mc_", 3)==0 && std::strcmp(key+3, scalarName(i))==0) return &mc[i];
+    }
+    return 0;
+  }
+};
+
+/** \internal \returns the tuning parameters of the products.
+  * They are initialized at the first call from the cpu cache sizes, and then from the profile named by the
+  * EIGEN_TUNING_PROFILE environment variable, or by the EIGEN_TUNING_PROFILE preprocessor token if the former
+  * is not set. */
+inline product_tuning& product_tuning_parameters()
+{
+  static product_tuning tuning;
+  static bool initialized = false;
+  if(!initialized)
+  {
+    initialized = true;
+    tuning.setDefault();
+    const char* filename = std::getenv("EIGEN_TUNING_PROFILE");
+    #ifdef EIGEN_TUNING_PROFILE
+    if(filename==0)
+      filename = EIGEN_TUNING_PROFILE;
+    #endif
+    if(filename)
+      tuning.read(filename);
+  }
+  return tuning;
+}
+
+} // end namespace internal
+
+/** Loads the tuning profile \a filename, as written by saveTuningProfile() or by the bench/tune_products tool.
+  * The parameters which are not set in the profile are left unchanged.
+  *
+  * A profile is also loaded automatically at the first product from the file named by the EIGEN_TUNING_PROFILE
+  * environment variable or, failing that, by the EIGEN_TUNING_PROFILE preprocessor token.
+  *
+  * \returns false if the file cannot be read or is not a valid profile, in which case nothing is changed
+  * \sa saveTuningProfile(), setCpuCacheSizes(), setMaxProductBlockingSizes(), setCoeffBasedProductThreshold() */
+inline bool loadTuningProfile(const char* filename)
+{
+  return internal::product_tuning_parameters().read(filename);
+}
+
+/** Writes the current cache sizes, blocking sizes and product thresholds to the tuning profile \a filename.
+  * \returns false if the file cannot be written
+  * \sa loadTuningProfile() */
+inline bool saveTuningProfile(const char* filename)
+{
+  return internal::product_tuning_parameters().write(filename);
+}
+
+/** Sets the upper bounds of the blocking sizes of the matrix products of \c Scalar along the depth (\a kc) and
+  * along the rows of the left hand side (\a mc). A value of 0 restores the blocking size derived from the
+  * cache sizes. Only float, double and their complex versions can be tuned.
+  *
+  * \sa maxProductBlockingSizes(), computeProductBlockingSizes() */
+template<typename Scalar>
+inline void setMaxProductBlockingSizes(std::ptrdiff_t kc, std::ptrdiff_t mc)
+{
+  enum { TuningIndex = internal::product_tuning_index<Scalar,Scalar>::value };
+  EIGEN_STATIC_ASSERT(TuningIndex>=0, YOU_MADE_A_PROGRAMMING_MISTAKE)
+  eigen_assert(kc>=0 && mc>=0);
+  internal::product_tuning_parameters().kc[TuningIndex] = kc;
+  internal::product_tuning_parameters().mc[TuningIndex] = mc;
+}
+
+/** Gets the upper bounds of the blocking sizes of the matrix products of \c Scalar, 0 meaning that they are
+  * derived from the cache sizes.
+  * \sa setMaxProductBlockingSizes() */
+template<typename Scalar>
+inline void maxProductBlockingSizes(std::ptrdiff_t& kc, std::ptrdiff_t& mc)
+{
+  enum { TuningIndex = internal::product_tuning_index<Scalar,Scalar>::value };
+  EIGEN_STATIC_ASSERT(TuningIndex>=0, YOU_MADE_A_PROGRAMMING_MISTAKE)
+  kc = internal::product_tuning_parameters().kc[TuningIndex];
+  mc = internal::product_tuning_parameters().mc[TuningIndex];
+}
+
+/** Sets the size below which the products of dynamic size matrices are evaluated coefficient by coefficient
+  * (as lazyProduct()) rather than by the cache friendly matrix product kernel. The size of a product is the
+  * sum of its number of rows, columns and depth. A value of 0, the default, always selects the latter.
+  *
+  * \sa coeffBasedProductThreshold() */
+inline void setCoeffBasedProductThreshold(std::ptrdiff_t size)
+{
+  eigen_assert(size>=0);
+  internal::product_tuning_parameters().coeffBasedThreshold = size;
+}
+
+/** \returns the size below which the products of dynamic size matrices are coefficient based
+  * \sa setCoeffBasedProductThreshold() */
+inline std::ptrdiff_t coeffBasedProductThreshold()
+{
+  return internal::product_tuning_parameters().coeffBasedThreshold;
+}
+
+#endif // EIGEN_PRODUCT_TUNING_H
@@ -33,10 +33,10 @@ namespace internal {
  * the instruction dependency.
  */
 template<typename Scalar, typename Index, int StorageOrder, int UpLo, bool ConjugateLhs, bool ConjugateRhs>
-static EIGEN_DONT_INLINE void product_selfadjoint_vector(
-  Index size,
+static EIGEN_DONT_INLINE void product_selfadjoint_vector_columns(
+  Index size, Index colStart, Index colEnd,
   const Scalar*  lhs, Index lhsStride,
-  const Scalar* _rhs, Index rhsIncr,
+  const Scalar* rhs,
   Scalar* res,
   Scalar alpha)
 {
@@ -59,23 +59,16 @@ static EIGEN_DONT_INLINE void product_selfadjoint_vector(
 
   Scalar cjAlpha = ConjugateRhs ? conj(alpha) : alpha;
 
-  // FIXME this copy is now handled outside product_selfadjoint_vector, so it could probably be removed.
-  // if the rhs is not sequentially stored in memory we copy it to a temporary buffer,
-  // this is because we need to extract packets
-  ei_declare_aligned_stack_constructed_variable(Scalar,rhs,size,rhsIncr==1 ? const_cast<Scalar*>(_rhs) : 0);  
-  if (rhsIncr!=1)
-  {
-    const Scalar* it = _rhs;
-    for (Index i=0; i<size; ++i, it+=rhsIncr)
-      rhs[i] = *it;
-  }
-
+  // The short columns are processed one at a time, and the other ones two at a time.
   Index bound = (std::max)(Index(0),size-8) & 0xfffffffe;
   if (FirstTriangular)
     bound = size - bound;
 
-  for (Index j=FirstTriangular ? bound : 0;
-       j<(FirstTriangular ? size : bound);j+=2)
+  Index pairStart = FirstTriangular ? (std::max)(colStart,bound) : colStart;
+  Index pairEnd   = FirstTriangular ? colEnd : (std::min)(colEnd,bound);
+  pairEnd = pairStart + ((std::max)(Index(0),pairEnd-pairStart) & ~Index(1));
+
+  for (Index j=pairStart; j<pairEnd; j+=2)
   {
     register const Scalar* EIGEN_RESTRICT A0 = lhs + j*lhsStride;
     register const Scalar* EIGEN_RESTRICT A1 = lhs + (j+1)*lhsStride;
@@ -111,9 +104,9 @@ static EIGEN_DONT_INLINE void product_selfadjoint_vector(
 
     for (size_t i=starti; i<alignedStart; ++i)
     {
-      res[i] += t0 * A0[i] + t1 * A1[i];
-      t2 += conj(A0[i]) * rhs[i];
-      t3 += conj(A1[i]) * rhs[i];
+      res[i] += cj0.pmul(A0[i], t0) + cj0.pmul(A1[i], t1);
+      t2 += cj1.pmul(A0[i], rhs[i]);
+      t3 += cj1.pmul(A1[i], rhs[i]);
     }
     // Yes this an optimization for gcc 4.3 and 4.4 (=> huge speed up)
     // gcc 4.2 does this optimization automatically.
@@ -143,8 +136,13 @@ static EIGEN_DONT_INLINE void product_selfadjoint_vector(
     res[j]   += alpha * (t2 + predux(ptmp2));
     res[j+1] += alpha * (t3 + predux(ptmp3));
   }
-  for (Index j=FirstTriangular ? 0 : bound;j<(FirstTriangular ? bound : size);j++)
+  for (Index j=colStart; j<colEnd; j++)
   {
+    if (j==pairStart && pairEnd>pairStart)
+    {
+      j = pairEnd-1;
+      continue;
+    }
     register const Scalar* EIGEN_RESTRICT A0 = lhs + j*lhsStride;
 
     Scalar t1 = cjAlpha * rhs[j];
@@ -160,6 +158,99 @@ static EIGEN_DONT_INLINE void product_selfadjoint_vector(
   }
 }
 
+template<typename Scalar, typename Index, int StorageOrder, int UpLo, bool ConjugateLhs, bool ConjugateRhs>
+static void product_selfadjoint_vector(
+  Index size,
+  const Scalar*  lhs, Index lhsStride,
+  const Scalar* _rhs, Index rhsIncr,
+  Scalar* res,
+  Scalar alpha)
+{
+  // FIXME this copy is now handled outside product_selfadjoint_vector, so it could probably be removed.
+  // if the rhs is not sequentially stored in memory we copy it to a temporary buffer,
+  // this is because we need to extract packets
+  ei_declare_aligned_stack_constructed_variable(Scalar,rhs,size,rhsIncr==1 ? const_cast<Scalar*>(_rhs) : 0);
+  if (rhsIncr!=1)
+  {
+    const Scalar* it = _rhs;
+    for (Index i=0; i<size; ++i, it+=rhsIncr)
+      rhs[i] = *it;
+  }
+
+  product_selfadjoint_vector_columns<Scalar,Index,StorageOrder,UpLo,ConjugateLhs,ConjugateRhs>(size, 0, size, lhs, lhsStride, rhs, res, alpha);
+}
+
+/* Multithreaded driver of product_selfadjoint_vector: the columns of the stored triangle are
+ * split over the threads. Each column updates both its own coefficient of the result and the
+ * coefficients below (or above) the diagonal, so every thread accumulates into a private
+ * result which is summed up at the end. This way the matrix is read only once.
+ */
+template<typename Scalar, typename Index, int StorageOrder, int UpLo, bool ConjugateLhs, bool ConjugateRhs>
+struct parallel_selfadjoint_vector
+{
+  enum {
+    FirstTriangular = (StorageOrder==RowMajor) == (UpLo==Lower)
+  };
+
+  parallel_selfadjoint_vector(Index size, const Scalar* lhs, Index lhsStride, const Scalar* rhs, Scalar alpha)
+    : m_size(size), m_lhs(lhs), m_lhsStride(lhsStride), m_rhs(rhs), m_alpha(alpha), m_threads(0), m_results(0), m_ranges(0)
+  {}
+
+  ~parallel_selfadjoint_vector()
+  {
+    aligned_delete(m_results, m_size*m_threads);
+    delete[] m_ranges;
+  }
+
+  Index cost(Index j) const { return FirstTriangular ? j+1 : m_size-j; }
+
+  void initParallelSession(Index threads)
+  {
+    m_threads = threads;
+    m_results = aligned_new<Scalar>(m_size*m_threads);
+    m_ranges = new Index[2*m_threads];
+  }
+
+  void operator()(Index start, Index end, Index tid)
+  {
+    // the columns [start,end) only touch the rows [0,end) (resp. [start,size))
+    Scalar* res = m_results + tid*m_size;
+    Index first = FirstTriangular ? 0 : start;
+    Index last = FirstTriangular ? end : m_size;
+    if(start==end)
+      first = last = start;
+    std::fill(res+first, res+last, Scalar(0));
+    product_selfadjoint_vector_columns<Scalar,Index,StorageOrder,UpLo,ConjugateLhs,ConjugateRhs>
+      (m_size, start, end, m_lhs, m_lhsStride, m_rhs, res, m_alpha);
+    m_ranges[2*tid] = first;
+    m_ranges[2*tid+1] = last;
+  }
+
+  static void run(Index size, const Scalar* lhs, Index lhsStride, const Scalar* rhs, Scalar* res, Scalar alpha)
+  {
+    parallel_selfadjoint_vector func(size, lhs, lhsStride, rhs, alpha);
+    if(!parallelize_gemv(func, size))
+      return product_selfadjoint_vector_columns<Scalar,Index,StorageOrder,UpLo,ConjugateLhs,ConjugateRhs>(size, 0, size, lhs, lhsStride, rhs, res, alpha);
+
+    typedef Map<Matrix<Scalar,Dynamic,1> > MappedRes;
+    MappedRes dest(res, size);
+    for(Index t=0; t<func.m_threads; ++t)
+    {
+      Index first = func.m_ranges[2*t];
+      Index last = func.m_ranges[2*t+1];
+      dest.segment(first, last-first) += MappedRes(func.m_results + t*size, size).segment(first, last-first);
+    }
+  }
+
+  Index m_size;
+  const Scalar* m_lhs; Index m_lhsStride;
+  const Scalar* m_rhs;
+  Scalar m_alpha;
+  Index m_threads;
+  Scalar* m_results;
+  Index* m_ranges;
+};
+
 } // end namespace internal 
 
 /***************************************************************************
@@ -232,11 +323,11 @@ struct SelfadjointProductMatrix<Lhs,LhsMode,false,Rhs,0,true>
     }
       
       
-    internal::product_selfadjoint_vector<Scalar, Index, (internal::traits<_ActualLhsType>::Flags&RowMajorBit) ? RowMajor : ColMajor, int(LhsUpLo), bool(LhsBlasTraits::NeedToConjugate), bool(RhsBlasTraits::NeedToConjugate)>
+    internal::parallel_selfadjoint_vector<Scalar, Index, (internal::traits<_ActualLhsType>::Flags&RowMajorBit) ? RowMajor : ColMajor, int(LhsUpLo), bool(LhsBlasTraits::NeedToConjugate), bool(RhsBlasTraits::NeedToConjugate)>::run
       (
         lhs.rows(),                             // size
         &lhs.coeffRef(0,0),  lhs.outerStride(), // lhs info
-        actualRhsPtr, 1,                        // rhs info
+        actualRhsPtr,                           // rhs info
         actualDestPtr,                          // result info
         actualAlpha                             // scale factor
       );
@@ -132,6 +132,78 @@ struct product_triangular_matrix_vector<Index,Mode,LhsScalar,ConjLhs,RhsScalar,C
   }
 };
 
+/* Multithreaded driver of product_triangular_matrix_vector: the rows of the result are
+ * split over the threads. For a lower triangular matrix, the slice [start,end) is made of the
+ * general block on the left of the diagonal and of the triangular block on the diagonal.
+ * For an upper triangular matrix, it is the triangular block on the diagonal and the general
+ * block on its right.
+ */
+template<typename Index, int Mode, typename LhsScalar, bool ConjLhs, typename RhsScalar, bool ConjRhs, int StorageOrder>
+struct parallel_triangular_matrix_vector
+{
+  typedef product_triangular_matrix_vector<Index,Mode,LhsScalar,ConjLhs,RhsScalar,ConjRhs,StorageOrder> Trmv;
+  typedef general_matrix_vector_product<Index,LhsScalar,StorageOrder,ConjLhs,RhsScalar,ConjRhs> Gemv;
+  typedef typename scalar_product_traits<LhsScalar, RhsScalar>::ReturnType ResScalar;
+  enum {
+    IsLower = ((Mode&Lower)==Lower)
+  };
+
+  struct functor
+  {
+    functor(Index cols, const LhsScalar* lhs, Index lhsStride, const RhsScalar* rhs, Index rhsIncr,
+            ResScalar* res, Index resIncr, ResScalar alpha)
+      : m_cols(cols), m_lhs(lhs), m_lhsStride(lhsStride), m_rhs(rhs), m_rhsIncr(rhsIncr),
+        m_res(res), m_resIncr(resIncr), m_alpha(alpha)
+    {}
+
+    Index cost(Index i) const { return IsLower ? (std::min)(i+1, m_cols) : (std::max)(Index(0), m_cols-i); }
+    void initParallelSession(Index) const {}
+
+    const LhsScalar* lhs(Index i, Index j) const
+    {
+      return StorageOrder==RowMajor ? m_lhs + i*m_lhsStride + j : m_lhs + i + j*m_lhsStride;
+    }
+
+    void operator()(Index start, Index end, Index) const
+    {
+      if(end<=start)
+        return;
+      ResScalar* res = m_res + start*m_resIncr;
+      if(IsLower)
+      {
+        Index left = (std::min)(start, m_cols);
+        Index diag = (std::max)(Index(0), (std::min)(end, m_cols) - start);
+        if(left>0)
+          Gemv::run(end-start, left, lhs(start,0), m_lhsStride, m_rhs, m_rhsIncr, res, m_resIncr, m_alpha);
+        if(diag>0)
+          Trmv::run(end-start, diag, lhs(start,start), m_lhsStride, m_rhs + start*m_rhsIncr, m_rhsIncr, res, m_resIncr, m_alpha);
+      }
+      else if(start<m_cols)
+      {
+        Index diag = (std::min)(end, m_cols) - start;
+        Index right = m_cols - start - diag;
+        Trmv::run(end-start, diag, lhs(start,start), m_lhsStride, m_rhs + start*m_rhsIncr, m_rhsIncr, res, m_resIncr, m_alpha);
+        if(right>0)
+          Gemv::run(end-start, right, lhs(start,start+diag), m_lhsStride, m_rhs + (start+diag)*m_rhsIncr, m_rhsIncr, res, m_resIncr, m_alpha);
+      }
+    }
+
+    Index m_cols;
+    const LhsScalar* m_lhs; Index m_lhsStride;
+    const RhsScalar* m_rhs; Index m_rhsIncr;
+    ResScalar* m_res; Index m_resIncr;
+    ResScalar m_alpha;
+  };
+
+  static void run(Index rows, Index cols, const LhsScalar* lhs, Index lhsStride,
+                  const RhsScalar* rhs, Index rhsIncr, ResScalar* res, Index resIncr, ResScalar alpha)
+  {
+    functor func(cols, lhs, lhsStride, rhs, rhsIncr, res, resIncr, alpha);
+    if(!parallelize_gemv(func, rows))
+      Trmv::run(rows, cols, lhs, lhsStride, rhs, rhsIncr, res, resIncr, alpha);
+  }
+};
+
 /***************************************************************************
 * Wrapper to product_triangular_vector
 ***************************************************************************/
@@ -247,7 +319,7 @@ template<> struct trmv_selector<ColMajor>
         MappedDest(actualDestPtr, dest.size()) = dest;
     }
     
-    internal::product_triangular_matrix_vector
+    internal::parallel_triangular_matrix_vector
       <Index,Mode,
        LhsScalar, LhsBlasTraits::NeedToConjugate,
        RhsScalar, RhsBlasTraits::NeedToConjugate,
@@ -307,7 +379,7 @@ template<> struct trmv_selector<RowMajor>
       Map<typename _ActualRhsType::PlainObject>(actualRhsPtr, actualRhs.size()) = actualRhs;
     }
     
-    internal::product_triangular_matrix_vector
+    internal::parallel_triangular_matrix_vector
       <Index,Mode,
        LhsScalar, LhsBlasTraits::NeedToConjugate,
        RhsScalar, RhsBlasTraits::NeedToConjugate,
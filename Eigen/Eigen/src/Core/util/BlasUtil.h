@@ -50,6 +50,9 @@ struct general_matrix_matrix_product;
 template<typename Index, typename LhsScalar, int LhsStorageOrder, bool ConjugateLhs, typename RhsScalar, bool ConjugateRhs>
 struct general_matrix_vector_product;
 
+template<typename Index, typename LhsScalar, int LhsStorageOrder, bool ConjugateLhs, typename RhsScalar, bool ConjugateRhs>
+struct parallel_matrix_vector_product;
+
 
 template<bool Conjugate> struct conj_if;
 
@@ -358,6 +358,23 @@ enum DecompositionOptions {
   GenEigMask = Ax_lBx | ABx_lx | BAx_lx
 };
 
+/** \ingroup enums
+  * Enum with the reductions computed in a single pass by DenseBase::reductions() and
+  * VectorwiseOp::reductions(). They can be combined with the bitwise or operator.
+  * \sa class Reductions, class VectorwiseReductions */
+enum ReductionOptions {
+  /** Computes the sum, and thus the mean, of the coefficients. */
+  SumReduction         = 0x1,
+  /** Computes the minimum of the coefficients. */
+  MinReduction         = 0x2,
+  /** Computes the maximum of the coefficients. */
+  MaxReduction         = 0x4,
+  /** Computes the squared norm, and thus the norm, of the coefficients. */
+  SquaredNormReduction = 0x8,
+  /** Computes all of the above. */
+  AllReductions = SumReduction | MinReduction | MaxReduction | SquaredNormReduction
+};
+
 /** \ingroup enums
   * Possible values for the \p QRPreconditioner template parameter of JacobiSVD. */
 enum QRPreconditioners {
@@ -409,7 +426,10 @@ namespace Architecture
     Generic = 0x0,
     SSE = 0x1,
     AltiVec = 0x2,
-#if defined EIGEN_VECTORIZE_SSE
+#if defined EIGEN_VECTORIZE_AVX
+    // the SSE specializations expect 128 bits float and double packets
+    Target = Generic
+#elif defined EIGEN_VECTORIZE_SSE
     Target = SSE
 #elif defined EIGEN_VECTORIZE_ALTIVEC
     Target = AltiVec
@@ -120,6 +120,14 @@
 #define EIGEN_FAST_MATH 1
 #endif
 
+/** Allows to vectorize the double precision Cwise::pow() as exp(b*log(a)), whose error grows
+  * with |b*log(a)| up to hundreds of ulp. It is disabled by default, and set EIGEN_FAST_POW to 1
+  * to enable it.
+  */
+#ifndef EIGEN_FAST_POW
+#define EIGEN_FAST_POW 0
+#endif
+
 #define EIGEN_DEBUG_VAR(x) std::cerr << #x << " = " << x << std::endl;
 
 // concatenate two tokens
@@ -274,6 +282,12 @@
 
 #define EIGEN_ALIGN16 EIGEN_ALIGN_TO_BOUNDARY(16)
 
+/* EIGEN_ALIGN_BYTES is the alignment in bytes guaranteed by aligned_malloc() and by the storage of the fixed size
+ * objects, and thus the alignment meant by AlignedBit. It is smaller than the AVX packets, which are loaded and
+ * stored unaligned.
+ */
+#define EIGEN_ALIGN_BYTES 16
+
 #if EIGEN_ALIGN_STATICALLY
 #define EIGEN_USER_ALIGN_TO_BOUNDARY(n) EIGEN_ALIGN_TO_BOUNDARY(n)
 #define EIGEN_USER_ALIGN16 EIGEN_ALIGN16
@@ -464,6 +464,229 @@ inline static Index first_aligned(const Scalar* array, Index size)
 
 } // end namespace internal
 
+/*****************************************************************************
+*** Implementation of the thread-local workspace arena                     ***
+*****************************************************************************/
+
+// The temporaries of the products and decompositions which are too large for the stack (the packed
+// blocks of the matrix products for instance) are drawn from a per-thread buffer which is kept alive
+// between calls, so that a loop of products does not go through malloc each time. Define
+// EIGEN_DONT_USE_WORKSPACE to allocate them on the heap instead. You can overwrite the thread-local
+// storage specifier by defining EIGEN_THREAD_LOCAL.
+// The buffer of a thread is freed when the thread exits if pthreads are available (EIGEN_HAS_PTHREADS).
+// Otherwise, as with MSVC, call setWorkspaceSize(0) before the exit of a thread which used Eigen.
+#ifndef EIGEN_THREAD_LOCAL
+  #if defined(__GNUC__) && !defined(__APPLE__)
+    #define EIGEN_THREAD_LOCAL __thread
+  #elif defined(_MSC_VER)
+    #define EIGEN_THREAD_LOCAL __declspec(thread)
+  #endif
+#endif
+
+#if (!defined EIGEN_DONT_USE_WORKSPACE) && (!defined EIGEN_THREAD_LOCAL)
+  #define EIGEN_DONT_USE_WORKSPACE
+#endif
+
+namespace internal {
+
+struct workspace_arena
+{
+  unsigned char* data;  // the buffer, 16 bytes aligned
+  size_t capacity;      // its size in bytes
+  size_t top;           // offset of the first free byte of the buffer
+  size_t blocks;        // number of live blocks taken from the buffer
+  size_t used;          // bytes requested by the live blocks, including the ones which did not fit in the buffer
+  size_t peak;          // highest value of used
+};
+
+/** \internal \returns the workspace of the calling thread */
+inline workspace_arena& thread_workspace()
+{
+#ifndef EIGEN_DONT_USE_WORKSPACE
+  static EIGEN_THREAD_LOCAL workspace_arena arena;
+#else
+  static workspace_arena arena;
+#endif
+  return arena;
+}
+
+#if (!defined EIGEN_DONT_USE_WORKSPACE) && (defined EIGEN_HAS_PTHREADS)
+/** \internal Frees the buffer of the workspace \a arena of an exiting thread */
+inline void workspace_thread_exit(void* arena)
+{
+  workspace_arena* a = static_cast<workspace_arena*>(arena);
+  aligned_free(a->data);
+  a->data = 0;
+  a->capacity = 0;
+  a->top = 0;
+}
+
+/** \internal Makes sure that the buffer of the workspace \a arena of the calling thread is freed at its exit */
+inline void workspace_register_thread(workspace_arena& arena)
+{
+  static pthread_key_t key;
+  static bool created = pthread_key_create(&key, workspace_thread_exit)==0;
+  if(created)
+    pthread_setspecific(key, &arena);
+}
+#else
+inline void workspace_register_thread(workspace_arena&) {}
+#endif
+
+/** \internal \returns \a size rounded up to a multiple of 16 */
+inline size_t workspace_block_size(size_t size)
+{
+  return (size + 15) & ~size_t(15);
+}
+
+/** \internal Allocates \a size bytes, 16 bytes aligned, from the workspace of the calling thread.
+  * If the workspace is too small, the memory is allocated on the heap, and the workspace will be
+  * enlarged the next time it is empty. The memory must be released with workspace_free().
+  */
+inline void* workspace_malloc(size_t size)
+{
+#ifdef EIGEN_DONT_USE_WORKSPACE
+  return aligned_malloc(size);
+#else
+  workspace_arena& arena = thread_workspace();
+  size = workspace_block_size(size);
+  if(arena.used + size > arena.peak)
+    arena.peak = arena.used + size;
+  if(arena.blocks==0 && arena.peak > arena.capacity)
+  {
+    // the workspace is empty, enlarge it to the largest amount of memory required so far
+    aligned_free(arena.data);
+    arena.data = 0;
+    arena.capacity = 0;
+    arena.data = static_cast<unsigned char*>(aligned_malloc(arena.peak));
+    arena.capacity = arena.peak;
+    workspace_register_thread(arena);
+  }
+  void* result;
+  if(arena.top + size > arena.capacity)
+    result = aligned_malloc(size);
+  else
+  {
+    result = arena.data + arena.top;
+    arena.top += size;
+    ++arena.blocks;
+  }
+  arena.used += size;
+  return result;
+#endif
+}
+
+/** \internal Frees memory allocated with workspace_malloc(). \a size must be the size passed to workspace_malloc().
+  * The blocks of the workspace are best released in the reverse order of their allocation, but the space of the
+  * others is recovered as soon as all the blocks have been released.
+  */
+inline void workspace_free(void* ptr, size_t size)
+{
+#ifdef EIGEN_DONT_USE_WORKSPACE
+  aligned_free(ptr);
+  EIGEN_UNUSED_VARIABLE(size);
+#else
+  if(ptr==0)
+    return;
+  workspace_arena& arena = thread_workspace();
+  size = workspace_block_size(size);
+  arena.used -= size;
+  unsigned char* p = static_cast<unsigned char*>(ptr);
+  if(p >= arena.data && p < arena.data + arena.capacity)
+  {
+    if(--arena.blocks==0)
+      arena.top = 0;
+    else if(p + size == arena.data + arena.top)
+      arena.top -= size;
+  }
+  else
+    aligned_free(ptr);
+#endif
+}
+
+/** \internal Allocates \a size objects of type T from the workspace of the calling thread, and calls their default constructors
+  * \sa workspace_delete()
+  */
+template<typename T> inline T* workspace_new(size_t size)
+{
+  T *result = reinterpret_cast<T*>(workspace_malloc(sizeof(T)*size));
+  return construct_elements_of_array(result, size);
+}
+
+/** \internal Deletes objects constructed with workspace_new
+  * The \a size parameters tells on how many objects to call the destructor of T.
+  */
+template<typename T> inline void workspace_delete(T *ptr, size_t size)
+{
+  if(ptr==0)
+    return;
+  destruct_elements_of_array<T>(ptr, size);
+  workspace_free(ptr, sizeof(T)*size);
+}
+
+} // end namespace internal
+
+/** Sets the size in bytes of the workspace of the calling thread. The workspace holds the temporaries of the
+  * products and decompositions which are too large for the stack, and grows automatically to the largest
+  * amount of memory required at once. Presizing it to workspacePeakUsage() after a typical run avoids the
+  * heap allocations of the first calls, and a size of 0 releases its memory.
+  * This function must not be called while an Eigen computation is running in the calling thread.
+  *
+  * The workspace is released when its thread exits where pthreads are available. Elsewhere, as with MSVC,
+  * call setWorkspaceSize(0) before a thread which used Eigen exits, or its workspace is leaked.
+  *
+  * \sa workspaceSize(), workspacePeakUsage()
+  */
+inline void setWorkspaceSize(std::size_t size)
+{
+#ifndef EIGEN_DONT_USE_WORKSPACE
+  internal::workspace_arena& arena = internal::thread_workspace();
+  eigen_assert(arena.blocks==0 && "setWorkspaceSize() cannot be called while the workspace is in use");
+  size = internal::workspace_block_size(size);
+  if(size == arena.capacity)
+    return;
+  internal::aligned_free(arena.data);
+  arena.data = 0;
+  arena.capacity = 0;
+  if(size)
+  {
+    arena.data = static_cast<unsigned char*>(internal::aligned_malloc(size));
+    internal::workspace_register_thread(arena);
+  }
+  arena.capacity = size;
+  arena.top = 0;
+  // prevent the workspace from growing back right away
+  if(arena.peak > size)
+    arena.peak = size;
+#else
+  EIGEN_UNUSED_VARIABLE(size);
+#endif
+}
+
+/** \returns the size in bytes of the workspace of the calling thread
+  * \sa setWorkspaceSize() */
+inline std::size_t workspaceSize()
+{
+  return internal::thread_workspace().capacity;
+}
+
+/** \returns the largest amount of memory in bytes required at once from the workspace of the calling thread since
+  * the first call or the last call to resetWorkspacePeakUsage(), including the requests which did not fit into it.
+  * \sa setWorkspaceSize() */
+inline std::size_t workspacePeakUsage()
+{
+  return internal::thread_workspace().peak;
+}
+
+/** Resets the value returned by workspacePeakUsage() to the memory currently in use. Since the workspace grows to the
+  * peak usage, this also stops it from growing until larger temporaries are requested.
+  * \sa workspacePeakUsage() */
+inline void resetWorkspacePeakUsage()
+{
+  internal::workspace_arena& arena = internal::thread_workspace();
+  arena.peak = arena.used;
+}
+
 /*****************************************************************************
 *** Implementation of runtime stack allocation (falling back to malloc)    ***
 *****************************************************************************/
@@ -502,7 +725,7 @@ template<typename T> class aligned_stack_memory_handler
       if(NumTraits<T>::RequireInitialization && m_ptr)
         Eigen::internal::destruct_elements_of_array<T>(m_ptr, m_size);
       if(m_deallocate)
-        Eigen::internal::aligned_free(m_ptr);
+        Eigen::internal::workspace_free(m_ptr, sizeof(T)*m_size);
     }
   protected:
     T* m_ptr;
@@ -515,7 +738,8 @@ template<typename T> class aligned_stack_memory_handler
 /** \internal
   * Declares, allocates and construct an aligned buffer named NAME of SIZE elements of type TYPE on the stack
   * if SIZE is smaller than EIGEN_STACK_ALLOCATION_LIMIT, and if stack allocation is supported by the platform
-  * (currently, this is Linux and Visual Studio only). Otherwise the memory is allocated on the heap.
+  * (currently, this is Linux and Visual Studio only). Otherwise the memory is taken from the workspace of the
+  * calling thread (see setWorkspaceSize()).
   * The allocated buffer is automatically deleted when exiting the scope of this declaration.
   * If BUFFER is non nul, then the declared variable is simply an alias for BUFFER, and no allocation/deletion occurs.
   * Here is an example:
@@ -539,13 +763,13 @@ template<typename T> class aligned_stack_memory_handler
     TYPE* NAME = (BUFFER)!=0 ? (BUFFER) \
                : reinterpret_cast<TYPE*>( \
                       (sizeof(TYPE)*SIZE<=EIGEN_STACK_ALLOCATION_LIMIT) ? EIGEN_ALIGNED_ALLOCA(sizeof(TYPE)*SIZE) \
-                    : Eigen::internal::aligned_malloc(sizeof(TYPE)*SIZE) );  \
+                    : Eigen::internal::workspace_malloc(sizeof(TYPE)*SIZE) );  \
     Eigen::internal::aligned_stack_memory_handler<TYPE> EIGEN_CAT(NAME,_stack_memory_destructor)((BUFFER)==0 ? NAME : 0,SIZE,sizeof(TYPE)*SIZE>EIGEN_STACK_ALLOCATION_LIMIT)
 
 #else
 
   #define ei_declare_aligned_stack_constructed_variable(TYPE,NAME,SIZE,BUFFER) \
-    TYPE* NAME = (BUFFER)!=0 ? BUFFER : reinterpret_cast<TYPE*>(Eigen::internal::aligned_malloc(sizeof(TYPE)*SIZE));    \
+    TYPE* NAME = (BUFFER)!=0 ? BUFFER : reinterpret_cast<TYPE*>(Eigen::internal::workspace_malloc(sizeof(TYPE)*SIZE));    \
     Eigen::internal::aligned_stack_memory_handler<TYPE> EIGEN_CAT(NAME,_stack_memory_destructor)((BUFFER)==0 ? NAME : 0,SIZE,true)
     
 #endif
@@ -95,7 +95,11 @@
         YOU_PERFORMED_AN_INVALID_TRANSFORMATION_CONVERSION,
         THIS_EXPRESSION_IS_NOT_A_LVALUE__IT_IS_READ_ONLY,
         YOU_ARE_TRYING_TO_USE_AN_INDEX_BASED_ACCESSOR_ON_AN_EXPRESSION_THAT_DOES_NOT_SUPPORT_THAT,
-        THIS_METHOD_IS_ONLY_FOR_1x1_EXPRESSIONS
+        THIS_METHOD_IS_ONLY_FOR_1x1_EXPRESSIONS,
+        THIS_SCALAR_TYPE_IS_NOT_SUPPORTED_BY_THE_BINARY_FILE_FORMAT,
+        THE_NUMBER_OF_INDICES_DOES_NOT_MATCH_THE_RANK_OF_THE_TENSOR,
+        THIS_TENSOR_OPERATION_MUST_LEAVE_AT_LEAST_ONE_DIMENSION,
+        THIS_REDUCTION_WAS_NOT_REQUESTED_IN_THE_OPTIONS
       };
     };
 
@@ -56,7 +56,10 @@ class GeneralizedSelfAdjointEigenSolver;
   *
   * The algorithm exploits the fact that the matrix is selfadjoint, making it
   * faster and more accurate than the general purpose eigenvalue algorithms
-  * implemented in EigenSolver and ComplexEigenSolver.
+  * implemented in EigenSolver and ComplexEigenSolver. The matrix is first reduced to a real
+  * tridiagonal matrix (see class Tridiagonalization), which is then diagonalized by implicit symmetric
+  * QR steps. When the eigenvectors of a large matrix are requested, the tridiagonal matrix is instead
+  * diagonalized by the divide and conquer algorithm, whose cost is dominated by matrix products.
   *
   * Only the \b lower \b triangular \b part of the input matrix is referenced.
   *
@@ -342,6 +345,11 @@ template<typename _MatrixType> class SelfAdjointEigenSolver
     #endif // EIGEN2_SUPPORT
 
   protected:
+    /** Size of the blocks of the divide and conquer algorithm which are diagonalized by QR iterations.
+      * The divide and conquer algorithm is used when the eigenvectors of a matrix of at least twice this
+      * size are requested. */
+    enum { DivideAndConquerSize = 32 };
+
     MatrixType m_eivec;
     RealVectorType m_eivalues;
     typename TridiagonalizationType::SubDiagonalType m_subdiag;
@@ -369,6 +377,13 @@ template<typename _MatrixType> class SelfAdjointEigenSolver
 namespace internal {
 template<int StorageOrder,typename RealScalar, typename Scalar, typename Index>
 static void tridiagonal_qr_step(RealScalar* diag, RealScalar* subdiag, Index start, Index end, Scalar* matrixQ, Index n);
+
+template<typename DiagType, typename SubDiagType, typename MatrixType>
+ComputationInfo tridiagonal_qr(DiagType& diag, SubDiagType& subdiag, int maxIterations, bool computeEigenvectors, MatrixType& eivec);
+
+template<typename RealScalar, typename Index>
+ComputationInfo tridiagonal_divide_and_conquer(Matrix<RealScalar,Dynamic,1>& diag, Matrix<RealScalar,Dynamic,1>& subdiag,
+                                               Matrix<RealScalar,Dynamic,Dynamic>& eivec, Index leafSize, int maxIterations);
 }
 
 template<typename MatrixType>
@@ -403,61 +418,34 @@ SelfAdjointEigenSolver<MatrixType>& SelfAdjointEigenSolver<MatrixType>
   if(scale==Scalar(0)) scale = 1;
   mat = matrix / scale;
   m_subdiag.resize(n-1);
-  internal::tridiagonalization_inplace(mat, diag, m_subdiag, computeEigenvectors);
-  
-  Index end = n-1;
-  Index start = 0;
-  Index iter = 0; // number of iterations we are working on one element
 
-  while (end>0)
+  if(computeEigenvectors && n >= 2*Index(DivideAndConquerSize))
   {
-    for (Index i = start; i<end; ++i)
-      if (internal::isMuchSmallerThan(internal::abs(m_subdiag[i]),(internal::abs(diag[i])+internal::abs(diag[i+1]))))
-        m_subdiag[i] = 0;
-
-    // find the largest unreduced block
-    while (end>0 && m_subdiag[end-1]==0)
+    // the tridiagonal matrix is diagonalized by divide and conquer, and its eigenvectors are then
+    // transformed by the Householder reflectors of the tridiagonalization, without forming Q
+    typename TridiagonalizationType::CoeffVectorType hCoeffs(n-1);
+    internal::tridiagonalization_inplace(mat, hCoeffs);
+    Matrix<RealScalar,Dynamic,1> d = mat.diagonal().real();
+    Matrix<RealScalar,Dynamic,1> e = mat.template diagonal<-1>().real();
+    m_subdiag = e;
+    Matrix<RealScalar,Dynamic,Dynamic> Z;
+    m_info = internal::tridiagonal_divide_and_conquer(d, e, Z, Index(DivideAndConquerSize), m_maxIterations);
+    if(m_info == Success)
     {
-      iter = 0;
-      end--;
+      MatrixType eivec = Z.template cast<Scalar>();
+      eivec.applyOnTheLeft(typename TridiagonalizationType::HouseholderSequenceType(mat, hCoeffs.conjugate())
+                           .setLength(n-1)
+                           .setShift(1));
+      diag = d;
+      m_eivec.swap(eivec);
     }
-    if (end<=0)
-      break;
-
-    // if we spent too many iterations on the current element, we give up
-    iter++;
-    if(iter > m_maxIterations) break;
-
-    start = end - 1;
-    while (start>0 && m_subdiag[start-1]!=0)
-      start--;
-
-    internal::tridiagonal_qr_step<MatrixType::Flags&RowMajorBit ? RowMajor : ColMajor>(diag.data(), m_subdiag.data(), start, end, computeEigenvectors ? m_eivec.data() : (Scalar*)0, n);
   }
-
-  if (iter <= m_maxIterations)
-    m_info = Success;
   else
-    m_info = NoConvergence;
-
-  // Sort eigenvalues and corresponding vectors.
-  // TODO make the sort optional ?
-  // TODO use a better sort algorithm !!
-  if (m_info == Success)
   {
-    for (Index i = 0; i < n-1; ++i)
-    {
-      Index k;
-      m_eivalues.segment(i,n-i).minCoeff(&k);
-      if (k > 0)
-      {
-        std::swap(m_eivalues[i], m_eivalues[k+i]);
-        if(computeEigenvectors)
-          m_eivec.col(i).swap(m_eivec.col(k+i));
-      }
-    }
+    internal::tridiagonalization_inplace(mat, diag, m_subdiag, computeEigenvectors);
+    m_info = internal::tridiagonal_qr(diag, m_subdiag, m_maxIterations, computeEigenvectors, m_eivec);
   }
-  
+
   // scale back the eigen values
   m_eivalues *= scale;
 
@@ -515,6 +503,344 @@ static void tridiagonal_qr_step(RealScalar* diag, RealScalar* subdiag, Index sta
     }
   }
 }
+
+/** \internal
+  * Diagonalizes the tridiagonal matrix given by \a diag and \a subdiag by implicit symmetric QR steps, and
+  * sorts the eigenvalues in increasing order. The rotations are accumulated in \a eivec if
+  * \a computeEigenvectors is true.
+  */
+template<typename DiagType, typename SubDiagType, typename MatrixType>
+ComputationInfo tridiagonal_qr(DiagType& diag, SubDiagType& subdiag, int maxIterations, bool computeEigenvectors, MatrixType& eivec)
+{
+  typedef typename MatrixType::Index Index;
+  Index n = diag.size();
+  Index end = n-1;
+  Index start = 0;
+  Index iter = 0; // number of iterations we are working on one element
+
+  while (end>0)
+  {
+    for (Index i = start; i<end; ++i)
+      if (isMuchSmallerThan(abs(subdiag[i]),(abs(diag[i])+abs(diag[i+1]))))
+        subdiag[i] = 0;
+
+    // find the largest unreduced block
+    while (end>0 && subdiag[end-1]==0)
+    {
+      iter = 0;
+      end--;
+    }
+    if (end<=0)
+      break;
+
+    // if we spent too many iterations on the current element, we give up
+    iter++;
+    if(iter > maxIterations) break;
+
+    start = end - 1;
+    while (start>0 && subdiag[start-1]!=0)
+      start--;
+
+    tridiagonal_qr_step<MatrixType::Flags&RowMajorBit ? RowMajor : ColMajor>(diag.data(), subdiag.data(), start, end, computeEigenvectors ? eivec.data() : (typename MatrixType::Scalar*)0, n);
+  }
+
+  ComputationInfo info = iter <= maxIterations ? Success : NoConvergence;
+
+  // Sort eigenvalues and corresponding vectors.
+  // TODO use a better sort algorithm !!
+  if (info == Success)
+  {
+    for (Index i = 0; i < n-1; ++i)
+    {
+      Index k;
+      diag.segment(i,n-i).minCoeff(&k);
+      if (k > 0)
+      {
+        std::swap(diag[i], diag[k+i]);
+        if(computeEigenvectors)
+          eivec.col(i).swap(eivec.col(k+i));
+      }
+    }
+  }
+  
+
+  return info;
+}
+
+/** \internal sorts indices by increasing values of the referenced vector */
+template<typename VectorType> struct tridiagonal_index_less
+{
+  tridiagonal_index_less(const VectorType& values) : m_values(values) {}
+  template<typename Index> bool operator()(Index a, Index b) const { return m_values.coeff(a) < m_values.coeff(b); }
+  const VectorType& m_values;
+};
+
+/** \internal evaluates the secular function 1 + rho sum z_j^2 / (d_j - lambda) at lambda = shift + mu,
+  * where diff = d - shift */
+template<typename VectorType, typename RealScalar>
+RealScalar tridiagonal_secular_eq(RealScalar mu, const VectorType& z, const VectorType& diff, RealScalar rho)
+{
+  RealScalar res = RealScalar(1);
+  for(typename VectorType::Index j = 0; j < z.size(); ++j)
+    res += rho * z.coeff(j) * z.coeff(j) / (diff.coeff(j) - mu);
+  return res;
+}
+
+/** \internal
+  * Computes the eigendecomposition \f$ D + \rho z z^T = U \Lambda U^T \f$ of a rank one update of a
+  * diagonal matrix, with \f$ \rho > 0 \f$. The eigenvalues are not sorted.
+  *
+  * Small components of \a z and close entries of \a d are deflated. The remaining eigenvalues are the
+  * roots of the secular equation, each of them being computed as an offset from the closest pole so that
+  * the differences \f$ d_j - \lambda_i \f$ keep their relative accuracy. Following Gu and Eisenstat, \a z
+  * is then recomputed from the eigenvalues, which makes the eigenvectors numerically orthogonal.
+  */
+template<typename RealScalar>
+void tridiagonal_rank_one_update(const Matrix<RealScalar,Dynamic,1>& d, const Matrix<RealScalar,Dynamic,1>& z, RealScalar rho,
+                                 Matrix<RealScalar,Dynamic,Dynamic>& U, Matrix<RealScalar,Dynamic,1>& lambda)
+{
+  typedef Matrix<RealScalar,Dynamic,1> VectorType;
+  typedef typename VectorType::Index Index;
+  typedef Matrix<Index,Dynamic,1> IndicesType;
+  const Index n = d.size();
+  const RealScalar eps = NumTraits<RealScalar>::epsilon();
+  const RealScalar inf = std::numeric_limits<RealScalar>::infinity();
+
+  U.setZero(n, n);
+  lambda.resize(n);
+
+  // sort d in increasing order, and normalize z
+  IndicesType perm(n);
+  for(Index i = 0; i < n; ++i) perm.coeffRef(i) = i;
+  std::sort(perm.data(), perm.data()+n, tridiagonal_index_less<VectorType>(d));
+  VectorType ds(n), zs(n);
+  for(Index i = 0; i < n; ++i)
+  {
+    ds.coeffRef(i) = d.coeff(perm.coeff(i));
+    zs.coeffRef(i) = z.coeff(perm.coeff(i));
+  }
+  RealScalar zNorm = zs.norm();
+  if(zNorm > RealScalar(0))
+  {
+    zs /= zNorm;
+    rho *= zNorm * zNorm;
+  }
+  const RealScalar tol = RealScalar(8) * eps * (std::max)(ds.cwiseAbs().maxCoeff(), rho);
+
+  // deflation: a negligible z_j makes d_j an eigenvalue, and a d_j close to the previous d_l
+  // allows to rotate z_j into z_l. The rotations are recorded to be applied to the eigenvectors.
+  Matrix<bool,Dynamic,1> deflated = Matrix<bool,Dynamic,1>::Constant(n, false);
+  IndicesType rotFirst(n), rotSecond(n);
+  VectorType rotC(n), rotS(n);
+  Index nbRotations = 0;
+  Index last = -1;
+  for(Index j = 0; j < n; ++j)
+  {
+    if(rho * abs(zs.coeff(j)) <= tol)
+    {
+      deflated.coeffRef(j) = true;
+      zs.coeffRef(j) = RealScalar(0);
+    }
+    else if(last >= 0 && ds.coeff(j) - ds.coeff(last) <= tol)
+    {
+      RealScalar r = hypot(zs.coeff(last), zs.coeff(j));
+      rotFirst.coeffRef(nbRotations) = last;
+      rotSecond.coeffRef(nbRotations) = j;
+      rotC.coeffRef(nbRotations) = zs.coeff(last) / r;
+      rotS.coeffRef(nbRotations) = zs.coeff(j) / r;
+      ++nbRotations;
+      zs.coeffRef(last) = r;
+      zs.coeffRef(j) = RealScalar(0);
+      deflated.coeffRef(j) = true;
+    }
+    else
+      last = j;
+  }
+
+  // gather the remaining secular problem
+  IndicesType J(n);
+  Index nd = 0;
+  for(Index j = 0; j < n; ++j)
+    if(!deflated.coeff(j)) J.coeffRef(nd++) = j;
+  VectorType dJ(nd), zJ(nd), diff(nd), shifts(nd), mus(nd);
+  for(Index p = 0; p < nd; ++p)
+  {
+    dJ.coeffRef(p) = ds.coeff(J.coeff(p));
+    zJ.coeffRef(p) = zs.coeff(J.coeff(p));
+  }
+
+  // the i-th root lies in (dJ_i, dJ_{i+1}), the last one in (dJ_{nd-1}, dJ_{nd-1} + rho |zJ|^2)
+  for(Index i = 0; i < nd; ++i)
+  {
+    RealScalar left = dJ.coeff(i);
+    RealScalar right = (i < nd-1) ? dJ.coeff(i+1) : left + rho * zJ.squaredNorm();
+    RealScalar mid = left + (right - left) / RealScalar(2);
+    diff = dJ.array() - left;
+    RealScalar fMid = tridiagonal_secular_eq(mid - left, zJ, diff, rho);
+    RealScalar shift = (i == nd-1 || fMid > RealScalar(0)) ? left : right;
+    diff = dJ.array() - shift;
+
+    // safeguarded regula falsi (Illinois variant) on mu, the ends of the interval being poles or not
+    RealScalar a, b, fa, fb;
+    if(shift == left)
+    {
+      a = RealScalar(0);   fa = -inf;
+      b = (i == nd-1) ? right - left : mid - left;
+      fb = (i == nd-1) ? tridiagonal_secular_eq(b, zJ, diff, rho) : fMid;
+    }
+    else
+    {
+      a = mid - right;     fa = fMid;
+      b = RealScalar(0);   fb = inf;
+    }
+    int side = 0;
+    for(int iter = 0; iter < 256; ++iter)
+    {
+      if(b - a <= RealScalar(2) * eps * (std::max)(abs(a), abs(b)) || fa >= RealScalar(0) || fb <= RealScalar(0))
+        break;
+      RealScalar m;
+      if(fa != -inf && fb != inf)
+      {
+        m = (a * fb - b * fa) / (fb - fa);
+        if(!(m > a && m < b)) m = a + (b - a) / RealScalar(2);
+      }
+      else
+        m = a + (b - a) / RealScalar(2);
+      if(m <= a || m >= b) break;
+      RealScalar fm = tridiagonal_secular_eq(m, zJ, diff, rho);
+      if(fm < RealScalar(0))
+      {
+        a = m; fa = fm;
+        if(side == -1 && fb != inf) fb /= RealScalar(2);
+        side = -1;
+      }
+      else
+      {
+        b = m; fb = fm;
+        if(side == 1 && fa != -inf) fa /= RealScalar(2);
+        side = 1;
+      }
+    }
+    // keep the end which is not a pole and whose value is the smallest
+    RealScalar mu;
+    if(fa == -inf)     mu = b;
+    else if(fb == inf) mu = a;
+    else               mu = abs(fa) < abs(fb) ? a : b;
+    shifts.coeffRef(i) = shift;
+    mus.coeffRef(i) = mu;
+    lambda.coeffRef(i) = shift + mu;
+  }
+
+  // recompute z from the computed eigenvalues (Loewner formula)
+  VectorType zhat(nd);
+  for(Index p = 0; p < nd; ++p)
+  {
+    RealScalar dp = dJ.coeff(p);
+    RealScalar prod = ((shifts.coeff(nd-1) - dp) + mus.coeff(nd-1)) / rho;
+    for(Index i = 0; i < nd-1; ++i)
+      prod *= ((shifts.coeff(i) - dp) + mus.coeff(i)) / (dJ.coeff(i < p ? i : i+1) - dp);
+    RealScalar absz = prod > RealScalar(0) ? sqrt(prod) : RealScalar(0);
+    zhat.coeffRef(p) = zJ.coeff(p) < RealScalar(0) ? -absz : absz;
+  }
+
+  // eigenvectors of the non deflated part: u_i = (D - lambda_i)^{-1} zhat
+  VectorType u(nd);
+  for(Index i = 0; i < nd; ++i)
+  {
+    for(Index p = 0; p < nd; ++p)
+      u.coeffRef(p) = zhat.coeff(p) / ((dJ.coeff(p) - shifts.coeff(i)) - mus.coeff(i));
+    u.normalize();
+    for(Index p = 0; p < nd; ++p)
+      U.coeffRef(J.coeff(p), i) = u.coeff(p);
+  }
+
+  // deflated eigenvalues
+  Index col = nd;
+  for(Index j = 0; j < n; ++j)
+  {
+    if(deflated.coeff(j))
+    {
+      U.coeffRef(j, col) = RealScalar(1);
+      lambda.coeffRef(col) = ds.coeff(j);
+      ++col;
+    }
+  }
+
+  // undo the deflation rotations
+  for(Index r = nbRotations-1; r >= 0; --r)
+    U.applyOnTheLeft(rotFirst.coeff(r), rotSecond.coeff(r), JacobiRotation<RealScalar>(rotC.coeff(r), rotS.coeff(r)).transpose());
+
+  // go back to the original ordering of d
+  Matrix<RealScalar,Dynamic,Dynamic> tmp(n, n);
+  for(Index i = 0; i < n; ++i) tmp.row(perm.coeff(i)) = U.row(i);
+  U.swap(tmp);
+}
+
+/** \internal
+  * Computes the eigendecomposition of the symmetric tridiagonal matrix given by \a diag and \a subdiag
+  * by Cuppen's divide and conquer algorithm. The matrix is split in two halves by a rank one update,
+  * the halves are diagonalized recursively, and their eigendecompositions are merged by
+  * tridiagonal_rank_one_update(), the eigenvectors being updated by matrix products. Blocks of at most
+  * \a leafSize rows are diagonalized by tridiagonal_qr().
+  *
+  * On output, \a diag holds the eigenvalues in increasing order and \a eivec the eigenvectors.
+  */
+template<typename RealScalar, typename Index>
+ComputationInfo tridiagonal_divide_and_conquer(Matrix<RealScalar,Dynamic,1>& diag, Matrix<RealScalar,Dynamic,1>& subdiag,
+                                               Matrix<RealScalar,Dynamic,Dynamic>& eivec, Index leafSize, int maxIterations)
+{
+  typedef Matrix<RealScalar,Dynamic,1> VectorType;
+  typedef Matrix<RealScalar,Dynamic,Dynamic> MatrixType;
+  const Index n = diag.size();
+
+  if(n <= leafSize)
+  {
+    eivec.setIdentity(n, n);
+    return tridiagonal_qr(diag, subdiag, maxIterations, true, eivec);
+  }
+
+  // T = diag(T1, T2) + rho (e_{k-1} + e_k) (e_{k-1} + e_k)^T
+  const Index k = n/2;
+  const RealScalar rho = subdiag.coeff(k-1);
+  VectorType d1 = diag.head(k), d2 = diag.tail(n-k);
+  VectorType e1 = subdiag.head(k-1), e2 = subdiag.tail(n-k-1);
+  d1.coeffRef(k-1) -= rho;
+  d2.coeffRef(0) -= rho;
+
+  MatrixType Q1, Q2;
+  ComputationInfo info = tridiagonal_divide_and_conquer(d1, e1, Q1, leafSize, maxIterations);
+  if(info != Success) return info;
+  info = tridiagonal_divide_and_conquer(d2, e2, Q2, leafSize, maxIterations);
+  if(info != Success) return info;
+
+  // T = diag(Q1, Q2) (D + rho z z^T) diag(Q1, Q2)^T
+  VectorType d(n), z(n), lambda;
+  d << d1, d2;
+  z << Q1.row(k-1).transpose(), Q2.row(0).transpose();
+  MatrixType U;
+  if(rho >= RealScalar(0))
+    tridiagonal_rank_one_update(d, z, rho, U, lambda);
+  else
+  {
+    tridiagonal_rank_one_update(VectorType(-d), z, RealScalar(-rho), U, lambda);
+    lambda = -lambda;
+  }
+
+  // sort the eigenvalues and compute the eigenvectors
+  Matrix<Index,Dynamic,1> perm(n);
+  for(Index i = 0; i < n; ++i) perm.coeffRef(i) = i;
+  std::sort(perm.data(), perm.data()+n, tridiagonal_index_less<VectorType>(lambda));
+  MatrixType sortedU(n, n);
+  for(Index i = 0; i < n; ++i)
+  {
+    diag.coeffRef(i) = lambda.coeff(perm.coeff(i));
+    sortedU.col(i) = U.col(perm.coeff(i));
+  }
+  eivec.resize(n, n);
+  eivec.topRows(k).noalias() = Q1 * sortedU.topRows(k);
+  eivec.bottomRows(n-k).noalias() = Q2 * sortedU.bottomRows(n-k);
+  return Success;
+}
 } // end namespace internal
 
 #endif // EIGEN_SELFADJOINTEIGENSOLVER_H
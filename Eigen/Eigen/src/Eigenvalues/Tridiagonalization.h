@@ -332,6 +332,12 @@ Tridiagonalization<MatrixType>::subDiagonal() const
 
 namespace internal {
 
+template<typename MatrixType, typename CoeffVectorType>
+void tridiagonalization_inplace_unblocked(MatrixType& matA, CoeffVectorType& hCoeffs);
+template<typename MatrixType, typename CoeffVectorType>
+void tridiagonalization_inplace_blocked(MatrixType& matA, CoeffVectorType& hCoeffs,
+                                        typename MatrixType::Index maxBlockSize=32);
+
 /** \internal
   * Performs a tridiagonal decomposition of the selfadjoint matrix \a matA in-place.
   *
@@ -351,12 +357,26 @@ namespace internal {
   * \f$ v_i \f$ is the Householder vector defined by
   *       \f$ v_i = [ 0, \ldots, 0, 1, matA(i+2,i), \ldots, matA(N-1,i) ]^T \f$.
   *
-  * Implemented from Golub's "Matrix Computations", algorithm 8.3.1.
+  * Implemented from Golub's "Matrix Computations", algorithm 8.3.1. Matrices of size 128 and above
+  * are reduced by panels, see tridiagonalization_inplace_blocked().
   *
   * \sa Tridiagonalization::packedMatrix()
   */
 template<typename MatrixType, typename CoeffVectorType>
 void tridiagonalization_inplace(MatrixType& matA, CoeffVectorType& hCoeffs)
+{
+  if(matA.rows() >= 128)
+    tridiagonalization_inplace_blocked(matA, hCoeffs);
+  else
+    tridiagonalization_inplace_unblocked(matA, hCoeffs);
+}
+
+/** \internal
+  * Unblocked version of tridiagonalization_inplace(MatrixType&, CoeffVectorType&): each reflector
+  * is applied to the trailing matrix by a selfadjoint rank-2 update.
+  */
+template<typename MatrixType, typename CoeffVectorType>
+void tridiagonalization_inplace_unblocked(MatrixType& matA, CoeffVectorType& hCoeffs)
 {
   typedef typename MatrixType::Index Index;
   typedef typename MatrixType::Scalar Scalar;
@@ -389,6 +409,93 @@ void tridiagonalization_inplace(MatrixType& matA, CoeffVectorType& hCoeffs)
   }
 }
 
+/** \internal
+  * Blocked version of tridiagonalization_inplace(MatrixType&, CoeffVectorType&), following LAPACK's xLATRD.
+  *
+  * The reflectors of a panel of \a maxBlockSize columns are computed one at a time, the trailing
+  * matrix being only updated implicitly: after the reflectors \f$ V \f$ of the first columns of the
+  * panel, the trailing matrix is \f$ A - V W^* - W V^* \f$ where \f$ W \f$ gathers the vectors of the
+  * rank-2 updates of tridiagonalization_inplace_unblocked(). Only the next column of the panel, and the
+  * product of the trailing matrix with the current reflector, are formed explicitly. Once the panel is done,
+  * the lower half of the trailing matrix gets the rank-2k update \f$ [V W] [W V]^* \f$ in a single triangular
+  * matrix product, which halves the memory traffic of the reduction and moves it to level 3 kernels.
+  */
+template<typename MatrixType, typename CoeffVectorType>
+void tridiagonalization_inplace_blocked(MatrixType& matA, CoeffVectorType& hCoeffs,
+                                        typename MatrixType::Index maxBlockSize)
+{
+  typedef typename MatrixType::Index Index;
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::RealScalar RealScalar;
+  typedef Block<MatrixType,Dynamic,Dynamic> BlockType;
+  typedef Matrix<Scalar,Dynamic,Dynamic,ColMajor,MatrixType::MaxRowsAtCompileTime,Dynamic> WorkMatrixType;
+  Index n = matA.rows();
+  eigen_assert(n==matA.cols());
+  eigen_assert(n==hCoeffs.size()+1 || n==1);
+
+  // the columns [0,bs) of W hold the vectors w of the panel, and the columns [bs,3bs) a copy of [V W] which
+  // gives the two operands of the rank-2k update as contiguous blocks
+  WorkMatrixType W(n, 3*maxBlockSize);
+  Matrix<RealScalar,Dynamic,1> betas(maxBlockSize);
+
+  Index k = 0;
+  for(; k + maxBlockSize < n-1; k += maxBlockSize)
+  {
+    const Index bs = maxBlockSize;
+    const Index rem = n-k-1;   // rows of the reflectors of the panel
+    BlockType V(matA, k+1, k, rem, bs);
+    W.topLeftCorner(rem, bs).setZero();
+
+    for(Index j = 0; j < bs; ++j)
+    {
+      Index i = k + j;
+      Index remainingSize = n-i-1;
+
+      // apply the pending updates to the current column
+      if(j > 0)
+      {
+        matA.col(i).tail(remainingSize+1).noalias() -= V.block(j-1,0,remainingSize+1,j) * W.block(j-1,0,1,j).adjoint();
+        matA.col(i).tail(remainingSize+1).noalias() -= W.block(j-1,0,remainingSize+1,j) * V.block(j-1,0,1,j).adjoint();
+      }
+
+      Scalar h;
+      matA.col(i).tail(remainingSize).makeHouseholderInPlace(h, betas.coeffRef(j));
+      matA.col(i).coeffRef(i+1) = 1;
+
+      // w = conj(h) (A - V W^* - W V^*) v, with v = matA.col(i).tail(remainingSize)
+      Block<WorkMatrixType,Dynamic,1> w(W, j, j, remainingSize, 1);
+      Block<MatrixType,Dynamic,1> v(matA, i+1, i, remainingSize, 1);
+      w.noalias() = matA.bottomRightCorner(remainingSize,remainingSize).template selfadjointView<Lower>() * v;
+      if(j > 0)
+      {
+        Matrix<Scalar,Dynamic,1> tmp = W.block(j,0,remainingSize,j).adjoint() * v;
+        w.noalias() -= V.block(j,0,remainingSize,j) * tmp;
+        tmp.noalias() = V.block(j,0,remainingSize,j).adjoint() * v;
+        w.noalias() -= W.block(j,0,remainingSize,j) * tmp;
+      }
+      w *= conj(h);
+      w += (conj(h)*Scalar(-0.5)*(w.dot(v))) * v;
+
+      hCoeffs.coeffRef(i) = h;
+    }
+
+    // rank-2k update of the trailing matrix, A22 -= [V W] [W V]^*, of which the triangular product kernel
+    // (general_matrix_matrix_triangular_product) computes only the lower half, in place
+    Index tsize = n-k-bs;
+    BlockType A22(matA, k+bs, k+bs, tsize, tsize);
+    W.block(bs-1,bs,tsize,bs) = V.bottomRows(tsize);
+    W.block(bs-1,2*bs,tsize,bs) = W.block(bs-1,0,tsize,bs);
+    A22.template triangularView<Lower>() -= W.block(bs-1,bs,tsize,2*bs) * W.block(bs-1,0,tsize,2*bs).adjoint();
+
+    for(Index j = 0; j < bs; ++j)
+      matA.coeffRef(k+j+1, k+j) = betas.coeff(j);
+  }
+
+  BlockType A22(matA, k, k, n-k, n-k);
+  Block<CoeffVectorType,Dynamic,1> hCoeffsTail(hCoeffs, k, 0, n-k-1, 1);
+  tridiagonalization_inplace_unblocked(A22, hCoeffsTail);
+}
+
 // forward declaration, implementation at the end of this file
 template<typename MatrixType,
          int Size=MatrixType::ColsAtCompileTime,
@@ -30,23 +30,23 @@
 
 namespace internal {
 
-/** \internal */
+/** \internal
+  * Computes the upper triangular factor \a triFactor such that H_0 H_1 ... H_{n-1} = I - V T V^*,
+  * where the unit diagonal of the Householder vectors \a vectors is implicit. */
 template<typename TriangularFactorType,typename VectorsType,typename CoeffsType>
 void make_block_householder_triangular_factor(TriangularFactorType& triFactor, const VectorsType& vectors, const CoeffsType& hCoeffs)
 {
   typedef typename TriangularFactorType::Index Index;
-  typedef typename VectorsType::Scalar Scalar;
   const Index nbVecs = vectors.cols();
   eigen_assert(triFactor.rows() == nbVecs && triFactor.cols() == nbVecs && vectors.rows()>=nbVecs);
 
   for(Index i = 0; i < nbVecs; i++)
   {
-    Index rs = vectors.rows() - i;
-    Scalar Vii = vectors(i,i);
-    vectors.const_cast_derived().coeffRef(i,i) = Scalar(1);
-    triFactor.col(i).head(i).noalias() = -hCoeffs(i) * vectors.block(i, 0, rs, i).adjoint()
-                                       * vectors.col(i).tail(rs);
-    vectors.const_cast_derived().coeffRef(i, i) = Vii;
+    Index rs = vectors.rows() - i - 1;
+    // the leading coefficient of the i-th vector is 1, so it only picks up the i-th row of the previous ones
+    triFactor.col(i).head(i) = -hCoeffs(i) * vectors.row(i).head(i).adjoint();
+    triFactor.col(i).head(i).noalias() -= hCoeffs(i) * vectors.block(i+1, 0, rs, i).adjoint()
+                                        * vectors.col(i).tail(rs);
     // FIXME add .noalias() once the triangular product can work inplace
     triFactor.col(i).head(i) = triFactor.block(0,0,i,i).template triangularView<Upper>()
                              * triFactor.col(i).head(i);
@@ -54,9 +54,12 @@ void make_block_householder_triangular_factor(TriangularFactorType& triFactor, c
   }
 }
 
-/** \internal */
+/** \internal
+  * Applies the block of Householder reflectors stored in \a vectors to \a mat from the left.
+  * If \a forward is true, \a mat is replaced by H_0 H_1 ... H_{n-1} \a mat, otherwise by
+  * (H_0 H_1 ... H_{n-1})^* \a mat. */
 template<typename MatrixType,typename VectorsType,typename CoeffsType>
-void apply_block_householder_on_the_left(MatrixType& mat, const VectorsType& vectors, const CoeffsType& hCoeffs)
+void apply_block_householder_on_the_left(MatrixType& mat, const VectorsType& vectors, const CoeffsType& hCoeffs, bool forward = false)
 {
   typedef typename MatrixType::Index Index;
   enum { TFactorSize = MatrixType::ColsAtCompileTime };
@@ -70,7 +73,8 @@ void apply_block_householder_on_the_left(MatrixType& mat, const VectorsType& vec
   Matrix<typename MatrixType::Scalar,VectorsType::ColsAtCompileTime,MatrixType::ColsAtCompileTime,0,
          VectorsType::MaxColsAtCompileTime,MatrixType::MaxColsAtCompileTime> tmp = V.adjoint() * mat;
   // FIXME add .noalias() once the triangular product can work inplace
-  tmp = T.template triangularView<Upper>().adjoint() * tmp;
+  if(forward) tmp = T.template triangularView<Upper>() * tmp;
+  else        tmp = T.template triangularView<Upper>().adjoint() * tmp;
   mat.noalias() -= V * tmp;
 }
 
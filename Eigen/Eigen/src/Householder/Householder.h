@@ -69,8 +69,11 @@ void MatrixBase<Derived>::makeHouseholder(
   
   RealScalar tailSqNorm = size()==1 ? RealScalar(0) : tail.squaredNorm();
   Scalar c0 = coeff(0);
+  // a tail whose squared norm is subnormal is taken as zero, as the reflector computed from it would not be
+  // orthogonal
+  const RealScalar tol = (std::numeric_limits<RealScalar>::min)();
 
-  if(tailSqNorm == RealScalar(0) && internal::imag(c0)==RealScalar(0))
+  if(tailSqNorm <= tol && internal::abs2(internal::imag(c0)) <= tol)
   {
     tau = RealScalar(0);
     beta = internal::real(c0);
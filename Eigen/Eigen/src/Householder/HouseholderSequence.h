@@ -247,6 +247,16 @@ template<typename VectorsType, typename CoeffsType, int Side> class HouseholderS
           && internal::extract_data(dst) == internal::extract_data(m_vectors))
       {
         // in-place
+        if(!m_trans && vecs>=BlockSize)
+        {
+          // the blocked path below overwrites the reflectors of a panel while applying them,
+          // so it works on a copy of the reflectors
+          typedef typename internal::remove_all<VectorsType>::type PlainVectorsType;
+          PlainVectorsType vectors(m_vectors);
+          HouseholderSequence<PlainVectorsType,CoeffsType,Side>(vectors, m_coeffs)
+            .setLength(m_length).setShift(m_shift).evalTo(dst);
+          return;
+        }
         dst.diagonal().setOnes();
         dst.template triangularView<StrictlyUpper>().setZero();
         for(Index k = vecs-1; k >= 0; --k)
@@ -266,6 +276,19 @@ template<typename VectorsType, typename CoeffsType, int Side> class HouseholderS
         for(Index k = 0; k<cols()-vecs ; ++k)
           dst.col(k).tail(rows()-k-1).setZero();
       }
+      else if(!m_trans && vecs>=BlockSize)
+      {
+        // accumulate the reflectors by panels, starting from the last one: each panel only touches
+        // the bottom right corner which has already been filled by the following panels
+        dst.setIdentity(rows(), rows());
+        for(Index end = vecs; end > 0; end -= BlockSize)
+        {
+          Index k = (std::max)(Index(0), end-BlockSize);
+          Index cornerSize = rows() - k - m_shift;
+          Block<DestType,Dynamic,Dynamic> corner(dst, rows()-cornerSize, rows()-cornerSize, cornerSize, cornerSize);
+          applyBlockOnTheLeft(corner, k, end-k, true);
+        }
+      }
       else
       {
         dst.setIdentity(rows(), rows());
@@ -297,6 +320,20 @@ template<typename VectorsType, typename CoeffsType, int Side> class HouseholderS
     /** \internal */
     template<typename Dest> inline void applyThisOnTheLeft(Dest& dst) const
     {
+      if(m_length>=BlockSize && dst.cols()>1)
+      {
+        // apply panels of reflectors at once using level 3 operations
+        for(Index i = 0; i < m_length; i += BlockSize)
+        {
+          Index end = m_trans ? (std::min)(m_length, i+BlockSize) : m_length-i;
+          Index k = m_trans ? i : (std::max)(Index(0), end-BlockSize);
+          Index start = k + m_shift;
+          Block<Dest,Dynamic,Dynamic> sub_dst(dst, dst.rows()-rows()+start, 0, rows()-start, dst.cols());
+          applyBlockOnTheLeft(sub_dst, k, end-k, !m_trans);
+        }
+        return;
+      }
+
       Matrix<Scalar,1,Dest::ColsAtCompileTime> temp(dst.cols());
       for(Index k = 0; k < m_length; ++k)
       {
@@ -364,6 +401,30 @@ template<typename VectorsType, typename CoeffsType, int Side> class HouseholderS
 
   protected:
 
+    enum { BlockSize = 48 };
+
+    /** \internal Applies the reflectors \p k to \p k+\p count-1 to \p dst, whose rows match the
+      * support of the k-th reflector. If \p forward is true, this computes H_k ... H_{k+count-1} \p dst,
+      * otherwise H_{k+count-1} ... H_k \p dst. */
+    template<typename Dest> void applyBlockOnTheLeft(Dest& dst, Index k, Index count, bool forward) const
+    {
+      typedef Block<const typename internal::remove_all<VectorsType>::type,Dynamic,Dynamic> SubVectorsType;
+      Index start = k + m_shift;
+      if(Side==OnTheLeft)
+        applyBlockOnTheLeft(dst, SubVectorsType(m_vectors, start, k, m_vectors.rows()-start, count), k, count, forward);
+      else
+        applyBlockOnTheLeft(dst, SubVectorsType(m_vectors, k, start, count, m_vectors.cols()-start).transpose(), k, count, forward);
+    }
+
+    template<typename Dest, typename SubVectorsType>
+    void applyBlockOnTheLeft(Dest& dst, const SubVectorsType& vecs, Index k, Index count, bool forward) const
+    {
+      if(forward)
+        internal::apply_block_householder_on_the_left(dst, vecs, m_coeffs.segment(k, count), true);
+      else
+        internal::apply_block_householder_on_the_left(dst, vecs, m_coeffs.segment(k, count).conjugate(), false);
+    }
+
     /** \brief Sets the transpose flag.
       * \param [in]  trans  New value of the transpose flag.
       *
@@ -0,0 +1,230 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_GMRES_H
+#define EIGEN_GMRES_H
+
+namespace internal {
+
+/** \internal Low-level restarted GMRES algorithm
+  *
+  * The Krylov basis is built by the Arnoldi process with modified Gram-Schmidt orthogonalization, and
+  * the least-squares problem is solved on the fly by Givens rotations, which gives the norm of the
+  * residual at each iteration. The preconditioner is applied on the right, so that this norm is the
+  * norm of the true residual.
+  *
+  * \param mat The matrix A
+  * \param rhs The right hand side vector b
+  * \param x On input and initial solution, on output the computed solution.
+  * \param precond A preconditioner being able to efficiently solve for an
+  *                approximation of Ax=b (regardless of b)
+  * \param restart The dimension of the Krylov subspace after which the iterations are restarted.
+  * \param iters On input the max number of iteration, on output the number of performed iterations.
+  * \param tol_error On input the tolerance error, on output an estimation of the relative error.
+  */
+template<typename MatrixType, typename Rhs, typename Dest, typename Preconditioner>
+EIGEN_DONT_INLINE
+void gmres(const MatrixType& mat, const Rhs& rhs, Dest& x, const Preconditioner& precond,
+           int restart, int& iters, typename Dest::RealScalar& tol_error)
+{
+  using std::abs;
+  typedef typename Dest::RealScalar RealScalar;
+  typedef typename Dest::Scalar Scalar;
+  typedef typename Dest::Index Index;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrixType;
+
+  RealScalar tol = tol_error;
+  int maxIters = iters;
+
+  const Index n = mat.cols();
+
+  RealScalar rhsNorm = rhs.norm();
+  if(rhsNorm == RealScalar(0))
+  {
+    x.setZero();
+    iters = 0;
+    tol_error = 0;
+    return;
+  }
+  RealScalar threshold = tol*rhsNorm;
+
+  const Index m = (std::max)(Index(1), (std::min)(Index(restart), n));
+  DenseMatrixType V(n, m+1), H(m+1, m);
+  VectorType g(m+1), w(n), tmp(n);
+  std::vector<JacobiRotation<Scalar> > G(m);
+
+  int i = 0;
+  RealScalar beta;
+  for(;;)
+  {
+    tmp.noalias() = mat * x;
+    w = rhs - tmp;
+    beta = w.norm();
+    if(beta <= threshold || i >= maxIters)
+      break;
+
+    V.col(0) = w / beta;
+    g.setZero();
+    g(0) = beta;
+    H.setZero();
+    Index k = 0;
+    while(k < m && i < maxIters)
+    {
+      tmp = precond.solve(V.col(k));
+      w.noalias() = mat * tmp;
+
+      for(Index l = 0; l <= k; ++l)
+      {
+        H(l,k) = V.col(l).dot(w);
+        w -= H(l,k) * V.col(l);
+      }
+      RealScalar h = w.norm();
+      H(k+1,k) = h;
+
+      for(Index l = 0; l < k; ++l)
+        H.col(k).applyOnTheLeft(l, l+1, G[l].adjoint());
+      G[k].makeGivens(H(k,k), H(k+1,k), &H(k,k));
+      H(k+1,k) = Scalar(0);
+      g.applyOnTheLeft(k, k+1, G[k].adjoint());
+      ++k;
+      ++i;
+
+      // stop on convergence, or on a lucky breakdown where the Krylov subspace is invariant
+      if(abs(g(k)) <= threshold || h == RealScalar(0))
+        break;
+      V.col(k) = w / h;
+    }
+
+    // x += M^-1 V y, where y minimizes |beta e1 - H y|
+    VectorType y = H.topLeftCorner(k,k).template triangularView<Upper>().solve(g.head(k));
+    tmp.noalias() = V.leftCols(k) * y;
+    x += precond.solve(tmp);
+  }
+  tol_error = beta / rhsNorm;
+  iters = i;
+}
+
+} // end namespace internal
+
+template< typename _MatrixType,
+          typename _Preconditioner = DiagonalPreconditioner<typename _MatrixType::Scalar> >
+class GMRES;
+
+namespace internal {
+
+template< typename _MatrixType, typename _Preconditioner>
+struct traits<GMRES<_MatrixType,_Preconditioner> >
+{
+  typedef _MatrixType MatrixType;
+  typedef _Preconditioner Preconditioner;
+};
+
+} // end namespace internal
+
+/** \ingroup IterativeLinearSolvers_Module
+  * \brief A restarted GMRES solver for sparse square problems
+  *
+  * This class allows to solve for A.x = b sparse linear problems using the generalized minimal residual
+  * method, restarted every restart() iterations (30 by default). Each iteration stores one more vector of
+  * the Krylov basis, so the memory cost is \c restart vectors of the size of b.
+  *
+  * \tparam _MatrixType the type of the matrix A, can be a dense, a sparse matrix, or a matrix-free
+  *                     operator (see IterativeSolverBase)
+  * \tparam _Preconditioner the type of the preconditioner. Default is DiagonalPreconditioner
+  *
+  * The maximal number of iterations and tolerance value can be controlled via the setMaxIterations()
+  * and setTolerance() methods. The defaults are twice the size of the matrix and the machine precision.
+  *
+  * Typical usage:
+  * \code
+  * GMRES<SparseMatrix<double>, IncompleteLUT<double> > solver(A);
+  * solver.setRestart(50);
+  * x = solver.solve(b);
+  * \endcode
+  *
+  * \sa class BiCGSTAB, class ConjugateGradient, class IncompleteLUT
+  */
+template< typename _MatrixType, typename _Preconditioner>
+class GMRES : public IterativeSolverBase<GMRES<_MatrixType,_Preconditioner> >
+{
+  typedef IterativeSolverBase<GMRES> Base;
+  using Base::mp_matrix;
+  using Base::m_preconditioner;
+public:
+  typedef _MatrixType MatrixType;
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::Index Index;
+  typedef typename MatrixType::RealScalar RealScalar;
+  typedef _Preconditioner Preconditioner;
+
+public:
+
+  /** Default constructor. */
+  GMRES() : Base(), m_restart(30) {}
+
+  /** Initialize the solver with matrix \a A for further \c Ax=b solving.
+    *
+    * This constructor is a shortcut for the default constructor followed
+    * by a call to compute().
+    *
+    * \warning this class stores a reference to the matrix A as well as some
+    * precomputed values that depend on it. Therefore, if \a A is changed
+    * this class becomes invalid. Call compute() to update it with the new
+    * matrix A, or modify a copy of A.
+    */
+  GMRES(const MatrixType& A) : Base(A), m_restart(30) {}
+
+  /** \returns the number of iterations between two restarts */
+  int restart() const { return m_restart; }
+
+  /** Sets the number of iterations between two restarts */
+  GMRES& setRestart(int restart)
+  {
+    eigen_assert(restart > 0);
+    m_restart = restart;
+    return *this;
+  }
+
+  /** \internal */
+  template<typename Rhs,typename Dest>
+  void _solveWithGuess(const Rhs& b, Dest& x) const
+  {
+    int maxIters = 0;
+    RealScalar maxError = 0;
+    for(int j=0; j<b.cols(); ++j)
+    {
+      int iters = this->maxIterations();
+      RealScalar error = this->tolerance();
+      typename Dest::ColXpr xj(x,j);
+      internal::gmres(*mp_matrix, b.col(j), xj, m_preconditioner, m_restart, iters, error);
+      maxIters = (std::max)(maxIters, iters);
+      maxError = (std::max)(maxError, error);
+    }
+    this->setResult(maxIters, maxError);
+  }
+
+protected:
+  int m_restart;
+};
+
+#endif // EIGEN_GMRES_H
@@ -0,0 +1,272 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_INCOMPLETE_CHOLESKY_H
+#define EIGEN_INCOMPLETE_CHOLESKY_H
+
+/** \ingroup IterativeLinearSolvers_Module
+  * \brief Incomplete Cholesky factorization with zero fill-in
+  *
+  * This class computes an incomplete LL^T factorization IC(0) of a selfadjoint positive definite sparse
+  * matrix A, i.e. a lower triangular factor L with the sparsity pattern of the lower triangular part of
+  * A, to be used as a preconditioner of the ConjugateGradient.
+  *
+  * The matrix is first scaled symmetrically to have a unit diagonal. Since the incomplete factorization
+  * of a positive definite matrix may break down, the factorization is then retried on
+  * \f$ S A S + \alpha I \f$ with an increasing shift \f$ \alpha \f$ until it succeeds (Manteuffel's
+  * shifted incomplete Cholesky). The shift which has been used is returned by shift().
+  *
+  * \tparam _Scalar the type of the scalar
+  * \tparam _UpLo the triangular part of the matrix which is used, Lower (default) or Upper
+  *
+  * \sa class ConjugateGradient, class IncompleteLUT
+  */
+template <typename _Scalar, int _UpLo = Lower>
+class IncompleteCholesky
+{
+    typedef _Scalar Scalar;
+    typedef typename NumTraits<Scalar>::Real RealScalar;
+    typedef Matrix<Scalar,Dynamic,1> Vector;
+    typedef Matrix<RealScalar,Dynamic,1> RealVector;
+    typedef SparseMatrix<Scalar,ColMajor> FactorType;
+    typedef typename FactorType::Index Index;
+
+  public:
+    // this typedef is only to export the scalar type and compile-time dimensions to solve_retval
+    typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+
+    IncompleteCholesky() : m_shift(0), m_isInitialized(false), m_info(Success) {}
+
+    template<typename MatType>
+    IncompleteCholesky(const MatType& mat) : m_shift(0), m_isInitialized(false), m_info(Success)
+    {
+      compute(mat);
+    }
+
+    Index rows() const { return m_L.rows(); }
+    Index cols() const { return m_L.cols(); }
+
+    /** \returns \c Success, or \c NumericalIssue if no shift could make the factorization succeed */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_isInitialized && "IncompleteCholesky is not initialized.");
+      return m_info;
+    }
+
+    /** \returns the diagonal shift used by the last factorization */
+    RealScalar shift() const { return m_shift; }
+
+    template<typename MatType>
+    IncompleteCholesky& analyzePattern(const MatType& )
+    {
+      return *this;
+    }
+
+    template<typename MatType>
+    IncompleteCholesky& factorize(const MatType& mat);
+
+    template<typename MatType>
+    IncompleteCholesky& compute(const MatType& mat)
+    {
+      return factorize(mat);
+    }
+
+    /** \internal */
+    template<typename Rhs, typename Dest>
+    void _solve(const Rhs& b, Dest& x) const
+    {
+      const Index size = m_L.rows();
+      const Index* outer = m_L._outerIndexPtr();
+      const Index* inner = m_L._innerIndexPtr();
+      const Scalar* values = m_L._valuePtr();
+      for(Index c = 0; c < b.cols(); ++c)
+      {
+        Vector y = m_scale.asDiagonal() * b.col(c);
+        // L y = S b, the diagonal entry is the first one of each column
+        for(Index j = 0; j < size; ++j)
+        {
+          y[j] /= values[outer[j]];
+          const Scalar yj = y[j];
+          for(Index p = outer[j]+1; p < outer[j+1]; ++p)
+            y[inner[p]] -= values[p] * yj;
+        }
+        // L^* z = y
+        for(Index j = size-1; j >= 0; --j)
+        {
+          Scalar tmp = y[j];
+          for(Index p = outer[j]+1; p < outer[j+1]; ++p)
+            tmp -= internal::conj(values[p]) * y[inner[p]];
+          y[j] = tmp / values[outer[j]];
+        }
+        x.col(c) = m_scale.asDiagonal() * y;
+      }
+    }
+
+    template<typename Rhs> inline const internal::solve_retval<IncompleteCholesky, Rhs>
+    solve(const MatrixBase<Rhs>& b) const
+    {
+      eigen_assert(m_isInitialized && "IncompleteCholesky is not initialized.");
+      eigen_assert(cols()==b.rows()
+                && "IncompleteCholesky::solve(): invalid number of rows of the right hand side matrix b");
+      return internal::solve_retval<IncompleteCholesky, Rhs>(*this, b.derived());
+    }
+
+  protected:
+    bool factorize_shifted(const FactorType& a, RealScalar shift);
+
+    FactorType m_L;                   // the factor, with sorted indices and the diagonal entry first
+    RealVector m_scale;
+    RealScalar m_shift;
+    bool m_isInitialized;
+    ComputationInfo m_info;
+};
+
+template <typename _Scalar, int _UpLo>
+template<typename MatType>
+IncompleteCholesky<_Scalar,_UpLo>& IncompleteCholesky<_Scalar,_UpLo>::factorize(const MatType& mat)
+{
+  using std::sqrt;
+  using std::abs;
+  eigen_assert(mat.rows()==mat.cols());
+  const Index size = mat.cols();
+
+  // the lower triangular part of A, with sorted indices
+  FactorType lower(size, size);
+  {
+    FactorType colMajor = mat;
+    internal::permute_symm_to_symm<_UpLo,Lower>(colMajor, lower, 0);
+  }
+  SparseMatrix<Scalar,RowMajor> sorted = lower;
+  lower = sorted;
+
+  // store the diagonal entry first in each column (explicitly, even if it is not in A), and scale
+  m_scale.resize(size);
+  for(Index j = 0; j < size; ++j)
+  {
+    RealScalar d = 0;
+    typename FactorType::InnerIterator it(lower,j);
+    if(it && it.index()==j)
+      d = abs(it.value());
+    m_scale[j] = d > RealScalar(0) ? RealScalar(1)/sqrt(d) : RealScalar(1);
+  }
+  FactorType a(size, size);
+  a.reserve(lower.nonZeros() + size);
+  for(Index j = 0; j < size; ++j)
+  {
+    a.startVec(j);
+    typename FactorType::InnerIterator it(lower,j);
+    Scalar d(0);
+    if(it && it.index()==j)
+    {
+      d = it.value();
+      ++it;
+    }
+    a.insertBackByOuterInner(j,j) = d * (m_scale[j]*m_scale[j]);
+    for(; it; ++it)
+      a.insertBackByOuterInner(j,it.index()) = it.value() * (m_scale[it.index()]*m_scale[j]);
+  }
+  a.finalize();
+
+  // minimal shift making the diagonal positive, then increase it until the factorization succeeds
+  const RealScalar beta = RealScalar(1e-3);
+  RealScalar minDiag = NumTraits<RealScalar>::highest();
+  for(Index j = 0; j < size; ++j)
+    minDiag = (std::min)(minDiag, internal::real(a._valuePtr()[a._outerIndexPtr()[j]]));
+  m_shift = (size==0 || minDiag > RealScalar(0)) ? RealScalar(0) : beta - minDiag;
+
+  m_info = NumericalIssue;
+  for(int iter = 0; iter < 64; ++iter)
+  {
+    if(factorize_shifted(a, m_shift))
+    {
+      m_info = Success;
+      break;
+    }
+    m_shift = (std::max)(RealScalar(2)*m_shift, beta);
+  }
+  m_isInitialized = true;
+  return *this;
+}
+
+/** \internal Right-looking IC(0) factorization of a + shift I, returns false on breakdown. */
+template <typename _Scalar, int _UpLo>
+bool IncompleteCholesky<_Scalar,_UpLo>::factorize_shifted(const FactorType& a, RealScalar shift)
+{
+  using std::sqrt;
+  m_L = a;
+  const Index size = m_L.rows();
+  const Index* outer = m_L._outerIndexPtr();
+  const Index* inner = m_L._innerIndexPtr();
+  Scalar* values = m_L._valuePtr();
+
+  for(Index j = 0; j < size; ++j)
+    values[outer[j]] += shift;
+
+  // mark[i]==p tells that pos[i] is the position of the entry (i,j) in the column j updated by entry p
+  Matrix<Index,Dynamic,1> mark = Matrix<Index,Dynamic,1>::Constant(size,-1), pos(size);
+  for(Index k = 0; k < size; ++k)
+  {
+    const Index p0 = outer[k], p1 = outer[k+1];
+    RealScalar d = internal::real(values[p0]);
+    if(!(d > RealScalar(0)))
+      return false;
+    d = sqrt(d);
+    values[p0] = d;
+    for(Index p = p0+1; p < p1; ++p)
+      values[p] /= d;
+
+    // L(i,j) -= L(i,k) L(j,k)^* for all i >= j in the column k such that (i,j) is in the pattern
+    for(Index p = p0+1; p < p1; ++p)
+    {
+      const Index j = inner[p];
+      const Scalar ljk = internal::conj(values[p]);
+      for(Index q = outer[j]; q < outer[j+1]; ++q)
+      {
+        mark[inner[q]] = p;
+        pos[inner[q]] = q;
+      }
+      for(Index q = p; q < p1; ++q)
+        if(mark[inner[q]] == p)
+          values[pos[inner[q]]] -= values[q] * ljk;
+    }
+  }
+  return true;
+}
+
+namespace internal {
+
+template<typename _Scalar, int _UpLo, typename Rhs>
+struct solve_retval<IncompleteCholesky<_Scalar,_UpLo>, Rhs>
+  : solve_retval_base<IncompleteCholesky<_Scalar,_UpLo>, Rhs>
+{
+  typedef IncompleteCholesky<_Scalar,_UpLo> Dec;
+  EIGEN_MAKE_SOLVE_HELPERS(Dec,Rhs)
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    dec()._solve(rhs(),dst);
+  }
+};
+
+} // end namespace internal
+
+#endif // EIGEN_INCOMPLETE_CHOLESKY_H
@@ -0,0 +1,339 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_INCOMPLETE_LUT_H
+#define EIGEN_INCOMPLETE_LUT_H
+
+namespace internal {
+
+/** \internal Compares the magnitudes of the entries of a dense work vector */
+template<typename Scalar, typename Index>
+struct incomplete_lut_greater
+{
+  incomplete_lut_greater(const Scalar* w) : m_w(w) {}
+  bool operator()(Index a, Index b) const { return abs(m_w[a]) > abs(m_w[b]); }
+  const Scalar* m_w;
+};
+
+} // end namespace internal
+
+/** \ingroup IterativeLinearSolvers_Module
+  * \brief Incomplete LU factorization with dual-threshold strategy
+  *
+  * This class computes the ILUT incomplete factorization of Y. Saad, "ILUT: a dual threshold
+  * incomplete LU factorization", Numerical Linear Algebra with Applications, 1994. The factors are
+  * computed row by row, and two dropping rules control their fill-in:
+  *  - the entries smaller than droptol() times the norm of the current row of A are dropped,
+  *  - only the fillfactor() times (number of entries of the current row of A) largest entries are kept
+  *    in each row of L and of U.
+  *
+  * It is the preconditioner of choice for BiCGSTAB and GMRES on general problems. Zero pivots are
+  * replaced by a small multiple of the norm of the row, and no pivoting is performed.
+  *
+  * \tparam _Scalar the type of the scalar
+  *
+  * \sa class BiCGSTAB, class GMRES, class IncompleteCholesky
+  */
+template <typename _Scalar>
+class IncompleteLUT
+{
+    typedef _Scalar Scalar;
+    typedef typename NumTraits<Scalar>::Real RealScalar;
+    typedef Matrix<Scalar,Dynamic,1> Vector;
+    typedef SparseMatrix<Scalar,RowMajor> FactorType;
+    typedef typename FactorType::Index Index;
+
+  public:
+    // this typedef is only to export the scalar type and compile-time dimensions to solve_retval
+    typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+
+    IncompleteLUT()
+      : m_droptol(NumTraits<Scalar>::dummy_precision()), m_fillfactor(10), m_isInitialized(false), m_info(Success)
+    {}
+
+    template<typename MatType>
+    IncompleteLUT(const MatType& mat, const RealScalar& droptol = NumTraits<Scalar>::dummy_precision(), int fillfactor = 10)
+      : m_droptol(droptol), m_fillfactor(fillfactor), m_isInitialized(false), m_info(Success)
+    {
+      eigen_assert(fillfactor != 0);
+      compute(mat);
+    }
+
+    Index rows() const { return m_L.rows(); }
+    Index cols() const { return m_L.cols(); }
+
+    /** \returns \c Success if the factorization succeeded */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_isInitialized && "IncompleteLUT is not initialized.");
+      return m_info;
+    }
+
+    /** \returns the relative threshold under which the entries are dropped */
+    RealScalar droptol() const { return m_droptol; }
+
+    /** Sets the relative threshold under which the entries are dropped */
+    IncompleteLUT& setDroptol(const RealScalar& droptol)
+    {
+      m_droptol = droptol;
+      return *this;
+    }
+
+    /** \returns the max number of entries kept in each row of L and U, relative to the row of A */
+    int fillfactor() const { return m_fillfactor; }
+
+    /** Sets the max number of entries kept in each row of L and U, relative to the row of A */
+    IncompleteLUT& setFillfactor(int fillfactor)
+    {
+      eigen_assert(fillfactor > 0);
+      m_fillfactor = fillfactor;
+      return *this;
+    }
+
+    template<typename MatType>
+    IncompleteLUT& analyzePattern(const MatType& )
+    {
+      return *this;
+    }
+
+    template<typename MatType>
+    IncompleteLUT& factorize(const MatType& mat);
+
+    template<typename MatType>
+    IncompleteLUT& compute(const MatType& mat)
+    {
+      return factorize(mat);
+    }
+
+    /** \internal */
+    template<typename Rhs, typename Dest>
+    void _solve(const Rhs& b, Dest& x) const
+    {
+      const Index size = m_L.rows();
+      const Index* Lp = m_L._outerIndexPtr();
+      const Index* Li = m_L._innerIndexPtr();
+      const Scalar* Lx = m_L._valuePtr();
+      const Index* Up = m_U._outerIndexPtr();
+      const Index* Ui = m_U._innerIndexPtr();
+      const Scalar* Ux = m_U._valuePtr();
+      for(Index c = 0; c < b.cols(); ++c)
+      {
+        Vector y = b.col(c);
+        for(Index i = 0; i < size; ++i)
+        {
+          Scalar tmp = y[i];
+          for(Index p = Lp[i]; p < Lp[i+1]; ++p)
+            tmp -= Lx[p] * y[Li[p]];
+          y[i] = tmp;
+        }
+        // the diagonal entry is the first one of each row of U
+        for(Index i = size-1; i >= 0; --i)
+        {
+          Scalar tmp = y[i];
+          for(Index p = Up[i]+1; p < Up[i+1]; ++p)
+            tmp -= Ux[p] * y[Ui[p]];
+          y[i] = tmp / Ux[Up[i]];
+        }
+        x.col(c) = y;
+      }
+    }
+
+    template<typename Rhs> inline const internal::solve_retval<IncompleteLUT, Rhs>
+    solve(const MatrixBase<Rhs>& b) const
+    {
+      eigen_assert(m_isInitialized && "IncompleteLUT is not initialized.");
+      eigen_assert(cols()==b.rows()
+                && "IncompleteLUT::solve(): invalid number of rows of the right hand side matrix b");
+      return internal::solve_retval<IncompleteLUT, Rhs>(*this, b.derived());
+    }
+
+  protected:
+    FactorType m_L;                   // strictly lower part of the unit lower factor
+    FactorType m_U;                   // upper factor, with the diagonal entry first in each row
+    RealScalar m_droptol;
+    int m_fillfactor;
+    bool m_isInitialized;
+    ComputationInfo m_info;
+};
+
+template <typename _Scalar>
+template<typename MatType>
+IncompleteLUT<_Scalar>& IncompleteLUT<_Scalar>::factorize(const MatType& amat)
+{
+  using std::sqrt;
+  using std::abs;
+  eigen_assert(amat.rows()==amat.cols());
+  const Index size = amat.cols();
+  FactorType mat = amat;
+
+  std::vector<Index> Lp(1,0), Li, Up(1,0), Ui;
+  std::vector<Scalar> Lx, Ux;
+  Lp.reserve(size+1); Up.reserve(size+1);
+  Li.reserve(m_fillfactor*mat.nonZeros()/2); Lx.reserve(m_fillfactor*mat.nonZeros()/2);
+  Ui.reserve(m_fillfactor*mat.nonZeros()/2 + size); Ux.reserve(m_fillfactor*mat.nonZeros()/2 + size);
+
+  // w is the dense work row, inPattern flags its nonzeros, and lcols/ucols list them
+  Vector w = Vector::Zero(size);
+  Matrix<bool,Dynamic,1> inPattern = Matrix<bool,Dynamic,1>::Constant(size, false);
+  std::vector<Index> lcols, ucols;
+  internal::incomplete_lut_greater<Scalar,Index> greater(w.data());
+
+  for(Index i = 0; i < size; ++i)
+  {
+    lcols.clear();
+    ucols.clear();
+    RealScalar rownorm = 0;
+    Index rownnz = 0;
+    for(typename FactorType::InnerIterator it(mat,i); it; ++it)
+    {
+      const Index j = it.index();
+      w[j] = it.value();
+      inPattern[j] = true;
+      if(j < i) lcols.push_back(j);
+      else if(j > i) ucols.push_back(j);
+      rownorm += internal::abs2(it.value());
+      ++rownnz;
+    }
+    inPattern[i] = true;
+    rownorm = sqrt(rownorm);
+    const RealScalar threshold = m_droptol * rownorm;
+
+    // eliminate the entries of the L part in increasing column order, the list growing with the fill-in
+    for(std::size_t jj = 0; jj < lcols.size(); ++jj)
+    {
+      std::size_t kk = jj;
+      for(std::size_t t = jj+1; t < lcols.size(); ++t)
+        if(lcols[t] < lcols[kk]) kk = t;
+      std::swap(lcols[jj], lcols[kk]);
+
+      const Index k = lcols[jj];
+      Scalar fact = w[k] / Ux[Up[k]];
+      if(abs(fact) <= threshold)
+      {
+        w[k] = Scalar(0);
+        continue;
+      }
+      w[k] = fact;
+      for(Index p = Up[k]+1; p < Up[k+1]; ++p)
+      {
+        const Index c = Ui[p];
+        if(inPattern[c])
+          w[c] -= fact * Ux[p];
+        else
+        {
+          inPattern[c] = true;
+          w[c] = -fact * Ux[p];
+          if(c < i) lcols.push_back(c);
+          else ucols.push_back(c);
+        }
+      }
+    }
+
+    // keep the largest entries of the L and U parts above the threshold, in increasing column order
+    const std::size_t fill = std::size_t(m_fillfactor) * std::size_t(rownnz);
+    for(int part = 0; part < 2; ++part)
+    {
+      std::vector<Index>& cols = part==0 ? lcols : ucols;
+      std::size_t kept = 0;
+      for(std::size_t t = 0; t < cols.size(); ++t)
+        if(abs(w[cols[t]]) > threshold)
+          cols[kept++] = cols[t];
+        else
+        {
+          inPattern[cols[t]] = false;
+          w[cols[t]] = Scalar(0);
+        }
+      if(kept > fill)
+      {
+        std::nth_element(cols.begin(), cols.begin()+fill, cols.begin()+kept, greater);
+        for(std::size_t t = fill; t < kept; ++t)
+        {
+          inPattern[cols[t]] = false;
+          w[cols[t]] = Scalar(0);
+        }
+        kept = fill;
+      }
+      std::sort(cols.begin(), cols.begin()+kept);
+      cols.resize(kept);
+    }
+
+    for(std::size_t t = 0; t < lcols.size(); ++t)
+    {
+      Li.push_back(lcols[t]);
+      Lx.push_back(w[lcols[t]]);
+    }
+    Lp.push_back(Index(Li.size()));
+
+    // replace a zero pivot by a small multiple of the norm of the row
+    Scalar pivot = w[i];
+    if(pivot == Scalar(0))
+      pivot = (m_droptol + RealScalar(1e-4)) * (rownorm > RealScalar(0) ? rownorm : RealScalar(1));
+    Ui.push_back(i);
+    Ux.push_back(pivot);
+    for(std::size_t t = 0; t < ucols.size(); ++t)
+    {
+      Ui.push_back(ucols[t]);
+      Ux.push_back(w[ucols[t]]);
+    }
+    Up.push_back(Index(Ui.size()));
+
+    // reset the work row
+    for(std::size_t t = 0; t < lcols.size(); ++t) { w[lcols[t]] = Scalar(0); inPattern[lcols[t]] = false; }
+    for(std::size_t t = 0; t < ucols.size(); ++t) { w[ucols[t]] = Scalar(0); inPattern[ucols[t]] = false; }
+    w[i] = Scalar(0);
+    inPattern[i] = false;
+  }
+
+  m_L.resize(size, size);
+  m_L.resizeNonZeros(Index(Li.size()));
+  std::copy(Lp.begin(), Lp.end(), m_L._outerIndexPtr());
+  std::copy(Li.begin(), Li.end(), m_L._innerIndexPtr());
+  std::copy(Lx.begin(), Lx.end(), m_L._valuePtr());
+  m_U.resize(size, size);
+  m_U.resizeNonZeros(Index(Ui.size()));
+  std::copy(Up.begin(), Up.end(), m_U._outerIndexPtr());
+  std::copy(Ui.begin(), Ui.end(), m_U._innerIndexPtr());
+  std::copy(Ux.begin(), Ux.end(), m_U._valuePtr());
+
+  m_isInitialized = true;
+  m_info = Success;
+  return *this;
+}
+
+namespace internal {
+
+template<typename _Scalar, typename Rhs>
+struct solve_retval<IncompleteLUT<_Scalar>, Rhs>
+  : solve_retval_base<IncompleteLUT<_Scalar>, Rhs>
+{
+  typedef IncompleteLUT<_Scalar> Dec;
+  EIGEN_MAKE_SOLVE_HELPERS(Dec,Rhs)
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    dec()._solve(rhs(),dst);
+  }
+};
+
+} // end namespace internal
+
+#endif // EIGEN_INCOMPLETE_LUT_H
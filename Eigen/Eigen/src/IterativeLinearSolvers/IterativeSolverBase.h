@@ -0,0 +1,295 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_ITERATIVE_SOLVER_BASE_H
+#define EIGEN_ITERATIVE_SOLVER_BASE_H
+
+namespace internal {
+
+template<typename Decomposition, typename Rhs, typename Guess> struct solve_retval_with_guess;
+
+template<typename Decomposition, typename Rhs, typename Guess>
+struct traits<solve_retval_with_guess<Decomposition, Rhs, Guess> >
+{
+  typedef typename Decomposition::MatrixType MatrixType;
+  typedef Matrix<typename Rhs::Scalar,
+                 MatrixType::ColsAtCompileTime,
+                 Rhs::ColsAtCompileTime,
+                 Rhs::PlainObject::Options,
+                 MatrixType::MaxColsAtCompileTime,
+                 Rhs::MaxColsAtCompileTime> ReturnType;
+};
+
+template<typename Decomposition, typename Rhs, typename Guess> struct solve_retval_with_guess
+  : public ReturnByValue<solve_retval_with_guess<Decomposition, Rhs, Guess> >
+{
+  typedef typename Decomposition::Index Index;
+
+  solve_retval_with_guess(const Decomposition& dec, const Rhs& rhs, const Guess& guess)
+    : m_dec(dec), m_rhs(rhs), m_guess(guess)
+  {}
+
+  inline Index rows() const { return m_dec.cols(); }
+  inline Index cols() const { return m_rhs.cols(); }
+
+  template<typename Dest> inline void evalTo(Dest& dst) const
+  {
+    dst = m_guess;
+    m_dec._solveWithGuess(m_rhs, dst);
+  }
+
+  protected:
+    const Decomposition& m_dec;
+    const typename Rhs::Nested m_rhs;
+    const typename Guess::Nested m_guess;
+};
+
+} // end namespace internal
+
+/** \ingroup IterativeLinearSolvers_Module
+  * \brief Base class for the iterative linear solvers
+  *
+  * The matrix given to compute() is only referenced, it must therefore stay alive as long as the solver is
+  * used. Besides SparseMatrix and dense matrices, it can be any matrix-free operator providing:
+  *  - the typedefs \c Scalar, \c RealScalar and \c Index,
+  *  - the enums \c ColsAtCompileTime and \c MaxColsAtCompileTime (typically \c Dynamic),
+  *  - the methods rows() and cols(),
+  *  - a product operator* with a dense column vector whose result can be assigned to a dense vector.
+  *
+  * Such operators are usually combined with the IdentityPreconditioner, since the other preconditioners
+  * need access to the coefficients of the matrix.
+  *
+  * The iterations stop when the relative residual \f$ |b - Ax| / |b| \f$ is below tolerance(), or after
+  * maxIterations() iterations. Then info() returns \c Success or \c NoConvergence respectively,
+  * and iterations() and error() report the number of iterations and the final relative residual.
+  */
+template<typename Derived>
+class IterativeSolverBase
+{
+  public:
+    typedef typename internal::traits<Derived>::MatrixType MatrixType;
+    typedef typename internal::traits<Derived>::Preconditioner Preconditioner;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::Index Index;
+    typedef typename MatrixType::RealScalar RealScalar;
+
+    Derived& derived() { return *static_cast<Derived*>(this); }
+    const Derived& derived() const { return *static_cast<const Derived*>(this); }
+
+    /** Default constructor. */
+    IterativeSolverBase()
+      : mp_matrix(0)
+    {
+      init();
+    }
+
+    /** Initializes the iterative solver for the matrix \a A, and computes the preconditioner.
+      * This constructor is a shortcut for the default constructor followed by a call to compute(). */
+    IterativeSolverBase(const MatrixType& A)
+    {
+      init();
+      compute(A);
+    }
+
+    /** Initializes the iterative solver for the sparsity pattern of the matrix \a A for further solving
+      * \c Ax=b problems. Only the structural analysis of the preconditioner is performed.
+      * \sa factorize(), compute()
+      */
+    Derived& analyzePattern(const MatrixType& A)
+    {
+      m_preconditioner.analyzePattern(A);
+      m_isInitialized = true;
+      m_analysisIsOk = true;
+      m_info = Success;
+      return derived();
+    }
+
+    /** Initializes the iterative solver with the numerical values of the matrix \a A, which must have
+      * the same sparsity pattern as the matrix given to analyzePattern().
+      * \sa analyzePattern(), compute()
+      */
+    Derived& factorize(const MatrixType& A)
+    {
+      eigen_assert(m_analysisIsOk && "You must first call analyzePattern()");
+      mp_matrix = &A;
+      m_preconditioner.factorize(A);
+      m_factorizationIsOk = true;
+      m_info = Success;
+      return derived();
+    }
+
+    /** Initializes the iterative solver with the matrix \a A for further solving \c Ax=b problems,
+      * and computes the preconditioner.
+      * \sa analyzePattern(), factorize()
+      */
+    Derived& compute(const MatrixType& A)
+    {
+      mp_matrix = &A;
+      m_preconditioner.compute(A);
+      m_isInitialized = true;
+      m_analysisIsOk = true;
+      m_factorizationIsOk = true;
+      m_info = Success;
+      return derived();
+    }
+
+    /** \internal */
+    Index rows() const { return mp_matrix ? mp_matrix->rows() : 0; }
+    /** \internal */
+    Index cols() const { return mp_matrix ? mp_matrix->cols() : 0; }
+
+    /** \returns the tolerance threshold used by the stopping criteria */
+    RealScalar tolerance() const { return m_tolerance; }
+
+    /** Sets the tolerance threshold used by the stopping criteria */
+    Derived& setTolerance(const RealScalar& tolerance)
+    {
+      m_tolerance = tolerance;
+      return derived();
+    }
+
+    /** \returns a read-write reference to the preconditioner for custom configuration. */
+    Preconditioner& preconditioner() { return m_preconditioner; }
+
+    /** \returns a read-only reference to the preconditioner. */
+    const Preconditioner& preconditioner() const { return m_preconditioner; }
+
+    /** \returns the max number of iterations, which is twice the number of columns of the matrix
+      * unless it has been set by setMaxIterations() */
+    int maxIterations() const
+    {
+      return (mp_matrix && m_maxIterations<0) ? int(2*mp_matrix->cols()) : m_maxIterations;
+    }
+
+    /** Sets the max number of iterations */
+    Derived& setMaxIterations(int maxIters)
+    {
+      m_maxIterations = maxIters;
+      return derived();
+    }
+
+    /** \returns the number of iterations performed during the last solve */
+    int iterations() const
+    {
+      eigen_assert(m_isInitialized && "IterativeSolverBase is not initialized.");
+      return m_iterations;
+    }
+
+    /** \returns the relative residual error of the last solve */
+    RealScalar error() const
+    {
+      eigen_assert(m_isInitialized && "IterativeSolverBase is not initialized.");
+      return m_error;
+    }
+
+    /** \returns the solution x of \f$ A x = b \f$ using the current decomposition of A,
+      * starting from x = 0.
+      *
+      * \sa compute(), solveWithGuess()
+      */
+    template<typename Rhs> inline const internal::solve_retval<IterativeSolverBase, Rhs>
+    solve(const MatrixBase<Rhs>& b) const
+    {
+      eigen_assert(m_isInitialized && "IterativeSolverBase is not initialized.");
+      eigen_assert(rows()==b.rows()
+                && "IterativeSolverBase::solve(): invalid number of rows of the right hand side matrix b");
+      return internal::solve_retval<IterativeSolverBase, Rhs>(*this, b.derived());
+    }
+
+    /** \returns the solution x of \f$ A x = b \f$ using the current decomposition of A,
+      * starting from the initial guess \a x0.
+      *
+      * \sa compute(), solve()
+      */
+    template<typename Rhs, typename Guess>
+    inline const internal::solve_retval_with_guess<Derived, Rhs, Guess>
+    solveWithGuess(const MatrixBase<Rhs>& b, const Guess& x0) const
+    {
+      eigen_assert(m_isInitialized && "IterativeSolverBase is not initialized.");
+      eigen_assert(rows()==b.rows()
+                && "IterativeSolverBase::solveWithGuess(): invalid number of rows of the right hand side matrix b");
+      return internal::solve_retval_with_guess<Derived, Rhs, Guess>(derived(), b.derived(), x0);
+    }
+
+    /** \returns \c Success if the iterations converged, and \c NoConvergence otherwise. */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_isInitialized && "IterativeSolverBase is not initialized.");
+      return m_info;
+    }
+
+    /** \internal */
+    template<typename Rhs, typename Dest>
+    void _solve(const Rhs& b, Dest& dest) const
+    {
+      dest.setZero();
+      derived()._solveWithGuess(b,dest);
+    }
+
+  protected:
+    void init()
+    {
+      m_isInitialized = false;
+      m_analysisIsOk = false;
+      m_factorizationIsOk = false;
+      m_maxIterations = -1;
+      m_tolerance = NumTraits<Scalar>::epsilon();
+    }
+
+    /** \internal Updates the convergence report after the iterations on the columns of b */
+    void setResult(int iterations, const RealScalar& error) const
+    {
+      m_iterations = iterations;
+      m_error = error;
+      m_info = m_error <= m_tolerance ? Success : NoConvergence;
+    }
+
+    const MatrixType* mp_matrix;
+    Preconditioner m_preconditioner;
+
+    int m_maxIterations;
+    RealScalar m_tolerance;
+
+    mutable RealScalar m_error;
+    mutable int m_iterations;
+    mutable ComputationInfo m_info;
+    bool m_isInitialized, m_analysisIsOk, m_factorizationIsOk;
+};
+
+namespace internal {
+
+template<typename Derived, typename Rhs>
+struct solve_retval<IterativeSolverBase<Derived>, Rhs>
+  : solve_retval_base<IterativeSolverBase<Derived>, Rhs>
+{
+  typedef IterativeSolverBase<Derived> Dec;
+  EIGEN_MAKE_SOLVE_HELPERS(Dec,Rhs)
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    dec()._solve(rhs(),dst);
+  }
+};
+
+} // end namespace internal
+
+#endif // EIGEN_ITERATIVE_SOLVER_BASE_H
@@ -0,0 +1,201 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_SPARSE_AMD_H
+#define EIGEN_SPARSE_AMD_H
+
+namespace internal {
+
+/** \internal
+  * \ingroup OrderingMethods_Module
+  *
+  * Computes an approximate minimum degree ordering of the symmetric pattern \a C, following the
+  * quotient graph approach of Amestoy, Davis and Duff. \a C must be structurally symmetric, both
+  * triangular parts being stored, and its diagonal is ignored.
+  *
+  * Eliminated nodes are kept as elements whose variables are the union of the variables of their
+  * adjacent nodes. Eliminating a node absorbs its adjacent elements, so that the quotient graph never
+  * needs more memory than \a C itself plus the patterns of the current elements. The external degree
+  * of each variable adjacent to the new element is then approximated by the sum of the sizes of its
+  * adjacent elements, each of them being reduced by its overlap with the new element. Elements which
+  * are fully covered by the new element are absorbed as well (aggressive absorption).
+  *
+  * Unlike the reference implementation, indistinguishable variables are not merged into supervariables.
+  *
+  * On output, \a perm.indices()[k] is the index of the k-th eliminated node, i.e., the permuted matrix
+  * is \f$ P^{-1} C P \f$.
+  */
+template<typename Scalar, typename Index>
+void minimum_degree_ordering(const SparseMatrix<Scalar,ColMajor,Index>& C, PermutationMatrix<Dynamic,Dynamic,Index>& perm)
+{
+  typedef std::vector<Index> IndexList;
+  enum { Variable = 0, Element = 1, Absorbed = 2 };
+
+  const Index n = C.cols();
+  perm.resize(n);
+  if(n == 0) return;
+
+  std::vector<IndexList> adjVars(n);   // variables adjacent to a variable
+  std::vector<IndexList> adjElems(n);  // elements adjacent to a variable
+  std::vector<IndexList> elemVars(n);  // variables of an element
+  std::vector<char> status(n, char(Variable));
+  std::vector<Index> degree(n), head(n, -1), next(n, -1), prev(n, -1);
+  std::vector<Index> mark(n, -1), wmark(n, -1), w(n, 0);
+
+  for(Index j = 0; j < n; ++j)
+  {
+    for(typename SparseMatrix<Scalar,ColMajor,Index>::InnerIterator it(C, j); it; ++it)
+      if(it.index() != j)
+        adjVars[j].push_back(it.index());
+    degree[j] = Index(adjVars[j].size());
+  }
+
+  // degree lists
+  for(Index j = 0; j < n; ++j)
+  {
+    Index d = degree[j];
+    next[j] = head[d];
+    if(head[d] != -1) prev[head[d]] = j;
+    head[d] = j;
+  }
+
+  Index mindeg = 0;
+  IndexList Lp;
+  for(Index k = 0; k < n; ++k)
+  {
+    // select a variable of minimum degree and remove it from its degree list
+    while(head[mindeg] == -1) ++mindeg;
+    Index p = head[mindeg];
+    head[mindeg] = next[p];
+    if(next[p] != -1) prev[next[p]] = -1;
+    status[p] = Element;
+    perm.indices().coeffRef(k) = p;
+
+    // pattern of the new element: the variables adjacent to p and to the elements it absorbs
+    Lp.clear();
+    mark[p] = k;
+    for(typename IndexList::const_iterator it = adjVars[p].begin(); it != adjVars[p].end(); ++it)
+      if(status[*it] == Variable && mark[*it] != k)
+      {
+        mark[*it] = k;
+        Lp.push_back(*it);
+      }
+    for(typename IndexList::const_iterator e = adjElems[p].begin(); e != adjElems[p].end(); ++e)
+    {
+      if(status[*e] != Element) continue;
+      for(typename IndexList::const_iterator it = elemVars[*e].begin(); it != elemVars[*e].end(); ++it)
+        if(status[*it] == Variable && mark[*it] != k)
+        {
+          mark[*it] = k;
+          Lp.push_back(*it);
+        }
+      status[*e] = Absorbed;
+      IndexList().swap(elemVars[*e]);
+    }
+    IndexList().swap(adjVars[p]);
+    IndexList().swap(adjElems[p]);
+    elemVars[p] = Lp;
+    const Index lpSize = Index(Lp.size());
+
+    // update the adjacency of the variables of the new element, and compute |Le \ Lp|
+    // for each element e adjacent to one of them
+    for(Index q = 0; q < lpSize; ++q)
+    {
+      Index i = Lp[q];
+      IndexList& Ei = adjElems[i];
+      Index nb = 0;
+      for(Index l = 0; l < Index(Ei.size()); ++l)
+      {
+        Index e = Ei[l];
+        if(status[e] != Element) continue;
+        Ei[nb++] = e;
+        if(wmark[e] != k)
+        {
+          // first visit of e: drop its eliminated variables
+          IndexList& Le = elemVars[e];
+          Index m = 0;
+          for(Index l2 = 0; l2 < Index(Le.size()); ++l2)
+            if(status[Le[l2]] == Variable) Le[m++] = Le[l2];
+          Le.resize(m);
+          wmark[e] = k;
+          w[e] = m;
+        }
+        --w[e];
+      }
+      Ei.resize(nb);
+      Ei.push_back(p);
+
+      // the variables of Lp are now reached through p
+      IndexList& Ai = adjVars[i];
+      nb = 0;
+      for(Index l = 0; l < Index(Ai.size()); ++l)
+        if(status[Ai[l]] == Variable && mark[Ai[l]] != k)
+          Ai[nb++] = Ai[l];
+      Ai.resize(nb);
+    }
+
+    // approximate external degrees
+    const Index remaining = n - k - 1;
+    for(Index q = 0; q < lpSize; ++q)
+    {
+      Index i = Lp[q];
+      IndexList& Ei = adjElems[i];
+      Index d = Index(adjVars[i].size()) + lpSize - 1;
+      Index nb = 0;
+      for(Index l = 0; l < Index(Ei.size()); ++l)
+      {
+        Index e = Ei[l];
+        if(e != p)
+        {
+          if(w[e] == 0)
+          {
+            // aggressive absorption: e is a subset of p
+            status[e] = Absorbed;
+            IndexList().swap(elemVars[e]);
+            continue;
+          }
+          d += w[e];
+        }
+        Ei[nb++] = e;
+      }
+      Ei.resize(nb);
+      d = (std::min)(d, degree[i] + lpSize - 1);
+      d = (std::min)(d, remaining - 1);
+      d = (std::max)(d, Index(0));
+
+      // move i to its new degree list
+      if(prev[i] != -1) next[prev[i]] = next[i];
+      else head[degree[i]] = next[i];
+      if(next[i] != -1) prev[next[i]] = prev[i];
+      degree[i] = d;
+      prev[i] = -1;
+      next[i] = head[d];
+      if(head[d] != -1) prev[head[d]] = i;
+      head[d] = i;
+      if(d < mindeg) mindeg = d;
+    }
+  }
+}
+
+} // end namespace internal
+
+#endif // EIGEN_SPARSE_AMD_H
@@ -0,0 +1,183 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_ORDERING_H
+#define EIGEN_ORDERING_H
+
+namespace internal {
+
+/** \internal
+  * Stores the columns of \a cols, after sorting and removing the duplicates, into \a symmat
+  */
+template<typename Scalar, typename Index>
+void ordering_fill_pattern(std::vector<std::vector<Index> >& cols, SparseMatrix<Scalar,ColMajor,Index>& symmat)
+{
+  const Index n = Index(cols.size());
+  Index nnz = 0;
+  for(Index j = 0; j < n; ++j)
+  {
+    std::sort(cols[j].begin(), cols[j].end());
+    cols[j].erase(std::unique(cols[j].begin(), cols[j].end()), cols[j].end());
+    nnz += Index(cols[j].size());
+  }
+  symmat.resize(n, n);
+  symmat.reserve(nnz);
+  for(Index j = 0; j < n; ++j)
+  {
+    symmat.startVec(j);
+    for(typename std::vector<Index>::const_iterator it = cols[j].begin(); it != cols[j].end(); ++it)
+      symmat.insertBackByOuterInner(j, *it) = Scalar(1);
+  }
+  symmat.finalize();
+}
+
+/** \internal
+  * Stores the pattern of \f$ A + A^T \f$ into \a symmat, whose values are meaningless.
+  */
+template<typename MatrixType>
+void ordering_symmetric_pattern(const MatrixType& mat, SparseMatrix<typename MatrixType::Scalar,ColMajor,typename MatrixType::Index>& symmat)
+{
+  typedef typename MatrixType::Index Index;
+  typedef typename MatrixType::Scalar Scalar;
+  typedef SparseMatrix<Scalar,ColMajor,Index> ColMajorType;
+  eigen_assert(mat.rows() == mat.cols() && "the fill-reducing orderings require a square matrix");
+  ColMajorType C = mat;
+  std::vector<std::vector<Index> > cols(C.cols());
+  for(Index j = 0; j < C.outerSize(); ++j)
+    for(typename ColMajorType::InnerIterator it(C, j); it; ++it)
+    {
+      cols[j].push_back(it.index());
+      cols[it.index()].push_back(j);
+    }
+  ordering_fill_pattern(cols, symmat);
+}
+
+/** \internal
+  * Stores the pattern of \f$ A^T A \f$ into \a symmat, whose values are meaningless. Rows having more than
+  * \f$ 10 \sqrt{n} \f$ entries are ignored, as in COLAMD, since they would make the pattern dense while
+  * having little influence on the ordering.
+  */
+template<typename MatrixType>
+void ordering_normal_pattern(const MatrixType& mat, SparseMatrix<typename MatrixType::Scalar,ColMajor,typename MatrixType::Index>& symmat)
+{
+  typedef typename MatrixType::Index Index;
+  typedef typename MatrixType::Scalar Scalar;
+  typedef SparseMatrix<Scalar,RowMajor,Index> RowMajorType;
+  RowMajorType R = mat;
+  const Index n = R.cols();
+  const Index denseRow = (std::max)(Index(16), Index(10 * std::sqrt(double(n))));
+
+  std::vector<std::vector<Index> > cols(n);
+  for(Index r = 0; r < R.rows(); ++r)
+  {
+    if(R.innerNonZeros(r) > denseRow) continue;
+    for(typename RowMajorType::InnerIterator i(R, r); i; ++i)
+      for(typename RowMajorType::InnerIterator j(R, r); j; ++j)
+        cols[j.index()].push_back(i.index());
+  }
+  ordering_fill_pattern(cols, symmat);
+}
+
+} // end namespace internal
+
+/** \ingroup OrderingMethods_Module
+  * \class AMDOrdering
+  *
+  * Functor computing the approximate minimum degree ordering of a symmetric pattern.
+  * If the matrix is not structurally symmetric, the ordering of \f$ A + A^T \f$ is computed.
+  *
+  * The output permutation \a perm is such that \c perm.indices()[k] is the index of the k-th pivot,
+  * i.e., the factorized matrix is \f$ P^{-1} A P \f$.
+  *
+  * \sa COLAMDOrdering, NaturalOrdering
+  */
+template<typename Index>
+class AMDOrdering
+{
+  public:
+    typedef PermutationMatrix<Dynamic, Dynamic, Index> PermutationType;
+
+    /** Computes the ordering of the pattern of \f$ A + A^T \f$ */
+    template<typename MatrixType>
+    void operator()(const MatrixType& mat, PermutationType& perm)
+    {
+      SparseMatrix<typename MatrixType::Scalar,ColMajor,Index> symmat;
+      internal::ordering_symmetric_pattern(mat, symmat);
+      internal::minimum_degree_ordering(symmat, perm);
+    }
+
+    /** Computes the ordering of a selfadjoint matrix of which only one triangular part is stored */
+    template<typename SrcType, unsigned int SrcUpLo>
+    void operator()(const SparseSelfAdjointView<SrcType, SrcUpLo>& mat, PermutationType& perm)
+    {
+      SparseMatrix<typename SrcType::Scalar,ColMajor,Index> C = mat.matrix(), symmat;
+      internal::ordering_symmetric_pattern(C, symmat);
+      internal::minimum_degree_ordering(symmat, perm);
+    }
+};
+
+/** \ingroup OrderingMethods_Module
+  * \class COLAMDOrdering
+  *
+  * Functor computing a column ordering of an unsymmetric matrix for sparse LU and QR factorizations.
+  * Like the COLAMD algorithm, it computes an approximate minimum degree ordering of the pattern of
+  * \f$ A^T A \f$, whose Cholesky factor bounds the fill-in of the LU factors whatever the row pivoting.
+  * Unlike COLAMD, the pattern of \f$ A^T A \f$ is formed explicitly, so it uses more memory on matrices
+  * with long rows.
+  *
+  * \sa AMDOrdering
+  */
+template<typename Index>
+class COLAMDOrdering
+{
+  public:
+    typedef PermutationMatrix<Dynamic, Dynamic, Index> PermutationType;
+
+    template<typename MatrixType>
+    void operator()(const MatrixType& mat, PermutationType& perm)
+    {
+      SparseMatrix<typename MatrixType::Scalar,ColMajor,Index> symmat;
+      internal::ordering_normal_pattern(mat, symmat);
+      internal::minimum_degree_ordering(symmat, perm);
+    }
+};
+
+/** \ingroup OrderingMethods_Module
+  * \class NaturalOrdering
+  *
+  * Functor returning the identity permutation.
+  */
+template<typename Index>
+class NaturalOrdering
+{
+  public:
+    typedef PermutationMatrix<Dynamic, Dynamic, Index> PermutationType;
+
+    template<typename MatrixType>
+    void operator()(const MatrixType& mat, PermutationType& perm)
+    {
+      perm.resize(mat.cols());
+      perm.setIdentity();
+    }
+};
+
+#endif // EIGEN_ORDERING_H
@@ -340,6 +340,12 @@ template<typename _MatrixType> class ColPivHouseholderQR
     RealScalar maxPivot() const { return m_maxpivot; }
 
   protected:
+
+    enum { BlockSize = 32 };
+
+    void computeInPlaceUnblocked(RealScalar threshold_helper, Index& number_of_transpositions);
+    void computeInPlaceBlocked(RealScalar threshold_helper, Index& number_of_transpositions);
+
     MatrixType m_qr;
     HCoeffsType m_hCoeffs;
     PermutationType m_colsPermutation;
@@ -392,6 +398,28 @@ ColPivHouseholderQR<MatrixType>& ColPivHouseholderQR<MatrixType>::compute(const
   m_nonzero_pivots = size; // the generic case is that in which all pivots are nonzero (invertible case)
   m_maxpivot = RealScalar(0);
 
+  if(size >= 2*Index(BlockSize))
+    computeInPlaceBlocked(threshold_helper, number_of_transpositions);
+  else
+    computeInPlaceUnblocked(threshold_helper, number_of_transpositions);
+
+  m_colsPermutation.setIdentity(cols);
+  for(Index k = 0; k < m_nonzero_pivots; ++k)
+    m_colsPermutation.applyTranspositionOnTheRight(k, m_colsTranspositions.coeff(k));
+
+  m_det_pq = (number_of_transpositions%2) ? -1 : 1;
+  m_isInitialized = true;
+
+  return *this;
+}
+
+template<typename MatrixType>
+void ColPivHouseholderQR<MatrixType>::computeInPlaceUnblocked(RealScalar threshold_helper, Index& number_of_transpositions)
+{
+  Index rows = m_qr.rows();
+  Index cols = m_qr.cols();
+  Index size = m_qr.diagonalSize();
+
   for(Index k = 0; k < size; ++k)
   {
     // first, we look up in our table m_colSqNorms which column has the biggest squared norm
@@ -448,15 +476,101 @@ ColPivHouseholderQR<MatrixType>& ColPivHouseholderQR<MatrixType>::compute(const
     // update our table of squared norms of the columns
     m_colSqNorms.tail(cols-k-1) -= m_qr.row(k).tail(cols-k-1).cwiseAbs2();
   }
+}
 
-  m_colsPermutation.setIdentity(cols);
-  for(Index k = 0; k < m_nonzero_pivots; ++k)
-    m_colsPermutation.applyTranspositionOnTheRight(k, m_colsTranspositions.coeff(k));
+template<typename MatrixType>
+void ColPivHouseholderQR<MatrixType>::computeInPlaceBlocked(RealScalar threshold_helper, Index& number_of_transpositions)
+{
+  Index rows = m_qr.rows();
+  Index cols = m_qr.cols();
+  Index size = m_qr.diagonalSize();
+
+  // This follows the same pivoting strategy as computeInPlaceUnblocked(), but the reflectors of a panel
+  // are only applied to the pivot column and to the pivot row while the panel is being factorized.
+  // The updates of the remaining rows are accumulated in F such that the trailing matrix equals
+  // A - V F^*, and are applied by a single matrix product once the panel is complete.
+  const Index blockSize = BlockSize;
+  Matrix<Scalar,Dynamic,Dynamic> F(cols, blockSize);
+  Matrix<Scalar,Dynamic,1> pivotColumn(rows), auxv(blockSize);
+
+  for(Index p = 0; p < size; p += blockSize)
+  {
+    Index bs = (std::min)(size-p, blockSize);
+    bool rankDeficient = false;
+    Index k = p;
+    for(; k < p+bs; ++k)
+    {
+      Index kk = k - p;             // number of reflectors of the panel already computed
+      Index remainingRows = rows - k;
+      Index remainingCols = cols - k - 1;
+
+      Index biggest_col_index;
+      RealScalar biggest_col_sq_norm = m_colSqNorms.tail(cols-k).maxCoeff(&biggest_col_index);
+      biggest_col_index += k;
+
+      // bring the selected column up to date and recompute its actual squared norm
+      pivotColumn.tail(remainingRows) = m_qr.col(biggest_col_index).tail(remainingRows);
+      if(kk>0)
+        pivotColumn.tail(remainingRows).noalias() -= m_qr.block(k, p, remainingRows, kk)
+                                                   * F.row(biggest_col_index).head(kk).adjoint();
+      biggest_col_sq_norm = pivotColumn.tail(remainingRows).squaredNorm();
+      m_colSqNorms.coeffRef(biggest_col_index) = biggest_col_sq_norm;
+
+      if(biggest_col_sq_norm < threshold_helper * RealScalar(remainingRows))
+      {
+        rankDeficient = true;
+        break;
+      }
+
+      m_colsTranspositions.coeffRef(k) = biggest_col_index;
+      if(k != biggest_col_index) {
+        m_qr.col(k).swap(m_qr.col(biggest_col_index));
+        F.row(k).head(kk).swap(F.row(biggest_col_index).head(kk));
+        std::swap(m_colSqNorms.coeffRef(k), m_colSqNorms.coeffRef(biggest_col_index));
+        ++number_of_transpositions;
+      }
+
+      m_qr.col(k).tail(remainingRows) = pivotColumn.tail(remainingRows);
+
+      RealScalar beta;
+      m_qr.col(k).tail(remainingRows).makeHouseholderInPlace(m_hCoeffs.coeffRef(k), beta);
+      if(internal::abs(beta) > m_maxpivot) m_maxpivot = internal::abs(beta);
+
+      // compute the k-th column of F, i.e., conj(tau) (A - V F^*)^* v restricted to the trailing columns
+      Scalar tau = internal::conj(m_hCoeffs.coeff(k));
+      m_qr.coeffRef(k,k) = Scalar(1);
+      F.col(kk).tail(remainingCols).noalias() = tau * m_qr.block(k, k+1, remainingRows, remainingCols).adjoint()
+                                              * m_qr.col(k).tail(remainingRows);
+      if(kk>0)
+      {
+        auxv.head(kk).noalias() = tau * m_qr.block(k, p, remainingRows, kk).adjoint() * m_qr.col(k).tail(remainingRows);
+        F.col(kk).tail(remainingCols).noalias() -= F.block(k+1, 0, remainingCols, kk) * auxv.head(kk);
+      }
+
+      // update the k-th row which is final from now on
+      m_qr.row(k).tail(remainingCols).noalias() -= m_qr.row(k).segment(p, kk+1)
+                                                 * F.block(k+1, 0, remainingCols, kk+1).adjoint();
+      m_qr.coeffRef(k,k) = beta;
+
+      m_colSqNorms.tail(remainingCols) -= m_qr.row(k).tail(remainingCols).cwiseAbs2();
+    }
 
-  m_det_pq = (number_of_transpositions%2) ? -1 : 1;
-  m_isInitialized = true;
+    // apply the panel to the trailing matrix
+    Index nb = k - p;
+    if(nb>0 && k<rows && k<cols)
+      m_qr.bottomRightCorner(rows-k, cols-k).noalias() -= m_qr.block(k, p, rows-k, nb)
+                                                       * F.block(k, 0, cols-k, nb).adjoint();
 
-  return *this;
+    if(rankDeficient)
+    {
+      m_nonzero_pivots = k;
+      m_hCoeffs.tail(size-k).setZero();
+      m_qr.bottomRightCorner(rows-k,cols-k)
+          .template triangularView<StrictlyLower>()
+          .setZero();
+      break;
+    }
+  }
 }
 
 namespace internal {
@@ -0,0 +1,770 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_BDCSVD_H
+#define EIGEN_BDCSVD_H
+
+namespace internal {
+
+/** \internal sorts indices by increasing values of the referenced vector */
+template<typename VectorType> struct bdcsvd_index_less
+{
+  bdcsvd_index_less(const VectorType& values) : m_values(values) {}
+  template<typename Index> bool operator()(Index a, Index b) const { return m_values.coeff(a) < m_values.coeff(b); }
+  const VectorType& m_values;
+};
+
+} // end namespace internal
+
+/** \ingroup SVD_Module
+  *
+  *
+  * \class BDCSVD
+  *
+  * \brief Bidiagonal divide and conquer SVD of a matrix
+  *
+  * \param MatrixType the type of the matrix of which we are computing the SVD decomposition
+  *
+  * This class computes the same decomposition \f$ A = U S V^* \f$ as JacobiSVD, with the same API, but is much faster
+  * for large matrices. The matrix is first reduced to an upper bidiagonal matrix \f$ B \f$ by Householder transformations
+  * applied by panels (see internal::UpperBidiagonalization), and the SVD of \f$ B \f$ is computed by the divide and conquer
+  * algorithm of Gu and Eisenstat: \f$ B \f$ is split in two halves whose SVDs are computed recursively and then merged
+  * by solving a secular equation, all the updates of the singular vectors being matrix products. Subproblems smaller
+  * than switchSize() are handed to JacobiSVD, and so are matrices whose smaller dimension is below it.
+  *
+  * Singular values are always sorted in decreasing order. As with JacobiSVD, only the singular values are computed by
+  * default, and full or thin \a U and \a V have to be asked for explicitly.
+  *
+  * JacobiSVD remains more accurate for the smallest singular values of graded matrices, while BDCSVD is the method of
+  * choice for large dense matrices.
+  *
+  * \sa class JacobiSVD, MatrixBase::bdcSvd()
+  */
+template<typename _MatrixType> class BDCSVD
+{
+  public:
+
+    typedef _MatrixType MatrixType;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename NumTraits<typename MatrixType::Scalar>::Real RealScalar;
+    typedef typename MatrixType::Index Index;
+    enum {
+      RowsAtCompileTime = MatrixType::RowsAtCompileTime,
+      ColsAtCompileTime = MatrixType::ColsAtCompileTime,
+      MaxRowsAtCompileTime = MatrixType::MaxRowsAtCompileTime,
+      MaxColsAtCompileTime = MatrixType::MaxColsAtCompileTime,
+      MatrixOptions = MatrixType::Options
+    };
+
+    typedef Matrix<Scalar, RowsAtCompileTime, RowsAtCompileTime,
+                   MatrixOptions, MaxRowsAtCompileTime, MaxRowsAtCompileTime>
+            MatrixUType;
+    typedef Matrix<Scalar, ColsAtCompileTime, ColsAtCompileTime,
+                   MatrixOptions, MaxColsAtCompileTime, MaxColsAtCompileTime>
+            MatrixVType;
+    typedef typename internal::plain_diag_type<MatrixType, RealScalar>::type SingularValuesType;
+    typedef Matrix<Scalar, Dynamic, Dynamic> MatrixX;
+    typedef Matrix<RealScalar, Dynamic, Dynamic> MatrixXr;
+    typedef Matrix<RealScalar, Dynamic, 1> VectorXr;
+    typedef Matrix<Index, Dynamic, 1> IndicesType;
+
+    /** \brief Default Constructor.
+      *
+      * The default constructor is useful in cases in which the user intends to
+      * perform decompositions via BDCSVD::compute(const MatrixType&).
+      */
+    BDCSVD()
+      : m_isInitialized(false),
+        m_isAllocated(false),
+        m_computationOptions(0),
+        m_rows(-1), m_cols(-1),
+        m_switchSize(16)
+    {}
+
+    /** \brief Default Constructor with memory preallocation
+      *
+      * Like the default constructor but with preallocation of the internal data
+      * according to the specified problem size.
+      * \sa BDCSVD()
+      */
+    BDCSVD(Index rows, Index cols, unsigned int computationOptions = 0)
+      : m_isInitialized(false),
+        m_isAllocated(false),
+        m_computationOptions(0),
+        m_rows(-1), m_cols(-1),
+        m_switchSize(16)
+    {
+      allocate(rows, cols, computationOptions);
+    }
+
+    /** \brief Constructor performing the decomposition of given matrix.
+     *
+     * \param matrix the matrix to decompose
+     * \param computationOptions optional parameter allowing to specify if you want full or thin U or V unitaries to be computed.
+     *                           By default, none is computed. This is a bit-field, the possible bits are #ComputeFullU, #ComputeThinU,
+     *                           #ComputeFullV, #ComputeThinV.
+     *
+     * Thin unitaries are only available if your matrix type has a Dynamic number of columns (for example MatrixXf).
+     */
+    BDCSVD(const MatrixType& matrix, unsigned int computationOptions = 0)
+      : m_isInitialized(false),
+        m_isAllocated(false),
+        m_computationOptions(0),
+        m_rows(-1), m_cols(-1),
+        m_switchSize(16)
+    {
+      compute(matrix, computationOptions);
+    }
+
+    /** \brief Method performing the decomposition of given matrix using custom options.
+     *
+     * \param matrix the matrix to decompose
+     * \param computationOptions optional parameter allowing to specify if you want full or thin U or V unitaries to be computed.
+     *                           By default, none is computed. This is a bit-field, the possible bits are #ComputeFullU, #ComputeThinU,
+     *                           #ComputeFullV, #ComputeThinV.
+     */
+    BDCSVD& compute(const MatrixType& matrix, unsigned int computationOptions);
+
+    /** \brief Method performing the decomposition of given matrix using current options.
+     *
+     * \param matrix the matrix to decompose
+     *
+     * This method uses the current \a computationOptions, as already passed to the constructor or to compute(const MatrixType&, unsigned int).
+     */
+    BDCSVD& compute(const MatrixType& matrix)
+    {
+      return compute(matrix, m_computationOptions);
+    }
+
+    /** Sets the size below which the bidiagonal subproblems are solved by JacobiSVD. The default is 16,
+      * and it cannot be smaller than 3. */
+    BDCSVD& setSwitchSize(Index size)
+    {
+      eigen_assert(size >= 3 && "BDCSVD: the switch size must be at least 3");
+      m_switchSize = size;
+      return *this;
+    }
+
+    /** \returns the size below which the bidiagonal subproblems are solved by JacobiSVD */
+    Index switchSize() const { return m_switchSize; }
+
+    /** \returns the \a U matrix.
+     *
+     * For the SVD decomposition of a n-by-p matrix, letting \a m be the minimum of \a n and \a p,
+     * the U matrix is n-by-n if you asked for #ComputeFullU, and is n-by-m if you asked for #ComputeThinU.
+     *
+     * The \a m first columns of \a U are the left singular vectors of the matrix being decomposed.
+     *
+     * This method asserts that you asked for \a U to be computed.
+     */
+    const MatrixUType& matrixU() const
+    {
+      eigen_assert(m_isInitialized && "BDCSVD is not initialized.");
+      eigen_assert(computeU() && "This BDCSVD decomposition didn't compute U. Did you ask for it?");
+      return m_matrixU;
+    }
+
+    /** \returns the \a V matrix.
+     *
+     * For the SVD decomposition of a n-by-p matrix, letting \a m be the minimum of \a n and \a p,
+     * the V matrix is p-by-p if you asked for #ComputeFullV, and is p-by-m if you asked for ComputeThinV.
+     *
+     * The \a m first columns of \a V are the right singular vectors of the matrix being decomposed.
+     *
+     * This method asserts that you asked for \a V to be computed.
+     */
+    const MatrixVType& matrixV() const
+    {
+      eigen_assert(m_isInitialized && "BDCSVD is not initialized.");
+      eigen_assert(computeV() && "This BDCSVD decomposition didn't compute V. Did you ask for it?");
+      return m_matrixV;
+    }
+
+    /** \returns the vector of singular values.
+     *
+     * For the SVD decomposition of a n-by-p matrix, letting \a m be the minimum of \a n and \a p, the
+     * returned vector has size \a m.  Singular values are always sorted in decreasing order.
+     */
+    const SingularValuesType& singularValues() const
+    {
+      eigen_assert(m_isInitialized && "BDCSVD is not initialized.");
+      return m_singularValues;
+    }
+
+    /** \returns true if \a U (full or thin) is asked for in this SVD decomposition */
+    inline bool computeU() const { return m_computeFullU || m_computeThinU; }
+    /** \returns true if \a V (full or thin) is asked for in this SVD decomposition */
+    inline bool computeV() const { return m_computeFullV || m_computeThinV; }
+
+    /** \returns a (least squares) solution of \f$ A x = b \f$ using the current SVD decomposition of A.
+      *
+      * \param b the right-hand-side of the equation to solve.
+      *
+      * \note Solving requires both U and V to be computed. Thin U and V are enough, there is no need for full U or V.
+      */
+    template<typename Rhs>
+    inline const internal::solve_retval<BDCSVD, Rhs>
+    solve(const MatrixBase<Rhs>& b) const
+    {
+      eigen_assert(m_isInitialized && "BDCSVD is not initialized.");
+      eigen_assert(computeU() && computeV() && "BDCSVD::solve() requires both unitaries U and V to be computed (thin unitaries suffice).");
+      return internal::solve_retval<BDCSVD, Rhs>(*this, b.derived());
+    }
+
+    /** \returns the number of singular values that are not exactly 0 */
+    Index nonzeroSingularValues() const
+    {
+      eigen_assert(m_isInitialized && "BDCSVD is not initialized.");
+      return m_nonzeroSingularValues;
+    }
+
+    inline Index rows() const { return m_rows; }
+    inline Index cols() const { return m_cols; }
+
+  private:
+    void allocate(Index rows, Index cols, unsigned int computationOptions);
+    void divide(Index first, Index n, MatrixXr& U, MatrixXr& V, VectorXr& S);
+    void computeSVDofM(const VectorXr& z, const VectorXr& d, MatrixXr& U, MatrixXr& V, VectorXr& S);
+    RealScalar secularEq(RealScalar mu, const VectorXr& z, const VectorXr& d, const VectorXr& diff, RealScalar shift);
+
+  protected:
+    MatrixUType m_matrixU;
+    MatrixVType m_matrixV;
+    SingularValuesType m_singularValues;
+    VectorXr m_alpha, m_beta;
+    bool m_isInitialized, m_isAllocated;
+    bool m_computeFullU, m_computeThinU;
+    bool m_computeFullV, m_computeThinV;
+    unsigned int m_computationOptions;
+    Index m_nonzeroSingularValues, m_rows, m_cols, m_diagSize, m_switchSize;
+};
+
+template<typename MatrixType>
+void BDCSVD<MatrixType>::allocate(Index rows, Index cols, unsigned int computationOptions)
+{
+  eigen_assert(rows >= 0 && cols >= 0);
+
+  if (m_isAllocated &&
+      rows == m_rows &&
+      cols == m_cols &&
+      computationOptions == m_computationOptions)
+  {
+    return;
+  }
+
+  m_rows = rows;
+  m_cols = cols;
+  m_isInitialized = false;
+  m_isAllocated = true;
+  m_computationOptions = computationOptions;
+  m_computeFullU = (computationOptions & ComputeFullU) != 0;
+  m_computeThinU = (computationOptions & ComputeThinU) != 0;
+  m_computeFullV = (computationOptions & ComputeFullV) != 0;
+  m_computeThinV = (computationOptions & ComputeThinV) != 0;
+  eigen_assert(!(m_computeFullU && m_computeThinU) && "BDCSVD: you can't ask for both full and thin U");
+  eigen_assert(!(m_computeFullV && m_computeThinV) && "BDCSVD: you can't ask for both full and thin V");
+  eigen_assert(EIGEN_IMPLIES(m_computeThinU || m_computeThinV, MatrixType::ColsAtCompileTime==Dynamic) &&
+              "BDCSVD: thin U and V are only available when your matrix has a dynamic number of columns.");
+  m_diagSize = (std::min)(m_rows, m_cols);
+  m_singularValues.resize(m_diagSize);
+  m_matrixU.resize(m_rows, m_computeFullU ? m_rows
+                          : m_computeThinU ? m_diagSize
+                          : 0);
+  m_matrixV.resize(m_cols, m_computeFullV ? m_cols
+                          : m_computeThinV ? m_diagSize
+                          : 0);
+}
+
+template<typename MatrixType>
+BDCSVD<MatrixType>&
+BDCSVD<MatrixType>::compute(const MatrixType& matrix, unsigned int computationOptions)
+{
+  allocate(matrix.rows(), matrix.cols(), computationOptions);
+
+  /*** step 0. Small matrices are handed to JacobiSVD ***/
+
+  if(m_diagSize <= m_switchSize)
+  {
+    JacobiSVD<MatrixType> jacobi(matrix, computationOptions);
+    m_singularValues = jacobi.singularValues();
+    if(computeU()) m_matrixU = jacobi.matrixU();
+    if(computeV()) m_matrixV = jacobi.matrixV();
+    m_nonzeroSingularValues = jacobi.nonzeroSingularValues();
+    m_isInitialized = true;
+    return *this;
+  }
+
+  /*** step 1. Reduce to an upper bidiagonal matrix B = U_B^* A V_B, transposing A if it has more columns than rows ***/
+
+  const bool transposed = m_rows < m_cols;
+  const Index n = m_diagSize;
+  MatrixX copy;
+  if(transposed) copy = matrix.adjoint();
+  else           copy = matrix;
+  internal::UpperBidiagonalization<MatrixX> bid(copy);
+
+  // The SVD of B is obtained from the one of the (n+1) x n lower bidiagonal matrix [B^T; 0]
+  typename internal::UpperBidiagonalization<MatrixX>::BidiagonalType bidiagonal(bid.bidiagonal());
+  m_alpha = bidiagonal.template diagonal<0>().transpose();
+  m_beta.resize(n);
+  m_beta.head(n-1) = bidiagonal.template diagonal<1>().transpose();
+  m_beta.coeffRef(n-1) = RealScalar(0);
+
+  // scale B to avoid overflows and underflows in the secular equations
+  RealScalar scale = (std::max)(m_alpha.cwiseAbs().maxCoeff(), m_beta.cwiseAbs().maxCoeff());
+  if(scale == RealScalar(0)) scale = RealScalar(1);
+  m_alpha /= scale;
+  m_beta /= scale;
+
+  // entries below epsilon are set to zero, a perturbation below the rounding errors of the bidiagonalization.
+  // Left as they are, they may underflow when squared in the secular equations, and the exact zeros split B
+  // into independent blocks, see divide()
+  const RealScalar eps = NumTraits<RealScalar>::epsilon();
+  for(Index i = 0; i < n; ++i)
+  {
+    if(internal::abs(m_alpha.coeff(i)) < eps) m_alpha.coeffRef(i) = RealScalar(0);
+    if(internal::abs(m_beta.coeff(i)) < eps)  m_beta.coeffRef(i) = RealScalar(0);
+  }
+
+  /*** step 2. Divide and conquer on the bidiagonal matrix: [B^T; 0] = naiveU [S; 0] naiveV^T ***/
+
+  MatrixXr naiveU, naiveV;
+  VectorXr S;
+  divide(0, n, naiveU, naiveV, S);
+
+  /*** step 3. Sort the singular values in decreasing order, and apply U_B and V_B to the singular vectors of B ***/
+
+  IndicesType perm(n);
+  for(Index i = 0; i < n; ++i) perm.coeffRef(i) = i;
+  std::sort(perm.data(), perm.data()+n, internal::bdcsvd_index_less<VectorXr>(-S));
+
+  m_nonzeroSingularValues = n;
+  for(Index i = 0; i < n; ++i)
+  {
+    m_singularValues.coeffRef(i) = scale * S.coeff(perm.coeff(i));
+    if(m_singularValues.coeff(i) == RealScalar(0) && m_nonzeroSingularValues == n)
+      m_nonzeroSingularValues = i;
+  }
+
+  // B = naiveV S naiveU^T, so the left singular vectors of the bidiagonalized matrix come from naiveV, and
+  // the right ones from the top left corner of naiveU whose last row and column are trivial
+  bool computeLeft  = transposed ? computeV() : computeU();
+  bool computeRight = transposed ? computeU() : computeV();
+  bool fullLeft     = transposed ? m_computeFullV : m_computeFullU;
+  MatrixX left, right;
+  if(computeLeft)
+  {
+    left.setIdentity(copy.rows(), fullLeft ? copy.rows() : n);
+    for(Index i = 0; i < n; ++i)
+      left.col(i).head(n) = naiveV.col(perm.coeff(i)).template cast<Scalar>();
+    left.applyOnTheLeft(bid.householderU());
+  }
+  if(computeRight)
+  {
+    right.resize(n, n);
+    for(Index i = 0; i < n; ++i)
+      right.col(i) = naiveU.col(perm.coeff(i)).head(n).template cast<Scalar>();
+    right.applyOnTheLeft(bid.householderV());
+  }
+
+  if(transposed)
+  {
+    if(computeU()) m_matrixU = right;
+    if(computeV()) m_matrixV = left;
+  }
+  else
+  {
+    if(computeU()) m_matrixU = left;
+    if(computeV()) m_matrixV = right;
+  }
+
+  m_isInitialized = true;
+  return *this;
+}
+
+/** \internal
+  * Computes the SVD of the (n+1) x n lower bidiagonal block of [B^T; 0] starting at (first,first):
+  * block = U [diag(S); 0] V^T with U of size n+1 and V of size n. The singular values are not sorted.
+  */
+template<typename MatrixType>
+void BDCSVD<MatrixType>::divide(Index first, Index n, MatrixXr& U, MatrixXr& V, VectorXr& S)
+{
+  // a block of zeros, as left by the deflation of the tiny entries in compute(), is split off directly
+  if(m_alpha.segment(first, n).isZero(RealScalar(0)) && m_beta.segment(first, n).isZero(RealScalar(0)))
+  {
+    U.setIdentity(n+1, n+1);
+    V.setIdentity(n, n);
+    S.setZero(n);
+    return;
+  }
+
+  if(n <= m_switchSize)
+  {
+    MatrixXr block = MatrixXr::Zero(n+1, n);
+    for(Index i = 0; i < n; ++i)
+    {
+      block.coeffRef(i,i) = m_alpha.coeff(first+i);
+      block.coeffRef(i+1,i) = m_beta.coeff(first+i);
+    }
+    JacobiSVD<MatrixXr> jacobi(block, ComputeFullU | ComputeFullV);
+    U = jacobi.matrixU();
+    V = jacobi.matrixV();
+    S = jacobi.singularValues();
+    return;
+  }
+
+  // The k-th column splits the block into a (k+1) x k lower bidiagonal block B1 (rows 0..k)
+  // and a (n2+1) x n2 one B2 (rows k+1..n):
+  //        B1 | alpha_k e_k |  0
+  // B =    --------------------------
+  //        0  | beta_k e_0  | B2
+  const Index k = n/2;
+  const Index n2 = n - k - 1;
+  MatrixXr U1, V1, U2, V2;
+  VectorXr S1, S2;
+  divide(first, k, U1, V1, S1);
+  divide(first+k+1, n2, U2, V2, S2);
+
+  // Multiplying by diag(U1,U2)^T on the left and by diag(V1,1,V2) on the right leaves two rows with only one
+  // nonzero in the k-th column: the last row of U1^T B1 and the last one of U2^T B2. A Givens rotation merges
+  // them so that the remaining n x n matrix is M = diag(d) + z e_0^T, with d = (0, S1, S2).
+  RealScalar alphaK = m_alpha.coeff(first+k), betaK = m_beta.coeff(first+k);
+  RealScalar lambda = alphaK * U1.coeff(k,k), phi = betaK * U2.coeff(0,n2);
+  RealScalar r0 = RealScalar(0), c0 = RealScalar(1), s0 = RealScalar(0);
+  if(lambda != RealScalar(0) || phi != RealScalar(0))
+  {
+    r0 = internal::hypot(lambda, phi);
+    c0 = lambda / r0;
+    s0 = phi / r0;
+  }
+
+  VectorXr z(n), d(n);
+  z.coeffRef(0) = r0;
+  d.coeffRef(0) = RealScalar(0);
+  z.segment(1,k) = alphaK * U1.row(k).head(k).transpose();
+  d.segment(1,k) = S1;
+  z.tail(n2) = betaK * U2.row(0).head(n2).transpose();
+  d.tail(n2) = S2;
+
+  MatrixXr UM, VM;
+  computeSVDofM(z, d, UM, VM, S);
+
+  // U = diag(U1,U2) G^T diag(UM,1), where the first row of UM goes to the merged rows
+  U.resize(n+1, n+1);
+  {
+    MatrixXr Q1(k+1, k+1);
+    Q1.col(0) = c0 * U1.col(k);
+    Q1.rightCols(k) = U1.leftCols(k);
+    U.topLeftCorner(k+1, n).noalias() = Q1 * UM.topRows(k+1);
+
+    MatrixXr Q2(n2+1, n2+1), UM2(n2+1, n);
+    Q2.col(0) = s0 * U2.col(n2);
+    Q2.rightCols(n2) = U2.leftCols(n2);
+    UM2.row(0) = UM.row(0);
+    UM2.bottomRows(n2) = UM.bottomRows(n2);
+    U.bottomLeftCorner(n2+1, n).noalias() = Q2 * UM2;
+
+    U.col(n).head(k+1) = -s0 * U1.col(k);
+    U.col(n).tail(n2+1) = c0 * U2.col(n2);
+  }
+
+  // V = diag(V1,1,V2) VM, where the first row of VM goes to the k-th column
+  V.resize(n, n);
+  V.topRows(k).noalias() = V1 * VM.middleRows(1, k);
+  V.row(k) = VM.row(0);
+  V.bottomRows(n2).noalias() = V2 * VM.bottomRows(n2);
+}
+
+/** \internal evaluates the secular function 1 + sum z_j^2 / (d_j^2 - sigma^2) at sigma = shift + mu,
+  * where diff = d - shift */
+template<typename MatrixType>
+typename BDCSVD<MatrixType>::RealScalar
+BDCSVD<MatrixType>::secularEq(RealScalar mu, const VectorXr& z, const VectorXr& d, const VectorXr& diff, RealScalar shift)
+{
+  RealScalar res = RealScalar(1);
+  for(Index j = 0; j < z.size(); ++j)
+    res += z.coeff(j) * z.coeff(j) / ((diff.coeff(j) - mu) * (d.coeff(j) + shift + mu));
+  return res;
+}
+
+/** \internal
+  * Computes the SVD M = U diag(S) V^T of M = diag(d) + z e_0^T, where d_0 = 0, following Gu and Eisenstat:
+  * after deflation, the singular values are the roots of the secular equation, z is recomputed from them
+  * by the Loewner formula, and the singular vectors are then given in closed form.
+  */
+template<typename MatrixType>
+void BDCSVD<MatrixType>::computeSVDofM(const VectorXr& z, const VectorXr& d, MatrixXr& U, MatrixXr& V, VectorXr& S)
+{
+  using std::abs;
+  using std::sqrt;
+  const Index n = z.size();
+  const RealScalar eps = NumTraits<RealScalar>::epsilon();
+  const RealScalar inf = std::numeric_limits<RealScalar>::infinity();
+
+  U.setZero(n, n);
+  V.setZero(n, n);
+  S.resize(n);
+
+  RealScalar maxAbs = (std::max)(d.maxCoeff(), z.cwiseAbs().maxCoeff());
+  if(maxAbs == RealScalar(0))
+  {
+    U.setIdentity();
+    V.setIdentity();
+    S.setZero();
+    return;
+  }
+  const RealScalar tol = RealScalar(8) * eps;
+
+  // sort d in increasing order, d_0 = 0 staying first. M is scaled to a unit largest entry, as the secular
+  // equation and the Loewner formula square its entries, which would underflow for a small block.
+  IndicesType perm(n);
+  for(Index i = 0; i < n; ++i) perm.coeffRef(i) = i;
+  std::sort(perm.data()+1, perm.data()+n, internal::bdcsvd_index_less<VectorXr>(d));
+  VectorXr ds(n), zs(n);
+  for(Index i = 0; i < n; ++i)
+  {
+    ds.coeffRef(i) = d.coeff(perm.coeff(i)) / maxAbs;
+    zs.coeffRef(i) = z.coeff(perm.coeff(i)) / maxAbs;
+  }
+
+  // deflation: a negligible z_j makes d_j a singular value, and a d_j close to a previous d_l allows
+  // to rotate z_j into z_l. The rotations G are recorded to be applied to the singular vectors.
+  if(abs(zs.coeff(0)) < tol) zs.coeffRef(0) = tol;
+  Matrix<bool,Dynamic,1> deflated = Matrix<bool,Dynamic,1>::Constant(n, false);
+  IndicesType rotFirst(n), rotSecond(n);
+  VectorXr rotC(n), rotS(n);
+  Index nbRotations = 0;
+  Index last = 0;
+  for(Index j = 1; j < n; ++j)
+  {
+    if(abs(zs.coeff(j)) <= tol)
+    {
+      deflated.coeffRef(j) = true;
+      zs.coeffRef(j) = RealScalar(0);
+    }
+    else if(ds.coeff(j) - ds.coeff(last) <= tol)
+    {
+      RealScalar r = internal::hypot(zs.coeff(last), zs.coeff(j));
+      rotFirst.coeffRef(nbRotations) = last;
+      rotSecond.coeffRef(nbRotations) = j;
+      rotC.coeffRef(nbRotations) = zs.coeff(last) / r;
+      rotS.coeffRef(nbRotations) = zs.coeff(j) / r;
+      ++nbRotations;
+      zs.coeffRef(last) = r;
+      zs.coeffRef(j) = RealScalar(0);
+      ds.coeffRef(j) = ds.coeff(last);
+      deflated.coeffRef(j) = true;
+    }
+    else
+      last = j;
+  }
+
+  // gather the remaining secular problem
+  IndicesType J(n);
+  Index nd = 0;
+  for(Index j = 0; j < n; ++j)
+    if(!deflated.coeff(j)) J.coeffRef(nd++) = j;
+  VectorXr dJ(nd), zJ(nd), diff(nd), shifts(nd), mus(nd);
+  for(Index p = 0; p < nd; ++p)
+  {
+    dJ.coeffRef(p) = ds.coeff(J.coeff(p));
+    zJ.coeffRef(p) = zs.coeff(J.coeff(p));
+  }
+
+  // solve the secular equation: the i-th root lies in (dJ_i, dJ_{i+1}), and is computed as an offset mu from
+  // the closest end of its interval so that the differences sigma - d_j keep their relative accuracy
+  const RealScalar zNorm = zJ.norm();
+  for(Index i = 0; i < nd; ++i)
+  {
+    RealScalar left = dJ.coeff(i);
+    RealScalar right = (i < nd-1) ? dJ.coeff(i+1) : left + zNorm;
+    RealScalar mid = left + (right - left) / RealScalar(2);
+    diff = dJ.array() - RealScalar(0);
+    RealScalar fMid = secularEq(mid, zJ, dJ, diff, RealScalar(0));
+    RealScalar shift = (i == nd-1 || fMid > RealScalar(0)) ? left : right;
+    diff = dJ.array() - shift;
+
+    // safeguarded regula falsi (Illinois variant) on mu, the ends of the interval being poles or not
+    RealScalar a, b, fa, fb;
+    if(shift == left)
+    {
+      a = RealScalar(0);   fa = -inf;
+      b = (i == nd-1) ? right - left : mid - left;
+      fb = (i == nd-1) ? secularEq(b, zJ, dJ, diff, shift) : fMid;
+    }
+    else
+    {
+      a = mid - right;     fa = fMid;
+      b = RealScalar(0);   fb = inf;
+    }
+    int side = 0;
+    for(int iter = 0; iter < 256; ++iter)
+    {
+      if(b - a <= RealScalar(2) * eps * (std::max)(abs(a), abs(b)) || fa >= RealScalar(0) || fb <= RealScalar(0))
+        break;
+      RealScalar m;
+      if(fa != -inf && fb != inf)
+      {
+        m = (a * fb - b * fa) / (fb - fa);
+        if(!(m > a && m < b)) m = a + (b - a) / RealScalar(2);
+      }
+      else
+        m = a + (b - a) / RealScalar(2);
+      if(m <= a || m >= b) break;
+      RealScalar fm = secularEq(m, zJ, dJ, diff, shift);
+      if(fm < RealScalar(0))
+      {
+        a = m; fa = fm;
+        if(side == -1 && fb != inf) fb /= RealScalar(2);
+        side = -1;
+      }
+      else
+      {
+        b = m; fb = fm;
+        if(side == 1 && fa != -inf) fa /= RealScalar(2);
+        side = 1;
+      }
+    }
+    // keep the end which is not a pole and whose value is the smallest
+    RealScalar mu;
+    if(fa == -inf)     mu = b;
+    else if(fb == inf) mu = a;
+    else               mu = abs(fa) < abs(fb) ? a : b;
+    shifts.coeffRef(i) = shift;
+    mus.coeffRef(i) = mu;
+    S.coeffRef(i) = shift + mu;
+  }
+
+  // recompute z from the computed singular values (Loewner formula), so that the singular vectors
+  // computed below are numerically orthogonal. Each factor is divided before it is multiplied, and z itself
+  // is kept if the product is not finite.
+  VectorXr zhat(nd);
+  for(Index p = 0; p < nd; ++p)
+  {
+    RealScalar dp = dJ.coeff(p);
+    RealScalar prod = ((shifts.coeff(nd-1) - dp) + mus.coeff(nd-1)) * (shifts.coeff(nd-1) + dp + mus.coeff(nd-1));
+    for(Index i = 0; i < nd-1; ++i)
+    {
+      RealScalar di = dJ.coeff(i < p ? i : i+1);
+      prod *= (((shifts.coeff(i) - dp) + mus.coeff(i)) / (di - dp)) * ((shifts.coeff(i) + dp + mus.coeff(i)) / (di + dp));
+    }
+    RealScalar absz;
+    if(!(prod <= (std::numeric_limits<RealScalar>::max)())) absz = abs(zJ.coeff(p));
+    else                                                    absz = prod > RealScalar(0) ? sqrt(prod) : RealScalar(0);
+    zhat.coeffRef(p) = zJ.coeff(p) < RealScalar(0) ? -absz : absz;
+  }
+
+  // singular vectors of the non deflated part: u_i = (D^2 - sigma_i^2)^{-1} zhat, v_i = M^T u_i / sigma_i
+  VectorXr u(nd), v(nd);
+  for(Index i = 0; i < nd; ++i)
+  {
+    for(Index p = 0; p < nd; ++p)
+    {
+      RealScalar dp = dJ.coeff(p);
+      u.coeffRef(p) = zhat.coeff(p) / (-((shifts.coeff(i) - dp) + mus.coeff(i)) * (shifts.coeff(i) + dp + mus.coeff(i)));
+      v.coeffRef(p) = dp * u.coeff(p);
+    }
+    v.coeffRef(0) = RealScalar(-1);
+    u.normalize();
+    v.normalize();
+    for(Index p = 0; p < nd; ++p)
+    {
+      U.coeffRef(J.coeff(p), i) = u.coeff(p);
+      V.coeffRef(J.coeff(p), i) = v.coeff(p);
+    }
+  }
+
+  // deflated singular values
+  Index col = nd;
+  for(Index j = 0; j < n; ++j)
+  {
+    if(deflated.coeff(j))
+    {
+      U.coeffRef(j, col) = RealScalar(1);
+      V.coeffRef(j, col) = RealScalar(1);
+      S.coeffRef(col) = ds.coeff(j);
+      ++col;
+    }
+  }
+  S *= maxAbs;
+
+  // undo the deflation rotations, the ones involving the first row only act on the left
+  for(Index r = nbRotations-1; r >= 0; --r)
+  {
+    JacobiRotation<RealScalar> G(rotC.coeff(r), rotS.coeff(r));
+    U.applyOnTheLeft(rotFirst.coeff(r), rotSecond.coeff(r), G.transpose());
+    if(rotFirst.coeff(r) != 0)
+      V.applyOnTheLeft(rotFirst.coeff(r), rotSecond.coeff(r), G.transpose());
+  }
+
+  // go back to the original ordering of d
+  MatrixXr tmp(n, n);
+  for(Index i = 0; i < n; ++i) tmp.row(perm.coeff(i)) = U.row(i);
+  U.swap(tmp);
+  for(Index i = 0; i < n; ++i) tmp.row(perm.coeff(i)) = V.row(i);
+  V.swap(tmp);
+}
+
+namespace internal {
+template<typename _MatrixType, typename Rhs>
+struct solve_retval<BDCSVD<_MatrixType>, Rhs>
+  : solve_retval_base<BDCSVD<_MatrixType>, Rhs>
+{
+  typedef BDCSVD<_MatrixType> BDCSVDType;
+  EIGEN_MAKE_SOLVE_HELPERS(BDCSVDType,Rhs)
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    eigen_assert(rhs().rows() == dec().rows());
+
+    // A = U S V^*
+    // So A^{-1} = V S^{-1} U^*
+
+    Index diagSize = (std::min)(dec().rows(), dec().cols());
+    typename BDCSVDType::SingularValuesType invertedSingVals(diagSize);
+
+    Index nonzeroSingVals = dec().nonzeroSingularValues();
+    invertedSingVals.head(nonzeroSingVals) = dec().singularValues().head(nonzeroSingVals).array().inverse();
+    invertedSingVals.tail(diagSize - nonzeroSingVals).setZero();
+
+    dst = dec().matrixV().leftCols(diagSize)
+        * invertedSingVals.asDiagonal()
+        * dec().matrixU().leftCols(diagSize).adjoint()
+        * rhs();
+  }
+};
+} // end namespace internal
+
+/** \svd_module
+  *
+  * \return the singular value decomposition of \c *this computed by the bidiagonal divide and conquer algorithm
+  *
+  * \sa class BDCSVD
+  */
+template<typename Derived>
+BDCSVD<typename MatrixBase<Derived>::PlainObject>
+MatrixBase<Derived>::bdcSvd(unsigned int computationOptions) const
+{
+  return BDCSVD<PlainObject>(*this, computationOptions);
+}
+
+#endif // EIGEN_BDCSVD_H
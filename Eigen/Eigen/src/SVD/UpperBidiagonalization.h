@@ -93,6 +93,10 @@ template<typename _MatrixType> class UpperBidiagonalization
     }
     
   protected:
+    enum { BlockSize = 32 };
+
+    void computePanel(Index k, Matrix<Scalar,Dynamic,Dynamic>& X, Matrix<Scalar,Dynamic,Dynamic>& Y);
+
     MatrixType m_householder;
     BidiagonalType m_bidiagonal;
     bool m_isInitialized;
@@ -110,7 +114,16 @@ UpperBidiagonalization<_MatrixType>& UpperBidiagonalization<_MatrixType>::comput
 
   ColVectorType temp(rows);
 
-  for (Index k = 0; /* breaks at k==cols-1 below */ ; ++k)
+  // reduce panels of BlockSize columns and rows at once, then finish the last columns one at a time
+  Index k = 0;
+  if(cols >= 2*Index(BlockSize))
+  {
+    Matrix<Scalar,Dynamic,Dynamic> X(rows, Index(BlockSize)), Y(cols, Index(BlockSize));
+    for(; k + Index(BlockSize) < cols; k += Index(BlockSize))
+      computePanel(k, X, Y);
+  }
+
+  for (; /* breaks at k==cols-1 below */ ; ++k)
   {
     Index remainingRows = rows - k;
     Index remainingCols = cols - k - 1;
@@ -127,13 +140,17 @@ UpperBidiagonalization<_MatrixType>& UpperBidiagonalization<_MatrixType>::comput
 
     if(k == cols-1) break;
     
-    // construct right householder transform in-place in m_householder
+    // construct right householder transform in-place in m_householder: the stored row v and
+    // coefficient tau are such that the k-th row times I - tau v^T conj(v) is real, which makes
+    // householderV() the product of these reflectors in the complex case as well
+    m_householder.row(k).tail(remainingCols) = m_householder.row(k).tail(remainingCols).conjugate();
     m_householder.row(k).tail(remainingCols)
                  .makeHouseholderInPlace(m_householder.coeffRef(k,k+1),
                                          m_bidiagonal.template diagonal<1>().coeffRef(k));
-    // apply householder transform to remaining part of m_householder on the left
+    m_householder.coeffRef(k,k+1) = internal::conj(m_householder.coeff(k,k+1));
+    // apply householder transform to remaining part of m_householder on the right
     m_householder.bottomRightCorner(remainingRows-1, remainingCols)
-                 .applyHouseholderOnTheRight(m_householder.row(k).tail(remainingCols-1).transpose(),
+                 .applyHouseholderOnTheRight(m_householder.row(k).tail(remainingCols-1).adjoint(),
                                              m_householder.coeff(k,k+1),
                                              temp.data());
   }
@@ -141,6 +158,91 @@ UpperBidiagonalization<_MatrixType>& UpperBidiagonalization<_MatrixType>::comput
   return *this;
 }
 
+/** \internal
+  * Reduces the columns and rows \a k to \a k+BlockSize-1 like the unblocked loop of compute(), but
+  * without updating the trailing matrix A22 for each reflector. Instead, the reflectors are accumulated
+  * in \a X and \a Y such that A22 - U Y^* - X W^* is the current trailing matrix, where the columns of
+  * U and W are the left and right Householder vectors respectively. A22 is then
+  * updated by two matrix products at the end of the panel (this is LAPACK's xLABRD).
+  */
+template<typename _MatrixType>
+void UpperBidiagonalization<_MatrixType>::computePanel(Index k0, Matrix<Scalar,Dynamic,Dynamic>& X, Matrix<Scalar,Dynamic,Dynamic>& Y)
+{
+  Index rows = m_householder.rows();
+  Index cols = m_householder.cols();
+  const Index bs = BlockSize;
+  Matrix<Scalar,Dynamic,1> tmp(bs);
+  // the Householder coefficients are stored in place of the implicit unit
+  // coefficients of the vectors, which are needed during the panel
+  Matrix<Scalar,Dynamic,1> tauLeft(bs), tauRight(bs);
+  X.setZero();
+  Y.setZero();
+
+  for(Index i = 0; i < bs; ++i)
+  {
+    Index k = k0 + i;
+    Index remainingRows = rows - k;
+    Index remainingCols = cols - k - 1;
+    Block<MatrixType,Dynamic,Dynamic> U_k(m_householder, k, k0, remainingRows, i);      // U(k:, 0:i)
+    Block<MatrixType,Dynamic,Dynamic> W_k(m_householder, k0, k+1, i, remainingCols);    // W(k+1:, 0:i)^T
+
+    // update the k-th column
+    Block<MatrixType,Dynamic,1> colK(m_householder, k, k, remainingRows, 1);
+    colK.noalias() -= U_k * Y.row(k).head(i).adjoint();
+    colK.noalias() -= X.block(k, 0, remainingRows, i) * m_householder.col(k).segment(k0, i).conjugate();
+
+    // construct the left Householder vector and set its leading coefficient to 1
+    Scalar tau;
+    colK.makeHouseholderInPlace(tau, m_bidiagonal.template diagonal<0>().coeffRef(k));
+    tauLeft.coeffRef(i) = tau;
+    m_householder.coeffRef(k,k) = Scalar(1);
+
+    // Y(k+1:,i) = conj(tau) (A - U Y^* - X W^*)^* u
+    Block<MatrixType,Dynamic,Dynamic> A_k(m_householder, k, k+1, remainingRows, remainingCols);
+    Block<Matrix<Scalar,Dynamic,Dynamic>,Dynamic,1> y(Y, k+1, i, remainingCols, 1);
+    y.noalias() = A_k.adjoint() * colK;
+    tmp.head(i).noalias() = U_k.adjoint() * colK;
+    y.noalias() -= Y.block(k+1, 0, remainingCols, i) * tmp.head(i);
+    tmp.head(i).noalias() = X.block(k, 0, remainingRows, i).adjoint() * colK;
+    y.noalias() -= W_k.transpose() * tmp.head(i);
+    y *= internal::conj(tau);
+
+    // update the k-th row
+    Block<MatrixType,1,Dynamic> rowK(m_householder, k, k+1, 1, remainingCols);
+    rowK.noalias() -= m_householder.row(k).segment(k0, i+1) * Y.block(k+1, 0, remainingCols, i+1).adjoint();
+    rowK.noalias() -= X.row(k).head(i) * W_k.conjugate();
+
+    // construct the right Householder vector and set its leading coefficient to 1
+    rowK = rowK.conjugate();
+    rowK.makeHouseholderInPlace(tau, m_bidiagonal.template diagonal<1>().coeffRef(k));
+    tau = internal::conj(tau);
+    tauRight.coeffRef(i) = tau;
+    m_householder.coeffRef(k,k+1) = Scalar(1);
+
+    // X(k+1:,i) = tau (A - U Y^* - X W^*) w
+    Index rr = remainingRows - 1;
+    Block<Matrix<Scalar,Dynamic,Dynamic>,Dynamic,1> x(X, k+1, i, rr, 1);
+    x.noalias() = m_householder.block(k+1, k+1, rr, remainingCols) * rowK.transpose();
+    tmp.head(i+1).noalias() = Y.block(k+1, 0, remainingCols, i+1).adjoint() * rowK.transpose();
+    x.noalias() -= m_householder.block(k+1, k0, rr, i+1) * tmp.head(i+1);
+    tmp.head(i).noalias() = W_k.conjugate() * rowK.transpose();
+    x.noalias() -= X.block(k+1, 0, rr, i) * tmp.head(i);
+    x *= tau;
+  }
+
+  // update the trailing matrix: A22 -= U Y^* + X W^*
+  Index k1 = k0 + bs;
+  Block<MatrixType,Dynamic,Dynamic> A22(m_householder, k1, k1, rows-k1, cols-k1);
+  A22.noalias() -= m_householder.block(k1, k0, rows-k1, bs) * Y.block(k1, 0, cols-k1, bs).adjoint();
+  A22.noalias() -= X.block(k1, 0, rows-k1, bs) * m_householder.block(k0, k1, bs, cols-k1).conjugate();
+
+  for(Index i = 0; i < bs; ++i)
+  {
+    m_householder.coeffRef(k0+i, k0+i) = tauLeft.coeff(i);
+    m_householder.coeffRef(k0+i, k0+i+1) = tauRight.coeff(i);
+  }
+}
+
 #if 0
 /** \return the Householder QR decomposition of \c *this.
   *
@@ -245,6 +245,7 @@ class SparseInnerVectorSet<SparseMatrix<_Scalar, _Options, _Index>, Size>
       _NestedMatrixType& matrix = const_cast<_NestedMatrixType&>(m_matrix);;
       // This assignement is slow if this vector set not empty
       // and/or it is not at the end of the nonzeros of the underlying matrix.
+      matrix.makeCompressed();
 
       // 1 - eval to a temporary to avoid transposition and/or aliasing issues
       SparseMatrix<Scalar, IsRowMajor ? RowMajor : ColMajor, Index> tmp(other);
@@ -334,6 +335,8 @@ class SparseInnerVectorSet<SparseMatrix<_Scalar, _Options, _Index>, Size>
 
     Index nonZeros() const
     {
+      if(!m_matrix.isCompressed())
+        return Eigen::Map<const Matrix<Index,Dynamic,1> >(m_matrix._innerNonZeroPtr()+m_outerStart, m_outerSize.value()).sum();
       return  std::size_t(m_matrix._outerIndexPtr()[m_outerStart+m_outerSize.value()])
             - std::size_t(m_matrix._outerIndexPtr()[m_outerStart]);
     }
@@ -342,7 +345,7 @@ class SparseInnerVectorSet<SparseMatrix<_Scalar, _Options, _Index>, Size>
     {
       EIGEN_STATIC_ASSERT_VECTOR_ONLY(SparseInnerVectorSet);
       eigen_assert(nonZeros()>0);
-      return m_matrix._valuePtr()[m_matrix._outerIndexPtr()[m_outerStart+1]-1];
+      return m_matrix._valuePtr()[m_matrix._outerIndexPtr()[m_outerStart] + m_matrix.innerNonZeros(m_outerStart) - 1];
     }
 
 //     template<typename Sparse>
@@ -141,6 +141,408 @@ class SparseDenseOuterProduct<Lhs,Rhs,Transpose>::InnerIterator : public _LhsNes
     Scalar m_factor;
 };
 
+namespace internal {
+
+/* ret tells whether T exposes the compressed arrays, and run() whether a given object is actually in
+ * compressed mode */
+template<typename T> struct is_compressed_sparse_matrix
+{
+  enum { ret = false };
+  static bool run(const T&) { return false; }
+};
+template<typename Scalar, int Options, typename Index>
+struct is_compressed_sparse_matrix<SparseMatrix<Scalar,Options,Index> >
+{
+  enum { ret = true };
+  static bool run(const SparseMatrix<Scalar,Options,Index>& mat) { return mat.isCompressed(); }
+};
+template<typename Scalar, int Options, typename Index>
+struct is_compressed_sparse_matrix<MappedSparseMatrix<Scalar,Options,Index> >
+{
+  enum { ret = true };
+  static bool run(const MappedSparseMatrix<Scalar,Options,Index>&) { return true; }
+};
+
+/* Kernels of the product of a compressed sparse matrix by a dense vector or matrix, working directly on
+ * the compressed arrays. They are used when the scalar types of the operands are the same, and run on
+ * several threads through parallelize_gemv:
+ *  - row-major (CSR) times vector: the rows are split such that each thread gets about the same number
+ *    of nonzeros, and each thread computes its own slice of the result,
+ *  - column-major (CSC) times vector: each column updates arbitrary rows of the result, so the columns
+ *    are split by nonzeros and every thread accumulates into a private result over the range of rows
+ *    touched by its columns. The private results are summed up at the end,
+ *  - times a matrix: the columns of the dense matrices are processed by panels of one or four packets.
+ *    The rows of a panel of the right hand side are gathered into a contiguous aligned buffer, so that
+ *    each nonzero a_ij updates a row of the panel of the result with a few pmadd:
+ *      - CSR: the whole right hand side is gathered once, then the rows of the result are split by
+ *        nonzeros over the threads, and each row of a panel is accumulated in registers,
+ *      - CSC: the columns of the right hand side are split over the threads, and each thread gathers its
+ *        panels and accumulates them into a private row-major panel of the result.
+ * run() returns false when the generic product has to be used, and the kernels are skipped for matrices
+ * in uncompressed mode.
+ */
+template<typename Lhs, typename Rhs, typename Dest,
+         bool Enable = is_compressed_sparse_matrix<Lhs>::ret
+                    && is_same<typename Lhs::Scalar, typename Rhs::Scalar>::value
+                    && is_same<typename Lhs::Scalar, typename Dest::Scalar>::value,
+         int LhsStorageOrder = (Lhs::Flags&RowMajorBit) ? RowMajor : ColMajor,
+         bool RhsIsVector = Rhs::ColsAtCompileTime==1>
+struct sparse_time_dense_product_kernel
+{
+  template<typename Alpha>
+  static bool run(const Lhs&, const Rhs&, Dest&, const Alpha&) { return false; }
+};
+
+template<typename Lhs, typename Rhs, typename Dest>
+struct sparse_time_dense_product_kernel<Lhs,Rhs,Dest,true,RowMajor,true>
+{
+  typedef typename Lhs::Index Index;
+  typedef typename Dest::Scalar Scalar;
+
+  sparse_time_dense_product_kernel(const Lhs& lhs, const Rhs& rhs, Dest& dest, const Scalar& alpha)
+    : m_lhs(lhs), m_rhs(rhs), m_dest(dest), m_alpha(alpha)
+  {}
+
+  Index cost(Index i) const { return m_lhs._outerIndexPtr()[i+1] - m_lhs._outerIndexPtr()[i] + 1; }
+  void initParallelSession(Index) const {}
+
+  void operator()(Index start, Index end, Index) const
+  {
+    const Index* outer = m_lhs._outerIndexPtr();
+    const Index* inner = m_lhs._innerIndexPtr();
+    const Scalar* values = m_lhs._valuePtr();
+    for(Index i=start; i<end; ++i)
+    {
+      // two accumulators to break the dependency chain of the additions
+      Scalar tmp0(0), tmp1(0);
+      Index p = outer[i];
+      for(; p+1<outer[i+1]; p+=2)
+      {
+        tmp0 += values[p]   * m_rhs.coeff(inner[p]);
+        tmp1 += values[p+1] * m_rhs.coeff(inner[p+1]);
+      }
+      if(p<outer[i+1])
+        tmp0 += values[p] * m_rhs.coeff(inner[p]);
+      m_dest.coeffRef(i) += m_alpha * (tmp0 + tmp1);
+    }
+  }
+
+  template<typename Alpha>
+  static bool run(const Lhs& lhs, const Rhs& rhs, Dest& dest, const Alpha& alpha)
+  {
+    sparse_time_dense_product_kernel func(lhs, rhs, dest, Scalar(alpha));
+    if(!parallelize_gemv(func, lhs.outerSize()))
+      func(0, lhs.outerSize(), 0);
+    return true;
+  }
+
+  const Lhs& m_lhs;
+  const Rhs& m_rhs;
+  Dest& m_dest;
+  Scalar m_alpha;
+};
+
+template<typename Lhs, typename Rhs, typename Dest>
+struct sparse_time_dense_product_kernel<Lhs,Rhs,Dest,true,ColMajor,true>
+{
+  typedef typename Lhs::Index Index;
+  typedef typename Dest::Scalar Scalar;
+
+  sparse_time_dense_product_kernel(const Lhs& lhs, const Rhs& rhs, const Scalar& alpha)
+    : m_lhs(lhs), m_rhs(rhs), m_alpha(alpha), m_threads(0), m_results(0), m_ranges(0)
+  {}
+
+  ~sparse_time_dense_product_kernel()
+  {
+    aligned_delete(m_results, m_lhs.rows()*m_threads);
+    delete[] m_ranges;
+  }
+
+  Index cost(Index j) const { return m_lhs._outerIndexPtr()[j+1] - m_lhs._outerIndexPtr()[j] + 1; }
+
+  void initParallelSession(Index threads)
+  {
+    m_threads = threads;
+    m_results = aligned_new<Scalar>(m_lhs.rows()*m_threads);
+    m_ranges = new Index[2*m_threads];
+  }
+
+  template<typename Res>
+  void product(Index start, Index end, Res& res) const
+  {
+    const Index* outer = m_lhs._outerIndexPtr();
+    const Index* inner = m_lhs._innerIndexPtr();
+    const Scalar* values = m_lhs._valuePtr();
+    for(Index j=start; j<end; ++j)
+    {
+      Scalar rhs_j = m_alpha * m_rhs.coeff(j);
+      for(Index p=outer[j]; p<outer[j+1]; ++p)
+        res.coeffRef(inner[p]) += values[p] * rhs_j;
+    }
+  }
+
+  void operator()(Index start, Index end, Index tid)
+  {
+    const Index* outer = m_lhs._outerIndexPtr();
+    const Index* inner = m_lhs._innerIndexPtr();
+
+    // the inner indices are sorted, so the rows touched by the columns [start,end) are known upfront
+    Index first = m_lhs.rows(), last = 0;
+    for(Index j=start; j<end; ++j)
+      if(outer[j+1]>outer[j])
+      {
+        first = (std::min)(first, inner[outer[j]]);
+        last = (std::max)(last, inner[outer[j+1]-1]+1);
+      }
+    if(first>=last)
+      first = last = 0;
+
+    Map<Matrix<Scalar,Dynamic,1> > res(m_results + tid*m_lhs.rows(), m_lhs.rows());
+    res.segment(first, last-first).setZero();
+    product(start, end, res);
+    m_ranges[2*tid] = first;
+    m_ranges[2*tid+1] = last;
+  }
+
+  template<typename Alpha>
+  static bool run(const Lhs& lhs, const Rhs& rhs, Dest& dest, const Alpha& alpha)
+  {
+    sparse_time_dense_product_kernel func(lhs, rhs, Scalar(alpha));
+    if(!parallelize_gemv(func, lhs.outerSize()))
+    {
+      func.product(0, lhs.outerSize(), dest);
+      return true;
+    }
+
+    typedef Map<Matrix<Scalar,Dynamic,1> > MappedRes;
+    for(Index t=0; t<func.m_threads; ++t)
+    {
+      Index first = func.m_ranges[2*t];
+      Index last = func.m_ranges[2*t+1];
+      dest.segment(first, last-first) += MappedRes(func.m_results + t*lhs.rows(), lhs.rows()).segment(first, last-first);
+    }
+    return true;
+  }
+
+  const Lhs& m_lhs;
+  const Rhs& m_rhs;
+  Scalar m_alpha;
+  Index m_threads;
+  Scalar* m_results;
+  Index* m_ranges;
+};
+
+/* Panels of the sparse times dense matrix kernels: a panel of PacketCount packets of Width columns of a
+ * dense matrix, whose rows are stored contiguously. */
+template<typename Scalar, int PacketCount>
+struct sparse_dense_panel
+{
+  typedef typename packet_traits<Scalar>::type Packet;
+  enum {
+    PacketSize = packet_traits<Scalar>::size,
+    Width = PacketCount * PacketSize
+  };
+
+  /* Gathers the columns [col,col+width) of src into the panel dst, the missing columns of the last panel
+   * are set to zero */
+  template<typename Index, typename Src>
+  static void pack(Scalar* dst, const Src& src, Index col, Index width)
+  {
+    const Index rows = src.rows();
+    for(Index j=0; j<rows; ++j, dst+=Width)
+    {
+      for(Index c=0; c<width; ++c)
+        dst[c] = src.coeff(j, col+c);
+      for(Index c=width; c<Index(Width); ++c)
+        dst[c] = Scalar(0);
+    }
+  }
+
+  /* res[0:Width) += a * b[0:Width) */
+  static EIGEN_STRONG_INLINE void madd(const Scalar& a, const Scalar* b, Scalar* res)
+  {
+    Packet pa = pset1<Packet>(a);
+    for(int k=0; k<PacketCount; ++k)
+      pstore(res+k*PacketSize, pmadd(pa, pload<Packet>(b+k*PacketSize), pload<Packet>(res+k*PacketSize)));
+  }
+
+  /* returns sum_p values[p] * b[inner[p]*Width:(inner[p]+1)*Width) into res */
+  template<typename Index>
+  static EIGEN_STRONG_INLINE void dot(const Scalar* values, const Index* inner, Index start, Index end,
+                                      const Scalar* b, Scalar* res)
+  {
+    Packet acc[PacketCount];
+    for(int k=0; k<PacketCount; ++k)
+      acc[k] = pset1<Packet>(Scalar(0));
+    for(Index p=start; p<end; ++p)
+    {
+      Packet pa = pset1<Packet>(values[p]);
+      const Scalar* bj = b + inner[p]*Index(Width);
+      for(int k=0; k<PacketCount; ++k)
+        acc[k] = pmadd(pa, pload<Packet>(bj+k*PacketSize), acc[k]);
+    }
+    for(int k=0; k<PacketCount; ++k)
+      pstore(res+k*PacketSize, acc[k]);
+  }
+};
+
+template<typename Lhs, typename Rhs, typename Dest>
+struct sparse_time_dense_product_kernel<Lhs,Rhs,Dest,true,RowMajor,false>
+{
+  typedef typename Lhs::Index Index;
+  typedef typename Dest::Scalar Scalar;
+  typedef sparse_dense_panel<Scalar,4> BigPanel;
+  typedef sparse_dense_panel<Scalar,1> SmallPanel;
+
+  sparse_time_dense_product_kernel(const Lhs& lhs, const Scalar* packed, Dest& dest, const Scalar& alpha)
+    : m_lhs(lhs), m_packed(packed), m_dest(dest), m_alpha(alpha)
+  {}
+
+  Index cost(Index i) const
+  {
+    return (m_lhs._outerIndexPtr()[i+1] - m_lhs._outerIndexPtr()[i] + 1) * m_dest.cols();
+  }
+  void initParallelSession(Index) const {}
+
+  template<typename Panel>
+  void panel(Index start, Index end, Index col, Index width) const
+  {
+    const Index* outer = m_lhs._outerIndexPtr();
+    const Index* inner = m_lhs._innerIndexPtr();
+    const Scalar* values = m_lhs._valuePtr();
+    const Scalar* b = m_packed + col*m_lhs.cols();
+    EIGEN_ALIGN16 Scalar res[Panel::Width];
+    for(Index i=start; i<end; ++i)
+    {
+      Panel::dot(values, inner, outer[i], outer[i+1], b, res);
+      for(Index c=0; c<width; ++c)
+        m_dest.coeffRef(i, col+c) += m_alpha * res[c];
+    }
+  }
+
+  void operator()(Index start, Index end, Index) const
+  {
+    const Index cols = m_dest.cols();
+    Index col = 0;
+    for(; col+Index(BigPanel::Width)<=cols; col+=BigPanel::Width)
+      panel<BigPanel>(start, end, col, BigPanel::Width);
+    for(; col<cols; col+=SmallPanel::Width)
+      panel<SmallPanel>(start, end, col, (std::min)(Index(SmallPanel::Width), cols-col));
+  }
+
+  template<typename Alpha>
+  static bool run(const Lhs& lhs, const Rhs& rhs, Dest& dest, const Alpha& alpha)
+  {
+    // gather the panels of the right hand side, the panel starting at column c is stored at c*rows
+    const Index rows = rhs.rows(), cols = rhs.cols();
+    const Index packedCols = (cols + SmallPanel::Width - 1) / SmallPanel::Width * SmallPanel::Width;
+    Scalar* packed = aligned_new<Scalar>(rows*packedCols);
+    Index col = 0;
+    for(; col+Index(BigPanel::Width)<=cols; col+=BigPanel::Width)
+      BigPanel::pack(packed + col*rows, rhs, col, Index(BigPanel::Width));
+    for(; col<cols; col+=SmallPanel::Width)
+      SmallPanel::pack(packed + col*rows, rhs, col, (std::min)(Index(SmallPanel::Width), cols-col));
+
+    sparse_time_dense_product_kernel func(lhs, packed, dest, Scalar(alpha));
+    if(!parallelize_gemv(func, lhs.outerSize()))
+      func(0, lhs.outerSize(), 0);
+    aligned_delete(packed, rows*packedCols);
+    return true;
+  }
+
+  const Lhs& m_lhs;
+  const Scalar* m_packed;
+  Dest& m_dest;
+  Scalar m_alpha;
+};
+
+template<typename Lhs, typename Rhs, typename Dest>
+struct sparse_time_dense_product_kernel<Lhs,Rhs,Dest,true,ColMajor,false>
+{
+  typedef typename Lhs::Index Index;
+  typedef typename Dest::Scalar Scalar;
+  typedef sparse_dense_panel<Scalar,4> BigPanel;
+  typedef sparse_dense_panel<Scalar,1> SmallPanel;
+
+  sparse_time_dense_product_kernel(const Lhs& lhs, const Rhs& rhs, Dest& dest, const Scalar& alpha)
+    : m_lhs(lhs), m_rhs(rhs), m_dest(dest), m_alpha(alpha), m_threads(0), m_buffers(0)
+  {}
+
+  ~sparse_time_dense_product_kernel()
+  {
+    aligned_delete(m_buffers, bufferSize()*m_threads);
+  }
+
+  // the result panel of a thread, only as wide as the widest panel used
+  Index bufferSize() const
+  {
+    return m_lhs.rows() * (m_rhs.cols()>=Index(BigPanel::Width) ? Index(BigPanel::Width) : Index(SmallPanel::Width));
+  }
+
+  Index cost(Index) const { return m_lhs.nonZeros() + m_lhs.cols(); }
+
+  void initParallelSession(Index threads)
+  {
+    m_threads = threads;
+    m_buffers = aligned_new<Scalar>(bufferSize()*m_threads);
+  }
+
+  template<typename Panel>
+  void panel(Index col, Index width, Scalar* res) const
+  {
+    const Index* outer = m_lhs._outerIndexPtr();
+    const Index* inner = m_lhs._innerIndexPtr();
+    const Scalar* values = m_lhs._valuePtr();
+    const Index rows = m_lhs.rows(), cols = m_lhs.cols();
+
+    // each row of the rhs panel is read once, so it is gathered on the fly rather than packed
+    EIGEN_ALIGN16 Scalar b[Panel::Width];
+    std::fill(b, b + Index(Panel::Width), Scalar(0));
+    std::fill(res, res + rows*Index(Panel::Width), Scalar(0));
+    for(Index j=0; j<cols; ++j)
+    {
+      for(Index c=0; c<width; ++c)
+        b[c] = m_rhs.coeff(j, col+c);
+      for(Index p=outer[j]; p<outer[j+1]; ++p)
+        Panel::madd(values[p], b, res + inner[p]*Index(Panel::Width));
+    }
+    for(Index i=0; i<rows; ++i)
+      for(Index c=0; c<width; ++c)
+        m_dest.coeffRef(i, col+c) += m_alpha * res[i*Index(Panel::Width)+c];
+  }
+
+  void operator()(Index start, Index end, Index tid) const
+  {
+    Scalar* buffer = m_buffers + tid*bufferSize();
+    Index col = start;
+    for(; col+Index(BigPanel::Width)<=end; col+=BigPanel::Width)
+      panel<BigPanel>(col, BigPanel::Width, buffer);
+    for(; col<end; col+=SmallPanel::Width)
+      panel<SmallPanel>(col, (std::min)(Index(SmallPanel::Width), end-col), buffer);
+  }
+
+  template<typename Alpha>
+  static bool run(const Lhs& lhs, const Rhs& rhs, Dest& dest, const Alpha& alpha)
+  {
+    sparse_time_dense_product_kernel func(lhs, rhs, dest, Scalar(alpha));
+    if(!parallelize_gemv(func, rhs.cols()))
+    {
+      func.initParallelSession(1);
+      func(0, rhs.cols(), 0);
+    }
+    return true;
+  }
+
+  const Lhs& m_lhs;
+  const Rhs& m_rhs;
+  Dest& m_dest;
+  Scalar m_alpha;
+  Index m_threads;
+  Scalar* m_buffers;
+};
+
+} // end namespace internal
+
 namespace internal {
 template<typename Lhs, typename Rhs>
 struct traits<SparseTimeDenseProduct<Lhs,Rhs> >
@@ -167,6 +569,9 @@ class SparseTimeDenseProduct
       typedef typename internal::remove_all<Rhs>::type _Rhs;
       typedef typename _Lhs::InnerIterator LhsInnerIterator;
       enum { LhsIsRowMajor = (_Lhs::Flags&RowMajorBit)==RowMajorBit };
+      if(internal::is_compressed_sparse_matrix<_LhsNested>::run(m_lhs)
+         && internal::sparse_time_dense_product_kernel<_LhsNested,_RhsNested,Dest>::run(m_lhs, m_rhs, dest, alpha))
+        return;
       for(Index j=0; j<m_lhs.outerSize(); ++j)
       {
         typename Rhs::Scalar rhs_j = alpha * m_rhs.coeff(LhsIsRowMajor ? 0 : j,0);
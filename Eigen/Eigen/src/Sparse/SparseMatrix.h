@@ -34,6 +34,11 @@
   * This class implements a sparse matrix using the very common compressed row/column storage
   * scheme.
   *
+  * The matrix can also be in an uncompressed mode, where each inner vector may have some free
+  * room after its non zeros. This mode is entered by reserving room per inner vector with
+  * reserve(const SizesType&), it makes random insertions with insert() cheap, and it is left with
+  * makeCompressed(). Matrices are most efficiently built from a list of triplets with setFromTriplets().
+  *
   * \tparam _Scalar the scalar type, i.e. the type of the coefficients
   * \tparam _Options Union of bit flags controlling the storage scheme. Currently the only possibility
   *                 is RowMajor. The default is 0 which means column-major.
@@ -93,6 +98,7 @@ class SparseMatrix
     Index m_outerSize;
     Index m_innerSize;
     Index* m_outerIndex;
+    Index* m_innerNonZeros;     // optional, if null then the data is compressed
     CompressedStorage<Scalar,Index> m_data;
 
   public:
@@ -102,7 +108,12 @@ class SparseMatrix
 
     inline Index innerSize() const { return m_innerSize; }
     inline Index outerSize() const { return m_outerSize; }
-    inline Index innerNonZeros(Index j) const { return m_outerIndex[j+1]-m_outerIndex[j]; }
+    inline Index innerNonZeros(Index j) const
+    { return m_innerNonZeros ? m_innerNonZeros[j] : m_outerIndex[j+1]-m_outerIndex[j]; }
+
+    /** \returns whether \c *this is in compressed form, i.e., without free room between its inner vectors
+      * \sa makeCompressed(), reserve(const SizesType&) */
+    inline bool isCompressed() const { return m_innerNonZeros==0; }
 
     inline const Scalar* _valuePtr() const { return &m_data.value(0); }
     inline Scalar* _valuePtr() { return &m_data.value(0); }
@@ -113,6 +124,11 @@ class SparseMatrix
     inline const Index* _outerIndexPtr() const { return m_outerIndex; }
     inline Index* _outerIndexPtr() { return m_outerIndex; }
 
+    /** \returns the number of non zeros of each inner vector in uncompressed mode, and a null pointer
+      * in compressed mode */
+    inline const Index* _innerNonZeroPtr() const { return m_innerNonZeros; }
+    inline Index* _innerNonZeroPtr() { return m_innerNonZeros; }
+
     inline Storage& data() { return m_data; }
     inline const Storage& data() const { return m_data; }
 
@@ -120,7 +136,8 @@ class SparseMatrix
     {
       const Index outer = IsRowMajor ? row : col;
       const Index inner = IsRowMajor ? col : row;
-      return m_data.atInRange(m_outerIndex[outer], m_outerIndex[outer+1], inner);
+      Index end = m_innerNonZeros ? m_outerIndex[outer] + m_innerNonZeros[outer] : m_outerIndex[outer+1];
+      return m_data.atInRange(m_outerIndex[outer], end, inner);
     }
 
     inline Scalar& coeffRef(Index row, Index col)
@@ -129,7 +146,7 @@ class SparseMatrix
       const Index inner = IsRowMajor ? col : row;
 
       Index start = m_outerIndex[outer];
-      Index end = m_outerIndex[outer+1];
+      Index end = m_innerNonZeros ? m_outerIndex[outer] + m_innerNonZeros[outer] : m_outerIndex[outer+1];
       eigen_assert(end>=start && "you probably called coeffRef on a non finalized matrix");
       eigen_assert(end>start && "coeffRef cannot be called on a zero coefficient");
       const Index p = m_data.searchLowerIndex(start,end-1,inner);
@@ -146,17 +163,47 @@ class SparseMatrix
     {
       m_data.clear();
       memset(m_outerIndex, 0, (m_outerSize+1)*sizeof(Index));
+      if(m_innerNonZeros)
+        memset(m_innerNonZeros, 0, m_outerSize*sizeof(Index));
     }
 
     /** \returns the number of non zero coefficients */
-    inline Index nonZeros() const  { return static_cast<Index>(m_data.size()); }
+    inline Index nonZeros() const
+    {
+      if(m_innerNonZeros)
+        return Eigen::Map<const Matrix<Index,Dynamic,1> >(m_innerNonZeros, m_outerSize).sum();
+      return static_cast<Index>(m_data.size());
+    }
 
-    /** Preallocates \a reserveSize non zeros */
+    /** Preallocates \a reserveSize non zeros
+      *
+      * This function only makes sense in compressed mode. */
     inline void reserve(Index reserveSize)
     {
+      eigen_assert(isCompressed() && "This function does not make sense in non compressed mode.");
       m_data.reserve(reserveSize);
     }
 
+    #ifdef EIGEN_PARSED_BY_DOXYGEN
+    /** Preallocates \a reserveSizes[\c j] non zeros for each inner vector \c j, and turns the matrix
+      * into uncompressed mode.
+      *
+      * The non zeros already present are kept, and the room already free in an inner vector is never
+      * reduced. Once enough room is reserved, insert() runs in amortized constant time whatever the
+      * insertion order.
+      *
+      * \sa insert(), makeCompressed() */
+    template<class SizesType>
+    inline void reserve(const SizesType& reserveSizes);
+    #else
+    template<class SizesType>
+    inline void reserve(const SizesType& reserveSizes, const typename SizesType::value_type& enableif = typename SizesType::value_type())
+    {
+      EIGEN_UNUSED_VARIABLE(enableif);
+      reserveInnerVectors(reserveSizes);
+    }
+    #endif
+
     //--- low level purely coherent filling ---
 
     /** \returns a reference to the non zero coefficient at position \a row, \a col assuming that:
@@ -196,6 +243,7 @@ class SparseMatrix
     /** \sa insertBack, insertBackByOuterInner */
     inline void startVec(Index outer)
     {
+      eigen_assert(isCompressed() && "The low level ordered filling API requires a compressed matrix");
       eigen_assert(m_outerIndex[outer]==int(m_data.size()) && "You must call startVec for each inner vector sequentially");
       eigen_assert(m_outerIndex[outer+1]==0 && "You must call startVec for each inner vector sequentially");
       m_outerIndex[outer+1] = m_outerIndex[outer];
@@ -206,12 +254,26 @@ class SparseMatrix
     /** \returns a reference to a novel non zero coefficient with coordinates \a row x \a col.
       * The non zero coefficient must \b not already exist.
       *
-      * \warning This function can be extremely slow if the non zero coefficients
+      * In uncompressed mode, the coefficient is inserted in the free room of its inner vector, in
+      * amortized constant time if enough room has been reserved with reserve(const SizesType&).
+      *
+      * \warning In compressed mode, this function can be extremely slow if the non zero coefficients
       * are not inserted in a coherent order.
       *
-      * After an insertion session, you should call the finalize() function.
+      * After an insertion session, you should call the finalize() function in compressed mode,
+      * or makeCompressed() in uncompressed mode.
       */
-    EIGEN_DONT_INLINE Scalar& insert(Index row, Index col)
+    Scalar& insert(Index row, Index col)
+    {
+      if(isCompressed())
+        return insertCompressed(row,col);
+      else
+        return insertUncompressed(row,col);
+    }
+
+  protected:
+
+    EIGEN_DONT_INLINE Scalar& insertCompressed(Index row, Index col)
     {
       const Index outer = IsRowMajor ? row : col;
       const Index inner = IsRowMajor ? col : row;
@@ -315,13 +377,195 @@ class SparseMatrix
       return (m_data.value(p) = 0);
     }
 
+    EIGEN_DONT_INLINE Scalar& insertUncompressed(Index row, Index col)
+    {
+      const Index outer = IsRowMajor ? row : col;
+      const Index inner = IsRowMajor ? col : row;
 
+      Index room = m_outerIndex[outer+1] - m_outerIndex[outer];
+      Index innerNNZ = m_innerNonZeros[outer];
+      if(innerNNZ>=room)
+      {
+        // this inner vector is full and the whole buffer has to be reallocated. As for a dynamic array,
+        // the room of all the inner vectors is doubled at once, so that for typical insertion patterns
+        // the buffer is only reallocated a few times
+        Matrix<Index,Dynamic,1> reserveSizes(m_outerSize);
+        for(Index j=0; j<m_outerSize; ++j)
+          reserveSizes[j] = (std::max)(Index(2), m_innerNonZeros[j]);
+        reserveInnerVectors(reserveSizes);
+      }
 
+      Index startId = m_outerIndex[outer];
+      Index p = startId + m_innerNonZeros[outer];
+      while ( (p > startId) && (m_data.index(p-1) > inner) )
+      {
+        m_data.index(p) = m_data.index(p-1);
+        m_data.value(p) = m_data.value(p-1);
+        --p;
+      }
+      eigen_assert((p<=startId || m_data.index(p-1)!=inner) && "you cannot insert an element that already exists, you must call coeffRef to this end");
+
+      m_innerNonZeros[outer]++;
+      m_data.index(p) = inner;
+      return (m_data.value(p) = 0);
+    }
+
+    /* Gives each inner vector j at least reserveSizes[j] free entries, the free room is never reduced */
+    template<class SizesType>
+    void reserveInnerVectors(const SizesType& reserveSizes)
+    {
+      Index* newOuterIndex = new Index[m_outerSize+1];
+      Index count = 0;
+      for(Index j=0; j<m_outerSize; ++j)
+      {
+        newOuterIndex[j] = count;
+        Index innerNNZ = innerNonZeros(j);
+        Index freeRoom = m_outerIndex[j+1] - m_outerIndex[j] - innerNNZ;
+        count += innerNNZ + (std::max)(Index(reserveSizes[j]), freeRoom);
+      }
+      newOuterIndex[m_outerSize] = count;
+
+      if(isCompressed())
+      {
+        m_innerNonZeros = new Index[m_outerSize];
+        for(Index j=0; j<m_outerSize; ++j)
+          m_innerNonZeros[j] = m_outerIndex[j+1] - m_outerIndex[j];
+      }
+
+      // the inner vectors only move forward, so they are moved from the last one
+      m_data.resize(count);
+      for(Index j=m_outerSize-1; j>=0; --j)
+      {
+        if(newOuterIndex[j]==m_outerIndex[j])
+          continue;
+        for(Index i=m_innerNonZeros[j]-1; i>=0; --i)
+        {
+          m_data.index(newOuterIndex[j]+i) = m_data.index(m_outerIndex[j]+i);
+          m_data.value(newOuterIndex[j]+i) = m_data.value(m_outerIndex[j]+i);
+        }
+      }
+      std::swap(m_outerIndex, newOuterIndex);
+      delete[] newOuterIndex;
+    }
 
-    /** Must be called after inserting a set of non zero entries.
+  public:
+
+    /** Turns the matrix into compressed mode, removing the free room between the inner vectors.
+      *
+      * \sa isCompressed(), reserve(const SizesType&) */
+    void makeCompressed()
+    {
+      if(isCompressed())
+        return;
+
+      Index oldStart = m_outerIndex[1];
+      m_outerIndex[1] = m_innerNonZeros[0];
+      for(Index j=1; j<m_outerSize; ++j)
+      {
+        Index nextOldStart = m_outerIndex[j+1];
+        if(oldStart>m_outerIndex[j])
+        {
+          for(Index k=0; k<m_innerNonZeros[j]; ++k)
+          {
+            m_data.index(m_outerIndex[j]+k) = m_data.index(oldStart+k);
+            m_data.value(m_outerIndex[j]+k) = m_data.value(oldStart+k);
+          }
+        }
+        m_outerIndex[j+1] = m_outerIndex[j] + m_innerNonZeros[j];
+        oldStart = nextOldStart;
+      }
+      delete[] m_innerNonZeros;
+      m_innerNonZeros = 0;
+      m_data.resize(m_outerIndex[m_outerSize]);
+      m_data.squeeze();
+    }
+
+    /** Fills \c *this with the list of triplets defined by the iterator range \a begin - \a end,
+      * the coefficients of the triplets sharing the same coordinates are summed up.
+      *
+      * The value type of \a InputIterator must provide the \c row(), \c col() and \c value() functions,
+      * such as the Triplet class. The range is traversed twice, and the matrix is built by two counting
+      * sorts in O(n + rows + cols) operations, where n is the number of triplets:
+      * \code
+      * std::vector<Triplet<double> > triplets;
+      * triplets.reserve(estimation_of_entries);
+      * for(...)
+      *   triplets.push_back(Triplet<double>(i,j,v_ij));
+      * SparseMatrix<double> mat(rows,cols);
+      * mat.setFromTriplets(triplets.begin(), triplets.end());
+      * \endcode
+      *
+      * The previous coefficients of \c *this are discarded, and the result is compressed.
+      */
+    template<typename InputIterator>
+    void setFromTriplets(const InputIterator& begin, const InputIterator& end)
+    {
+      const Index outerSize = m_outerSize, innerSize = m_innerSize;
+      resize(rows(), cols());
+
+      // 1 - counting sort by inner index, the outer indices are kept in the order of the triplets
+      Matrix<Index,Dynamic,1> innerStart = Matrix<Index,Dynamic,1>::Zero(innerSize+1);
+      Index count = 0;
+      for(InputIterator it(begin); it!=end; ++it, ++count)
+      {
+        eigen_assert(it->row()>=0 && it->row()<rows() && it->col()>=0 && it->col()<cols());
+        ++innerStart[(IsRowMajor ? it->col() : it->row()) + 1];
+        ++m_outerIndex[(IsRowMajor ? it->row() : it->col()) + 1];
+      }
+      for(Index i=0; i<innerSize; ++i)
+        innerStart[i+1] += innerStart[i];
+      CompressedStorage<Scalar,Index> byInner(count);
+      for(InputIterator it(begin); it!=end; ++it)
+      {
+        Index p = innerStart[IsRowMajor ? it->col() : it->row()]++;
+        byInner.index(p) = IsRowMajor ? it->row() : it->col();
+        byInner.value(p) = it->value();
+      }
+
+      // 2 - stable counting sort by outer index, the inner indices come out sorted
+      for(Index j=0; j<outerSize; ++j)
+        m_outerIndex[j+1] += m_outerIndex[j];
+      Matrix<Index,Dynamic,1> positions = Eigen::Map<Matrix<Index,Dynamic,1> >(m_outerIndex, outerSize);
+      m_data.resize(count);
+      for(Index i=0, p=0; i<innerSize; ++i)
+      {
+        for(; p<innerStart[i]; ++p)
+        {
+          Index q = positions[byInner.index(p)]++;
+          m_data.index(q) = i;
+          m_data.value(q) = byInner.value(p);
+        }
+      }
+
+      // 3 - sum up the duplicates, which are now contiguous
+      Index k = 0;
+      for(Index j=0; j<outerSize; ++j)
+      {
+        Index vecStart = m_outerIndex[j], vecEnd = m_outerIndex[j+1];
+        m_outerIndex[j] = k;
+        for(Index p=vecStart; p<vecEnd; ++p)
+        {
+          if(k>m_outerIndex[j] && m_data.index(k-1)==m_data.index(p))
+            m_data.value(k-1) += m_data.value(p);
+          else
+          {
+            m_data.index(k) = m_data.index(p);
+            m_data.value(k) = m_data.value(p);
+            ++k;
+          }
+        }
+      }
+      m_outerIndex[outerSize] = k;
+      m_data.resize(k);
+    }
+
+    /** Must be called after inserting a set of non zero entries in compressed mode.
+      * It has no effect in uncompressed mode, see makeCompressed().
       */
     inline void finalize()
     {
+      if(!isCompressed())
+        return;
       Index size = static_cast<Index>(m_data.size());
       Index i = m_outerSize;
       // find the last filled column
@@ -356,7 +600,7 @@ class SparseMatrix
       {
         Index previousStart = m_outerIndex[j];
         m_outerIndex[j] = k;
-        Index end = m_outerIndex[j+1];
+        Index end = m_innerNonZeros ? previousStart + m_innerNonZeros[j] : m_outerIndex[j+1];
         for(Index i=previousStart; i<end; ++i)
         {
           if(keep(IsRowMajor?j:m_data.index(i), IsRowMajor?m_data.index(i):j, m_data.value(i)))
@@ -369,6 +613,8 @@ class SparseMatrix
       }
       m_outerIndex[m_outerSize] = k;
       m_data.resize(k,0);
+      delete[] m_innerNonZeros;
+      m_innerNonZeros = 0;
     }
 
     /** Resizes the matrix to a \a rows x \a cols matrix and initializes it to zero
@@ -385,6 +631,8 @@ class SparseMatrix
         m_outerIndex = new Index [outerSize+1];
         m_outerSize = outerSize;
       }
+      delete[] m_innerNonZeros;
+      m_innerNonZeros = 0;
       memset(m_outerIndex, 0, (m_outerSize+1)*sizeof(Index));
     }
 
@@ -392,19 +640,20 @@ class SparseMatrix
       * Resize the nonzero vector to \a size */
     void resizeNonZeros(Index size)
     {
+      eigen_assert(isCompressed());
       m_data.resize(size);
     }
 
     /** Default constructor yielding an empty \c 0 \c x \c 0 matrix */
     inline SparseMatrix()
-      : m_outerSize(-1), m_innerSize(0), m_outerIndex(0)
+      : m_outerSize(-1), m_innerSize(0), m_outerIndex(0), m_innerNonZeros(0)
     {
       resize(0, 0);
     }
 
     /** Constructs a \a rows \c x \a cols empty matrix */
     inline SparseMatrix(Index rows, Index cols)
-      : m_outerSize(0), m_innerSize(0), m_outerIndex(0)
+      : m_outerSize(0), m_innerSize(0), m_outerIndex(0), m_innerNonZeros(0)
     {
       resize(rows, cols);
     }
@@ -412,14 +661,14 @@ class SparseMatrix
     /** Constructs a sparse matrix from the sparse expression \a other */
     template<typename OtherDerived>
     inline SparseMatrix(const SparseMatrixBase<OtherDerived>& other)
-      : m_outerSize(0), m_innerSize(0), m_outerIndex(0)
+      : m_outerSize(0), m_innerSize(0), m_outerIndex(0), m_innerNonZeros(0)
     {
       *this = other.derived();
     }
 
     /** Copy constructor */
     inline SparseMatrix(const SparseMatrix& other)
-      : Base(), m_outerSize(0), m_innerSize(0), m_outerIndex(0)
+      : Base(), m_outerSize(0), m_innerSize(0), m_outerIndex(0), m_innerNonZeros(0)
     {
       *this = other.derived();
     }
@@ -429,6 +678,7 @@ class SparseMatrix
     {
       //EIGEN_DBG_SPARSE(std::cout << "SparseMatrix:: swap\n");
       std::swap(m_outerIndex, other.m_outerIndex);
+      std::swap(m_innerNonZeros, other.m_innerNonZeros);
       std::swap(m_innerSize, other.m_innerSize);
       std::swap(m_outerSize, other.m_outerSize);
       m_data.swap(other.m_data);
@@ -441,12 +691,25 @@ class SparseMatrix
       {
         swap(other.const_cast_derived());
       }
-      else
+      else if(other.isCompressed())
       {
         resize(other.rows(), other.cols());
         memcpy(m_outerIndex, other.m_outerIndex, (m_outerSize+1)*sizeof(Index));
         m_data = other.m_data;
       }
+      else
+      {
+        // the copy of an uncompressed matrix is compressed
+        resize(other.rows(), other.cols());
+        for(Index j=0; j<m_outerSize; ++j)
+          m_outerIndex[j+1] = m_outerIndex[j] + other.m_innerNonZeros[j];
+        m_data.resize(m_outerIndex[m_outerSize]);
+        for(Index j=0; j<m_outerSize; ++j)
+        {
+          memcpy(&m_data.value(m_outerIndex[j]), &other.m_data.value(other.m_outerIndex[j]), other.m_innerNonZeros[j]*sizeof(Scalar));
+          memcpy(&m_data.index(m_outerIndex[j]), &other.m_data.index(other.m_outerIndex[j]), other.m_innerNonZeros[j]*sizeof(Index));
+        }
+      }
       return *this;
     }
 
@@ -544,6 +807,7 @@ class SparseMatrix
     inline ~SparseMatrix()
     {
       delete[] m_outerIndex;
+      delete[] m_innerNonZeros;
     }
 
     /** Overloaded for performance */
@@ -625,7 +889,8 @@ class SparseMatrix<Scalar,_Options,_Index>::InnerIterator
 {
   public:
     InnerIterator(const SparseMatrix& mat, Index outer)
-      : m_values(mat._valuePtr()), m_indices(mat._innerIndexPtr()), m_outer(outer), m_id(mat.m_outerIndex[outer]), m_end(mat.m_outerIndex[outer+1])
+      : m_values(mat._valuePtr()), m_indices(mat._innerIndexPtr()), m_outer(outer), m_id(mat.m_outerIndex[outer]),
+        m_end(mat.m_innerNonZeros ? m_id + mat.m_innerNonZeros[outer] : mat.m_outerIndex[outer+1])
     {}
 
     inline InnerIterator& operator++() { m_id++; return *this; }
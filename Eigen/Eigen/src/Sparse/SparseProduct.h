@@ -106,7 +106,7 @@ class SparseSparseProduct : internal::no_assignment_operator,
 
     template<typename Lhs, typename Rhs>
     EIGEN_STRONG_INLINE SparseSparseProduct(const Lhs& lhs, const Rhs& rhs)
-      : m_lhs(lhs), m_rhs(rhs)
+      : m_lhs(lhs), m_rhs(rhs), m_tolerance(0)
     {
       eigen_assert(lhs.cols() == rhs.rows());
 
@@ -133,9 +133,31 @@ class SparseSparseProduct : internal::no_assignment_operator,
     EIGEN_STRONG_INLINE const _LhsNested& lhs() const { return m_lhs; }
     EIGEN_STRONG_INLINE const _RhsNested& rhs() const { return m_rhs; }
 
+    /** \returns an expression of the product where the coefficients which are much smaller than
+      * \a reference, up to the relative tolerance \a epsilon, are not stored. With the default
+      * arguments, only the exact zeros are dropped, as in the plain product.
+      *
+      * The pruning is done while each column of the result is computed, so that the full product
+      * is never stored:
+      * \code
+      * C = (A*B).pruned(1, 1e-12);
+      * \endcode
+      * \sa SparseMatrix::prune() */
+    const SparseSparseProduct pruned(const Scalar& reference = 0,
+                                     const RealScalar& epsilon = NumTraits<RealScalar>::dummy_precision()) const
+    {
+      SparseSparseProduct res(*this);
+      res.m_tolerance = internal::abs(reference) * epsilon;
+      return res;
+    }
+
+    /** \returns the magnitude up to which the coefficients of the product are dropped */
+    EIGEN_STRONG_INLINE RealScalar tolerance() const { return m_tolerance; }
+
   protected:
     LhsNested m_lhs;
     RhsNested m_rhs;
+    RealScalar m_tolerance;
 };
 
 #endif // EIGEN_SPARSEPRODUCT_H
@@ -110,61 +110,243 @@ static void sparse_product_impl2(const Lhs& lhs, const Rhs& rhs, ResultType& res
   res.finalize();
 }
 
-// perform a pseudo in-place sparse * sparse product assuming all matrices are col major
+/* Two-phase product of sparse matrices, assuming all matrices are col major (the callers fake the
+ * storage order to handle the other cases):
+ *  1 - the symbolic phase computes the exact number of nonzeros of each column of the result with a
+ *      marker per row, so that the result is allocated once,
+ *  2 - the numeric phase computes each column into a dense accumulator, gathers its row indices, sorts
+ *      them, and writes the column in place.
+ * Both phases process the columns independently and are split over the threads by number of flops.
+ * The coefficients whose magnitude is not larger than the tolerance, at least the exact zeros, are
+ * dropped by the numeric phase, and the columns are compacted at the end.
+ */
 template<typename Lhs, typename Rhs, typename ResultType>
-static void sparse_product_impl(const Lhs& lhs, const Rhs& rhs, ResultType& res)
+struct sparse_sparse_product_kernel
 {
-//   return sparse_product_impl2(lhs,rhs,res);
-
   typedef typename remove_all<Lhs>::type::Scalar Scalar;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
   typedef typename remove_all<Lhs>::type::Index Index;
 
+  sparse_sparse_product_kernel(const Lhs& lhs, const Rhs& rhs, ResultType& res, const Matrix<Index,Dynamic,1>& flops,
+                               bool numeric, const RealScalar& tolerance)
+    : m_lhs(lhs), m_rhs(rhs), m_res(res), m_flops(flops), m_numeric(numeric), m_tolerance(tolerance),
+      m_rows(lhs.innerSize()), m_threads(0), m_masks(0), m_values(0), m_indices(0), m_kept(0)
+  {}
+
+  ~sparse_sparse_product_kernel()
+  {
+    delete[] m_masks;
+    delete[] m_indices;
+    aligned_delete(m_values, m_numeric ? m_rows*m_threads : 0);
+  }
+
+  Index cost(Index j) const { return m_flops[j]; }
+
+  void initParallelSession(Index threads)
+  {
+    m_threads = threads;
+    m_masks = new Index[m_rows*threads];
+    std::fill(m_masks, m_masks + m_rows*threads, Index(-1));
+    if(m_numeric)
+    {
+      m_values = aligned_new<Scalar>(m_rows*threads);
+      m_indices = new Index[m_rows*threads];
+    }
+  }
+
+  void operator()(Index start, Index end, Index tid) const
+  {
+    if(m_numeric)
+      numeric(start, end, m_masks + tid*m_rows, m_values + tid*m_rows, m_indices + tid*m_rows);
+    else
+      symbolic(start, end, m_masks + tid*m_rows);
+  }
+
+  // stores the number of nonzeros of the column j of the result at outer[j+1]
+  void symbolic(Index start, Index end, Index* mask) const
+  {
+    Index* outer = m_res._outerIndexPtr();
+    for(Index j=start; j<end; ++j)
+    {
+      Index nnz = 0;
+      for(typename Rhs::InnerIterator rhsIt(m_rhs, j); rhsIt; ++rhsIt)
+        for(typename Lhs::InnerIterator lhsIt(m_lhs, rhsIt.index()); lhsIt; ++lhsIt)
+        {
+          Index i = lhsIt.index();
+          if(mask[i]!=j)
+          {
+            mask[i] = j;
+            ++nnz;
+          }
+        }
+      outer[j+1] = nnz;
+    }
+  }
+
+  void numeric(Index start, Index end, Index* mask, Scalar* values, Index* indices) const
+  {
+    const Index* outer = m_res._outerIndexPtr();
+    Index* resIndices = m_res._innerIndexPtr();
+    Scalar* resValues = m_res._valuePtr();
+    for(Index j=start; j<end; ++j)
+    {
+      Index nnz = 0;
+      for(typename Rhs::InnerIterator rhsIt(m_rhs, j); rhsIt; ++rhsIt)
+      {
+        Scalar y = rhsIt.value();
+        for(typename Lhs::InnerIterator lhsIt(m_lhs, rhsIt.index()); lhsIt; ++lhsIt)
+        {
+          Index i = lhsIt.index();
+          if(mask[i]!=j)
+          {
+            mask[i] = j;
+            values[i] = lhsIt.value() * y;
+            indices[nnz++] = i;
+          }
+          else
+            values[i] += lhsIt.value() * y;
+        }
+      }
+
+      // sort the row indices, unless the column is dense enough for a scan of the marker
+      if(nnz*16 > m_rows)
+      {
+        nnz = 0;
+        for(Index i=0; i<m_rows; ++i)
+          if(mask[i]==j)
+            indices[nnz++] = i;
+      }
+      else
+        std::sort(indices, indices+nnz);
+
+      Index p = outer[j];
+      for(Index k=0; k<nnz; ++k)
+      {
+        Index i = indices[k];
+        if(internal::abs(values[i])>m_tolerance)
+        {
+          resIndices[p] = i;
+          resValues[p] = values[i];
+          ++p;
+        }
+      }
+      m_kept[j] = p - outer[j];
+    }
+  }
+
+  const Lhs& m_lhs;
+  const Rhs& m_rhs;
+  ResultType& m_res;
+  const Matrix<Index,Dynamic,1>& m_flops;
+  bool m_numeric;
+  RealScalar m_tolerance;
+  Index m_rows;
+  Index m_threads;
+  Index* m_masks;
+  Scalar* m_values;
+  Index* m_indices;
+  Index* m_kept;
+};
+
+// perform a pseudo in-place sparse * sparse product assuming all matrices are col major
+// ResultType must be a SparseMatrix, and the coefficients not larger than tolerance are pruned
+template<typename Lhs, typename Rhs, typename ResultType>
+static void sparse_product_impl(const Lhs& lhs, const Rhs& rhs, ResultType& res,
+                                const typename NumTraits<typename remove_all<Lhs>::type::Scalar>::Real& tolerance)
+{
+  typedef typename remove_all<Lhs>::type::Index Index;
+  typedef sparse_sparse_product_kernel<Lhs,Rhs,ResultType> Kernel;
+
   // make sure to call innerSize/outerSize since we fake the storage order.
   Index rows = lhs.innerSize();
   Index cols = rhs.outerSize();
-  //int size = lhs.outerSize();
   eigen_assert(lhs.outerSize() == rhs.innerSize());
 
-  // allocate a temporary buffer
-  AmbiVector<Scalar,Index> tempVector(rows);
-
-  // estimate the number of non zero entries
-  float ratioLhs = float(lhs.nonZeros())/(float(lhs.rows())*float(lhs.cols()));
-  float avgNnzPerRhsColumn = float(rhs.nonZeros())/float(cols);
-  float ratioRes = (std::min)(ratioLhs * avgNnzPerRhsColumn, 1.f);
-
   // mimics a resizeByInnerOuter:
   if(ResultType::IsRowMajor)
     res.resize(cols, rows);
   else
     res.resize(rows, cols);
 
-  res.reserve(Index(ratioRes*rows*cols));
-  for (Index j=0; j<cols; ++j)
+  // the number of flops of each column of the result, to balance the threads
+  Matrix<Index,Dynamic,1> lhsNnz(lhs.outerSize());
+  for(Index k=0; k<lhs.outerSize(); ++k)
   {
-    // let's do a more accurate determination of the nnz ratio for the current column j of res
-    //float ratioColRes = (std::min)(ratioLhs * rhs.innerNonZeros(j), 1.f);
-    // FIXME find a nice way to get the number of nonzeros of a sub matrix (here an inner vector)
-    float ratioColRes = ratioRes;
-    tempVector.init(ratioColRes);
-    tempVector.setZero();
-    for (typename Rhs::InnerIterator rhsIt(rhs, j); rhsIt; ++rhsIt)
+    Index nnz = 0;
+    for(typename Lhs::InnerIterator it(lhs, k); it; ++it)
+      ++nnz;
+    lhsNnz[k] = nnz;
+  }
+  Matrix<Index,Dynamic,1> flops(cols);
+  for(Index j=0; j<cols; ++j)
+  {
+    Index f = 1;
+    for(typename Rhs::InnerIterator it(rhs, j); it; ++it)
+      f += lhsNnz[it.index()];
+    flops[j] = f;
+  }
+
+  // 1 - symbolic phase, followed by the single allocation of the result
+  {
+    Kernel symbolic(lhs, rhs, res, flops, false, tolerance);
+    if(!parallelize_gemv(symbolic, cols))
+    {
+      symbolic.initParallelSession(1);
+      symbolic(0, cols, 0);
+    }
+  }
+  Index* outer = res._outerIndexPtr();
+  outer[0] = 0;
+  for(Index j=0; j<cols; ++j)
+    outer[j+1] += outer[j];
+  res.resizeNonZeros(outer[cols]);
+
+  // 2 - numeric phase
+  Matrix<Index,Dynamic,1> kept(cols);
+  {
+    Kernel numeric(lhs, rhs, res, flops, true, tolerance);
+    numeric.m_kept = kept.data();
+    if(!parallelize_gemv(numeric, cols))
     {
-      // FIXME should be written like this: tmp += rhsIt.value() * lhs.col(rhsIt.index())
-      tempVector.restart();
-      Scalar x = rhsIt.value();
-      for (typename Lhs::InnerIterator lhsIt(lhs, rhsIt.index()); lhsIt; ++lhsIt)
+      numeric.initParallelSession(1);
+      numeric(0, cols, 0);
+    }
+  }
+
+  // 3 - remove the holes left by the pruned coefficients
+  if(kept.sum()<outer[cols])
+  {
+    Index* resIndices = res._innerIndexPtr();
+    typename ResultType::Scalar* resValues = res._valuePtr();
+    Index p = 0;
+    for(Index j=0; j<cols; ++j)
+    {
+      Index start = outer[j];
+      outer[j] = p;
+      for(Index k=0; k<kept[j]; ++k, ++p)
       {
-        tempVector.coeffRef(lhsIt.index()) += lhsIt.value() * x;
+        resIndices[p] = resIndices[start+k];
+        resValues[p] = resValues[start+k];
       }
     }
-    res.startVec(j);
-    for (typename AmbiVector<Scalar,Index>::Iterator it(tempVector); it; ++it)
-      res.insertBackByOuterInner(j,it.index()) = it.value();
+    outer[cols] = p;
+    res.resizeNonZeros(p);
   }
-  res.finalize();
 }
 
+// assigns the temporary result of a product to res, without copy when possible
+template<typename ResultType, typename Temporary>
+struct sparse_product_assign_temporary
+{
+  static void run(ResultType& res, Temporary& tmp) { res = tmp; }
+};
+
+template<typename ResultType>
+struct sparse_product_assign_temporary<ResultType,ResultType>
+{
+  static void run(ResultType& res, ResultType& tmp) { res.swap(tmp); }
+};
+
 template<typename Lhs, typename Rhs, typename ResultType,
   int LhsStorageOrder = traits<Lhs>::Flags&RowMajorBit,
   int RhsStorageOrder = traits<Rhs>::Flags&RowMajorBit,
@@ -175,26 +357,29 @@ template<typename Lhs, typename Rhs, typename ResultType>
 struct sparse_product_selector<Lhs,Rhs,ResultType,ColMajor,ColMajor,ColMajor>
 {
   typedef typename traits<typename remove_all<Lhs>::type>::Scalar Scalar;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
 
-  static void run(const Lhs& lhs, const Rhs& rhs, ResultType& res)
+  static void run(const Lhs& lhs, const Rhs& rhs, ResultType& res, const RealScalar& tolerance)
   {
-//     std::cerr << __LINE__ << "\n";
-    typename remove_all<ResultType>::type _res(res.rows(), res.cols());
-    sparse_product_impl<Lhs,Rhs,ResultType>(lhs, rhs, _res);
-    res.swap(_res);
+    typedef SparseMatrix<typename ResultType::Scalar,ColMajor,typename ResultType::Index> SparseTemporaryType;
+    SparseTemporaryType _res(res.rows(), res.cols());
+    sparse_product_impl<Lhs,Rhs,SparseTemporaryType>(lhs, rhs, _res, tolerance);
+    sparse_product_assign_temporary<ResultType,SparseTemporaryType>::run(res, _res);
   }
 };
 
 template<typename Lhs, typename Rhs, typename ResultType>
 struct sparse_product_selector<Lhs,Rhs,ResultType,ColMajor,ColMajor,RowMajor>
 {
-  static void run(const Lhs& lhs, const Rhs& rhs, ResultType& res)
+  typedef typename traits<typename remove_all<Lhs>::type>::Scalar Scalar;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+
+  static void run(const Lhs& lhs, const Rhs& rhs, ResultType& res, const RealScalar& tolerance)
   {
-//     std::cerr << __LINE__ << "\n";
     // we need a col-major matrix to hold the result
     typedef SparseMatrix<typename ResultType::Scalar> SparseTemporaryType;
     SparseTemporaryType _res(res.rows(), res.cols());
-    sparse_product_impl<Lhs,Rhs,SparseTemporaryType>(lhs, rhs, _res);
+    sparse_product_impl<Lhs,Rhs,SparseTemporaryType>(lhs, rhs, _res, tolerance);
     res = _res;
   }
 };
@@ -202,35 +387,33 @@ struct sparse_product_selector<Lhs,Rhs,ResultType,ColMajor,ColMajor,RowMajor>
 template<typename Lhs, typename Rhs, typename ResultType>
 struct sparse_product_selector<Lhs,Rhs,ResultType,RowMajor,RowMajor,RowMajor>
 {
-  static void run(const Lhs& lhs, const Rhs& rhs, ResultType& res)
+  typedef typename traits<typename remove_all<Lhs>::type>::Scalar Scalar;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+
+  static void run(const Lhs& lhs, const Rhs& rhs, ResultType& res, const RealScalar& tolerance)
   {
-//     std::cerr << __LINE__ << "\n";
     // let's transpose the product to get a column x column product
-    typename remove_all<ResultType>::type _res(res.rows(), res.cols());
-    sparse_product_impl<Rhs,Lhs,ResultType>(rhs, lhs, _res);
-    res.swap(_res);
+    typedef SparseMatrix<typename ResultType::Scalar,RowMajor,typename ResultType::Index> SparseTemporaryType;
+    SparseTemporaryType _res(res.rows(), res.cols());
+    sparse_product_impl<Rhs,Lhs,SparseTemporaryType>(rhs, lhs, _res, tolerance);
+    sparse_product_assign_temporary<ResultType,SparseTemporaryType>::run(res, _res);
   }
 };
 
 template<typename Lhs, typename Rhs, typename ResultType>
 struct sparse_product_selector<Lhs,Rhs,ResultType,RowMajor,RowMajor,ColMajor>
 {
-  static void run(const Lhs& lhs, const Rhs& rhs, ResultType& res)
+  typedef typename traits<typename remove_all<Lhs>::type>::Scalar Scalar;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+
+  static void run(const Lhs& lhs, const Rhs& rhs, ResultType& res, const RealScalar& tolerance)
   {
-//     std::cerr << "here...\n";
-    typedef SparseMatrix<typename ResultType::Scalar,ColMajor> ColMajorMatrix;
+    typedef SparseMatrix<typename ResultType::Scalar,ColMajor,typename ResultType::Index> ColMajorMatrix;
     ColMajorMatrix colLhs(lhs);
     ColMajorMatrix colRhs(rhs);
-//     std::cerr << "more...\n";
-    sparse_product_impl<ColMajorMatrix,ColMajorMatrix,ResultType>(colLhs, colRhs, res);
-//     std::cerr << "OK.\n";
-
-    // let's transpose the product to get a column x column product
-
-//     typedef SparseMatrix<typename ResultType::Scalar> SparseTemporaryType;
-//     SparseTemporaryType _res(res.cols(), res.rows());
-//     sparse_product_impl<Rhs,Lhs,SparseTemporaryType>(rhs, lhs, _res);
-//     res = _res.transpose();
+    ColMajorMatrix _res(res.rows(), res.cols());
+    sparse_product_impl<ColMajorMatrix,ColMajorMatrix,ColMajorMatrix>(colLhs, colRhs, _res, tolerance);
+    sparse_product_assign_temporary<ResultType,ColMajorMatrix>::run(res, _res);
   }
 };
 
@@ -244,11 +427,10 @@ template<typename Derived>
 template<typename Lhs, typename Rhs>
 inline Derived& SparseMatrixBase<Derived>::operator=(const SparseSparseProduct<Lhs,Rhs>& product)
 {
-//   std::cerr << "there..." << typeid(Lhs).name() << "  " << typeid(Lhs).name() << " " << (Derived::Flags&&RowMajorBit) << "\n";
   internal::sparse_product_selector<
     typename internal::remove_all<Lhs>::type,
     typename internal::remove_all<Rhs>::type,
-    Derived>::run(product.lhs(),product.rhs(),derived());
+    Derived>::run(product.lhs(),product.rhs(),derived(),product.tolerance());
   return derived();
 }
 
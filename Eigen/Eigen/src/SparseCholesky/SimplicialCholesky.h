@@ -0,0 +1,479 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_SIMPLICIAL_CHOLESKY_H
+#define EIGEN_SIMPLICIAL_CHOLESKY_H
+
+/** \ingroup SparseCholesky_Module
+  * \brief Common base class of the sparse Cholesky factorizations
+  *
+  * This class holds the fill-reducing permutation and the elimination tree of the factorized matrix, which
+  * are computed by analyzePattern(). As long as the sparsity pattern does not change, analyzePattern()
+  * only has to be called once, and factorize() can then be called for each new set of coefficients.
+  *
+  * \sa class SimplicialLLT, class SimplicialLDLT, class SupernodalLLT, class SupernodalLDLT
+  */
+template<typename Derived>
+class SparseCholeskyBase
+{
+  public:
+    typedef typename internal::traits<Derived>::MatrixType MatrixType;
+    typedef typename internal::traits<Derived>::OrderingType OrderingType;
+    enum { UpLo = internal::traits<Derived>::UpLo };
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::RealScalar RealScalar;
+    typedef typename MatrixType::Index Index;
+    typedef SparseMatrix<Scalar,ColMajor,Index> CholMatrixType;
+    typedef Matrix<Index,Dynamic,1> VectorI;
+    typedef PermutationMatrix<Dynamic,Dynamic,Index> PermutationType;
+
+    SparseCholeskyBase()
+      : m_info(Success), m_isInitialized(false), m_analysisIsOk(false), m_factorizationIsOk(false), m_size(0)
+    {}
+
+    Derived& derived() { return *static_cast<Derived*>(this); }
+    const Derived& derived() const { return *static_cast<const Derived*>(this); }
+
+    inline Index cols() const { return m_size; }
+    inline Index rows() const { return m_size; }
+
+    /** \brief Reports whether previous computation was successful.
+      *
+      * \returns \c Success if computation was succesful,
+      *          \c NumericalIssue if the matrix is not positive definite (or has a zero pivot for LDLT).
+      */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_isInitialized && "Decomposition is not initialized.");
+      return m_info;
+    }
+
+    /** Computes the sparse Cholesky decomposition of \a matrix, which is equivalent to
+      * analyzePattern(matrix) followed by factorize(matrix). */
+    Derived& compute(const MatrixType& matrix)
+    {
+      derived().analyzePattern(matrix);
+      derived().factorize(matrix);
+      return derived();
+    }
+
+    /** \returns the solution x of \f$ A x = b \f$ using the current decomposition of A.
+      *
+      * \sa compute()
+      */
+    template<typename Rhs>
+    inline const internal::solve_retval<SparseCholeskyBase, Rhs>
+    solve(const MatrixBase<Rhs>& b) const
+    {
+      eigen_assert(m_isInitialized && "Decomposition is not initialized.");
+      eigen_assert(rows()==b.rows()
+                && "SparseCholeskyBase::solve(): invalid number of rows of the right hand side matrix b");
+      return internal::solve_retval<SparseCholeskyBase, Rhs>(*this, b.derived());
+    }
+
+    /** \returns the permutation P such that the factorized matrix is \f$ P A P^{-1} \f$
+      * \sa permutationPinv() */
+    const PermutationType& permutationP() const
+    { return m_P; }
+
+    /** \returns the inverse P^-1 of the permutation P
+      * \sa permutationP() */
+    const PermutationType& permutationPinv() const
+    { return m_Pinv; }
+
+  protected:
+
+    /** \internal
+      * Computes the fill-reducing permutation, and stores the upper triangular part of the permuted
+      * matrix \f$ P A P^{-1} \f$ into \a ap. */
+    void ordering(const MatrixType& a, CholMatrixType& ap)
+    {
+      eigen_assert(a.rows()==a.cols());
+      m_size = a.cols();
+      OrderingType ordering;
+      ordering(a.template selfadjointView<UpLo>(), m_Pinv);
+      m_P = m_Pinv.inverse();
+      ap.resize(m_size, m_size);
+      internal::permute_symm_to_symm<UpLo,Upper>(a, ap, m_P.indices().data());
+    }
+
+    /** \internal
+      * Computes the elimination tree and the number of nonzeros of each column of the strictly lower
+      * triangular part of the factor, from the upper triangular part \a ap of the permuted matrix.
+      * Each row of the factor is the set of the nodes reached by walking up the elimination tree from
+      * the nonzeros of the corresponding column of \a ap.
+      */
+    void analyzePattern_preordered(const CholMatrixType& ap)
+    {
+      const Index size = ap.rows();
+      m_parent.resize(size);
+      m_nonZerosPerCol.resize(size);
+      VectorI tags(size);
+
+      for(Index k = 0; k < size; ++k)
+      {
+        // L(k,:) pattern: all nodes reachable in etree from nz in A(0:k-1,k)
+        m_parent[k] = -1;
+        tags[k] = k;
+        m_nonZerosPerCol[k] = 0;
+        for(typename CholMatrixType::InnerIterator it(ap,k); it; ++it)
+        {
+          Index i = it.index();
+          if(i < k)
+          {
+            // follow path from i to root of etree, stop at flagged node
+            for(; tags[i] != k; i = m_parent[i])
+            {
+              // find parent of i if not yet determined
+              if (m_parent[i] == -1)
+                m_parent[i] = k;
+              m_nonZerosPerCol[i]++;
+              tags[i] = k;
+            }
+          }
+        }
+      }
+    }
+
+    mutable ComputationInfo m_info;
+    bool m_isInitialized;
+    bool m_analysisIsOk;
+    bool m_factorizationIsOk;
+    Index m_size;
+
+    VectorI m_parent;                 // elimination tree
+    VectorI m_nonZerosPerCol;         // number of nonzeros below the diagonal in each column of L
+    PermutationType m_P;              // the fill-reducing permutation
+    PermutationType m_Pinv;           // the inverse permutation
+};
+
+namespace internal {
+
+template<typename Derived, typename Rhs>
+struct solve_retval<SparseCholeskyBase<Derived>, Rhs>
+  : solve_retval_base<SparseCholeskyBase<Derived>, Rhs>
+{
+  typedef SparseCholeskyBase<Derived> Dec;
+  EIGEN_MAKE_SOLVE_HELPERS(Dec,Rhs)
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    dec().derived()._solve(rhs(),dst);
+  }
+};
+
+} // end namespace internal
+
+template<typename _MatrixType, int _UpLo = Lower, typename _Ordering = AMDOrdering<typename _MatrixType::Index> > class SimplicialLLT;
+template<typename _MatrixType, int _UpLo = Lower, typename _Ordering = AMDOrdering<typename _MatrixType::Index> > class SimplicialLDLT;
+
+namespace internal {
+
+template<typename _MatrixType, int _UpLo, typename _Ordering> struct traits<SimplicialLLT<_MatrixType,_UpLo,_Ordering> >
+{
+  typedef _MatrixType MatrixType;
+  typedef _Ordering OrderingType;
+  enum { UpLo = _UpLo };
+};
+
+template<typename _MatrixType, int _UpLo, typename _Ordering> struct traits<SimplicialLDLT<_MatrixType,_UpLo,_Ordering> >
+{
+  typedef _MatrixType MatrixType;
+  typedef _Ordering OrderingType;
+  enum { UpLo = _UpLo };
+};
+
+} // end namespace internal
+
+/** \ingroup SparseCholesky_Module
+  * \brief Base class of the simplicial sparse Cholesky factorizations
+  *
+  * The factor is computed row by row (up-looking algorithm): the k-th row of L is obtained by a sparse
+  * triangular solve whose pattern is given by the elimination tree, as in Tim Davis' LDL package.
+  * This is the method of choice for very sparse factors, such as the ones of 2D problems.
+  */
+template<typename Derived>
+class SimplicialCholeskyBase : public SparseCholeskyBase<Derived>
+{
+    typedef SparseCholeskyBase<Derived> Base;
+  public:
+    typedef typename Base::MatrixType MatrixType;
+    typedef typename Base::Scalar Scalar;
+    typedef typename Base::RealScalar RealScalar;
+    typedef typename Base::Index Index;
+    typedef typename Base::CholMatrixType CholMatrixType;
+    typedef typename Base::VectorI VectorI;
+    typedef Matrix<Scalar,Dynamic,1> VectorType;
+
+    /** Performs a symbolic decomposition on the sparsity pattern of \a a: computes the fill-reducing
+      * ordering, the elimination tree, and allocates the factor.
+      *
+      * \sa factorize()
+      */
+    void analyzePattern(const MatrixType& a)
+    {
+      CholMatrixType ap;
+      this->ordering(a, ap);
+      this->analyzePattern_preordered(ap);
+
+      const Index size = this->m_size;
+      const Index diagEntries = Derived::DoLDLT ? 0 : 1;
+      m_matrix.resize(size, size);
+      Index* Lp = m_matrix._outerIndexPtr();
+      Lp[0] = 0;
+      for(Index k = 0; k < size; ++k)
+        Lp[k+1] = Lp[k] + this->m_nonZerosPerCol[k] + diagEntries;
+      m_matrix.resizeNonZeros(Lp[size]);
+
+      this->m_isInitialized = true;
+      this->m_info = Success;
+      this->m_analysisIsOk = true;
+      this->m_factorizationIsOk = false;
+    }
+
+    /** Performs a numeric decomposition of \a a, which must have the same sparsity pattern as the matrix
+      * given to analyzePattern().
+      *
+      * \sa analyzePattern()
+      */
+    void factorize(const MatrixType& a)
+    {
+      eigen_assert(this->m_analysisIsOk && "You must first call analyzePattern()");
+      eigen_assert(a.rows()==a.cols() && a.cols()==this->m_size);
+      CholMatrixType ap(this->m_size, this->m_size);
+      internal::permute_symm_to_symm<Base::UpLo,Upper>(a, ap, this->m_P.indices().data());
+      factorize_preordered(ap);
+    }
+
+    /** \internal */
+    template<typename Rhs, typename Dest>
+    void _solve(const Rhs& b, Dest& dest) const
+    {
+      eigen_assert(this->m_factorizationIsOk && "The decomposition is not in a valid state for solving, you must first call either compute() or symbolic()/numeric()");
+      eigen_assert(m_matrix.rows()==b.rows());
+
+      if(this->m_info!=Success)
+        return;
+
+      dest = this->m_P * b;
+      if(Derived::DoLDLT)
+      {
+        m_matrix.template triangularView<UnitLower>().solveInPlace(dest);
+        dest = m_diag.asDiagonal().inverse() * dest;
+        m_matrix.adjoint().template triangularView<UnitUpper>().solveInPlace(dest);
+      }
+      else
+      {
+        m_matrix.template triangularView<Lower>().solveInPlace(dest);
+        m_matrix.adjoint().template triangularView<Upper>().solveInPlace(dest);
+      }
+      dest = this->m_Pinv * dest;
+    }
+
+  protected:
+
+    /** \internal */
+    void factorize_preordered(const CholMatrixType& ap);
+
+    CholMatrixType m_matrix;
+    VectorType m_diag;                // the diagonal coefficients of an LDLT factorization
+};
+
+template<typename Derived>
+void SimplicialCholeskyBase<Derived>::factorize_preordered(const CholMatrixType& ap)
+{
+  const bool DoLDLT = Derived::DoLDLT;
+  const Index size = ap.rows();
+  eigen_assert(size==this->m_size && m_matrix.rows()==size);
+
+  const Index* Lp = m_matrix._outerIndexPtr();
+  Index* Li = m_matrix._innerIndexPtr();
+  Scalar* Lx = m_matrix._valuePtr();
+
+  VectorType y(size);
+  VectorI pattern(size), tags(size);
+  VectorI& nonZerosPerCol = this->m_nonZerosPerCol;
+  const VectorI& parent = this->m_parent;
+  if(DoLDLT)
+    m_diag.resize(size);
+
+  bool ok = true;
+  for(Index k = 0; k < size; ++k)
+  {
+    // compute nonzero pattern of kth row of L, in topological order
+    y[k] = Scalar(0);                     // Y(0:k) is now all zero
+    Index top = size;                     // stack for pattern is empty
+    tags[k] = k;                          // mark node k as visited
+    nonZerosPerCol[k] = 0;                // count of nonzeros in column k of L
+    for(typename CholMatrixType::InnerIterator it(ap,k); it; ++it)
+    {
+      Index i = it.index();
+      if(i <= k)
+      {
+        y[i] += internal::conj(it.value());  // scatter A(i,k) into Y (sum duplicates)
+        Index len;
+        for(len = 0; tags[i] != k; i = parent[i])
+        {
+          pattern[len++] = i;             // L(k,i) is nonzero
+          tags[i] = k;                    // mark i as visited
+        }
+        while(len > 0)
+          pattern[--top] = pattern[--len];
+      }
+    }
+
+    // compute numerical values kth row of L (a sparse triangular solve)
+    RealScalar d = internal::real(y[k]);  // get D(k,k) and clear Y(k)
+    y[k] = Scalar(0);
+    for(; top < size; ++top)
+    {
+      Index i = pattern[top];             // pattern[top:n-1] is pattern of L(:,k)
+      Scalar yi = y[i];                   // get and clear Y(i)
+      y[i] = Scalar(0);
+
+      // the nonzero entry L(k,i)
+      Scalar l_ki;
+      if(DoLDLT)
+        l_ki = yi / m_diag[i];
+      else
+        yi = l_ki = yi / Lx[Lp[i]];
+
+      Index p2 = Lp[i] + nonZerosPerCol[i];
+      Index p;
+      for(p = Lp[i] + (DoLDLT ? 0 : 1); p < p2; ++p)
+        y[Li[p]] -= internal::conj(Lx[p]) * yi;
+      d -= internal::real(l_ki * internal::conj(yi));
+      Li[p] = k;                          // store L(k,i) in column form of L
+      Lx[p] = l_ki;
+      ++nonZerosPerCol[i];                // increment count of nonzeros in col i
+    }
+    if(DoLDLT)
+    {
+      m_diag[k] = d;
+      if(d == RealScalar(0))
+      {
+        ok = false;                       // failure, D(k,k) is zero
+        break;
+      }
+    }
+    else
+    {
+      Index p = Lp[k] + nonZerosPerCol[k]++;
+      Li[p] = k;                          // store L(k,k) = sqrt(d) in column k
+      if(d <= RealScalar(0))
+      {
+        ok = false;                       // failure, matrix is not positive definite
+        break;
+      }
+      Lx[p] = internal::sqrt(d);
+    }
+  }
+
+  this->m_info = ok ? Success : NumericalIssue;
+  this->m_factorizationIsOk = true;
+}
+
+/** \ingroup SparseCholesky_Module
+  * \class SimplicialLLT
+  * \brief A direct sparse LLT Cholesky factorization
+  *
+  * This class provides a LL^T Cholesky factorization of sparse matrices that are selfadjoint and positive
+  * definite. The factorization is computed on \f$ P A P^{-1} \f$, where P is a fill-reducing permutation.
+  *
+  * \tparam _MatrixType the type of the sparse matrix A, it must be a SparseMatrix<>
+  * \tparam _UpLo the triangular part that will be used for the computations. It can be Lower
+  *               or Upper. Default is Lower.
+  * \tparam _Ordering the fill-reducing ordering method, AMDOrdering by default
+  *
+  * \sa class SimplicialLDLT, class SupernodalLLT
+  */
+template<typename _MatrixType, int _UpLo, typename _Ordering>
+class SimplicialLLT : public SimplicialCholeskyBase<SimplicialLLT<_MatrixType,_UpLo,_Ordering> >
+{
+  public:
+    typedef _MatrixType MatrixType;
+    enum { DoLDLT = false };
+    typedef SimplicialCholeskyBase<SimplicialLLT> Base;
+    typedef typename Base::CholMatrixType CholMatrixType;
+    typedef SparseTriangularView<CholMatrixType, Lower> MatrixLType;
+
+    /** Default constructor */
+    SimplicialLLT() : Base() {}
+    /** Constructs and performs the LLT factorization of \a matrix */
+    SimplicialLLT(const MatrixType& matrix) : Base() { Base::compute(matrix); }
+
+    /** \returns an expression of the factor L */
+    inline const MatrixLType matrixL() const
+    {
+      eigen_assert(Base::m_factorizationIsOk && "Simplicial LLT not factorized");
+      return Base::m_matrix;
+    }
+};
+
+/** \ingroup SparseCholesky_Module
+  * \class SimplicialLDLT
+  * \brief A direct sparse LDLT Cholesky factorization without square root
+  *
+  * This class provides a LDL^T Cholesky factorization without square root of sparse matrices that are
+  * selfadjoint. Since no pivoting is performed, the matrix must be such that all pivots are nonzero,
+  * which is the case for positive definite matrices. The factorization is computed on \f$ P A P^{-1} \f$,
+  * where P is a fill-reducing permutation.
+  *
+  * \tparam _MatrixType the type of the sparse matrix A, it must be a SparseMatrix<>
+  * \tparam _UpLo the triangular part that will be used for the computations. It can be Lower
+  *               or Upper. Default is Lower.
+  * \tparam _Ordering the fill-reducing ordering method, AMDOrdering by default
+  *
+  * \sa class SimplicialLLT, class SupernodalLDLT
+  */
+template<typename _MatrixType, int _UpLo, typename _Ordering>
+class SimplicialLDLT : public SimplicialCholeskyBase<SimplicialLDLT<_MatrixType,_UpLo,_Ordering> >
+{
+  public:
+    typedef _MatrixType MatrixType;
+    enum { DoLDLT = true };
+    typedef SimplicialCholeskyBase<SimplicialLDLT> Base;
+    typedef typename Base::CholMatrixType CholMatrixType;
+    typedef typename Base::VectorType VectorType;
+    typedef SparseTriangularView<CholMatrixType, UnitLower> MatrixLType;
+
+    /** Default constructor */
+    SimplicialLDLT() : Base() {}
+    /** Constructs and performs the LDLT factorization of \a matrix */
+    SimplicialLDLT(const MatrixType& matrix) : Base() { Base::compute(matrix); }
+
+    /** \returns a vector expression of the diagonal D */
+    inline const VectorType& vectorD() const
+    {
+      eigen_assert(Base::m_factorizationIsOk && "Simplicial LDLT not factorized");
+      return Base::m_diag;
+    }
+
+    /** \returns an expression of the factor L */
+    inline const MatrixLType matrixL() const
+    {
+      eigen_assert(Base::m_factorizationIsOk && "Simplicial LDLT not factorized");
+      return Base::m_matrix;
+    }
+};
+
+#endif // EIGEN_SIMPLICIAL_CHOLESKY_H
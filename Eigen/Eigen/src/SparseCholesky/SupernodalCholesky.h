@@ -0,0 +1,480 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_SUPERNODAL_CHOLESKY_H
+#define EIGEN_SUPERNODAL_CHOLESKY_H
+
+template<typename _MatrixType, int _UpLo = Lower, typename _Ordering = AMDOrdering<typename _MatrixType::Index> > class SupernodalLLT;
+template<typename _MatrixType, int _UpLo = Lower, typename _Ordering = AMDOrdering<typename _MatrixType::Index> > class SupernodalLDLT;
+
+namespace internal {
+
+template<typename _MatrixType, int _UpLo, typename _Ordering> struct traits<SupernodalLLT<_MatrixType,_UpLo,_Ordering> >
+{
+  typedef _MatrixType MatrixType;
+  typedef _Ordering OrderingType;
+  enum { UpLo = _UpLo };
+};
+
+template<typename _MatrixType, int _UpLo, typename _Ordering> struct traits<SupernodalLDLT<_MatrixType,_UpLo,_Ordering> >
+{
+  typedef _MatrixType MatrixType;
+  typedef _Ordering OrderingType;
+  enum { UpLo = _UpLo };
+};
+
+} // end namespace internal
+
+/** \ingroup SparseCholesky_Module
+  * \brief Base class of the supernodal sparse Cholesky factorizations
+  *
+  * A supernode is a set of contiguous columns of the factor L which share the same sparsity pattern below
+  * their diagonal block. Each supernode is stored as a dense column-major matrix whose rows are the
+  * sorted row indices of the supernode, so that the factorization can be performed by dense kernels:
+  * the supernodes are factorized from left to right, each of them first receiving the updates of its
+  * descendants as matrix-matrix products (left-looking algorithm), then factorizing its diagonal block
+  * with a blocked dense Cholesky and the block below it with a triangular solve.
+  *
+  * On problems with large dense blocks in the factor, such as 3D meshes, this is considerably faster
+  * than the simplicial factorizations.
+  */
+template<typename Derived>
+class SupernodalCholeskyBase : public SparseCholeskyBase<Derived>
+{
+    typedef SparseCholeskyBase<Derived> Base;
+  public:
+    typedef typename Base::MatrixType MatrixType;
+    typedef typename Base::Scalar Scalar;
+    typedef typename Base::RealScalar RealScalar;
+    typedef typename Base::Index Index;
+    typedef typename Base::CholMatrixType CholMatrixType;
+    typedef typename Base::VectorI VectorI;
+    typedef Matrix<Scalar,Dynamic,1> VectorType;
+    typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrixType;
+    typedef Map<DenseMatrixType> SupernodeType;
+
+    /** Performs a symbolic decomposition on the sparsity pattern of \a a: computes the fill-reducing
+      * ordering, the elimination tree, the supernodes and their row structures, and allocates the factor.
+      *
+      * \sa factorize()
+      */
+    void analyzePattern(const MatrixType& a);
+
+    /** Performs a numeric decomposition of \a a, which must have the same sparsity pattern as the matrix
+      * given to analyzePattern().
+      *
+      * \sa analyzePattern()
+      */
+    void factorize(const MatrixType& a);
+
+    /** \returns the number of supernodes of the factor */
+    Index supernodes() const { return m_superStart.size()-1; }
+
+    /** \internal */
+    template<typename Rhs, typename Dest>
+    void _solve(const Rhs& b, Dest& dest) const;
+
+  protected:
+
+    /** \internal \returns the dense block storing the supernode \a s */
+    SupernodeType supernode(Index s)
+    {
+      return SupernodeType(m_values.data() + m_valueStart[s], m_rowStart[s+1]-m_rowStart[s], m_superStart[s+1]-m_superStart[s]);
+    }
+
+    /** \internal \returns the dense block storing the supernode \a s */
+    const Map<const DenseMatrixType> supernode(Index s) const
+    {
+      return Map<const DenseMatrixType>(m_values.data() + m_valueStart[s], m_rowStart[s+1]-m_rowStart[s], m_superStart[s+1]-m_superStart[s]);
+    }
+
+    VectorI m_superStart;             // first column of each supernode
+    VectorI m_superOf;                // supernode of each column
+    VectorI m_rowStart;               // offset of the row structure of each supernode in m_rowIndices
+    VectorI m_rowIndices;             // sorted row indices of the supernodes
+    VectorI m_valueStart;             // offset of each supernode in m_values
+    VectorType m_values;              // the supernodes, stored as dense column-major matrices
+};
+
+template<typename Derived>
+void SupernodalCholeskyBase<Derived>::analyzePattern(const MatrixType& a)
+{
+  CholMatrixType ap;
+  this->ordering(a, ap);
+  this->analyzePattern_preordered(ap);
+
+  const Index size = this->m_size;
+  const VectorI& parent = this->m_parent;
+  const VectorI& nonZerosPerCol = this->m_nonZerosPerCol;
+
+  // fundamental supernodes: column j+1 extends the supernode of column j if it is its parent in the
+  // elimination tree and the structure of L(:,j) is {j} union the structure of L(:,j+1)
+  std::vector<Index> superStart;
+  m_superOf.resize(size);
+  for(Index j = 0; j < size; ++j)
+  {
+    if(j==0 || !(parent[j-1]==j && nonZerosPerCol[j-1]==nonZerosPerCol[j]+1))
+      superStart.push_back(j);
+    m_superOf[j] = Index(superStart.size())-1;
+  }
+  const Index nsuper = Index(superStart.size());
+  superStart.push_back(size);
+  m_superStart = Map<VectorI>(&superStart[0], nsuper+1);
+
+  m_rowStart.resize(nsuper+1);
+  m_valueStart.resize(nsuper+1);
+  m_rowStart[0] = 0;
+  m_valueStart[0] = 0;
+  for(Index s = 0; s < nsuper; ++s)
+  {
+    Index nrows = nonZerosPerCol[m_superStart[s]] + 1;
+    m_rowStart[s+1] = m_rowStart[s] + nrows;
+    m_valueStart[s+1] = m_valueStart[s] + nrows * (m_superStart[s+1]-m_superStart[s]);
+  }
+
+  // the row structure of a supernode is the union of the structure of the lower triangular part of its
+  // columns in A and of the structures of its children below their own columns
+  CholMatrixType apl(size, size);
+  internal::permute_symm_to_symm<Base::UpLo,Lower>(a, apl, this->m_P.indices().data());
+  m_rowIndices.resize(m_rowStart[nsuper]);
+  VectorI marker = VectorI::Constant(size, -1);
+  VectorI childHead = VectorI::Constant(nsuper, -1);
+  VectorI childNext(nsuper);
+  for(Index s = 0; s < nsuper; ++s)
+  {
+    Index* rows = m_rowIndices.data() + m_rowStart[s];
+    Index count = 0;
+    for(Index j = m_superStart[s]; j < m_superStart[s+1]; ++j)
+    {
+      marker[j] = s;
+      rows[count++] = j;
+    }
+    for(Index j = m_superStart[s]; j < m_superStart[s+1]; ++j)
+    {
+      for(typename CholMatrixType::InnerIterator it(apl,j); it; ++it)
+      {
+        Index i = it.index();
+        if(marker[i] != s)
+        {
+          marker[i] = s;
+          rows[count++] = i;
+        }
+      }
+    }
+    for(Index c = childHead[s]; c != -1; c = childNext[c])
+    {
+      Index ncols = m_superStart[c+1] - m_superStart[c];
+      for(Index k = m_rowStart[c] + ncols; k < m_rowStart[c+1]; ++k)
+      {
+        Index i = m_rowIndices[k];
+        if(marker[i] != s)
+        {
+          marker[i] = s;
+          rows[count++] = i;
+        }
+      }
+    }
+    eigen_assert(count == m_rowStart[s+1]-m_rowStart[s] && "SupernodalCholesky: inconsistent column counts");
+    std::sort(rows, rows+count);
+
+    Index p = parent[m_superStart[s+1]-1];
+    if(p != -1)
+    {
+      Index ps = m_superOf[p];
+      childNext[s] = childHead[ps];
+      childHead[ps] = s;
+    }
+  }
+
+  m_values.resize(m_valueStart[nsuper]);
+
+  this->m_isInitialized = true;
+  this->m_info = Success;
+  this->m_analysisIsOk = true;
+  this->m_factorizationIsOk = false;
+}
+
+template<typename Derived>
+void SupernodalCholeskyBase<Derived>::factorize(const MatrixType& a)
+{
+  eigen_assert(this->m_analysisIsOk && "You must first call analyzePattern()");
+  eigen_assert(a.rows()==a.cols() && a.cols()==this->m_size);
+  const bool DoLDLT = Derived::DoLDLT;
+  const Index size = this->m_size;
+  const Index nsuper = supernodes();
+
+  CholMatrixType apl(size, size);
+  internal::permute_symm_to_symm<Base::UpLo,Lower>(a, apl, this->m_P.indices().data());
+
+  // each factorized supernode d is kept in the list of the next supernode it has to update, which is
+  // the supernode of the row m_rowIndices[nextRow[d]]
+  VectorI head = VectorI::Constant(nsuper, -1);
+  VectorI next(nsuper);
+  VectorI nextRow(nsuper);
+  VectorI map(size);
+  VectorType updateBuffer, scaleBuffer;
+
+  m_values.setZero();
+  bool ok = true;
+  for(Index s = 0; s < nsuper && ok; ++s)
+  {
+    const Index first = m_superStart[s];
+    const Index ncols = m_superStart[s+1] - first;
+    const Index nrows = m_rowStart[s+1] - m_rowStart[s];
+    const Index* rows = m_rowIndices.data() + m_rowStart[s];
+    SupernodeType S = supernode(s);
+
+    for(Index k = 0; k < nrows; ++k)
+      map[rows[k]] = k;
+
+    // scatter the columns of A
+    for(Index j = 0; j < ncols; ++j)
+      for(typename CholMatrixType::InnerIterator it(apl,first+j); it; ++it)
+        S(map[it.index()], j) += it.value();
+
+    // apply the updates of the descendants
+    Index d = head[s];
+    while(d != -1)
+    {
+      const Index dnext = next[d];
+      const Index dncols = m_superStart[d+1] - m_superStart[d];
+      const Index dnrows = m_rowStart[d+1] - m_rowStart[d];
+      const Index* drows = m_rowIndices.data() + m_rowStart[d];
+      const Index p1 = nextRow[d];
+      Index p2 = p1;
+      while(p2 < dnrows && drows[p2] < first+ncols)
+        ++p2;
+      const Index m = dnrows - p1;
+      const Index w = p2 - p1;
+
+      if(updateBuffer.size() < m*w)
+        updateBuffer.resize(m*w);
+      SupernodeType C(updateBuffer.data(), m, w);
+      Map<const DenseMatrixType> D = const_cast<const SupernodalCholeskyBase*>(this)->supernode(d);
+      if(DoLDLT)
+      {
+        if(scaleBuffer.size() < w*dncols)
+          scaleBuffer.resize(w*dncols);
+        SupernodeType T(scaleBuffer.data(), w, dncols);
+        T = D.middleRows(p1,w) * D.diagonal().asDiagonal();
+        C.noalias() = D.bottomRows(m) * T.adjoint();
+      }
+      else
+        C.noalias() = D.bottomRows(m) * D.middleRows(p1,w).adjoint();
+
+      // scatter the lower triangular part of the update
+      for(Index j = 0; j < w; ++j)
+      {
+        const Index col = drows[p1+j] - first;
+        for(Index i = j; i < m; ++i)
+          S(map[drows[p1+i]], col) -= C(i,j);
+      }
+
+      // move d to the list of the next supernode it updates
+      nextRow[d] = p2;
+      if(p2 < dnrows)
+      {
+        Index t = m_superOf[drows[p2]];
+        next[d] = head[t];
+        head[t] = d;
+      }
+      d = dnext;
+    }
+
+    // factorize the diagonal block, and the block below it by a triangular solve
+    Block<SupernodeType> diag(S, 0, 0, ncols, ncols);
+    if(DoLDLT)
+    {
+      for(Index k = 0; k < ncols && ok; ++k)
+      {
+        for(Index j = 0; j < k; ++j)
+        {
+          Scalar ukj = internal::conj(diag(k,j)) * diag(j,j);
+          diag.col(k).tail(ncols-k) -= diag.col(j).tail(ncols-k) * ukj;
+        }
+        RealScalar dk = internal::real(diag(k,k));
+        diag(k,k) = dk;
+        if(dk == RealScalar(0))
+          ok = false;
+        else
+          diag.col(k).tail(ncols-k-1) /= dk;
+      }
+      if(ok && nrows > ncols)
+      {
+        Block<SupernodeType> below(S, ncols, 0, nrows-ncols, ncols);
+        diag.template triangularView<UnitLower>().adjoint().template solveInPlace<OnTheRight>(below);
+        below = below * diag.diagonal().real().cwiseInverse().template cast<Scalar>().asDiagonal();
+      }
+    }
+    else
+    {
+      ok = internal::llt_inplace<Lower>::blocked(diag) == -1;
+      if(ok && nrows > ncols)
+      {
+        Block<SupernodeType> below(S, ncols, 0, nrows-ncols, ncols);
+        diag.template triangularView<Lower>().adjoint().template solveInPlace<OnTheRight>(below);
+      }
+    }
+
+    if(nrows > ncols)
+    {
+      nextRow[s] = ncols;
+      Index t = m_superOf[rows[ncols]];
+      next[s] = head[t];
+      head[t] = s;
+    }
+  }
+
+  this->m_info = ok ? Success : NumericalIssue;
+  this->m_factorizationIsOk = true;
+}
+
+template<typename Derived>
+template<typename Rhs, typename Dest>
+void SupernodalCholeskyBase<Derived>::_solve(const Rhs& b, Dest& dest) const
+{
+  eigen_assert(this->m_factorizationIsOk && "The decomposition is not in a valid state for solving, you must first call either compute() or symbolic()/numeric()");
+  eigen_assert(this->m_size==b.rows());
+
+  if(this->m_info!=Success)
+    return;
+
+  const Index nsuper = supernodes();
+  const Index nrhs = b.cols();
+  dest = this->m_P * b;
+  DenseMatrixType tmp;
+
+  // forward substitution with L
+  for(Index s = 0; s < nsuper; ++s)
+  {
+    const Index first = m_superStart[s];
+    const Index ncols = m_superStart[s+1] - first;
+    const Index nbelow = m_rowStart[s+1] - m_rowStart[s] - ncols;
+    const Index* rows = m_rowIndices.data() + m_rowStart[s] + ncols;
+    Map<const DenseMatrixType> S = supernode(s);
+
+    if(Derived::DoLDLT)
+      S.topRows(ncols).template triangularView<UnitLower>().solveInPlace(dest.middleRows(first, ncols));
+    else
+      S.topRows(ncols).template triangularView<Lower>().solveInPlace(dest.middleRows(first, ncols));
+    if(nbelow > 0)
+    {
+      tmp.noalias() = S.bottomRows(nbelow) * dest.middleRows(first, ncols);
+      for(Index i = 0; i < nbelow; ++i)
+        dest.row(rows[i]) -= tmp.row(i);
+    }
+  }
+
+  if(Derived::DoLDLT)
+    for(Index s = 0; s < nsuper; ++s)
+    {
+      const Index first = m_superStart[s];
+      const Index ncols = m_superStart[s+1] - first;
+      dest.middleRows(first, ncols) = supernode(s).diagonal().real().cwiseInverse().template cast<Scalar>().asDiagonal()
+                                    * dest.middleRows(first, ncols);
+    }
+
+  // backward substitution with L^*
+  for(Index s = nsuper-1; s >= 0; --s)
+  {
+    const Index first = m_superStart[s];
+    const Index ncols = m_superStart[s+1] - first;
+    const Index nbelow = m_rowStart[s+1] - m_rowStart[s] - ncols;
+    const Index* rows = m_rowIndices.data() + m_rowStart[s] + ncols;
+    Map<const DenseMatrixType> S = supernode(s);
+
+    if(nbelow > 0)
+    {
+      tmp.resize(nbelow, nrhs);
+      for(Index i = 0; i < nbelow; ++i)
+        tmp.row(i) = dest.row(rows[i]);
+      dest.middleRows(first, ncols).noalias() -= S.bottomRows(nbelow).adjoint() * tmp;
+    }
+    if(Derived::DoLDLT)
+      S.topRows(ncols).template triangularView<UnitLower>().adjoint().solveInPlace(dest.middleRows(first, ncols));
+    else
+      S.topRows(ncols).template triangularView<Lower>().adjoint().solveInPlace(dest.middleRows(first, ncols));
+  }
+
+  dest = this->m_Pinv * dest;
+}
+
+/** \ingroup SparseCholesky_Module
+  * \class SupernodalLLT
+  * \brief A supernodal sparse LLT Cholesky factorization
+  *
+  * This class provides a LL^T Cholesky factorization of sparse matrices that are selfadjoint and positive
+  * definite, computed by the supernodal algorithm described in SupernodalCholeskyBase. The factorization is
+  * computed on \f$ P A P^{-1} \f$, where P is a fill-reducing permutation.
+  *
+  * \tparam _MatrixType the type of the sparse matrix A, it must be a SparseMatrix<>
+  * \tparam _UpLo the triangular part that will be used for the computations. It can be Lower
+  *               or Upper. Default is Lower.
+  * \tparam _Ordering the fill-reducing ordering method, AMDOrdering by default
+  *
+  * \sa class SupernodalLDLT, class SimplicialLLT
+  */
+template<typename _MatrixType, int _UpLo, typename _Ordering>
+class SupernodalLLT : public SupernodalCholeskyBase<SupernodalLLT<_MatrixType,_UpLo,_Ordering> >
+{
+  public:
+    typedef _MatrixType MatrixType;
+    enum { DoLDLT = false };
+    typedef SupernodalCholeskyBase<SupernodalLLT> Base;
+
+    /** Default constructor */
+    SupernodalLLT() : Base() {}
+    /** Constructs and performs the LLT factorization of \a matrix */
+    SupernodalLLT(const MatrixType& matrix) : Base() { Base::compute(matrix); }
+};
+
+/** \ingroup SparseCholesky_Module
+  * \class SupernodalLDLT
+  * \brief A supernodal sparse LDLT Cholesky factorization without square root
+  *
+  * This class provides a LDL^T Cholesky factorization without square root of sparse matrices that are
+  * selfadjoint, computed by the supernodal algorithm described in SupernodalCholeskyBase. Since no pivoting
+  * is performed, the matrix must be such that all pivots are nonzero, which is the case for positive
+  * definite matrices.
+  *
+  * \tparam _MatrixType the type of the sparse matrix A, it must be a SparseMatrix<>
+  * \tparam _UpLo the triangular part that will be used for the computations. It can be Lower
+  *               or Upper. Default is Lower.
+  * \tparam _Ordering the fill-reducing ordering method, AMDOrdering by default
+  *
+  * \sa class SupernodalLLT, class SimplicialLDLT
+  */
+template<typename _MatrixType, int _UpLo, typename _Ordering>
+class SupernodalLDLT : public SupernodalCholeskyBase<SupernodalLDLT<_MatrixType,_UpLo,_Ordering> >
+{
+  public:
+    typedef _MatrixType MatrixType;
+    enum { DoLDLT = true };
+    typedef SupernodalCholeskyBase<SupernodalLDLT> Base;
+
+    /** Default constructor */
+    SupernodalLDLT() : Base() {}
+    /** Constructs and performs the LDLT factorization of \a matrix */
+    SupernodalLDLT(const MatrixType& matrix) : Base() { Base::compute(matrix); }
+};
+
+#endif // EIGEN_SUPERNODAL_CHOLESKY_H
@@ -0,0 +1,447 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_SPARSE_LU_H
+#define EIGEN_SPARSE_LU_H
+
+/** \ingroup SparseLU_Module
+  * \class SparseLU
+  * \brief Sparse LU decomposition with partial pivoting
+  *
+  * This class computes a LU decomposition \f$ P A Q = L U \f$ of a general square sparse matrix A, where
+  * Q is a fill-reducing column permutation computed by analyzePattern(), P is a row permutation chosen
+  * during the numerical factorization by threshold partial pivoting, L is unit lower triangular and U is
+  * upper triangular.
+  *
+  * The factorization is computed column by column with the left-looking algorithm of Gilbert and Peierls:
+  * each column of L and U is obtained by a sparse triangular solve with the columns of L already computed,
+  * whose nonzero pattern is found beforehand by a depth-first search, so that the cost is proportional to
+  * the number of floating point operations.
+  *
+  * When the diagonal entry of the current column is at least \c threshold times the largest candidate
+  * pivot, it is preferred to it, which preserves the fill-reducing ordering on diagonally dominant
+  * matrices. The threshold is 1 by default (standard partial pivoting), and can be changed by
+  * setPivotThreshold().
+  *
+  * \tparam _MatrixType the type of the sparse matrix A, it must be a SparseMatrix<>
+  * \tparam _Ordering the fill-reducing column ordering method, COLAMDOrdering by default
+  *
+  * \sa class SimplicialLLT, class SupernodalLLT
+  */
+template<typename _MatrixType, typename _Ordering = COLAMDOrdering<typename _MatrixType::Index> >
+class SparseLU
+{
+  public:
+    typedef _MatrixType MatrixType;
+    typedef _Ordering OrderingType;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::RealScalar RealScalar;
+    typedef typename MatrixType::Index Index;
+    typedef SparseMatrix<Scalar,ColMajor,Index> FactorType;
+    typedef Matrix<Scalar,Dynamic,1> VectorType;
+    typedef Matrix<Index,Dynamic,1> VectorI;
+    typedef PermutationMatrix<Dynamic,Dynamic,Index> PermutationType;
+
+    /** Default constructor */
+    SparseLU()
+      : m_info(Success), m_isInitialized(false), m_analysisIsOk(false), m_factorizationIsOk(false),
+        m_size(0), m_threshold(1)
+    {}
+
+    /** Constructs and performs the LU factorization of \a matrix */
+    SparseLU(const MatrixType& matrix)
+      : m_info(Success), m_isInitialized(false), m_analysisIsOk(false), m_factorizationIsOk(false),
+        m_size(0), m_threshold(1)
+    {
+      compute(matrix);
+    }
+
+    inline Index rows() const { return m_size; }
+    inline Index cols() const { return m_size; }
+
+    /** Sets the threshold of the partial pivoting: the diagonal entry of a column is chosen as pivot when
+      * its magnitude is at least \a threshold times the largest magnitude of the candidate pivots.
+      * The threshold must be in ]0,1], the default value 1 corresponds to the standard partial pivoting. */
+    SparseLU& setPivotThreshold(const RealScalar& threshold)
+    {
+      eigen_assert(threshold > RealScalar(0) && threshold <= RealScalar(1));
+      m_threshold = threshold;
+      return *this;
+    }
+
+    /** \brief Reports whether previous computation was successful.
+      *
+      * \returns \c Success if computation was succesful,
+      *          \c NumericalIssue if the matrix is structurally or numerically singular.
+      */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_isInitialized && "Decomposition is not initialized.");
+      return m_info;
+    }
+
+    /** Computes the LU decomposition of \a matrix, which is equivalent to analyzePattern(matrix) followed
+      * by factorize(matrix). */
+    SparseLU& compute(const MatrixType& matrix)
+    {
+      analyzePattern(matrix);
+      factorize(matrix);
+      return *this;
+    }
+
+    /** Computes the fill-reducing column permutation of \a matrix. Only the sparsity pattern of \a matrix
+      * is used, so that the result can be reused by factorize() for any matrix with the same pattern.
+      *
+      * \sa factorize()
+      */
+    void analyzePattern(const MatrixType& matrix)
+    {
+      eigen_assert(matrix.rows()==matrix.cols() && "SparseLU: the matrix must be square");
+      m_size = matrix.cols();
+      OrderingType ordering;
+      ordering(matrix, m_colsPermutation);
+      m_isInitialized = true;
+      m_info = Success;
+      m_analysisIsOk = true;
+      m_factorizationIsOk = false;
+    }
+
+    /** Performs the numerical factorization of \a matrix, using the column permutation computed by
+      * analyzePattern().
+      *
+      * \sa analyzePattern()
+      */
+    void factorize(const MatrixType& matrix);
+
+    /** \returns the solution x of \f$ A x = b \f$ using the current decomposition of A.
+      *
+      * \sa compute()
+      */
+    template<typename Rhs>
+    inline const internal::solve_retval<SparseLU, Rhs>
+    solve(const MatrixBase<Rhs>& b) const
+    {
+      eigen_assert(m_isInitialized && "SparseLU is not initialized.");
+      eigen_assert(rows()==b.rows()
+                && "SparseLU::solve(): invalid number of rows of the right hand side matrix b");
+      return internal::solve_retval<SparseLU, Rhs>(*this, b.derived());
+    }
+
+    /** \returns the strictly lower triangular part of the unit lower triangular factor L */
+    const FactorType& matrixL() const
+    {
+      eigen_assert(m_factorizationIsOk && "SparseLU is not factorized.");
+      return m_L;
+    }
+
+    /** \returns the upper triangular factor U */
+    const FactorType& matrixU() const
+    {
+      eigen_assert(m_factorizationIsOk && "SparseLU is not factorized.");
+      return m_U;
+    }
+
+    /** \returns the row permutation P */
+    const PermutationType& rowsPermutation() const
+    {
+      eigen_assert(m_factorizationIsOk && "SparseLU is not factorized.");
+      return m_rowsPermutation;
+    }
+
+    /** \returns the column permutation Q */
+    const PermutationType& colsPermutation() const
+    {
+      eigen_assert(m_isInitialized && "SparseLU is not initialized.");
+      return m_colsPermutation;
+    }
+
+    /** \internal */
+    template<typename Rhs, typename Dest>
+    void _solve(const Rhs& b, Dest& dest) const;
+
+  protected:
+
+    Index reach(const MatrixType& matrix, Index col, const Index* pinv, VectorI& stack, VectorI& work);
+
+    mutable ComputationInfo m_info;
+    bool m_isInitialized;
+    bool m_analysisIsOk;
+    bool m_factorizationIsOk;
+    Index m_size;
+    RealScalar m_threshold;
+
+    FactorType m_L;                   // strictly lower part of L, in pivot order
+    FactorType m_U;                   // U, with the diagonal entry stored last in each column
+    PermutationType m_rowsPermutation;
+    PermutationType m_colsPermutation;
+
+    // the columns of L while they are being computed, with the original row indices
+    std::vector<Index> m_Lp, m_Li;
+    std::vector<Scalar> m_Lx;
+};
+
+/** \internal
+  * Computes the nonzero pattern of the solution of L x = A(:,col) by a non-recursive depth-first search in
+  * the graph of the columns of L already computed, and stores it in topological order in stack[size+top:2*size-1].
+  * \returns top
+  */
+template<typename _MatrixType, typename _Ordering>
+typename SparseLU<_MatrixType,_Ordering>::Index
+SparseLU<_MatrixType,_Ordering>::reach(const MatrixType& matrix, Index col, const Index* pinv, VectorI& stack, VectorI& work)
+{
+  const Index size = m_size;
+  // work[0:size-1] marks the visited rows (with the column being computed), work[size:2*size-1] is the
+  // position of the next child to visit of the nodes of the dfs stack, stored in stack[0:size-1]
+  Index* mark = work.data();
+  Index* childPos = work.data() + size;
+  Index* dfs = stack.data();
+  Index* out = stack.data() + size;
+  Index top = size;
+  for(typename MatrixType::InnerIterator it(matrix,col); it; ++it)
+  {
+    Index r = it.index();
+    if(mark[r] == col)
+      continue;
+    Index head = 0;
+    dfs[0] = r;
+    while(head >= 0)
+    {
+      Index i = dfs[head];
+      Index j = pinv[i];
+      if(mark[i] != col)
+      {
+        mark[i] = col;
+        childPos[i] = j < 0 ? 0 : m_Lp[j];
+      }
+      bool done = true;
+      if(j >= 0)
+      {
+        Index end = m_Lp[j+1];
+        for(Index p = childPos[i]; p < end; ++p)
+        {
+          Index c = m_Li[p];
+          if(mark[c] == col)
+            continue;
+          childPos[i] = p+1;
+          dfs[++head] = c;
+          done = false;
+          break;
+        }
+      }
+      if(done)
+      {
+        --head;
+        out[--top] = i;
+      }
+    }
+  }
+  return top;
+}
+
+template<typename _MatrixType, typename _Ordering>
+void SparseLU<_MatrixType,_Ordering>::factorize(const MatrixType& matrix)
+{
+  eigen_assert(m_analysisIsOk && "You must first call analyzePattern()");
+  eigen_assert(matrix.rows()==m_size && matrix.cols()==m_size);
+  using std::abs;
+  const Index size = m_size;
+  const Index* q = m_colsPermutation.indices().data();
+
+  VectorI pinv = VectorI::Constant(size, -1);
+  VectorI stack(2*size), work(2*size);
+  work.head(size).setConstant(-1);
+  VectorType x = VectorType::Zero(size);
+
+  const Index estimatedNnz = 4*matrix.nonZeros() + size;
+  m_Lp.assign(1, 0); m_Li.clear(); m_Lx.clear();
+  m_Lp.reserve(size+1); m_Li.reserve(estimatedNnz); m_Lx.reserve(estimatedNnz);
+  std::vector<Index> Up(1, 0), Ui;
+  std::vector<Scalar> Ux;
+  Up.reserve(size+1); Ui.reserve(estimatedNnz); Ux.reserve(estimatedNnz);
+
+  m_info = Success;
+  for(Index k = 0; k < size; ++k)
+  {
+    const Index col = q[k];
+
+    // x = L \ A(:,col)
+    const Index top = reach(matrix, col, pinv.data(), stack, work);
+    const Index* pattern = stack.data() + size;
+    for(typename MatrixType::InnerIterator it(matrix,col); it; ++it)
+      x[it.index()] += it.value();
+    for(Index t = top; t < size; ++t)
+    {
+      Index i = pattern[t];
+      Index j = pinv[i];
+      if(j < 0)
+        continue;
+      // the first entry of each column of L is its unit diagonal
+      const Scalar xi = x[i];
+      for(Index p = m_Lp[j]+1; p < m_Lp[j+1]; ++p)
+        x[m_Li[p]] -= m_Lx[p] * xi;
+    }
+
+    // find the pivot among the rows not pivoted yet, and store the column of U
+    Index ipiv = -1;
+    RealScalar maxAbs = -1;
+    for(Index t = top; t < size; ++t)
+    {
+      Index i = pattern[t];
+      if(pinv[i] < 0)
+      {
+        RealScalar a = abs(x[i]);
+        if(a > maxAbs)
+        {
+          maxAbs = a;
+          ipiv = i;
+        }
+      }
+      else
+      {
+        Ui.push_back(pinv[i]);
+        Ux.push_back(x[i]);
+      }
+    }
+    if(ipiv == -1 || maxAbs <= RealScalar(0))
+    {
+      m_info = NumericalIssue;
+      break;
+    }
+    if(pinv[col] < 0 && work[col] == col && abs(x[col]) >= m_threshold * maxAbs)
+      ipiv = col;
+
+    const Scalar pivot = x[ipiv];
+    Ui.push_back(k);
+    Ux.push_back(pivot);
+    Up.push_back(Index(Ui.size()));
+    pinv[ipiv] = k;
+
+    // store the column of L, and clear x
+    m_Li.push_back(ipiv);
+    m_Lx.push_back(Scalar(1));
+    for(Index t = top; t < size; ++t)
+    {
+      Index i = pattern[t];
+      if(pinv[i] < 0)
+      {
+        m_Li.push_back(i);
+        m_Lx.push_back(x[i] / pivot);
+      }
+      x[i] = Scalar(0);
+    }
+    m_Lp.push_back(Index(m_Li.size()));
+  }
+
+  if(m_info == Success)
+  {
+    // renumber the rows of L in pivot order, and drop its unit diagonal
+    m_L.resize(size, size);
+    m_L.resizeNonZeros(Index(m_Li.size()) - size);
+    Index* Lp = m_L._outerIndexPtr();
+    Index* Li = m_L._innerIndexPtr();
+    Scalar* Lx = m_L._valuePtr();
+    Lp[0] = 0;
+    for(Index j = 0; j < size; ++j)
+    {
+      Index count = Lp[j];
+      for(Index p = m_Lp[j]+1; p < m_Lp[j+1]; ++p, ++count)
+      {
+        Li[count] = pinv[m_Li[p]];
+        Lx[count] = m_Lx[p];
+      }
+      Lp[j+1] = count;
+    }
+
+    m_U.resize(size, size);
+    m_U.resizeNonZeros(Index(Ui.size()));
+    std::copy(Up.begin(), Up.end(), m_U._outerIndexPtr());
+    std::copy(Ui.begin(), Ui.end(), m_U._innerIndexPtr());
+    std::copy(Ux.begin(), Ux.end(), m_U._valuePtr());
+
+    m_rowsPermutation.indices() = pinv;
+  }
+
+  // release the working copy of L
+  std::vector<Index>().swap(m_Li);
+  std::vector<Scalar>().swap(m_Lx);
+  std::vector<Index>().swap(m_Lp);
+
+  m_factorizationIsOk = true;
+}
+
+template<typename _MatrixType, typename _Ordering>
+template<typename Rhs, typename Dest>
+void SparseLU<_MatrixType,_Ordering>::_solve(const Rhs& b, Dest& dest) const
+{
+  eigen_assert(m_factorizationIsOk && "The decomposition is not in a valid state for solving, you must first call either compute() or analyzePattern()/factorize()");
+  eigen_assert(m_size==b.rows());
+
+  if(m_info!=Success)
+    return;
+
+  const Index size = m_size;
+  const Index* Lp = m_L._outerIndexPtr();
+  const Index* Li = m_L._innerIndexPtr();
+  const Scalar* Lx = m_L._valuePtr();
+  const Index* Up = m_U._outerIndexPtr();
+  const Index* Ui = m_U._innerIndexPtr();
+  const Scalar* Ux = m_U._valuePtr();
+
+  VectorType y(size);
+  for(Index c = 0; c < b.cols(); ++c)
+  {
+    y = m_rowsPermutation * b.col(c);
+    for(Index j = 0; j < size; ++j)
+    {
+      const Scalar yj = y[j];
+      for(Index p = Lp[j]; p < Lp[j+1]; ++p)
+        y[Li[p]] -= Lx[p] * yj;
+    }
+    for(Index j = size-1; j >= 0; --j)
+    {
+      y[j] /= Ux[Up[j+1]-1];
+      const Scalar yj = y[j];
+      for(Index p = Up[j]; p < Up[j+1]-1; ++p)
+        y[Ui[p]] -= Ux[p] * yj;
+    }
+    dest.col(c) = m_colsPermutation * y;
+  }
+}
+
+namespace internal {
+
+template<typename _MatrixType, typename _Ordering, typename Rhs>
+struct solve_retval<SparseLU<_MatrixType,_Ordering>, Rhs>
+  : solve_retval_base<SparseLU<_MatrixType,_Ordering>, Rhs>
+{
+  typedef SparseLU<_MatrixType,_Ordering> Dec;
+  EIGEN_MAKE_SOLVE_HELPERS(Dec,Rhs)
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    dec()._solve(rhs(),dst);
+  }
+};
+
+} // end namespace internal
+
+#endif // EIGEN_SPARSE_LU_H
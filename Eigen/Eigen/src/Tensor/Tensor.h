@@ -0,0 +1,252 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_TENSOR_H
+#define EIGEN_TENSOR_H
+
+namespace internal {
+template<typename _Scalar, int _NumIndices>
+struct traits<Tensor<_Scalar,_NumIndices> >
+{
+  typedef _Scalar Scalar;
+  typedef DenseIndex Index;
+  enum {
+    NumDimensions = _NumIndices,
+    Flags = LvalueBit | DirectAccessBit | AlignedBit | (packet_traits<_Scalar>::Vectorizable ? PacketAccessBit : 0)
+  };
+};
+}
+
+/** \ingroup Tensor_Module
+  * \brief A dense tensor of arbitrary rank
+  *
+  * \tparam _Scalar the type of the coefficients
+  * \tparam _NumIndices the rank of the tensor, that is its number of dimensions
+  *
+  * The dimensions are set at runtime, and the coefficients are stored in a contiguous aligned buffer
+  * with the first index varying fastest, as in a column-major matrix. A tensor of rank 2 therefore has
+  * the layout of a MatrixXf, and a Map can view its data as a matrix:
+  * \code
+  * Tensor<float,3> t(64, 32, 16);
+  * t.setRandom();
+  * t(1, 2, 3) = 4;
+  * Tensor<float,2> s = t.slice(DSizes<DenseIndex,3>(0,0,8), DSizes<DenseIndex,3>(64,32,1))
+  *                      .reshape(DSizes<DenseIndex,2>(64,32));
+  * \endcode
+  *
+  * The constructors and the accessors taking the indices one by one are provided up to rank 6. The
+  * tensors of higher rank are built and accessed with a DSizes.
+  *
+  * \sa class TensorBase, class TensorMap
+  */
+template<typename _Scalar, int _NumIndices>
+class Tensor : public TensorBase<Tensor<_Scalar,_NumIndices> >
+{
+  public:
+    typedef TensorBase<Tensor> Base;
+    typedef typename Base::Scalar Scalar;
+    typedef typename Base::Index Index;
+    typedef typename Base::Packet Packet;
+    typedef typename Base::Dimensions Dimensions;
+    enum { NumIndices = _NumIndices };
+
+    /** Constructs an empty tensor, of dimensions all zero. */
+    inline Tensor() : m_data(0) {}
+
+    /** Constructs an uninitialized tensor of dimensions \a dims. */
+    explicit inline Tensor(const Dimensions& dims) : m_data(0) { resize(dims); }
+
+    explicit inline Tensor(Index d0) : m_data(0) { resize(Dimensions(d0)); }
+    inline Tensor(Index d0, Index d1) : m_data(0) { resize(Dimensions(d0, d1)); }
+    inline Tensor(Index d0, Index d1, Index d2) : m_data(0) { resize(Dimensions(d0, d1, d2)); }
+    inline Tensor(Index d0, Index d1, Index d2, Index d3) : m_data(0) { resize(Dimensions(d0, d1, d2, d3)); }
+    inline Tensor(Index d0, Index d1, Index d2, Index d3, Index d4) : m_data(0)
+    { resize(Dimensions(d0, d1, d2, d3, d4)); }
+    inline Tensor(Index d0, Index d1, Index d2, Index d3, Index d4, Index d5) : m_data(0)
+    { resize(Dimensions(d0, d1, d2, d3, d4, d5)); }
+
+    inline Tensor(const Tensor& other) : Base(), m_data(0)
+    {
+      resize(other.dimensions());
+      std::copy(other.m_data, other.m_data + size(), m_data);
+    }
+
+    /** Constructs a tensor from the evaluation of the expression \a other. */
+    template<typename OtherDerived>
+    inline Tensor(const TensorBase<OtherDerived>& other) : m_data(0)
+    {
+      resize(other.derived().dimensions());
+      internal::tensor_assign(*this, other.derived());
+    }
+
+    inline ~Tensor()
+    {
+      internal::conditional_aligned_delete_auto<Scalar,true>(m_data, size());
+    }
+
+    inline Tensor& operator=(const Tensor& other)
+    {
+      if(this != &other)
+      {
+        resize(other.dimensions());
+        std::copy(other.m_data, other.m_data + size(), m_data);
+      }
+      return *this;
+    }
+
+    /** Resizes *this to the dimensions of \a other and evaluates it. */
+    template<typename OtherDerived>
+    inline Tensor& operator=(const TensorBase<OtherDerived>& other)
+    {
+      if(!(other.derived().dimensions() == m_dimensions))
+      {
+        // \a other may read *this, whose dimensions and buffer must not change before it is evaluated
+        Tensor tmp(other);
+        swap(tmp);
+        return *this;
+      }
+      internal::tensor_assign(*this, other.derived());
+      return *this;
+    }
+
+    template<typename OtherDerived>
+    inline Tensor& operator+=(const TensorBase<OtherDerived>& other)
+    {
+      internal::tensor_assign(*this, *this + other.derived());
+      return *this;
+    }
+
+    template<typename OtherDerived>
+    inline Tensor& operator-=(const TensorBase<OtherDerived>& other)
+    {
+      internal::tensor_assign(*this, *this - other.derived());
+      return *this;
+    }
+
+    inline Tensor& operator*=(const Scalar& scalar)
+    {
+      internal::tensor_assign(*this, *this * scalar);
+      return *this;
+    }
+
+    /** Resizes *this to the dimensions \a dims. The coefficients are left uninitialized, and are kept only
+      * if the total size does not change. */
+    void resize(const Dimensions& dims)
+    {
+      const Index newSize = dims.totalSize();
+      eigen_assert(newSize >= 0);
+      if(newSize != size())
+      {
+        internal::conditional_aligned_delete_auto<Scalar,true>(m_data, size());
+        m_data = newSize ? internal::conditional_aligned_new_auto<Scalar,true>(newSize) : 0;
+      }
+      m_dimensions = dims;
+    }
+
+    inline void resize(Index d0) { resize(Dimensions(d0)); }
+    inline void resize(Index d0, Index d1) { resize(Dimensions(d0, d1)); }
+    inline void resize(Index d0, Index d1, Index d2) { resize(Dimensions(d0, d1, d2)); }
+    inline void resize(Index d0, Index d1, Index d2, Index d3) { resize(Dimensions(d0, d1, d2, d3)); }
+    inline void resize(Index d0, Index d1, Index d2, Index d3, Index d4) { resize(Dimensions(d0, d1, d2, d3, d4)); }
+    inline void resize(Index d0, Index d1, Index d2, Index d3, Index d4, Index d5)
+    { resize(Dimensions(d0, d1, d2, d3, d4, d5)); }
+
+    /** Swaps the coefficients and dimensions of *this and \a other, without copying them. */
+    inline void swap(Tensor& other)
+    {
+      std::swap(m_data, other.m_data);
+      std::swap(m_dimensions, other.m_dimensions);
+    }
+
+    inline const Dimensions& dimensions() const { return m_dimensions; }
+    inline Index size() const { return m_dimensions.totalSize(); }
+
+    inline Scalar* data() { return m_data; }
+    inline const Scalar* data() const { return m_data; }
+
+    inline const Scalar& coeff(Index index) const { return m_data[index]; }
+    inline Scalar& coeffRef(Index index) { return m_data[index]; }
+
+    template<int LoadMode>
+    inline Packet packet(Index index) const
+    { return internal::ploadt<Packet, LoadMode>(m_data + index); }
+
+    template<int StoreMode>
+    inline void writePacket(Index index, const Packet& x)
+    { internal::pstoret<Scalar, Packet, StoreMode>(m_data + index, x); }
+
+    inline Index costPerCoeff() const { return NumTraits<Scalar>::ReadCost; }
+
+    /** \returns the coefficient at the position \a indices */
+    inline const Scalar& operator()(const Dimensions& indices) const { return m_data[linearIndex(indices)]; }
+    inline Scalar& operator()(const Dimensions& indices) { return m_data[linearIndex(indices)]; }
+
+    inline const Scalar& operator()(Index i0) const { return (*this)(Dimensions(i0)); }
+    inline const Scalar& operator()(Index i0, Index i1) const { return (*this)(Dimensions(i0, i1)); }
+    inline const Scalar& operator()(Index i0, Index i1, Index i2) const { return (*this)(Dimensions(i0, i1, i2)); }
+    inline const Scalar& operator()(Index i0, Index i1, Index i2, Index i3) const
+    { return (*this)(Dimensions(i0, i1, i2, i3)); }
+    inline const Scalar& operator()(Index i0, Index i1, Index i2, Index i3, Index i4) const
+    { return (*this)(Dimensions(i0, i1, i2, i3, i4)); }
+    inline const Scalar& operator()(Index i0, Index i1, Index i2, Index i3, Index i4, Index i5) const
+    { return (*this)(Dimensions(i0, i1, i2, i3, i4, i5)); }
+
+    inline Scalar& operator()(Index i0) { return (*this)(Dimensions(i0)); }
+    inline Scalar& operator()(Index i0, Index i1) { return (*this)(Dimensions(i0, i1)); }
+    inline Scalar& operator()(Index i0, Index i1, Index i2) { return (*this)(Dimensions(i0, i1, i2)); }
+    inline Scalar& operator()(Index i0, Index i1, Index i2, Index i3) { return (*this)(Dimensions(i0, i1, i2, i3)); }
+    inline Scalar& operator()(Index i0, Index i1, Index i2, Index i3, Index i4)
+    { return (*this)(Dimensions(i0, i1, i2, i3, i4)); }
+    inline Scalar& operator()(Index i0, Index i1, Index i2, Index i3, Index i4, Index i5)
+    { return (*this)(Dimensions(i0, i1, i2, i3, i4, i5)); }
+
+    inline Tensor& setConstant(const Scalar& value)
+    {
+      std::fill(m_data, m_data + size(), value);
+      return *this;
+    }
+    inline Tensor& setZero() { return setConstant(Scalar(0)); }
+    /** Sets the coefficients to random values, as DenseBase::setRandom(). */
+    inline Tensor& setRandom()
+    {
+      for(Index i = 0; i < size(); ++i)
+        m_data[i] = internal::random<Scalar>();
+      return *this;
+    }
+
+  protected:
+    inline Index linearIndex(const Dimensions& indices) const
+    {
+      Index index = 0;
+      for(int i = NumIndices-1; i >= 0; --i)
+      {
+        eigen_assert(indices[i] >= 0 && indices[i] < m_dimensions[i]);
+        index = index * m_dimensions[i] + indices[i];
+      }
+      return index;
+    }
+
+    Scalar* m_data;
+    Dimensions m_dimensions;
+};
+
+#endif // EIGEN_TENSOR_H
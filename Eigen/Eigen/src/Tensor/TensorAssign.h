@@ -0,0 +1,129 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_TENSORASSIGN_H
+#define EIGEN_TENSORASSIGN_H
+
+namespace internal {
+
+template<typename Dst, typename Src,
+         bool Vectorize = (traits<Dst>::Flags & traits<Src>::Flags & PacketAccessBit)
+                       && is_same<typename traits<Dst>::Scalar, typename traits<Src>::Scalar>::value>
+struct tensor_assign_kernel;
+
+template<typename Dst, typename Src>
+struct tensor_assign_kernel<Dst,Src,false>
+{
+  typedef typename traits<Dst>::Index Index;
+
+  tensor_assign_kernel(Dst& dst, const Src& src) : m_dst(dst), m_src(src) {}
+
+  void initParallelSession(Index) {}
+
+  void operator()(Index first, Index last, Index)
+  {
+    for(Index i = first; i < last; ++i)
+      m_dst.coeffRef(i) = m_src.coeff(i);
+  }
+
+  Dst& m_dst;
+  const Src& m_src;
+};
+
+template<typename Dst, typename Src>
+struct tensor_assign_kernel<Dst,Src,true>
+{
+  typedef typename traits<Dst>::Index Index;
+  enum {
+    PacketSize = packet_traits<typename traits<Dst>::Scalar>::size,
+    StoreMode = traits<Dst>::Flags & AlignedBit ? Aligned : Unaligned,
+    LoadMode = traits<Src>::Flags & AlignedBit ? Aligned : Unaligned
+  };
+
+  tensor_assign_kernel(Dst& dst, const Src& src) : m_dst(dst), m_src(src) {}
+
+  void initParallelSession(Index) {}
+
+  // first is either 0 or a multiple of 16, so that the packets are aligned
+  void operator()(Index first, Index last, Index)
+  {
+    const Index alignedEnd = first + ((last-first)/PacketSize)*PacketSize;
+    Index i = first;
+    for(; i < alignedEnd; i += PacketSize)
+      m_dst.template writePacket<StoreMode>(i, m_src.template packet<LoadMode>(i));
+    for(; i < last; ++i)
+      m_dst.coeffRef(i) = m_src.coeff(i);
+  }
+
+  Dst& m_dst;
+  const Src& m_src;
+};
+
+template<typename Dst, typename Src>
+struct tensor_assign_selector
+{
+  static void run(Dst& dst, const Src& src)
+  {
+    typedef typename traits<Dst>::Index Index;
+    eigen_assert(dst.dimensions() == src.dimensions());
+    tensor_assign_kernel<Dst,Src> kernel(dst, src);
+    const Index size = dst.size();
+    if(!parallelize_range(kernel, size, src.costPerCoeff()))
+      kernel(0, size, 0);
+  }
+};
+
+/** \internal Evaluates the tensor expression \a src into \a dst, which has the same dimensions */
+template<typename Dst, typename Src>
+void tensor_assign(Dst& dst, const Src& src)
+{
+  tensor_assign_selector<Dst,Src>::run(dst, src);
+}
+
+// loads a packet of an expression without packet access to its coefficients, such as a slice crossing the
+// boundary of its first dimension
+template<typename Packet, typename XprType>
+inline Packet tensor_gather_packet(const XprType& xpr, typename XprType::Index index)
+{
+  typedef typename XprType::Scalar Scalar;
+  enum { PacketSize = packet_traits<Scalar>::size };
+  EIGEN_ALIGN16 Scalar values[PacketSize];
+  for(int k = 0; k < PacketSize; ++k)
+    values[k] = xpr.coeff(index+k);
+  return pload<Packet>(values);
+}
+
+// the converse of tensor_gather_packet()
+template<typename Packet, typename XprType>
+inline void tensor_scatter_packet(XprType& xpr, typename XprType::Index index, const Packet& x)
+{
+  typedef typename XprType::Scalar Scalar;
+  enum { PacketSize = packet_traits<Scalar>::size };
+  EIGEN_ALIGN16 Scalar values[PacketSize];
+  pstore(values, x);
+  for(int k = 0; k < PacketSize; ++k)
+    xpr.coeffRef(index+k) = values[k];
+}
+
+} // end namespace internal
+
+#endif // EIGEN_TENSORASSIGN_H
@@ -0,0 +1,278 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_TENSORBASE_H
+#define EIGEN_TENSORBASE_H
+
+template<typename _Scalar, int _NumIndices> class Tensor;
+template<typename PlainTensorType, int MapOptions = Unaligned> class TensorMap;
+template<typename UnaryOp, typename XprType> class TensorCwiseUnaryOp;
+template<typename BinaryOp, typename LhsXprType, typename RhsXprType> class TensorCwiseBinaryOp;
+template<typename XprType> class TensorSlicingOp;
+template<int NumDims, typename XprType> class TensorReshapingOp;
+template<typename XprType> class TensorShufflingOp;
+template<typename Reducer, int NumReduced, typename XprType> class TensorReductionOp;
+template<int NumContracted, typename LhsXprType, typename RhsXprType> class TensorContractionOp;
+
+namespace internal {
+
+template<typename Scalar> struct tensor_sum_reducer;
+template<typename Scalar> struct tensor_mean_reducer;
+template<typename Scalar> struct tensor_prod_reducer;
+template<typename Scalar> struct tensor_max_reducer;
+template<typename Scalar> struct tensor_min_reducer;
+
+template<typename Dst, typename Src> void tensor_assign(Dst& dst, const Src& src);
+template<typename XprType, typename Reducer>
+typename XprType::Scalar tensor_full_reduce(const XprType& xpr, const Reducer& reducer);
+
+// how an expression is stored by the expressions using it: plain tensors by reference, the other
+// expressions by value, and the contractions as their evaluated result
+template<typename T> struct tensor_nested { typedef T type; };
+template<typename Scalar, int NumIndices> struct tensor_nested<Tensor<Scalar,NumIndices> >
+{ typedef Tensor<Scalar,NumIndices>& type; };
+template<typename Scalar, int NumIndices> struct tensor_nested<const Tensor<Scalar,NumIndices> >
+{ typedef const Tensor<Scalar,NumIndices>& type; };
+
+} // end namespace internal
+
+/** \internal Defines the assignment operators of a writable tensor expression, which copy the coefficients */
+#define EIGEN_TENSOR_INHERIT_ASSIGNMENT_OPERATORS(Derived) \
+  inline Derived& operator=(const Derived& other) \
+  { \
+    internal::tensor_assign(*this, other); \
+    return *this; \
+  } \
+  template<typename OtherDerived> \
+  inline Derived& operator=(const TensorBase<OtherDerived>& other) \
+  { \
+    internal::tensor_assign(*this, other.derived()); \
+    return *this; \
+  }
+
+/** \ingroup Tensor_Module
+  * \brief Base class of the tensors and tensor expressions
+  *
+  * \param Derived the type of the tensor or expression
+  *
+  * Every tensor expression has dimensions() and gives access to its coefficients in the storage order of
+  * class Tensor, first index varying fastest, through coeff(Index) and packet<LoadMode>(Index). The writable
+  * ones also have coeffRef(Index) and writePacket<StoreMode>(Index,Packet).
+  *
+  * The expressions are evaluated when they are assigned to a Tensor, a TensorMap or a writable expression
+  * such as a slice. As for matrices, the destination is assumed not to alias the operands, except for
+  * coefficient-wise expressions, contractions, and assignments which change the dimensions of a Tensor: use
+  * eval() to assign, say, a transposing shuffle of a square matrix to itself.
+  *
+  * \sa class Tensor, class TensorMap
+  */
+template<typename Derived>
+class TensorBase
+{
+  public:
+    typedef typename internal::traits<Derived>::Scalar Scalar;
+    typedef typename internal::traits<Derived>::Index Index;
+    typedef typename NumTraits<Scalar>::Real RealScalar;
+    typedef typename internal::packet_traits<Scalar>::type Packet;
+    enum {
+      NumDimensions = internal::traits<Derived>::NumDimensions,
+      Flags = internal::traits<Derived>::Flags,
+      PacketSize = internal::packet_traits<Scalar>::size
+    };
+    typedef DSizes<Index,NumDimensions> Dimensions;
+    typedef Tensor<Scalar,NumDimensions> PlainObject;
+
+    inline Derived& derived() { return *static_cast<Derived*>(this); }
+    inline const Derived& derived() const { return *static_cast<const Derived*>(this); }
+
+    /** \returns the number of dimensions */
+    static inline int rank() { return NumDimensions; }
+    /** \returns the \a i-th dimension */
+    inline Index dimension(int i) const { return derived().dimensions()[i]; }
+    /** \returns the number of coefficients */
+    inline Index size() const { return derived().dimensions().totalSize(); }
+
+    /** \returns the expression evaluated into a Tensor */
+    inline PlainObject eval() const { return PlainObject(derived()); }
+
+    /** \returns an expression of the coefficient-wise \a func applied to *this */
+    template<typename CustomUnaryOp>
+    inline const TensorCwiseUnaryOp<CustomUnaryOp, const Derived> unaryExpr(const CustomUnaryOp& func) const
+    { return TensorCwiseUnaryOp<CustomUnaryOp, const Derived>(derived(), func); }
+
+    /** \returns an expression of \a func applied coefficient-wise to *this and \a other */
+    template<typename CustomBinaryOp, typename OtherDerived>
+    inline const TensorCwiseBinaryOp<CustomBinaryOp, const Derived, const OtherDerived>
+    binaryExpr(const TensorBase<OtherDerived>& other, const CustomBinaryOp& func) const
+    { return TensorCwiseBinaryOp<CustomBinaryOp, const Derived, const OtherDerived>(derived(), other.derived(), func); }
+
+    inline const TensorCwiseUnaryOp<internal::scalar_opposite_op<Scalar>, const Derived> operator-() const
+    { return unaryExpr(internal::scalar_opposite_op<Scalar>()); }
+    inline const TensorCwiseUnaryOp<internal::scalar_abs_op<Scalar>, const Derived> abs() const
+    { return unaryExpr(internal::scalar_abs_op<Scalar>()); }
+    inline const TensorCwiseUnaryOp<internal::scalar_sqrt_op<Scalar>, const Derived> sqrt() const
+    { return unaryExpr(internal::scalar_sqrt_op<Scalar>()); }
+    inline const TensorCwiseUnaryOp<internal::scalar_square_op<Scalar>, const Derived> square() const
+    { return unaryExpr(internal::scalar_square_op<Scalar>()); }
+    inline const TensorCwiseUnaryOp<internal::scalar_inverse_op<Scalar>, const Derived> inverse() const
+    { return unaryExpr(internal::scalar_inverse_op<Scalar>()); }
+    inline const TensorCwiseUnaryOp<internal::scalar_exp_op<Scalar>, const Derived> exp() const
+    { return unaryExpr(internal::scalar_exp_op<Scalar>()); }
+    inline const TensorCwiseUnaryOp<internal::scalar_log_op<Scalar>, const Derived> log() const
+    { return unaryExpr(internal::scalar_log_op<Scalar>()); }
+    inline const TensorCwiseUnaryOp<internal::scalar_sin_op<Scalar>, const Derived> sin() const
+    { return unaryExpr(internal::scalar_sin_op<Scalar>()); }
+    inline const TensorCwiseUnaryOp<internal::scalar_cos_op<Scalar>, const Derived> cos() const
+    { return unaryExpr(internal::scalar_cos_op<Scalar>()); }
+    inline const TensorCwiseUnaryOp<internal::scalar_tanh_op<Scalar>, const Derived> tanh() const
+    { return unaryExpr(internal::scalar_tanh_op<Scalar>()); }
+
+    /** \returns an expression of *this with its coefficients cast to \a NewType */
+    template<typename NewType>
+    inline const TensorCwiseUnaryOp<internal::scalar_cast_op<Scalar,NewType>, const Derived> cast() const
+    { return unaryExpr(internal::scalar_cast_op<Scalar,NewType>()); }
+
+    inline const TensorCwiseUnaryOp<internal::scalar_multiple_op<Scalar>, const Derived> operator*(const Scalar& scalar) const
+    { return unaryExpr(internal::scalar_multiple_op<Scalar>(scalar)); }
+    friend inline const TensorCwiseUnaryOp<internal::scalar_multiple_op<Scalar>, const Derived>
+    operator*(const Scalar& scalar, const TensorBase& tensor)
+    { return tensor * scalar; }
+    inline const TensorCwiseUnaryOp<internal::scalar_quotient1_op<Scalar>, const Derived> operator/(const Scalar& scalar) const
+    { return unaryExpr(internal::scalar_quotient1_op<Scalar>(scalar)); }
+    inline const TensorCwiseUnaryOp<internal::scalar_add_op<Scalar>, const Derived> operator+(const Scalar& scalar) const
+    { return unaryExpr(internal::scalar_add_op<Scalar>(scalar)); }
+    inline const TensorCwiseUnaryOp<internal::scalar_add_op<Scalar>, const Derived> operator-(const Scalar& scalar) const
+    { return unaryExpr(internal::scalar_add_op<Scalar>(-scalar)); }
+
+    template<typename OtherDerived>
+    inline const TensorCwiseBinaryOp<internal::scalar_sum_op<Scalar>, const Derived, const OtherDerived>
+    operator+(const TensorBase<OtherDerived>& other) const
+    { return binaryExpr(other, internal::scalar_sum_op<Scalar>()); }
+    template<typename OtherDerived>
+    inline const TensorCwiseBinaryOp<internal::scalar_difference_op<Scalar>, const Derived, const OtherDerived>
+    operator-(const TensorBase<OtherDerived>& other) const
+    { return binaryExpr(other, internal::scalar_difference_op<Scalar>()); }
+    /** \returns an expression of the coefficient-wise product of *this and \a other, see contract() for tensor products */
+    template<typename OtherDerived>
+    inline const TensorCwiseBinaryOp<internal::scalar_product_op<Scalar,Scalar>, const Derived, const OtherDerived>
+    operator*(const TensorBase<OtherDerived>& other) const
+    { return binaryExpr(other, internal::scalar_product_op<Scalar,Scalar>()); }
+    template<typename OtherDerived>
+    inline const TensorCwiseBinaryOp<internal::scalar_quotient_op<Scalar>, const Derived, const OtherDerived>
+    operator/(const TensorBase<OtherDerived>& other) const
+    { return binaryExpr(other, internal::scalar_quotient_op<Scalar>()); }
+    template<typename OtherDerived>
+    inline const TensorCwiseBinaryOp<internal::scalar_max_op<Scalar>, const Derived, const OtherDerived>
+    cwiseMax(const TensorBase<OtherDerived>& other) const
+    { return binaryExpr(other, internal::scalar_max_op<Scalar>()); }
+    template<typename OtherDerived>
+    inline const TensorCwiseBinaryOp<internal::scalar_min_op<Scalar>, const Derived, const OtherDerived>
+    cwiseMin(const TensorBase<OtherDerived>& other) const
+    { return binaryExpr(other, internal::scalar_min_op<Scalar>()); }
+
+    /** \returns an expression of the block of *this starting at \a offsets and of dimensions \a extents.
+      * The slice has the rank of *this, and is writable if *this is. */
+    inline TensorSlicingOp<Derived> slice(const Dimensions& offsets, const Dimensions& extents)
+    { return TensorSlicingOp<Derived>(derived(), offsets, extents); }
+    inline const TensorSlicingOp<const Derived> slice(const Dimensions& offsets, const Dimensions& extents) const
+    { return TensorSlicingOp<const Derived>(derived(), offsets, extents); }
+
+    /** \returns an expression of *this seen with the dimensions \a dims, which must have the same total size.
+      * The coefficients keep their order in memory. */
+    template<int NewNumDims>
+    inline TensorReshapingOp<NewNumDims, Derived> reshape(const DSizes<Index,NewNumDims>& dims)
+    { return TensorReshapingOp<NewNumDims, Derived>(derived(), dims); }
+    template<int NewNumDims>
+    inline const TensorReshapingOp<NewNumDims, const Derived> reshape(const DSizes<Index,NewNumDims>& dims) const
+    { return TensorReshapingOp<NewNumDims, const Derived>(derived(), dims); }
+
+    /** \returns an expression of *this with its dimensions permuted: the \a i-th dimension of the result is the
+      * dimension \a permutation[i] of *this. For instance shuffle(DSizes<Index,2>(1,0)) transposes a matrix. */
+    inline TensorShufflingOp<Derived> shuffle(const Dimensions& permutation)
+    { return TensorShufflingOp<Derived>(derived(), permutation); }
+    inline const TensorShufflingOp<const Derived> shuffle(const Dimensions& permutation) const
+    { return TensorShufflingOp<const Derived>(derived(), permutation); }
+
+    /** \returns an expression of the reduction of *this along the dimensions \a axes by \a reducer. The other
+      * dimensions are kept, in their order. */
+    template<typename Reducer, int NumReduced>
+    inline const TensorReductionOp<Reducer, NumReduced, const Derived>
+    reduce(const DSizes<Index,NumReduced>& axes, const Reducer& reducer) const
+    { return TensorReductionOp<Reducer, NumReduced, const Derived>(derived(), axes, reducer); }
+
+    /** \returns an expression of the sums of the coefficients along the dimensions \a axes */
+    template<int NumReduced>
+    inline const TensorReductionOp<internal::tensor_sum_reducer<Scalar>, NumReduced, const Derived>
+    sum(const DSizes<Index,NumReduced>& axes) const
+    { return reduce(axes, internal::tensor_sum_reducer<Scalar>()); }
+    /** \returns an expression of the means of the coefficients along the dimensions \a axes */
+    template<int NumReduced>
+    inline const TensorReductionOp<internal::tensor_mean_reducer<Scalar>, NumReduced, const Derived>
+    mean(const DSizes<Index,NumReduced>& axes) const
+    { return reduce(axes, internal::tensor_mean_reducer<Scalar>()); }
+    /** \returns an expression of the products of the coefficients along the dimensions \a axes */
+    template<int NumReduced>
+    inline const TensorReductionOp<internal::tensor_prod_reducer<Scalar>, NumReduced, const Derived>
+    prod(const DSizes<Index,NumReduced>& axes) const
+    { return reduce(axes, internal::tensor_prod_reducer<Scalar>()); }
+    /** \returns an expression of the maxima of the coefficients along the dimensions \a axes */
+    template<int NumReduced>
+    inline const TensorReductionOp<internal::tensor_max_reducer<Scalar>, NumReduced, const Derived>
+    maximum(const DSizes<Index,NumReduced>& axes) const
+    { return reduce(axes, internal::tensor_max_reducer<Scalar>()); }
+    /** \returns an expression of the minima of the coefficients along the dimensions \a axes */
+    template<int NumReduced>
+    inline const TensorReductionOp<internal::tensor_min_reducer<Scalar>, NumReduced, const Derived>
+    minimum(const DSizes<Index,NumReduced>& axes) const
+    { return reduce(axes, internal::tensor_min_reducer<Scalar>()); }
+
+    /** \returns the sum of all the coefficients */
+    inline Scalar sum() const { return internal::tensor_full_reduce(derived(), internal::tensor_sum_reducer<Scalar>()); }
+    /** \returns the mean of all the coefficients */
+    inline Scalar mean() const { return internal::tensor_full_reduce(derived(), internal::tensor_mean_reducer<Scalar>()); }
+    /** \returns the product of all the coefficients */
+    inline Scalar prod() const { return internal::tensor_full_reduce(derived(), internal::tensor_prod_reducer<Scalar>()); }
+    /** \returns the largest coefficient */
+    inline Scalar maximum() const { return internal::tensor_full_reduce(derived(), internal::tensor_max_reducer<Scalar>()); }
+    /** \returns the smallest coefficient */
+    inline Scalar minimum() const { return internal::tensor_full_reduce(derived(), internal::tensor_min_reducer<Scalar>()); }
+
+    /** \returns an expression of the contraction of *this and \a other over the pairs of dimensions
+      * (\a lhsAxes[k], \a rhsAxes[k]), which must have the same sizes. The dimensions of the result are the
+      * remaining dimensions of *this followed by the remaining dimensions of \a other, in their order.
+      *
+      * The contraction is evaluated as a matrix product with the general block panel kernel, and runs in
+      * parallel as a matrix product does. For instance, the product of two matrices \c a and \c b is
+      * \code a.contract(b, DSizes<DenseIndex,1>(1), DSizes<DenseIndex,1>(0)) \endcode
+      */
+    template<int NumContracted, typename OtherDerived>
+    inline const TensorContractionOp<NumContracted, const Derived, const OtherDerived>
+    contract(const TensorBase<OtherDerived>& other,
+             const DSizes<Index,NumContracted>& lhsAxes, const DSizes<Index,NumContracted>& rhsAxes) const
+    { return TensorContractionOp<NumContracted, const Derived, const OtherDerived>(derived(), other.derived(), lhsAxes, rhsAxes); }
+
+  protected:
+    TensorBase() {}
+    TensorBase(const TensorBase&) {}
+};
+
+#endif // EIGEN_TENSORBASE_H
@@ -0,0 +1,240 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_TENSORCONTRACTION_H
+#define EIGEN_TENSORCONTRACTION_H
+
+namespace internal {
+template<int NumContracted, typename LhsXprType, typename RhsXprType>
+struct traits<TensorContractionOp<NumContracted,LhsXprType,RhsXprType> >
+{
+  typedef typename traits<LhsXprType>::Scalar Scalar;
+  typedef typename traits<LhsXprType>::Index Index;
+  enum {
+    NumDimensions = traits<LhsXprType>::NumDimensions + traits<RhsXprType>::NumDimensions - 2*NumContracted,
+    Flags = 0
+  };
+};
+
+// a contraction is evaluated once by the expressions using it
+template<int NumContracted, typename LhsXprType, typename RhsXprType>
+struct tensor_nested<TensorContractionOp<NumContracted,LhsXprType,RhsXprType> >
+{
+  typedef traits<TensorContractionOp<NumContracted,LhsXprType,RhsXprType> > Traits;
+  typedef const Tensor<typename Traits::Scalar, Traits::NumDimensions> type;
+};
+template<int NumContracted, typename LhsXprType, typename RhsXprType>
+struct tensor_nested<const TensorContractionOp<NumContracted,LhsXprType,RhsXprType> >
+  : tensor_nested<TensorContractionOp<NumContracted,LhsXprType,RhsXprType> >
+{};
+
+// the operands of a contraction are read from memory, and evaluated first if they are expressions
+template<typename XprType>
+struct tensor_contraction_operand
+{
+  typedef typename conditional<bool(traits<XprType>::Flags & DirectAccessBit),
+                               typename tensor_nested<XprType>::type,
+                               const Tensor<typename traits<XprType>::Scalar, traits<XprType>::NumDimensions> >::type type;
+};
+
+template<typename Dst, int NumContracted, typename LhsXprType, typename RhsXprType>
+struct tensor_assign_selector<Dst, TensorContractionOp<NumContracted,LhsXprType,RhsXprType> >
+{
+  static void run(Dst& dst, const TensorContractionOp<NumContracted,LhsXprType,RhsXprType>& src)
+  {
+    eigen_assert(dst.dimensions() == src.dimensions());
+    src.evalTo(dst);
+  }
+};
+
+} // end namespace internal
+
+/** \ingroup Tensor_Module
+  * \brief Tensor expression of the contraction of two tensor expressions
+  *
+  * This is the return type of TensorBase::contract(). The contraction is lowered to a matrix product: the
+  * dimensions of the left operand which are kept form the rows of the left matrix and the contracted ones
+  * its columns, and conversely for the right operand. An operand is read in place when its contracted
+  * dimensions are either its first or its last ones, in the order of the contraction. Otherwise, or when
+  * it is an expression, it is first evaluated into a temporary with the right order of the dimensions.
+  * The product then runs with the general block panel kernel, in parallel when it is large enough.
+  *
+  * The contraction is evaluated once, either into the destination when it is assigned, or into a
+  * temporary when it is nested in another expression. The product runs into a temporary instead of the
+  * destination when the latter overlaps an operand read in place, as in \c m = m.contract(n, ...).
+  */
+template<int NumContracted, typename LhsXprType, typename RhsXprType>
+class TensorContractionOp : public TensorBase<TensorContractionOp<NumContracted,LhsXprType,RhsXprType> >
+{
+  public:
+    typedef TensorBase<TensorContractionOp> Base;
+    typedef typename Base::Scalar Scalar;
+    typedef typename Base::Index Index;
+    typedef typename Base::Dimensions Dimensions;
+    typedef typename Base::PlainObject PlainObject;
+    enum {
+      NumDimensions = Base::NumDimensions,
+      LhsNumDimensions = internal::traits<LhsXprType>::NumDimensions,
+      RhsNumDimensions = internal::traits<RhsXprType>::NumDimensions
+    };
+    typedef DSizes<Index,NumContracted> ContractedDimensions;
+    typedef DSizes<Index,LhsNumDimensions> LhsDimensions;
+    typedef DSizes<Index,RhsNumDimensions> RhsDimensions;
+
+    inline TensorContractionOp(const LhsXprType& lhs, const RhsXprType& rhs,
+                               const ContractedDimensions& lhsAxes, const ContractedDimensions& rhsAxes)
+      : m_lhs(lhs), m_rhs(rhs), m_lhsAxes(lhsAxes), m_rhsAxes(rhsAxes)
+    {
+      EIGEN_STATIC_ASSERT(NumDimensions>=1, THIS_TENSOR_OPERATION_MUST_LEAVE_AT_LEAST_ONE_DIMENSION)
+      EIGEN_STATIC_ASSERT((internal::is_same<Scalar, typename internal::traits<RhsXprType>::Scalar>::value),
+        YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+      bool lhsContracted[LhsNumDimensions] = { false };
+      bool rhsContracted[RhsNumDimensions] = { false };
+      for(int k = 0; k < NumContracted; ++k)
+      {
+        eigen_assert(lhsAxes[k] >= 0 && lhsAxes[k] < LhsNumDimensions && !lhsContracted[lhsAxes[k]]
+                  && rhsAxes[k] >= 0 && rhsAxes[k] < RhsNumDimensions && !rhsContracted[rhsAxes[k]]
+                  && "the contracted axes must be distinct dimensions");
+        eigen_assert(lhs.dimensions()[lhsAxes[k]] == rhs.dimensions()[rhsAxes[k]]
+                  && "the contracted dimensions must have the same sizes");
+        lhsContracted[lhsAxes[k]] = rhsContracted[rhsAxes[k]] = true;
+      }
+      int d = 0;
+      for(int i = 0; i < LhsNumDimensions; ++i)
+        if(!lhsContracted[i])
+          m_dimensions[d++] = lhs.dimensions()[i];
+      for(int i = 0; i < RhsNumDimensions; ++i)
+        if(!rhsContracted[i])
+          m_dimensions[d++] = rhs.dimensions()[i];
+    }
+
+    inline const Dimensions& dimensions() const { return m_dimensions; }
+
+    /** \internal Evaluates the contraction into \a dst, which has the right dimensions */
+    template<typename Dst>
+    void evalTo(Dst& dst) const
+    {
+      PlainObject tmp(m_dimensions);
+      evalTo(tmp);
+      internal::tensor_assign(dst, tmp);
+    }
+
+    /** \internal */
+    void evalTo(PlainObject& dst) const
+    {
+      typename internal::tensor_contraction_operand<LhsXprType>::type lhs(m_lhs);
+      typename internal::tensor_contraction_operand<RhsXprType>::type rhs(m_rhs);
+
+      // lhs: rows x depth, or depth x rows if lhsTransposed
+      Index rows = 1, depth = 1, cols = 1;
+      bool lhsContracted[LhsNumDimensions] = { false };
+      bool rhsContracted[RhsNumDimensions] = { false };
+      bool lhsInPlace = true, lhsTransposed = true, rhsInPlace = true, rhsTransposed = true;
+      for(int k = 0; k < NumContracted; ++k)
+      {
+        lhsContracted[m_lhsAxes[k]] = rhsContracted[m_rhsAxes[k]] = true;
+        depth *= lhs.dimensions()[m_lhsAxes[k]];
+        lhsInPlace = lhsInPlace && m_lhsAxes[k] == LhsNumDimensions - NumContracted + k;
+        lhsTransposed = lhsTransposed && m_lhsAxes[k] == k;
+        rhsInPlace = rhsInPlace && m_rhsAxes[k] == k;
+        rhsTransposed = rhsTransposed && m_rhsAxes[k] == RhsNumDimensions - NumContracted + k;
+      }
+      for(int i = 0; i < LhsNumDimensions; ++i)
+        if(!lhsContracted[i])
+          rows *= lhs.dimensions()[i];
+      for(int i = 0; i < RhsNumDimensions; ++i)
+        if(!rhsContracted[i])
+          cols *= rhs.dimensions()[i];
+
+      // otherwise the operands are shuffled into rows x depth and depth x cols tensors
+      Tensor<Scalar,LhsNumDimensions> lhsShuffled;
+      Tensor<Scalar,RhsNumDimensions> rhsShuffled;
+      const Scalar* lhsData = lhs.data();
+      const Scalar* rhsData = rhs.data();
+      if(!lhsInPlace && !lhsTransposed)
+      {
+        LhsDimensions permutation;
+        for(int i = 0, d = 0; i < LhsNumDimensions; ++i)
+          if(!lhsContracted[i])
+            permutation[d++] = i;
+        for(int k = 0; k < NumContracted; ++k)
+          permutation[LhsNumDimensions - NumContracted + k] = m_lhsAxes[k];
+        lhsShuffled = lhs.shuffle(permutation);
+        lhsData = lhsShuffled.data();
+        lhsInPlace = true;
+      }
+      if(!rhsInPlace && !rhsTransposed)
+      {
+        RhsDimensions permutation;
+        for(int k = 0; k < NumContracted; ++k)
+          permutation[k] = m_rhsAxes[k];
+        for(int i = 0, d = NumContracted; i < RhsNumDimensions; ++i)
+          if(!rhsContracted[i])
+            permutation[d++] = i;
+        rhsShuffled = rhs.shuffle(permutation);
+        rhsData = rhsShuffled.data();
+        rhsInPlace = true;
+      }
+
+      // the product cannot run into a destination it reads
+      if(overlaps(dst.data(), rows*cols, lhsData, rows*depth) || overlaps(dst.data(), rows*cols, rhsData, depth*cols))
+      {
+        PlainObject tmp(m_dimensions);
+        product(tmp.data(), lhsData, rhsData, lhsInPlace, rhsInPlace, rows, depth, cols);
+        std::copy(tmp.data(), tmp.data() + tmp.size(), dst.data());
+      }
+      else
+        product(dst.data(), lhsData, rhsData, lhsInPlace, rhsInPlace, rows, depth, cols);
+    }
+
+  protected:
+    static bool overlaps(const Scalar* a, Index aSize, const Scalar* b, Index bSize)
+    {
+      return a < b + bSize && b < a + aSize;
+    }
+
+    // dst = lhs * rhs, where lhs is rows x depth (or its transpose if !lhsInPlace) and rhs is depth x cols (or
+    // its transpose if !rhsInPlace)
+    static void product(Scalar* dst, const Scalar* lhsData, const Scalar* rhsData, bool lhsInPlace, bool rhsInPlace,
+                        Index rows, Index depth, Index cols)
+    {
+      typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+      typedef Map<const MatrixType> ConstMatrixMap;
+      Map<MatrixType> res(dst, rows, cols);
+      if(lhsInPlace && rhsInPlace)
+        res.noalias() = ConstMatrixMap(lhsData, rows, depth) * ConstMatrixMap(rhsData, depth, cols);
+      else if(lhsInPlace)
+        res.noalias() = ConstMatrixMap(lhsData, rows, depth) * ConstMatrixMap(rhsData, cols, depth).transpose();
+      else if(rhsInPlace)
+        res.noalias() = ConstMatrixMap(lhsData, depth, rows).transpose() * ConstMatrixMap(rhsData, depth, cols);
+      else
+        res.noalias() = ConstMatrixMap(lhsData, depth, rows).transpose() * ConstMatrixMap(rhsData, cols, depth).transpose();
+    }
+
+    typename internal::tensor_nested<LhsXprType>::type m_lhs;
+    typename internal::tensor_nested<RhsXprType>::type m_rhs;
+    const ContractedDimensions m_lhsAxes;
+    const ContractedDimensions m_rhsAxes;
+    Dimensions m_dimensions;
+};
+
+#endif // EIGEN_TENSORCONTRACTION_H
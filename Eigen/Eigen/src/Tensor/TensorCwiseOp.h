@@ -0,0 +1,127 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_TENSORCWISEOP_H
+#define EIGEN_TENSORCWISEOP_H
+
+namespace internal {
+template<typename UnaryOp, typename XprType>
+struct traits<TensorCwiseUnaryOp<UnaryOp,XprType> >
+{
+  typedef typename result_of<UnaryOp(typename traits<XprType>::Scalar)>::type Scalar;
+  typedef typename traits<XprType>::Index Index;
+  enum {
+    NumDimensions = traits<XprType>::NumDimensions,
+    Flags = traits<XprType>::Flags & (functor_traits<UnaryOp>::PacketAccess ? (PacketAccessBit | AlignedBit) : 0)
+  };
+};
+
+template<typename BinaryOp, typename LhsXprType, typename RhsXprType>
+struct traits<TensorCwiseBinaryOp<BinaryOp,LhsXprType,RhsXprType> >
+{
+  typedef typename result_of<BinaryOp(typename traits<LhsXprType>::Scalar,
+                                      typename traits<RhsXprType>::Scalar)>::type Scalar;
+  typedef typename traits<LhsXprType>::Index Index;
+  enum {
+    NumDimensions = traits<LhsXprType>::NumDimensions,
+    SameScalars = is_same<typename traits<LhsXprType>::Scalar, typename traits<RhsXprType>::Scalar>::value,
+    Flags = traits<LhsXprType>::Flags & traits<RhsXprType>::Flags
+          & (functor_traits<BinaryOp>::PacketAccess && SameScalars ? (PacketAccessBit | AlignedBit) : 0)
+  };
+};
+}
+
+/** \ingroup Tensor_Module
+  * \brief Tensor expression of a unary functor applied to each coefficient of a tensor expression
+  *
+  * This is the return type of TensorBase::unaryExpr() and of the coefficient-wise methods of TensorBase,
+  * such as abs() or operator*(const Scalar&). They are vectorized when the functor supports packets, with
+  * the same functors as the matrices and arrays.
+  */
+template<typename UnaryOp, typename XprType>
+class TensorCwiseUnaryOp : public TensorBase<TensorCwiseUnaryOp<UnaryOp,XprType> >
+{
+  public:
+    typedef TensorBase<TensorCwiseUnaryOp> Base;
+    typedef typename Base::Scalar Scalar;
+    typedef typename Base::Index Index;
+    typedef typename Base::Packet Packet;
+    typedef typename Base::Dimensions Dimensions;
+
+    inline TensorCwiseUnaryOp(const XprType& xpr, const UnaryOp& func = UnaryOp())
+      : m_xpr(xpr), m_functor(func) {}
+
+    inline const Dimensions& dimensions() const { return m_xpr.dimensions(); }
+
+    inline Scalar coeff(Index index) const { return m_functor(m_xpr.coeff(index)); }
+
+    template<int LoadMode>
+    inline Packet packet(Index index) const
+    { return m_functor.packetOp(m_xpr.template packet<LoadMode>(index)); }
+
+    inline Index costPerCoeff() const { return m_xpr.costPerCoeff() + internal::functor_traits<UnaryOp>::Cost; }
+
+  protected:
+    typename internal::tensor_nested<XprType>::type m_xpr;
+    const UnaryOp m_functor;
+};
+
+/** \ingroup Tensor_Module
+  * \brief Tensor expression of a binary functor applied to the coefficients of two tensor expressions
+  *
+  * This is the return type of TensorBase::binaryExpr() and of the coefficient-wise operators between
+  * tensors. Both operands must have the same dimensions.
+  */
+template<typename BinaryOp, typename LhsXprType, typename RhsXprType>
+class TensorCwiseBinaryOp : public TensorBase<TensorCwiseBinaryOp<BinaryOp,LhsXprType,RhsXprType> >
+{
+  public:
+    typedef TensorBase<TensorCwiseBinaryOp> Base;
+    typedef typename Base::Scalar Scalar;
+    typedef typename Base::Index Index;
+    typedef typename Base::Packet Packet;
+    typedef typename Base::Dimensions Dimensions;
+
+    inline TensorCwiseBinaryOp(const LhsXprType& lhs, const RhsXprType& rhs, const BinaryOp& func = BinaryOp())
+      : m_lhs(lhs), m_rhs(rhs), m_functor(func)
+    {
+      eigen_assert(lhs.dimensions() == rhs.dimensions());
+    }
+
+    inline const Dimensions& dimensions() const { return m_lhs.dimensions(); }
+
+    inline Scalar coeff(Index index) const { return m_functor(m_lhs.coeff(index), m_rhs.coeff(index)); }
+
+    template<int LoadMode>
+    inline Packet packet(Index index) const
+    { return m_functor.packetOp(m_lhs.template packet<LoadMode>(index), m_rhs.template packet<LoadMode>(index)); }
+
+    inline Index costPerCoeff() const
+    { return m_lhs.costPerCoeff() + m_rhs.costPerCoeff() + internal::functor_traits<BinaryOp>::Cost; }
+
+  protected:
+    typename internal::tensor_nested<LhsXprType>::type m_lhs;
+    typename internal::tensor_nested<RhsXprType>::type m_rhs;
+    const BinaryOp m_functor;
+};
+
+#endif // EIGEN_TENSORCWISEOP_H
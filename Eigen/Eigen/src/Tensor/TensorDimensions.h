@@ -0,0 +1,140 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_TENSOR_DIMENSIONS_H
+#define EIGEN_TENSOR_DIMENSIONS_H
+
+/** \ingroup Tensor_Module
+  * \brief A fixed number of indices, such as the dimensions of a tensor or the position of a coefficient
+  *
+  * DSizes is used for the dimensions of tensors and expressions, and for the indices, offsets, extents, axes
+  * and permutations passed to them. The constructors taking the indices one by one check at compile time
+  * that their number matches \c NumDims:
+  * \code
+  * Tensor<float,3> t(DSizes<DenseIndex,3>(64, 32, 16));
+  * Tensor<float,2> s = t.sum(DSizes<DenseIndex,1>(2));
+  * \endcode
+  *
+  * \tparam Index the type of the indices
+  * \tparam NumDims the number of indices, at least 1
+  */
+template<typename Index, int NumDims>
+class DSizes
+{
+  public:
+    enum { Size = NumDims };
+
+    /** Sets all the indices to zero. */
+    DSizes()
+    {
+      for(int i = 0; i < NumDims; ++i)
+        m_data[i] = 0;
+    }
+
+    /** Copies \c NumDims indices from \a values. */
+    template<typename OtherIndex>
+    explicit DSizes(const OtherIndex* values)
+    {
+      for(int i = 0; i < NumDims; ++i)
+        m_data[i] = values[i];
+    }
+
+    explicit DSizes(Index i0)
+    {
+      EIGEN_STATIC_ASSERT(NumDims==1, THE_NUMBER_OF_INDICES_DOES_NOT_MATCH_THE_RANK_OF_THE_TENSOR)
+      m_data[0] = i0;
+    }
+
+    DSizes(Index i0, Index i1)
+    {
+      EIGEN_STATIC_ASSERT(NumDims==2, THE_NUMBER_OF_INDICES_DOES_NOT_MATCH_THE_RANK_OF_THE_TENSOR)
+      m_data[0] = i0; m_data[1] = i1;
+    }
+
+    DSizes(Index i0, Index i1, Index i2)
+    {
+      EIGEN_STATIC_ASSERT(NumDims==3, THE_NUMBER_OF_INDICES_DOES_NOT_MATCH_THE_RANK_OF_THE_TENSOR)
+      m_data[0] = i0; m_data[1] = i1; m_data[2] = i2;
+    }
+
+    DSizes(Index i0, Index i1, Index i2, Index i3)
+    {
+      EIGEN_STATIC_ASSERT(NumDims==4, THE_NUMBER_OF_INDICES_DOES_NOT_MATCH_THE_RANK_OF_THE_TENSOR)
+      m_data[0] = i0; m_data[1] = i1; m_data[2] = i2; m_data[3] = i3;
+    }
+
+    DSizes(Index i0, Index i1, Index i2, Index i3, Index i4)
+    {
+      EIGEN_STATIC_ASSERT(NumDims==5, THE_NUMBER_OF_INDICES_DOES_NOT_MATCH_THE_RANK_OF_THE_TENSOR)
+      m_data[0] = i0; m_data[1] = i1; m_data[2] = i2; m_data[3] = i3; m_data[4] = i4;
+    }
+
+    DSizes(Index i0, Index i1, Index i2, Index i3, Index i4, Index i5)
+    {
+      EIGEN_STATIC_ASSERT(NumDims==6, THE_NUMBER_OF_INDICES_DOES_NOT_MATCH_THE_RANK_OF_THE_TENSOR)
+      m_data[0] = i0; m_data[1] = i1; m_data[2] = i2; m_data[3] = i3; m_data[4] = i4; m_data[5] = i5;
+    }
+
+    inline Index& operator[](int i) { eigen_assert(i >= 0 && i < NumDims); return m_data[i]; }
+    inline const Index& operator[](int i) const { eigen_assert(i >= 0 && i < NumDims); return m_data[i]; }
+
+    /** \returns the number of indices, \c NumDims */
+    static inline int size() { return NumDims; }
+
+    /** \returns the product of the indices, that is the number of coefficients of a tensor of these dimensions */
+    inline Index totalSize() const
+    {
+      Index ret = 1;
+      for(int i = 0; i < NumDims; ++i)
+        ret *= m_data[i];
+      return ret;
+    }
+
+    inline bool operator==(const DSizes& other) const
+    {
+      for(int i = 0; i < NumDims; ++i)
+        if(m_data[i] != other.m_data[i])
+          return false;
+      return true;
+    }
+    inline bool operator!=(const DSizes& other) const { return !(*this == other); }
+
+  protected:
+    Index m_data[NumDims];
+};
+
+namespace internal {
+
+// computes the strides of a tensor stored with its first index varying fastest
+template<typename Index, int NumDims>
+inline DSizes<Index,NumDims> tensor_strides(const DSizes<Index,NumDims>& dims)
+{
+  DSizes<Index,NumDims> strides;
+  strides[0] = 1;
+  for(int i = 1; i < NumDims; ++i)
+    strides[i] = strides[i-1] * dims[i-1];
+  return strides;
+}
+
+} // end namespace internal
+
+#endif // EIGEN_TENSOR_DIMENSIONS_H
@@ -0,0 +1,133 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_TENSORMAP_H
+#define EIGEN_TENSORMAP_H
+
+namespace internal {
+template<typename PlainTensorType, int MapOptions>
+struct traits<TensorMap<PlainTensorType,MapOptions> > : traits<typename remove_const<PlainTensorType>::type>
+{
+  typedef traits<typename remove_const<PlainTensorType>::type> TensorTraits;
+  enum {
+    Flags = (TensorTraits::Flags & ~(LvalueBit | AlignedBit))
+          | (is_const<PlainTensorType>::value ? 0 : LvalueBit)
+          | (MapOptions & Aligned ? AlignedBit : 0)
+  };
+};
+}
+
+/** \ingroup Tensor_Module
+  * \brief A tensor expression mapping existing data
+  *
+  * \tparam PlainTensorType the type of the mapped tensor, such as Tensor<float,3>, or const Tensor<float,3>
+  *         for read-only data
+  * \tparam MapOptions Aligned if the data is aligned on a packet boundary, Unaligned otherwise (the default)
+  *
+  * TensorMap lets existing buffers be used as tensors without copying them, with the storage order of
+  * class Tensor, first index varying fastest:
+  * \code
+  * float* buffer = ...; // 64 x 32 x 16 samples
+  * TensorMap<Tensor<float,3> > t(buffer, 64, 32, 16);
+  * t(1, 2, 3) = 4;
+  * Tensor<float,2> energy = t.square().sum(DSizes<DenseIndex,1>(0));
+  * \endcode
+  *
+  * \sa class Tensor
+  */
+template<typename PlainTensorType, int MapOptions>
+class TensorMap : public TensorBase<TensorMap<PlainTensorType,MapOptions> >
+{
+  public:
+    typedef TensorBase<TensorMap> Base;
+    typedef typename Base::Scalar Scalar;
+    typedef typename Base::Index Index;
+    typedef typename Base::Packet Packet;
+    typedef typename Base::Dimensions Dimensions;
+    typedef typename internal::conditional<internal::is_const<PlainTensorType>::value,
+                                           const Scalar*, Scalar*>::type PointerType;
+    typedef typename internal::conditional<internal::is_const<PlainTensorType>::value,
+                                           const Scalar&, Scalar&>::type ReferenceType;
+
+    inline TensorMap(PointerType data, const Dimensions& dims) : m_data(data), m_dimensions(dims) { checkAlignment(); }
+    inline TensorMap(PointerType data, Index d0) : m_data(data), m_dimensions(d0) { checkAlignment(); }
+    inline TensorMap(PointerType data, Index d0, Index d1) : m_data(data), m_dimensions(d0, d1) { checkAlignment(); }
+    inline TensorMap(PointerType data, Index d0, Index d1, Index d2)
+      : m_data(data), m_dimensions(d0, d1, d2) { checkAlignment(); }
+    inline TensorMap(PointerType data, Index d0, Index d1, Index d2, Index d3)
+      : m_data(data), m_dimensions(d0, d1, d2, d3) { checkAlignment(); }
+    inline TensorMap(PointerType data, Index d0, Index d1, Index d2, Index d3, Index d4)
+      : m_data(data), m_dimensions(d0, d1, d2, d3, d4) { checkAlignment(); }
+    inline TensorMap(PointerType data, Index d0, Index d1, Index d2, Index d3, Index d4, Index d5)
+      : m_data(data), m_dimensions(d0, d1, d2, d3, d4, d5) { checkAlignment(); }
+
+    EIGEN_TENSOR_INHERIT_ASSIGNMENT_OPERATORS(TensorMap)
+
+    inline const Dimensions& dimensions() const { return m_dimensions; }
+
+    inline PointerType data() const { return m_data; }
+
+    inline const Scalar& coeff(Index index) const { return m_data[index]; }
+    inline ReferenceType coeffRef(Index index) { return m_data[index]; }
+
+    template<int LoadMode>
+    inline Packet packet(Index index) const
+    { return internal::ploadt<Packet, LoadMode>(m_data + index); }
+
+    template<int StoreMode>
+    inline void writePacket(Index index, const Packet& x)
+    { internal::pstoret<Scalar, Packet, StoreMode>(m_data + index, x); }
+
+    inline Index costPerCoeff() const { return NumTraits<Scalar>::ReadCost; }
+
+    inline ReferenceType operator()(const Dimensions& indices) const
+    {
+      Index index = 0;
+      for(int i = Base::NumDimensions-1; i >= 0; --i)
+      {
+        eigen_assert(indices[i] >= 0 && indices[i] < m_dimensions[i]);
+        index = index * m_dimensions[i] + indices[i];
+      }
+      return m_data[index];
+    }
+
+    inline ReferenceType operator()(Index i0) const { return (*this)(Dimensions(i0)); }
+    inline ReferenceType operator()(Index i0, Index i1) const { return (*this)(Dimensions(i0, i1)); }
+    inline ReferenceType operator()(Index i0, Index i1, Index i2) const { return (*this)(Dimensions(i0, i1, i2)); }
+    inline ReferenceType operator()(Index i0, Index i1, Index i2, Index i3) const
+    { return (*this)(Dimensions(i0, i1, i2, i3)); }
+    inline ReferenceType operator()(Index i0, Index i1, Index i2, Index i3, Index i4) const
+    { return (*this)(Dimensions(i0, i1, i2, i3, i4)); }
+    inline ReferenceType operator()(Index i0, Index i1, Index i2, Index i3, Index i4, Index i5) const
+    { return (*this)(Dimensions(i0, i1, i2, i3, i4, i5)); }
+
+  protected:
+    void checkAlignment()
+    {
+      eigen_assert(!(MapOptions & Aligned) || (size_t(m_data) % 16) == 0);
+    }
+
+    PointerType m_data;
+    Dimensions m_dimensions;
+};
+
+#endif // EIGEN_TENSORMAP_H
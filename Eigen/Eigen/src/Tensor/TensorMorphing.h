@@ -0,0 +1,167 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_TENSORMORPHING_H
+#define EIGEN_TENSORMORPHING_H
+
+namespace internal {
+template<typename XprType>
+struct traits<TensorSlicingOp<XprType> > : traits<XprType>
+{
+  enum { Flags = traits<XprType>::Flags & (PacketAccessBit | LvalueBit) };
+};
+
+template<int NumDims, typename XprType>
+struct traits<TensorReshapingOp<NumDims,XprType> > : traits<XprType>
+{
+  enum {
+    NumDimensions = NumDims,
+    Flags = traits<XprType>::Flags & (PacketAccessBit | AlignedBit | LvalueBit)
+  };
+};
+}
+
+/** \ingroup Tensor_Module
+  * \brief Tensor expression of a block of a tensor expression
+  *
+  * This is the return type of TensorBase::slice(). The slice of a writable expression, such as a Tensor or
+  * a TensorMap, is writable:
+  * \code
+  * Tensor<float,3> t(64, 32, 16);
+  * Tensor<float,3> frame(64, 32, 1);
+  * t.slice(DSizes<DenseIndex,3>(0,0,15), DSizes<DenseIndex,3>(64,32,1)) = frame;
+  * \endcode
+  *
+  * Packets are loaded directly from the sliced expression when they lie in one run of the first dimension,
+  * which is the common case when the slice keeps most of it.
+  */
+template<typename XprType>
+class TensorSlicingOp : public TensorBase<TensorSlicingOp<XprType> >
+{
+  public:
+    typedef TensorBase<TensorSlicingOp> Base;
+    typedef typename Base::Scalar Scalar;
+    typedef typename Base::Index Index;
+    typedef typename Base::Packet Packet;
+    typedef typename Base::Dimensions Dimensions;
+    enum { NumDimensions = Base::NumDimensions, PacketSize = Base::PacketSize };
+
+    inline TensorSlicingOp(XprType& xpr, const Dimensions& offsets, const Dimensions& extents)
+      : m_xpr(xpr), m_dimensions(extents), m_outputStrides(internal::tensor_strides(extents)),
+        m_inputStrides(internal::tensor_strides(xpr.dimensions())), m_inputOffset(0)
+    {
+      for(int i = 0; i < NumDimensions; ++i)
+      {
+        eigen_assert(offsets[i] >= 0 && extents[i] >= 0 && offsets[i] + extents[i] <= xpr.dimensions()[i]);
+        m_inputOffset += offsets[i] * m_inputStrides[i];
+      }
+    }
+
+    EIGEN_TENSOR_INHERIT_ASSIGNMENT_OPERATORS(TensorSlicingOp)
+
+    inline const Dimensions& dimensions() const { return m_dimensions; }
+
+    inline Scalar coeff(Index index) const { return m_xpr.coeff(inputIndex(index)); }
+    inline Scalar& coeffRef(Index index) { return m_xpr.coeffRef(inputIndex(index)); }
+
+    template<int LoadMode>
+    inline Packet packet(Index index) const
+    {
+      if(index % m_dimensions[0] + PacketSize <= m_dimensions[0])
+        return m_xpr.template packet<Unaligned>(inputIndex(index));
+      return internal::tensor_gather_packet<Packet>(*this, index);
+    }
+
+    template<int StoreMode>
+    inline void writePacket(Index index, const Packet& x)
+    {
+      if(index % m_dimensions[0] + PacketSize <= m_dimensions[0])
+        m_xpr.template writePacket<Unaligned>(inputIndex(index), x);
+      else
+        internal::tensor_scatter_packet(*this, index, x);
+    }
+
+    inline Index costPerCoeff() const { return m_xpr.costPerCoeff() + NumDimensions; }
+
+  protected:
+    inline Index inputIndex(Index index) const
+    {
+      Index input = m_inputOffset;
+      for(int i = NumDimensions-1; i > 0; --i)
+      {
+        const Index idx = index / m_outputStrides[i];
+        input += idx * m_inputStrides[i];
+        index -= idx * m_outputStrides[i];
+      }
+      return input + index;
+    }
+
+    typename internal::tensor_nested<XprType>::type m_xpr;
+    const Dimensions m_dimensions;
+    const Dimensions m_outputStrides;
+    const Dimensions m_inputStrides;
+    Index m_inputOffset;
+};
+
+/** \ingroup Tensor_Module
+  * \brief Tensor expression of a tensor expression with other dimensions
+  *
+  * This is the return type of TensorBase::reshape(). The coefficients are not moved, so that a reshaped
+  * tensor is as fast to read and write as the tensor itself.
+  */
+template<int NumDims, typename XprType>
+class TensorReshapingOp : public TensorBase<TensorReshapingOp<NumDims,XprType> >
+{
+  public:
+    typedef TensorBase<TensorReshapingOp> Base;
+    typedef typename Base::Scalar Scalar;
+    typedef typename Base::Index Index;
+    typedef typename Base::Packet Packet;
+    typedef typename Base::Dimensions Dimensions;
+
+    inline TensorReshapingOp(XprType& xpr, const Dimensions& dims)
+      : m_xpr(xpr), m_dimensions(dims)
+    {
+      eigen_assert(dims.totalSize() == xpr.dimensions().totalSize());
+    }
+
+    EIGEN_TENSOR_INHERIT_ASSIGNMENT_OPERATORS(TensorReshapingOp)
+
+    inline const Dimensions& dimensions() const { return m_dimensions; }
+
+    inline Scalar coeff(Index index) const { return m_xpr.coeff(index); }
+    inline Scalar& coeffRef(Index index) { return m_xpr.coeffRef(index); }
+
+    template<int LoadMode>
+    inline Packet packet(Index index) const { return m_xpr.template packet<LoadMode>(index); }
+
+    template<int StoreMode>
+    inline void writePacket(Index index, const Packet& x) { m_xpr.template writePacket<StoreMode>(index, x); }
+
+    inline Index costPerCoeff() const { return m_xpr.costPerCoeff(); }
+
+  protected:
+    typename internal::tensor_nested<XprType>::type m_xpr;
+    const Dimensions m_dimensions;
+};
+
+#endif // EIGEN_TENSORMORPHING_H
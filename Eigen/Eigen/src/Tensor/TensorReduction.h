@@ -0,0 +1,385 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_TENSORREDUCTION_H
+#define EIGEN_TENSORREDUCTION_H
+
+namespace internal {
+
+/** \internal
+  * \brief Reducer computing the sum of the coefficients
+  *
+  * A reducer combines the coefficients with reduce() and reducePacket() starting from initialize() and
+  * initializePacket(), turns an accumulated packet into a scalar with predux(), and gives the final value
+  * of \a count accumulated coefficients with finalize() and finalizePacket().
+  *
+  * \sa TensorBase::reduce()
+  */
+template<typename Scalar> struct tensor_sum_reducer
+{
+  typedef typename packet_traits<Scalar>::type Packet;
+  typedef DenseIndex Index;
+  enum { PacketAccess = packet_traits<Scalar>::HasAdd, Cost = NumTraits<Scalar>::AddCost };
+  inline Scalar initialize() const { return Scalar(0); }
+  inline Packet initializePacket() const { return pset1<Packet>(Scalar(0)); }
+  inline Scalar reduce(const Scalar& a, const Scalar& b) const { return a + b; }
+  inline Packet reducePacket(const Packet& a, const Packet& b) const { return padd(a, b); }
+  inline Scalar predux(const Packet& a) const { return internal::predux(a); }
+  inline Scalar finalize(const Scalar& accum, Index) const { return accum; }
+  inline Packet finalizePacket(const Packet& accum, Index) const { return accum; }
+};
+
+template<typename Scalar> struct tensor_mean_reducer : tensor_sum_reducer<Scalar>
+{
+  typedef typename packet_traits<Scalar>::type Packet;
+  typedef DenseIndex Index;
+  enum { PacketAccess = packet_traits<Scalar>::HasAdd && packet_traits<Scalar>::HasDiv };
+  inline Scalar finalize(const Scalar& accum, Index count) const { return accum / Scalar(count); }
+  inline Packet finalizePacket(const Packet& accum, Index count) const
+  { return pdiv(accum, pset1<Packet>(Scalar(count))); }
+};
+
+template<typename Scalar> struct tensor_prod_reducer
+{
+  typedef typename packet_traits<Scalar>::type Packet;
+  typedef DenseIndex Index;
+  enum { PacketAccess = packet_traits<Scalar>::HasMul, Cost = NumTraits<Scalar>::MulCost };
+  inline Scalar initialize() const { return Scalar(1); }
+  inline Packet initializePacket() const { return pset1<Packet>(Scalar(1)); }
+  inline Scalar reduce(const Scalar& a, const Scalar& b) const { return a * b; }
+  inline Packet reducePacket(const Packet& a, const Packet& b) const { return pmul(a, b); }
+  inline Scalar predux(const Packet& a) const { return predux_mul(a); }
+  inline Scalar finalize(const Scalar& accum, Index) const { return accum; }
+  inline Packet finalizePacket(const Packet& accum, Index) const { return accum; }
+};
+
+template<typename Scalar> struct tensor_max_reducer
+{
+  typedef typename packet_traits<Scalar>::type Packet;
+  typedef DenseIndex Index;
+  enum { PacketAccess = packet_traits<Scalar>::HasMax, Cost = NumTraits<Scalar>::AddCost };
+  inline Scalar initialize() const { return NumTraits<Scalar>::lowest(); }
+  inline Packet initializePacket() const { return pset1<Packet>(NumTraits<Scalar>::lowest()); }
+  inline Scalar reduce(const Scalar& a, const Scalar& b) const { return (std::max)(a, b); }
+  inline Packet reducePacket(const Packet& a, const Packet& b) const { return pmax(a, b); }
+  inline Scalar predux(const Packet& a) const { return predux_max(a); }
+  inline Scalar finalize(const Scalar& accum, Index) const { return accum; }
+  inline Packet finalizePacket(const Packet& accum, Index) const { return accum; }
+};
+
+template<typename Scalar> struct tensor_min_reducer
+{
+  typedef typename packet_traits<Scalar>::type Packet;
+  typedef DenseIndex Index;
+  enum { PacketAccess = packet_traits<Scalar>::HasMin, Cost = NumTraits<Scalar>::AddCost };
+  inline Scalar initialize() const { return NumTraits<Scalar>::highest(); }
+  inline Packet initializePacket() const { return pset1<Packet>(NumTraits<Scalar>::highest()); }
+  inline Scalar reduce(const Scalar& a, const Scalar& b) const { return (std::min)(a, b); }
+  inline Packet reducePacket(const Packet& a, const Packet& b) const { return pmin(a, b); }
+  inline Scalar predux(const Packet& a) const { return predux_min(a); }
+  inline Scalar finalize(const Scalar& accum, Index) const { return accum; }
+  inline Packet finalizePacket(const Packet& accum, Index) const { return accum; }
+};
+
+template<typename Reducer, int NumReduced, typename XprType>
+struct traits<TensorReductionOp<Reducer,NumReduced,XprType> > : traits<XprType>
+{
+  enum {
+    NumDimensions = traits<XprType>::NumDimensions - NumReduced,
+    Flags = traits<XprType>::Flags & (Reducer::PacketAccess ? PacketAccessBit : 0)
+  };
+};
+
+} // end namespace internal
+
+/** \ingroup Tensor_Module
+  * \brief Tensor expression of the reduction of a tensor expression along some of its dimensions
+  *
+  * This is the return type of TensorBase::reduce() and of the reductions along axes such as
+  * TensorBase::sum(const DSizes<Index,NumReduced>&). Each coefficient is computed when it is read, by
+  * running through the reduced dimensions with the smallest stride innermost. The reduction is
+  * vectorized along the first dimension: across the results if it is kept, and within each result
+  * otherwise. Assigning the reduction to a tensor evaluates the results in parallel.
+  */
+template<typename Reducer, int NumReduced, typename XprType>
+class TensorReductionOp : public TensorBase<TensorReductionOp<Reducer,NumReduced,XprType> >
+{
+  public:
+    typedef TensorBase<TensorReductionOp> Base;
+    typedef typename Base::Scalar Scalar;
+    typedef typename Base::Index Index;
+    typedef typename Base::Packet Packet;
+    typedef typename Base::Dimensions Dimensions;
+    enum {
+      NumDimensions = Base::NumDimensions,
+      NumInputDimensions = internal::traits<XprType>::NumDimensions,
+      PacketSize = Base::PacketSize,
+      Vectorize = (internal::traits<XprType>::Flags & PacketAccessBit) && Reducer::PacketAccess
+    };
+    typedef DSizes<Index,NumInputDimensions> InputDimensions;
+    typedef DSizes<Index,NumReduced> ReducedDimensions;
+
+    inline TensorReductionOp(const XprType& xpr, const ReducedDimensions& axes, const Reducer& reducer = Reducer())
+      : m_xpr(xpr), m_reducer(reducer)
+    {
+      EIGEN_STATIC_ASSERT(NumDimensions>=1, THIS_TENSOR_OPERATION_MUST_LEAVE_AT_LEAST_ONE_DIMENSION)
+      const InputDimensions& dims = xpr.dimensions();
+      const InputDimensions strides = internal::tensor_strides(dims);
+      bool reduced[NumInputDimensions] = { false };
+      for(int r = 0; r < NumReduced; ++r)
+      {
+        eigen_assert(axes[r] >= 0 && axes[r] < NumInputDimensions && !reduced[axes[r]]
+                     && "the reduced axes must be distinct dimensions");
+        reduced[axes[r]] = true;
+      }
+      for(int i = 0, p = 0, r = 0; i < NumInputDimensions; ++i)
+      {
+        if(reduced[i])
+        {
+          m_reducedDims[r] = dims[i];
+          m_reducedStrides[r++] = strides[i];
+        }
+        else
+        {
+          m_dimensions[p] = dims[i];
+          m_preservedStrides[p++] = strides[i];
+        }
+      }
+      m_outputStrides = internal::tensor_strides(m_dimensions);
+      m_reducedSize = m_reducedDims.totalSize();
+    }
+
+    inline const Dimensions& dimensions() const { return m_dimensions; }
+
+    inline Scalar coeff(Index index) const
+    {
+      typedef typename internal::conditional<Vectorize, internal::true_type, internal::false_type>::type Vectorized;
+      return m_reducer.finalize(reduceAt(firstInput(index), Vectorized()), m_reducedSize);
+    }
+
+    template<int LoadMode>
+    inline Packet packet(Index index) const
+    {
+      // the PacketSize results are reductions of contiguous packets if the first dimension is kept
+      if(m_preservedStrides[0] == 1 && index % m_dimensions[0] + PacketSize <= m_dimensions[0])
+      {
+        Packet accum = m_reducer.initializePacket();
+        ReducedDimensions counter;
+        Index offset = firstInput(index);
+        for(Index k = 0; k < m_reducedSize; ++k)
+        {
+          accum = m_reducer.reducePacket(accum, m_xpr.template packet<Unaligned>(offset));
+          offset = nextInput(offset, counter, 0);
+        }
+        return m_reducer.finalizePacket(accum, m_reducedSize);
+      }
+      return internal::tensor_gather_packet<Packet>(*this, index);
+    }
+
+    inline Index costPerCoeff() const { return m_reducedSize * (m_xpr.costPerCoeff() + Reducer::Cost); }
+
+  protected:
+    // returns the index in the nested expression of the first coefficient reduced into the result index
+    inline Index firstInput(Index index) const
+    {
+      Index input = 0;
+      for(int i = NumDimensions-1; i > 0; --i)
+      {
+        const Index idx = index / m_outputStrides[i];
+        input += idx * m_preservedStrides[i];
+        index -= idx * m_outputStrides[i];
+      }
+      return input + index * m_preservedStrides[0];
+    }
+
+    // moves offset to the next coefficient along the reduced dimensions from the first one on
+    inline Index nextInput(Index offset, ReducedDimensions& counter, int first) const
+    {
+      for(int r = first; r < NumReduced; ++r)
+      {
+        offset += m_reducedStrides[r];
+        if(++counter[r] < m_reducedDims[r])
+          break;
+        offset -= m_reducedStrides[r] * m_reducedDims[r];
+        counter[r] = 0;
+      }
+      return offset;
+    }
+
+    inline Scalar reduceAt(Index offset, internal::false_type) const
+    {
+      Scalar accum = m_reducer.initialize();
+      ReducedDimensions counter;
+      for(Index k = 0; k < m_reducedSize; ++k)
+      {
+        accum = m_reducer.reduce(accum, m_xpr.coeff(offset));
+        offset = nextInput(offset, counter, 0);
+      }
+      return accum;
+    }
+
+    // the innermost reduced dimension is contiguous if it is the first one
+    inline Scalar reduceAt(Index offset, internal::true_type) const
+    {
+      if(m_reducedStrides[0] != 1 || m_reducedSize == 0)
+        return reduceAt(offset, internal::false_type());
+
+      const Index innerSize = m_reducedDims[0];
+      const Index outerSize = m_reducedSize / innerSize;
+      const Index alignedSize = (innerSize / PacketSize) * PacketSize;
+      Scalar accum = m_reducer.initialize();
+      Packet paccum = m_reducer.initializePacket();
+      ReducedDimensions counter;
+      for(Index outer = 0; outer < outerSize; ++outer)
+      {
+        Index k = 0;
+        for(; k < alignedSize; k += PacketSize)
+          paccum = m_reducer.reducePacket(paccum, m_xpr.template packet<Unaligned>(offset + k));
+        for(; k < innerSize; ++k)
+          accum = m_reducer.reduce(accum, m_xpr.coeff(offset + k));
+        offset = nextInput(offset, counter, 1);
+      }
+      return alignedSize ? m_reducer.reduce(accum, m_reducer.predux(paccum)) : accum;
+    }
+
+    typename internal::tensor_nested<XprType>::type m_xpr;
+    const Reducer m_reducer;
+    Dimensions m_dimensions;
+    Dimensions m_outputStrides;
+    Dimensions m_preservedStrides;
+    ReducedDimensions m_reducedDims;
+    ReducedDimensions m_reducedStrides;
+    Index m_reducedSize;
+};
+
+namespace internal {
+
+template<typename XprType, typename Reducer,
+         bool Vectorize = (traits<XprType>::Flags & PacketAccessBit) && Reducer::PacketAccess>
+struct tensor_full_reduce_kernel
+{
+  typedef typename XprType::Scalar Scalar;
+  typedef typename XprType::Index Index;
+
+  tensor_full_reduce_kernel(const XprType& xpr, const Reducer& reducer)
+    : m_xpr(xpr), m_reducer(reducer), m_partials(0), m_threads(1) {}
+  ~tensor_full_reduce_kernel() { delete[] m_partials; }
+
+  void initParallelSession(Index threads)
+  {
+    m_partials = new Scalar[threads];
+    m_threads = threads;
+  }
+
+  void operator()(Index first, Index last, Index tid)
+  {
+    Scalar accum = m_reducer.initialize();
+    for(Index i = first; i < last; ++i)
+      accum = m_reducer.reduce(accum, m_xpr.coeff(i));
+    (m_partials ? m_partials[tid] : m_result) = accum;
+  }
+
+  const XprType& m_xpr;
+  const Reducer& m_reducer;
+  Scalar* m_partials;
+  Index m_threads;
+  Scalar m_result;
+};
+
+template<typename XprType, typename Reducer>
+struct tensor_full_reduce_kernel<XprType,Reducer,true>
+{
+  typedef typename XprType::Scalar Scalar;
+  typedef typename XprType::Index Index;
+  typedef typename packet_traits<Scalar>::type Packet;
+  enum {
+    PacketSize = packet_traits<Scalar>::size,
+    LoadMode = traits<XprType>::Flags & AlignedBit ? Aligned : Unaligned
+  };
+
+  tensor_full_reduce_kernel(const XprType& xpr, const Reducer& reducer)
+    : m_xpr(xpr), m_reducer(reducer), m_partials(0), m_threads(1) {}
+  ~tensor_full_reduce_kernel() { delete[] m_partials; }
+
+  void initParallelSession(Index threads)
+  {
+    m_partials = new Scalar[threads];
+    m_threads = threads;
+  }
+
+  // first is either 0 or a multiple of 16, so that the packets are aligned
+  void operator()(Index first, Index last, Index tid)
+  {
+    const Index alignedEnd2 = first + ((last-first)/(2*PacketSize))*(2*PacketSize);
+    const Index alignedEnd = first + ((last-first)/PacketSize)*PacketSize;
+    Scalar accum = m_reducer.initialize();
+    if(alignedEnd > first)
+    {
+      // two accumulators hide the latency of the reduction
+      Packet p0 = m_reducer.initializePacket(), p1 = m_reducer.initializePacket();
+      Index i = first;
+      for(; i < alignedEnd2; i += 2*PacketSize)
+      {
+        p0 = m_reducer.reducePacket(p0, m_xpr.template packet<LoadMode>(i));
+        p1 = m_reducer.reducePacket(p1, m_xpr.template packet<LoadMode>(i+PacketSize));
+      }
+      if(i < alignedEnd)
+        p0 = m_reducer.reducePacket(p0, m_xpr.template packet<LoadMode>(i));
+      accum = m_reducer.predux(m_reducer.reducePacket(p0, p1));
+    }
+    for(Index i = alignedEnd; i < last; ++i)
+      accum = m_reducer.reduce(accum, m_xpr.coeff(i));
+    (m_partials ? m_partials[tid] : m_result) = accum;
+  }
+
+  const XprType& m_xpr;
+  const Reducer& m_reducer;
+  Scalar* m_partials;
+  Index m_threads;
+  Scalar m_result;
+};
+
+/** \internal \returns the reduction of all the coefficients of \a xpr by \a reducer, computed in parallel
+  * if it is worth it */
+template<typename XprType, typename Reducer>
+typename XprType::Scalar tensor_full_reduce(const XprType& xpr, const Reducer& reducer)
+{
+  typedef typename XprType::Index Index;
+  typedef typename tensor_nested<const XprType>::type Nested;
+  // evaluates the contractions
+  Nested nested(xpr);
+  tensor_full_reduce_kernel<typename remove_all<Nested>::type, Reducer> kernel(nested, reducer);
+  const Index size = xpr.size();
+  if(parallelize_range(kernel, size, nested.costPerCoeff()))
+  {
+    kernel.m_result = kernel.m_partials[0];
+    for(Index t = 1; t < kernel.m_threads; ++t)
+      kernel.m_result = reducer.reduce(kernel.m_result, kernel.m_partials[t]);
+  }
+  else
+    kernel(0, size, 0);
+  return reducer.finalize(kernel.m_result, size);
+}
+
+} // end namespace internal
+
+#endif // EIGEN_TENSORREDUCTION_H
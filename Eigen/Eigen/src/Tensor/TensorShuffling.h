@@ -0,0 +1,125 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_TENSORSHUFFLING_H
+#define EIGEN_TENSORSHUFFLING_H
+
+namespace internal {
+template<typename XprType>
+struct traits<TensorShufflingOp<XprType> > : traits<XprType>
+{
+  enum { Flags = traits<XprType>::Flags & (PacketAccessBit | LvalueBit) };
+};
+}
+
+/** \ingroup Tensor_Module
+  * \brief Tensor expression of a tensor expression with permuted dimensions
+  *
+  * This is the return type of TensorBase::shuffle(). The \a i-th dimension of the shuffled expression is
+  * the dimension \a permutation[i] of the nested one, so that
+  * \code shuffled(i0, ..., in) == xpr(j0, ..., jn) \endcode
+  * with j_permutation[k] = ik. The shuffle of a writable expression is writable.
+  *
+  * When the first dimension stays in place, the packets are loaded directly from the nested expression.
+  * Otherwise they are gathered with the stride of the first dimension.
+  */
+template<typename XprType>
+class TensorShufflingOp : public TensorBase<TensorShufflingOp<XprType> >
+{
+  public:
+    typedef TensorBase<TensorShufflingOp> Base;
+    typedef typename Base::Scalar Scalar;
+    typedef typename Base::Index Index;
+    typedef typename Base::Packet Packet;
+    typedef typename Base::Dimensions Dimensions;
+    enum { NumDimensions = Base::NumDimensions, PacketSize = Base::PacketSize };
+
+    inline TensorShufflingOp(XprType& xpr, const Dimensions& permutation)
+      : m_xpr(xpr), m_innerContiguous(permutation[0] == 0)
+    {
+      const Dimensions inputStrides = internal::tensor_strides(xpr.dimensions());
+      bool used[NumDimensions] = { false };
+      for(int i = 0; i < NumDimensions; ++i)
+      {
+        eigen_assert(permutation[i] >= 0 && permutation[i] < NumDimensions && !used[permutation[i]]
+                     && "the shuffle is not a permutation");
+        used[permutation[i]] = true;
+        m_dimensions[i] = xpr.dimensions()[permutation[i]];
+        m_inputStrides[i] = inputStrides[permutation[i]];
+      }
+      m_outputStrides = internal::tensor_strides(m_dimensions);
+    }
+
+    EIGEN_TENSOR_INHERIT_ASSIGNMENT_OPERATORS(TensorShufflingOp)
+
+    inline const Dimensions& dimensions() const { return m_dimensions; }
+
+    inline Scalar coeff(Index index) const { return m_xpr.coeff(inputIndex(index)); }
+    inline Scalar& coeffRef(Index index) { return m_xpr.coeffRef(inputIndex(index)); }
+
+    template<int LoadMode>
+    inline Packet packet(Index index) const
+    {
+      if(index % m_dimensions[0] + PacketSize > m_dimensions[0])
+        return internal::tensor_gather_packet<Packet>(*this, index);
+      const Index input = inputIndex(index);
+      if(m_innerContiguous)
+        return m_xpr.template packet<Unaligned>(input);
+      // the coefficients are read with the stride of the first dimension, such as when transposing
+      EIGEN_ALIGN16 Scalar values[PacketSize];
+      for(int k = 0; k < PacketSize; ++k)
+        values[k] = m_xpr.coeff(input + k * m_inputStrides[0]);
+      return internal::pload<Packet>(values);
+    }
+
+    template<int StoreMode>
+    inline void writePacket(Index index, const Packet& x)
+    {
+      if(m_innerContiguous && index % m_dimensions[0] + PacketSize <= m_dimensions[0])
+        m_xpr.template writePacket<Unaligned>(inputIndex(index), x);
+      else
+        internal::tensor_scatter_packet(*this, index, x);
+    }
+
+    inline Index costPerCoeff() const { return m_xpr.costPerCoeff() + NumDimensions; }
+
+  protected:
+    inline Index inputIndex(Index index) const
+    {
+      Index input = 0;
+      for(int i = NumDimensions-1; i > 0; --i)
+      {
+        const Index idx = index / m_outputStrides[i];
+        input += idx * m_inputStrides[i];
+        index -= idx * m_outputStrides[i];
+      }
+      return input + index * m_inputStrides[0];
+    }
+
+    typename internal::tensor_nested<XprType>::type m_xpr;
+    Dimensions m_dimensions;
+    Dimensions m_outputStrides;
+    Dimensions m_inputStrides;
+    bool m_innerContiguous;
+};
+
+#endif // EIGEN_TENSORSHUFFLING_H
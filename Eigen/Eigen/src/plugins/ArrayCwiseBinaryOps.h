@@ -38,6 +38,13 @@ EIGEN_MAKE_CWISE_BINARY_OP(min,internal::scalar_min_op)
   */
 EIGEN_MAKE_CWISE_BINARY_OP(max,internal::scalar_max_op)
 
+/** \returns an expression of the coefficient-wise arc tangent of \c *this / \a other,
+  * in the quadrant given by the signs of both arguments.
+  *
+  * \sa atan()
+  */
+EIGEN_MAKE_CWISE_BINARY_OP(atan2,internal::scalar_atan2_op)
+
 /** \returns an expression of the coefficient-wise \< operator of *this and \a other
   *
   * Example: \include Cwise_less.cpp
@@ -131,6 +131,36 @@ tan() const
   return derived();
 }
 
+/** \returns an expression of the coefficient-wise arc tangent of *this.
+  *
+  * \sa tan(), ArrayBase::atan2()
+  */
+inline const CwiseUnaryOp<internal::scalar_atan_op<Scalar>, const Derived>
+atan() const
+{
+  return derived();
+}
+
+/** \returns an expression of the coefficient-wise hyperbolic tangent of *this.
+  *
+  * \sa logistic(), exp()
+  */
+inline const CwiseUnaryOp<internal::scalar_tanh_op<Scalar>, const Derived>
+tanh() const
+{
+  return derived();
+}
+
+/** \returns an expression of the coefficient-wise logistic function 1/(1+exp(-x)) of *this.
+  *
+  * \sa tanh(), exp()
+  */
+inline const CwiseUnaryOp<internal::scalar_logistic_op<Scalar>, const Derived>
+logistic() const
+{
+  return derived();
+}
+
 
 /** \returns an expression of the coefficient-wise power of *this to the given exponent.
   *
@@ -0,0 +1,112 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_BENCH_TIMER_H
+#define EIGEN_BENCH_TIMER_H
+
+#if defined(_WIN32) || defined(__CYGWIN__)
+# ifndef NOMINMAX
+#   define NOMINMAX
+# endif
+# include <windows.h>
+#else
+# include <sys/time.h>
+#endif
+
+#include <limits>
+#include <algorithm>
+
+namespace Eigen
+{
+
+/** Elapsed time timer keeping track of the best and total times of several runs.
+  *
+  * The BENCH macro below runs a piece of code several times and keeps the best time:
+  * \code
+  * BenchTimer t;
+  * BENCH(t, 4, 10, y = A*x);
+  * std::cout << t.best() << "s\n";
+  * \endcode
+  */
+class BenchTimer
+{
+public:
+
+  BenchTimer() { reset(); }
+
+  void reset()
+  {
+    m_best = (std::numeric_limits<double>::max)();
+    m_total = 0;
+    m_start = 0;
+  }
+
+  inline void start() { m_start = getTime(); }
+
+  inline void stop()
+  {
+    double t = getTime() - m_start;
+    m_best = (std::min)(m_best, t);
+    m_total += t;
+  }
+
+  /** \returns the best elapsed time in seconds */
+  inline double best() const { return m_best; }
+
+  /** \returns the sum of the elapsed times in seconds */
+  inline double total() const { return m_total; }
+
+  /** \returns the current wall clock time in seconds */
+  static inline double getTime()
+  {
+#if defined(_WIN32) || defined(__CYGWIN__)
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return double(count.QuadPart) / double(freq.QuadPart);
+#else
+    struct timeval tv;
+    gettimeofday(&tv, 0);
+    return double(tv.tv_sec) + 1e-6 * double(tv.tv_usec);
+#endif
+  }
+
+protected:
+  double m_best, m_total, m_start;
+};
+
+/** Runs CODE REP times within each of TRIES timed runs, and keeps the best time of a run in TIMER,
+  * so that best() is the time of REP executions of CODE. */
+#define BENCH(TIMER,TRIES,REP,CODE) { \
+    TIMER.reset(); \
+    for(int uglyvarname1=0; uglyvarname1<TRIES; ++uglyvarname1){ \
+      TIMER.start(); \
+      for(int uglyvarname2=0; uglyvarname2<REP; ++uglyvarname2){ \
+        CODE; \
+      } \
+      TIMER.stop(); \
+    } \
+  }
+
+}
+
+#endif // EIGEN_BENCH_TIMER_H
@@ -0,0 +1,364 @@
+// Benchmark suite of the dense products, the dense decompositions and the sparse products, to check that a
+// compiler, flag or code change does not regress them. Each benchmark is run over a range of sizes, for fixed
+// and dynamic size matrices, in float and double, and for the parallel ones with a range of thread counts.
+// The results are printed as JSON, one result per line, so that the outputs of two builds can be diffed:
+//
+// g++ -O3 -DNDEBUG -march=native benchmark_suite.cpp -I.. -o benchmark_suite && ./benchmark_suite > a.json
+// g++ -O3 -DNDEBUG -march=native -fopenmp benchmark_suite.cpp -I.. -o benchmark_suite && ./benchmark_suite
+//
+// ./benchmark_suite gemm llt   only runs the benchmarks whose name contains one of the arguments
+//
+// -DQUICK runs fewer sizes and shorter measurements, -DSCALE=n multiplies the sizes by about n (default 1).
+//
+// Each result gives the best time of one run in seconds, the rate in GFLOP/s computed from a nominal flop count,
+// and the bandwidth in GB/s computed from the size of the operands which have to be read or written at least
+// once. The nominal flop counts of the decompositions are the usual ones of LAPACK (n^3/3 for LLT, 2n^3/3 for
+// LU, 4n^3/3 + 9n^3 for SelfAdjointEigenSolver with eigenvectors, 12n^3 for JacobiSVD with U and V),
+// so the GFLOP/s are only meant to compare builds, not algorithms.
+
+#define EIGEN_YES_I_KNOW_SPARSE_MODULE_IS_NOT_STABLE_YET
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include "BenchTimer.h"
+
+using namespace Eigen;
+
+#ifndef SCALE
+#define SCALE 1
+#endif
+
+#ifdef QUICK
+static const int tries = 2;
+static const double minTime = 0.01;
+#else
+static const int tries = 5;
+static const double minTime = 0.05;
+#endif
+
+static std::vector<std::string> filters;
+static bool firstResult = true;
+
+bool enabled(const char* name)
+{
+  if(filters.empty())
+    return true;
+  for(size_t i=0; i<filters.size(); ++i)
+    if(std::strstr(name, filters[i].c_str()))
+      return true;
+  return false;
+}
+
+template<typename Scalar> const char* scalarName();
+template<> const char* scalarName<float>() { return "float"; }
+template<> const char* scalarName<double>() { return "double"; }
+
+void report(const char* name, const char* scalar, const char* storage, int size, double time, double flops, double bytes)
+{
+  std::cout << (firstResult ? "" : ",\n") << "    {\"name\": \"" << name << "\", \"scalar\": \"" << scalar
+            << "\", \"storage\": \"" << storage << "\", \"size\": " << size << ", \"threads\": " << nbThreads()
+            << ", \"time\": " << time << ", \"gflops\": " << flops/time*1e-9 << ", \"gbps\": " << bytes/time*1e-9 << "}";
+  firstResult = false;
+}
+
+// Measures the best time of one execution of a functor, repeating it enough times for the timer resolution.
+// The functor is a class with an operator() so that the benchmarks can be written as templates in C++98, and
+// the operator() is not inlined so that the compiler cannot merge the repetitions of the small fixed sizes.
+template<typename Func>
+double measure(Func& func)
+{
+  BenchTimer timer;
+  int rep = 1;
+  for(;;)
+  {
+    BENCH(timer, 1, rep, func());
+    if(timer.best() > minTime || rep > (1<<24))
+      break;
+    rep *= 2;
+  }
+  BENCH(timer, tries, rep, func());
+  return timer.best() / rep;
+}
+
+template<typename MatrixType>
+const char* storageName()
+{
+  return MatrixType::SizeAtCompileTime==Dynamic ? "dynamic" : "fixed";
+}
+
+template<typename MatrixType>
+MatrixType randomSpd(int n)
+{
+  MatrixType a = MatrixType::Random(n,n);
+  MatrixType spd = a * a.transpose();
+  spd.diagonal().array() += typename MatrixType::Scalar(n);
+  return spd;
+}
+
+/***************************************************************************
+* Dense benchmarks
+***************************************************************************/
+
+template<typename MatrixType> struct GemmBench
+{
+  MatrixType a, b, c;
+  GemmBench(int n) : a(MatrixType::Random(n,n)), b(MatrixType::Random(n,n)), c(n,n) {}
+  EIGEN_DONT_INLINE void operator()() { c.noalias() += a * b; }
+  static const char* name() { return "gemm"; }
+  static double flops(double n) { return 2*n*n*n; }
+  static double bytes(double n) { return 4*n*n; }
+};
+
+template<typename MatrixType> struct GemvBench
+{
+  typedef Matrix<typename MatrixType::Scalar,MatrixType::RowsAtCompileTime,1> VectorType;
+  MatrixType a;
+  VectorType x, y;
+  GemvBench(int n) : a(MatrixType::Random(n,n)), x(VectorType::Random(n)), y(VectorType::Zero(n)) {}
+  EIGEN_DONT_INLINE void operator()() { y.noalias() += a * x; }
+  static const char* name() { return "gemv"; }
+  static double flops(double n) { return 2*n*n; }
+  static double bytes(double n) { return n*n + 3*n; }
+};
+
+template<typename MatrixType> struct LltBench
+{
+  MatrixType a;
+  LLT<MatrixType> llt;
+  LltBench(int n) : a(randomSpd<MatrixType>(n)), llt(n) {}
+  EIGEN_DONT_INLINE void operator()() { llt.compute(a); }
+  static const char* name() { return "llt"; }
+  static double flops(double n) { return n*n*n/3; }
+  static double bytes(double n) { return 2*n*n; }
+};
+
+template<typename MatrixType> struct LuBench
+{
+  MatrixType a;
+  PartialPivLU<MatrixType> lu;
+  LuBench(int n) : a(MatrixType::Random(n,n)), lu(n) { a.diagonal().array() += typename MatrixType::Scalar(n); }
+  EIGEN_DONT_INLINE void operator()() { lu.compute(a); }
+  static const char* name() { return "partialpivlu"; }
+  static double flops(double n) { return 2*n*n*n/3; }
+  static double bytes(double n) { return 2*n*n; }
+};
+
+template<typename MatrixType> struct SvdBench
+{
+  MatrixType a;
+  JacobiSVD<MatrixType> svd;
+  SvdBench(int n) : a(MatrixType::Random(n,n)), svd(n,n,ComputeFullU|ComputeFullV) {}
+  EIGEN_DONT_INLINE void operator()() { svd.compute(a, ComputeFullU|ComputeFullV); }
+  static const char* name() { return "jacobisvd"; }
+  static double flops(double n) { return 12*n*n*n; }
+  static double bytes(double n) { return 4*n*n; }
+};
+
+template<typename MatrixType> struct EigenSolverBench
+{
+  MatrixType a;
+  SelfAdjointEigenSolver<MatrixType> eig;
+  EigenSolverBench(int n) : a(randomSpd<MatrixType>(n)), eig(n) {}
+  EIGEN_DONT_INLINE void operator()() { eig.compute(a); }
+  static const char* name() { return "selfadjointeigensolver"; }
+  static double flops(double n) { return 4*n*n*n/3 + 9*n*n*n; }
+  static double bytes(double n) { return 3*n*n; }
+};
+
+template<template<typename> class Bench, typename MatrixType>
+void runDense(int n)
+{
+  if(!enabled(Bench<MatrixType>::name()))
+    return;
+  typedef typename MatrixType::Scalar Scalar;
+  Bench<MatrixType> bench(n);
+  double time = measure(bench);
+  report(Bench<MatrixType>::name(), scalarName<Scalar>(), storageName<MatrixType>(), n, time,
+         Bench<MatrixType>::flops(n), Bench<MatrixType>::bytes(n) * sizeof(Scalar));
+}
+
+template<template<typename> class Bench, typename Scalar>
+void runFixed()
+{
+  runDense<Bench, Matrix<Scalar,2,2> >(2);
+  runDense<Bench, Matrix<Scalar,3,3> >(3);
+  runDense<Bench, Matrix<Scalar,4,4> >(4);
+  runDense<Bench, Matrix<Scalar,8,8> >(8);
+  runDense<Bench, Matrix<Scalar,16,16> >(16);
+}
+
+template<template<typename> class Bench, typename Scalar>
+void runDynamic(const std::vector<int>& sizes)
+{
+  for(size_t i=0; i<sizes.size(); ++i)
+    runDense<Bench, Matrix<Scalar,Dynamic,Dynamic> >(sizes[i]);
+}
+
+/***************************************************************************
+* Sparse benchmarks
+***************************************************************************/
+
+// 5-point stencil of a n x n grid
+template<typename SparseMatrixType>
+SparseMatrixType laplacian2d(int n)
+{
+  typedef typename SparseMatrixType::Scalar Scalar;
+  std::vector<Triplet<Scalar> > triplets;
+  triplets.reserve(5*n*n);
+  for(int y=0; y<n; ++y)
+    for(int x=0; x<n; ++x)
+    {
+      int i = x + y*n;
+      triplets.push_back(Triplet<Scalar>(i, i, Scalar(4)));
+      if(x>0)   triplets.push_back(Triplet<Scalar>(i, i-1, Scalar(-1)));
+      if(x<n-1) triplets.push_back(Triplet<Scalar>(i, i+1, Scalar(-1)));
+      if(y>0)   triplets.push_back(Triplet<Scalar>(i, i-n, Scalar(-1)));
+      if(y<n-1) triplets.push_back(Triplet<Scalar>(i, i+n, Scalar(-1)));
+    }
+  SparseMatrixType a(n*n, n*n);
+  a.setFromTriplets(triplets.begin(), triplets.end());
+  return a;
+}
+
+template<typename SparseMatrixType> struct SpmvBench
+{
+  typedef typename SparseMatrixType::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  SparseMatrixType a;
+  VectorType x, y;
+  SpmvBench(int n) : a(laplacian2d<SparseMatrixType>(n)), x(VectorType::Random(n*n)), y(n*n) {}
+  EIGEN_DONT_INLINE void operator()() { y.noalias() = a * x; }
+  static const char* name() { return "spmv"; }
+  double flops() const { return 2.*a.nonZeros(); }
+  double bytes() const { return a.nonZeros()*(sizeof(Scalar)+sizeof(int)) + 2.*a.rows()*sizeof(Scalar); }
+};
+
+template<typename SparseMatrixType> struct SpmmBench
+{
+  enum { Cols = 8 };
+  typedef typename SparseMatrixType::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseType;
+  SparseMatrixType a;
+  DenseType x, y;
+  SpmmBench(int n) : a(laplacian2d<SparseMatrixType>(n)), x(DenseType::Random(n*n,Cols)), y(n*n,Cols) {}
+  EIGEN_DONT_INLINE void operator()() { y.noalias() = a * x; }
+  static const char* name() { return "spmm"; }
+  double flops() const { return 2.*a.nonZeros()*Cols; }
+  double bytes() const { return a.nonZeros()*(sizeof(Scalar)+sizeof(int)) + 2.*a.rows()*Cols*sizeof(Scalar); }
+};
+
+template<typename SparseMatrixType> struct SpgemmBench
+{
+  typedef typename SparseMatrixType::Scalar Scalar;
+  SparseMatrixType a, c;
+  SpgemmBench(int n) : a(laplacian2d<SparseMatrixType>(n)) {}
+  EIGEN_DONT_INLINE void operator()() { c = a * a; }
+  static const char* name() { return "spgemm"; }
+  // each nonzero a(i,k) is multiplied by the nonzeros of the row k, 5 per row of the stencil at most
+  double flops() const { return 2.*5*a.nonZeros(); }
+  double bytes() const { return (2.*a.nonZeros() + c.nonZeros())*(sizeof(Scalar)+sizeof(int)); }
+};
+
+template<template<typename> class Bench, typename SparseMatrixType>
+void runSparse(int n, const char* storage)
+{
+  if(!enabled(Bench<SparseMatrixType>::name()))
+    return;
+  typedef typename SparseMatrixType::Scalar Scalar;
+  Bench<SparseMatrixType> bench(n);
+  double time = measure(bench);
+  report(Bench<SparseMatrixType>::name(), scalarName<Scalar>(), storage, n*n, time, bench.flops(), bench.bytes());
+}
+
+template<typename Scalar>
+void runSparse(const std::vector<int>& grids)
+{
+  for(size_t i=0; i<grids.size(); ++i)
+  {
+    runSparse<SpmvBench, SparseMatrix<Scalar,ColMajor> >(grids[i], "colmajor");
+    runSparse<SpmvBench, SparseMatrix<Scalar,RowMajor> >(grids[i], "rowmajor");
+    runSparse<SpmmBench, SparseMatrix<Scalar,ColMajor> >(grids[i], "colmajor");
+    runSparse<SpmmBench, SparseMatrix<Scalar,RowMajor> >(grids[i], "rowmajor");
+    runSparse<SpgemmBench, SparseMatrix<Scalar,ColMajor> >(grids[i], "colmajor");
+  }
+}
+
+/***************************************************************************
+* Driver
+***************************************************************************/
+
+template<typename Scalar>
+void runAll(bool serial)
+{
+#ifdef QUICK
+  static const int denseSizes[] = { 32, 128, 512 };
+  static const int svdSizes[] = { 16, 64 };
+  static const int grids[] = { 64, 256 };
+#else
+  static const int denseSizes[] = { 8, 16, 32, 64, 128, 256, 512, 1024 };
+  static const int svdSizes[] = { 8, 16, 32, 64, 128, 256 };
+  static const int grids[] = { 32, 128, 512, 1024 };
+#endif
+  // the small sizes never run in parallel, so they are only measured with one thread
+  std::vector<int> dense, svd, sparse;
+  for(size_t i=0; i<sizeof(denseSizes)/sizeof(int); ++i)
+    if(serial || denseSizes[i]>=128)
+      dense.push_back(denseSizes[i]*SCALE);
+  for(size_t i=0; i<sizeof(svdSizes)/sizeof(int); ++i)
+    if(serial)
+      svd.push_back(svdSizes[i]*SCALE);
+  for(size_t i=0; i<sizeof(grids)/sizeof(int); ++i)
+    sparse.push_back(grids[i]*SCALE);
+
+  if(serial)
+  {
+    runFixed<GemmBench,Scalar>();
+    runFixed<GemvBench,Scalar>();
+    runFixed<LltBench,Scalar>();
+    runFixed<LuBench,Scalar>();
+    runFixed<SvdBench,Scalar>();
+    runFixed<EigenSolverBench,Scalar>();
+  }
+  runDynamic<GemmBench,Scalar>(dense);
+  runDynamic<GemvBench,Scalar>(dense);
+  runDynamic<LltBench,Scalar>(dense);
+  runDynamic<LuBench,Scalar>(dense);
+  // JacobiSVD and SelfAdjointEigenSolver are sequential
+  runDynamic<SvdBench,Scalar>(svd);
+  runDynamic<EigenSolverBench,Scalar>(svd);
+  runSparse<Scalar>(sparse);
+}
+
+int main(int argc, char** argv)
+{
+  for(int i=1; i<argc; ++i)
+    filters.push_back(argv[i]);
+
+  const int maxThreads = nbThreads();
+  std::vector<int> threads;
+  for(int t=1; t<maxThreads; t*=2)
+    threads.push_back(t);
+  threads.push_back(maxThreads);
+
+  std::cout << "{\n";
+  std::cout << "  \"eigen_version\": \"" << EIGEN_WORLD_VERSION << "." << EIGEN_MAJOR_VERSION << "." << EIGEN_MINOR_VERSION << "\",\n";
+  std::cout << "  \"simd\": \"" << SimdInstructionSetsInUse() << "\",\n";
+#ifdef __VERSION__
+  std::cout << "  \"compiler\": \"" << __VERSION__ << "\",\n";
+#endif
+  std::cout << "  \"max_threads\": " << maxThreads << ",\n";
+  std::cout << "  \"l1_cache_size\": " << l1CacheSize() << ",\n";
+  std::cout << "  \"l2_cache_size\": " << l2CacheSize() << ",\n";
+  std::cout << "  \"results\": [\n";
+  for(size_t t=0; t<threads.size(); ++t)
+  {
+    setNbThreads(threads[t]);
+    runAll<float>(t==0);
+    runAll<double>(t==0);
+  }
+  std::cout << "\n  ]\n}\n";
+  return 0;
+}
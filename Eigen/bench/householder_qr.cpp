@@ -0,0 +1,107 @@
+// Benchmark of the blocked ColPivHouseholderQR and of the blocked application of a HouseholderSequence, on a
+// tall 2000x500 and a square 4000x4000 matrix. The column pivoting QR is compared to HouseholderQR, whose lack
+// of pivoting gives the speed the blocked pivoting can reach at best (so its speedup is below 1). The products
+// by the Householder sequence, Q*B, Q^*B and Q itself, are compared to the application of one reflector at a time.
+//
+// g++ -O3 -DNDEBUG -march=native householder_qr.cpp -I.. -o householder_qr && ./householder_qr
+// g++ -O3 -DNDEBUG -march=native -fopenmp householder_qr.cpp -I.. -o householder_qr && OMP_NUM_THREADS=4 ./householder_qr
+//
+// ./householder_qr rows cols   runs a single size. The rel.diff column is the relative difference with the
+// reference, or the residual |A P - Q R| / |A| for the decompositions. The GFlop/s are computed from the nominal
+// flop counts of LAPACK, 2mn^2 - 2n^3/3 for the QR and 4mnk - 2n^2k for applying n reflectors to k columns.
+
+#include <Eigen/Dense>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include "BenchTimer.h"
+
+#ifndef SCALAR
+#define SCALAR double
+#endif
+
+using namespace Eigen;
+
+typedef SCALAR Scalar;
+typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+typedef Matrix<Scalar,Dynamic,1> DenseVector;
+
+// number of columns of the right hand sides of Q*B and Q^*B
+static const int rhsCols = 256;
+
+// applies the reflectors of the decomposition to dst one at a time, as Q*dst, or Q^*dst if adjoint is true
+template<typename Decomposition>
+void reference_apply(const Decomposition& dec, DenseMatrix& dst, bool adjoint)
+{
+  const DenseMatrix& qr = dec.matrixQR();
+  const int m = int(qr.rows()), n = int((std::min)(qr.rows(), qr.cols()));
+  DenseVector temp(dst.cols());
+  for(int i=0; i<n; ++i)
+  {
+    int k = adjoint ? i : n-1-i;
+    Scalar tau = adjoint ? internal::conj(dec.hCoeffs().coeff(k)) : dec.hCoeffs().coeff(k);
+    dst.bottomRows(m-k).applyHouseholderOnTheLeft(qr.col(k).tail(m-k-1), tau, temp.data());
+  }
+}
+
+void report(const char* op, int rows, int cols, double flops, double time, double refTime, double diff)
+{
+  std::cout << std::setw(11) << rows << "x" << std::left << std::setw(6) << cols << std::right << std::setw(12) << op
+            << std::setw(10) << std::setprecision(3) << time << std::setw(10) << flops / time * 1e-9;
+  if(refTime > 0)
+    std::cout << std::setw(10) << refTime << std::setw(10) << std::setprecision(2) << refTime / time;
+  else
+    std::cout << std::setw(10) << "-" << std::setw(10) << "-";
+  std::cout << std::setw(12) << std::setprecision(1) << diff << "\n";
+}
+
+void bench(int m, int n)
+{
+  // the large sizes take seconds per run
+  const int tries = double(m)*n*n > 1e9 ? 1 : 3;
+  const double dm = m, dn = (std::min)(m, n);
+  DenseMatrix A = DenseMatrix::Random(m, n);
+
+  BenchTimer timer, timerRef;
+  ColPivHouseholderQR<DenseMatrix> cpqr(m, n);
+  HouseholderQR<DenseMatrix> hqr(m, n);
+  BENCH(timer, tries, 1, cpqr.compute(A));
+  BENCH(timerRef, tries, 1, hqr.compute(A));
+  const double qrFlops = 2*dm*n*n - 2*dn*dn*dn/3, cpqrTime = timer.best(), hqrTime = timerRef.best();
+
+  DenseMatrix Q;
+  BENCH(timer, tries, 1, Q = cpqr.householderQ());
+  DenseMatrix Qref(m, m);
+  BENCH(timerRef, tries, 1, Qref.setIdentity(); reference_apply(cpqr, Qref, false));
+
+  DenseMatrix R = cpqr.matrixQR().template triangularView<Upper>();
+  DenseMatrix AP = A * cpqr.colsPermutation();
+  report("colpivqr", m, n, qrFlops, cpqrTime, hqrTime, (AP - Q * R).norm() / A.norm());
+  R = hqr.matrixQR().template triangularView<Upper>();
+  report("qr", m, n, qrFlops, hqrTime, 0, (A - DenseMatrix(hqr.householderQ()) * R).norm() / A.norm());
+  report("matrixQ", m, n, 4*dm*dn*m - 2*dn*dn*m, timer.best(), timerRef.best(), (Q - Qref).norm() / Qref.norm());
+
+  DenseMatrix B = DenseMatrix::Random(m, rhsCols), C, Cref;
+  double applyFlops = 4*dm*dn*rhsCols - 2*dn*dn*rhsCols;
+  BENCH(timer, tries, 1, C = B; C.applyOnTheLeft(cpqr.householderQ()));
+  BENCH(timerRef, tries, 1, Cref = B; reference_apply(cpqr, Cref, false));
+  report("Q*B", m, n, applyFlops, timer.best(), timerRef.best(), (C - Cref).norm() / Cref.norm());
+  BENCH(timer, tries, 1, C = B; C.applyOnTheLeft(cpqr.householderQ().adjoint()));
+  BENCH(timerRef, tries, 1, Cref = B; reference_apply(cpqr, Cref, true));
+  report("Q^*B", m, n, applyFlops, timer.best(), timerRef.best(), (C - Cref).norm() / Cref.norm());
+}
+
+int main(int argc, char** argv)
+{
+  std::cout << "threads: " << nbThreads() << ", " << SimdInstructionSetsInUse() << "\n";
+  std::cout << std::setw(18) << "size" << std::setw(12) << "op" << std::setw(10) << "time" << std::setw(10) << "GFlop/s"
+            << std::setw(10) << "ref.time" << std::setw(10) << "speedup" << std::setw(12) << "rel.diff" << "\n";
+  if(argc==3)
+    bench(std::atoi(argv[1]), std::atoi(argv[2]));
+  else
+  {
+    bench(2000, 500);
+    bench(4000, 4000);
+  }
+  return 0;
+}
@@ -0,0 +1,211 @@
+// Benchmark of the products of a compressed sparse matrix by a dense vector (SpMV) and by a dense
+// matrix (SpMM), on synthetic matrices with the shapes of typical SuiteSparse problems.
+// For each matrix, the product with the SparseMatrix kernels is compared to a reference implementation
+// of the generic InnerIterator loop, in both storage orders.
+//
+// g++ -O3 -DNDEBUG -msse4.2 spmv.cpp -I.. -o spmv && ./spmv
+// g++ -O3 -DNDEBUG -march=native -fopenmp spmv.cpp -I.. -o spmv && OMP_NUM_THREADS=4 ./spmv
+//
+// -DSCALE=n multiplies the sizes of the matrices by about n (default 1).
+
+#define EIGEN_YES_I_KNOW_SPARSE_MODULE_IS_NOT_STABLE_YET
+#include <Eigen/Sparse>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include "BenchTimer.h"
+
+#ifndef SCALE
+#define SCALE 1
+#endif
+
+#ifndef SCALAR
+#define SCALAR double
+#endif
+
+using namespace Eigen;
+
+typedef SCALAR Scalar;
+typedef SparseMatrix<Scalar,ColMajor> SpMatCol;
+typedef SparseMatrix<Scalar,RowMajor> SpMatRow;
+typedef Matrix<Scalar,Dynamic,1> DenseVector;
+typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrix;
+typedef std::vector<std::vector<int> > Pattern;
+
+// builds a column-major matrix from the row indices of each column, with random values
+SpMatCol fromPattern(int rows, Pattern& cols)
+{
+  int nnz = 0;
+  for(size_t j=0; j<cols.size(); ++j)
+  {
+    std::sort(cols[j].begin(), cols[j].end());
+    cols[j].erase(std::unique(cols[j].begin(), cols[j].end()), cols[j].end());
+    nnz += int(cols[j].size());
+  }
+  SpMatCol A(rows, int(cols.size()));
+  A.reserve(nnz);
+  for(int j=0; j<int(cols.size()); ++j)
+  {
+    A.startVec(j);
+    for(size_t k=0; k<cols[j].size(); ++k)
+      A.insertBackByOuterInner(j, cols[j][k]) = internal::random<Scalar>();
+  }
+  A.finalize();
+  return A;
+}
+
+// 2D Poisson problem, 5-point stencil (e.g. the 2D/3D problem group)
+SpMatCol stencil2d(int n)
+{
+  Pattern cols(n*n);
+  for(int y=0; y<n; ++y)
+    for(int x=0; x<n; ++x)
+    {
+      int j = x + y*n;
+      cols[j].push_back(j);
+      if(x>0) cols[j].push_back(j-1);
+      if(x<n-1) cols[j].push_back(j+1);
+      if(y>0) cols[j].push_back(j-n);
+      if(y<n-1) cols[j].push_back(j+n);
+    }
+  return fromPattern(n*n, cols);
+}
+
+// 3D problem, 27-point stencil
+SpMatCol stencil3d(int n)
+{
+  Pattern cols(n*n*n);
+  for(int z=0; z<n; ++z)
+    for(int y=0; y<n; ++y)
+      for(int x=0; x<n; ++x)
+      {
+        int j = x + n*(y + n*z);
+        for(int dz=-1; dz<=1; ++dz)
+          for(int dy=-1; dy<=1; ++dy)
+            for(int dx=-1; dx<=1; ++dx)
+              if(x+dx>=0 && x+dx<n && y+dy>=0 && y+dy<n && z+dz>=0 && z+dz<n)
+                cols[j].push_back(j + dx + n*(dy + n*dz));
+      }
+  return fromPattern(n*n*n, cols);
+}
+
+// structural mechanics, 3x3 dense blocks on a 2D mesh with 9 neighbors per node
+SpMatCol fem(int n)
+{
+  Pattern cols(3*n*n);
+  for(int y=0; y<n; ++y)
+    for(int x=0; x<n; ++x)
+      for(int dy=-1; dy<=1; ++dy)
+        for(int dx=-1; dx<=1; ++dx)
+          if(x+dx>=0 && x+dx<n && y+dy>=0 && y+dy<n)
+          {
+            int node = x + y*n, other = x+dx + (y+dy)*n;
+            for(int a=0; a<3; ++a)
+              for(int b=0; b<3; ++b)
+                cols[3*node+a].push_back(3*other+b);
+          }
+  return fromPattern(3*n*n, cols);
+}
+
+// circuit simulation, a diagonal and a few random entries per column
+SpMatCol circuit(int n)
+{
+  Pattern cols(n);
+  for(int j=0; j<n; ++j)
+  {
+    cols[j].push_back(j);
+    for(int k=0; k<4; ++k)
+      cols[j].push_back(std::rand() % n);
+  }
+  return fromPattern(n, cols);
+}
+
+// web or social graph, the number of entries of the rows follows a power law
+SpMatCol powerlaw(int n)
+{
+  Pattern cols(n);
+  for(int i=0; i<n; ++i)
+  {
+    double u = (std::rand() + 1.0) / (RAND_MAX + 2.0);
+    int count = (std::min)(n, int(2.0 * std::pow(u, -1.0/1.2)));
+    for(int k=0; k<count; ++k)
+      cols[std::rand() % n].push_back(i);
+  }
+  return fromPattern(n, cols);
+}
+
+// the generic loop of SparseTimeDenseProduct
+template<typename Lhs, typename Rhs, typename Dest>
+void reference_product(const Lhs& lhs, const Rhs& rhs, Dest& dest)
+{
+  enum { LhsIsRowMajor = (Lhs::Flags&RowMajorBit)==RowMajorBit };
+  dest.setZero();
+  for(int j=0; j<lhs.outerSize(); ++j)
+  {
+    typename Dest::RowXpr dest_j(dest.row(LhsIsRowMajor ? j : 0));
+    for(typename Lhs::InnerIterator it(lhs,j); it; ++it)
+    {
+      if(LhsIsRowMajor) dest_j += it.value() * rhs.row(it.index());
+      else              dest.row(it.index()) += it.value() * rhs.row(j);
+    }
+  }
+}
+
+template<typename SpMat>
+void bench(const char* name, const char* order, const SpMat& A)
+{
+  const int tries = 3;
+  const int ks[] = { 1, 4, 16, 64 };
+  for(int t=0; t<4; ++t)
+  {
+    const int k = ks[t];
+    DenseMatrix B = DenseMatrix::Random(A.cols(), k);
+    DenseMatrix C(A.rows(), k), Cref(A.rows(), k);
+    int rep = (std::max)(1, int(2e7 / (double(A.nonZeros()) * k)));
+
+    BenchTimer timer, timerRef;
+    if(k==1)
+    {
+      DenseVector x = B.col(0), y(A.rows());
+      BENCH(timer, tries, rep, y.noalias() = A * x);
+      C.col(0) = y;
+    }
+    else
+      BENCH(timer, tries, rep, C.noalias() = A * B);
+    BENCH(timerRef, tries, rep, reference_product(A, B, Cref));
+
+    double flops = 2.0 * double(A.nonZeros()) * k * rep;
+    std::cout << std::setw(10) << name << std::setw(5) << order
+              << std::setw(9) << A.rows() << std::setw(10) << A.nonZeros() << std::setw(5) << k
+              << std::setw(12) << std::setprecision(3) << flops / timer.best() * 1e-9
+              << std::setw(12) << flops / timerRef.best() * 1e-9
+              << std::setw(10) << std::setprecision(2) << timerRef.best() / timer.best()
+              << std::setw(12) << std::setprecision(1) << (C - Cref).norm() / Cref.norm() << "\n";
+  }
+}
+
+void bench(const char* name, const SpMatCol& A)
+{
+  bench(name, "CSC", A);
+  SpMatRow Ar = A;
+  bench(name, "CSR", Ar);
+}
+
+int main()
+{
+  std::srand(0);
+  std::cout << "threads: " << nbThreads() << "\n";
+  std::cout << std::setw(10) << "matrix" << std::setw(5) << "fmt" << std::setw(9) << "rows" << std::setw(10) << "nnz"
+            << std::setw(5) << "k" << std::setw(12) << "GFlop/s" << std::setw(12) << "generic" << std::setw(10) << "speedup"
+            << std::setw(12) << "rel.diff" << "\n";
+  const double s = std::sqrt(double(SCALE));
+  bench("poisson2d", stencil2d(int(500*s)));
+  bench("stencil27", stencil3d(int(40*std::pow(double(SCALE),1.0/3.0))));
+  bench("fem3x3", fem(int(150*s)));
+  bench("circuit", circuit(250000*SCALE));
+  bench("powerlaw", powerlaw(250000*SCALE));
+  return 0;
+}
@@ -0,0 +1,146 @@
+// Tuning of the matrix products for the current machine, in the spirit of the tuneup program of GMP/MPIR.
+// For float and double, the program benchmarks the GEBP product kernel over a range of blocking sizes kc and
+// mc, and the coefficient based product against the GEBP kernel for small dynamic sizes to find their crossover.
+// It then writes a tuning profile which Eigen loads at startup when the EIGEN_TUNING_PROFILE environment
+// variable names it, or with loadTuningProfile():
+//
+// g++ -O3 -DNDEBUG -march=native tune_products.cpp -I.. -o tune_products && ./tune_products eigen_tuning.txt
+// EIGEN_TUNING_PROFILE=eigen_tuning.txt ./my_program
+//
+// Compile with the same vectorization flags as the programs using the profile, since the best blocking sizes
+// depend on the packet size. -DQUICK runs a shorter and noisier tuning.
+
+#include <Eigen/Core>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include "BenchTimer.h"
+
+using namespace Eigen;
+
+#ifdef QUICK
+static const int tries = 2;
+static const int largeSize = 384;
+static const double minTime = 0.02;
+#else
+static const int tries = 5;
+static const int largeSize = 1024;
+static const double minTime = 0.1;
+#endif
+
+// a new setting has to be faster than the current one by this factor to be kept
+static const double margin = 1.02;
+
+// returns the best time of one product of a rows x depth matrix by a depth x cols matrix
+template<typename Scalar>
+double timeProduct(int rows, int cols, int depth)
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+  MatrixType a = MatrixType::Random(rows,depth), b = MatrixType::Random(depth,cols), c(rows,cols);
+  BenchTimer timer;
+  int rep = 1;
+  for(;;)
+  {
+    BENCH(timer, 1, rep, c.noalias() = a*b);
+    if(timer.best() > minTime || rep > (1<<24))
+      break;
+    rep *= 2;
+  }
+  BENCH(timer, tries, rep, c.noalias() = a*b);
+  return timer.best() / rep;
+}
+
+template<typename Scalar>
+double gflops(int size, double time)
+{
+  return 2. * double(size) * double(size) * double(size) / time * 1e-9;
+}
+
+// tunes the upper bounds of the blocking sizes by coordinate descent, starting from the ones derived from the
+// cache sizes
+template<typename Scalar>
+void tuneBlockingSizes(const char* name)
+{
+  std::ptrdiff_t defaultKc = largeSize, defaultMc = largeSize, n = largeSize;
+  setMaxProductBlockingSizes<Scalar>(0, 0);
+  internal::computeProductBlockingSizes<Scalar,Scalar>(defaultKc, defaultMc, n);
+  double bestTime = timeProduct<Scalar>(largeSize, largeSize, largeSize);
+  std::ptrdiff_t bestKc = 0, bestMc = 0;
+  std::cout << name << ": default kc=" << defaultKc << " mc=" << defaultMc << ", "
+            << gflops<Scalar>(largeSize, bestTime) << " GFLOPS\n";
+
+  static const int kcs[] = { 64, 96, 128, 160, 192, 256, 320, 384, 512, 768 };
+  for(unsigned int i = 0; i < sizeof(kcs)/sizeof(kcs[0]); ++i)
+  {
+    setMaxProductBlockingSizes<Scalar>(kcs[i], bestMc);
+    double t = timeProduct<Scalar>(largeSize, largeSize, largeSize);
+    std::cout << "  kc=" << std::setw(4) << kcs[i] << ": " << gflops<Scalar>(largeSize, t) << " GFLOPS\n";
+    if(t * margin < bestTime)
+    {
+      bestTime = t;
+      bestKc = kcs[i];
+    }
+  }
+
+  static const int mcs[] = { 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024 };
+  for(unsigned int i = 0; i < sizeof(mcs)/sizeof(mcs[0]); ++i)
+  {
+    setMaxProductBlockingSizes<Scalar>(bestKc, mcs[i]);
+    double t = timeProduct<Scalar>(largeSize, largeSize, largeSize);
+    std::cout << "  mc=" << std::setw(4) << mcs[i] << ": " << gflops<Scalar>(largeSize, t) << " GFLOPS\n";
+    if(t * margin < bestTime)
+    {
+      bestTime = t;
+      bestMc = mcs[i];
+    }
+  }
+
+  setMaxProductBlockingSizes<Scalar>(bestKc, bestMc);
+  std::cout << name << ": kc=" << bestKc << " mc=" << bestMc << " (0 = default), "
+            << gflops<Scalar>(largeSize, bestTime) << " GFLOPS\n";
+}
+
+// returns the smallest size of a square product from which the GEBP kernel is faster than the coefficient based
+// product on several consecutive sizes
+template<typename Scalar>
+int tuneCrossover(const char* name)
+{
+  const int confirm = 3;
+  int wins = 0;
+  for(int size = 2; size <= 64; ++size)
+  {
+    setCoeffBasedProductThreshold(0);
+    double gemm = timeProduct<Scalar>(size, size, size);
+    setCoeffBasedProductThreshold(3*size+1);
+    double lazy = timeProduct<Scalar>(size, size, size);
+    std::cout << "  " << name << " " << std::setw(2) << size << "^3: gebp " << gemm*1e9 << " ns, coeff based "
+              << lazy*1e9 << " ns\n";
+    wins = gemm < lazy ? wins+1 : 0;
+    if(wins == confirm)
+      return size - confirm + 1;
+  }
+  return 64;
+}
+
+int main(int argc, char** argv)
+{
+  const char* filename = argc > 1 ? argv[1] : "eigen_tuning.txt";
+  std::cout << "SIMD: " << SimdInstructionSetsInUse() << "\n";
+  std::cout << "cache sizes: l1=" << l1CacheSize() << " l2=" << l2CacheSize() << "\n";
+
+  tuneBlockingSizes<float>("float");
+  tuneBlockingSizes<double>("double");
+
+  // the threshold is shared by all scalar types, keep the smallest crossover
+  int crossover = std::min(tuneCrossover<float>("float"), tuneCrossover<double>("double"));
+  setCoeffBasedProductThreshold(3*crossover);
+  std::cout << "coefficient based products below " << crossover << "^3 (threshold " << 3*crossover << ")\n";
+
+  if(!saveTuningProfile(filename))
+  {
+    std::cerr << "cannot write " << filename << "\n";
+    return 1;
+  }
+  std::cout << "profile written to " << filename << "\n";
+  return 0;
+}
@@ -0,0 +1,71 @@
+// Regression test of the fixed size objects in AVX builds. The AVX packets are 32 bytes, but the storage of
+// the fixed size objects is only aligned on 16 bytes, so an object can start in the middle of a packet. The
+// products and the inverse of such objects used to abort on the "data is not aligned" assertion of MapBase.
+//
+// g++ -mavx2 -mfma avx_alignment.cpp -I.. -o avx_alignment && ./avx_alignment
+//
+// The test is also meaningful, and must pass, in the SSE and non vectorized builds.
+
+#include <Eigen/Dense>
+#include <iostream>
+
+using namespace Eigen;
+
+static int failures = 0;
+
+#define CHECK(...) \
+  if(!(__VA_ARGS__)) { std::cout << "FAILED line " << __LINE__ << ": " #__VA_ARGS__ << "\n"; ++failures; }
+
+// The padding puts the objects on an odd multiple of 16 bytes when the struct itself is 32 bytes aligned,
+// and on an even one otherwise, both cases are run.
+template<typename MatrixType> struct Padded
+{
+  typedef Matrix<typename MatrixType::Scalar,MatrixType::RowsAtCompileTime,1> VectorType;
+  double pad[2];
+  MatrixType a, b;
+  VectorType v, w;
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+template<typename MatrixType> void check()
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  const RealScalar eps = RealScalar(1000) * NumTraits<Scalar>::epsilon();
+  for(int k=0; k<4; ++k)
+  {
+    Padded<MatrixType>* p = new Padded<MatrixType>[k+1];
+    Padded<MatrixType>& o = p[k];
+    o.a = MatrixType::Random();
+    o.a.diagonal().array() += Scalar(MatrixType::RowsAtCompileTime);
+    o.v = Padded<MatrixType>::VectorType::Random();
+
+    o.b = o.a.inverse();
+    CHECK((o.a*o.b - MatrixType::Identity()).norm() < eps);
+    o.w = o.a * o.v;
+    CHECK((o.w - o.a.lazyProduct(o.v)).norm() < eps * o.w.norm());
+    o.b = o.a * o.a;
+    CHECK((o.b - o.a.lazyProduct(o.a)).norm() < eps * o.b.norm());
+    o.w.noalias() = o.a.transpose() * o.v;
+    CHECK((o.w - o.a.transpose().lazyProduct(o.v)).norm() < eps * o.w.norm());
+
+    // only the objects whose size is a multiple of 16 bytes are aligned
+    if((sizeof(Scalar)*MatrixType::SizeAtCompileTime) % 16 == 0)
+    {
+      Map<MatrixType,Aligned> map(o.a.data());
+      CHECK(map.col(1).sum() == o.a.col(1).sum());
+    }
+    delete[] p;
+  }
+}
+
+int main()
+{
+  check<Matrix4d>();
+  check<Matrix2d>();
+  check<Matrix4f>();
+  check<Matrix<float,8,8> >();
+  check<Matrix3d>();
+  std::cout << (failures ? "FAILED" : "passed") << " (" << SimdInstructionSetsInUse() << ")\n";
+  return failures ? 1 : 0;
+}
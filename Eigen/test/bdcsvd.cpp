@@ -0,0 +1,77 @@
+// BDCSVD of rank deficient matrices, whose bidiagonal form has entries far below the rounding errors, down to
+// subnormal numbers: matrices of ones and products of thin random matrices. The singular values must match the
+// ones of JacobiSVD, U and V must be finite and orthogonal, and U S V^* must reconstruct the matrix. Random full
+// rank matrices are checked as well.
+//
+// g++ -O2 bdcsvd.cpp -I.. -o bdcsvd && ./bdcsvd
+// g++ -O2 -mavx2 -mfma bdcsvd.cpp -I.. -o bdcsvd && ./bdcsvd
+
+#include <Eigen/Dense>
+#include <iostream>
+
+using namespace Eigen;
+
+static int failures = 0;
+
+#define CHECK(...) \
+  if(!(__VA_ARGS__)) { std::cout << "FAILED line " << __LINE__ << ": " #__VA_ARGS__ << "\n"; ++failures; }
+
+// max |Q^* Q - I|, which is NaN if Q has NaN coefficients
+template<typename MatrixType> typename MatrixType::RealScalar orthogonalityError(const MatrixType& q)
+{
+  return (q.adjoint() * q - MatrixType::Identity(q.cols(), q.cols())).cwiseAbs().maxCoeff();
+}
+
+template<typename MatrixType> void check(const MatrixType& a)
+{
+  typedef typename MatrixType::RealScalar RealScalar;
+  const RealScalar tol = RealScalar(100) * NumTraits<RealScalar>::epsilon() * (std::max)(a.rows(), a.cols());
+  const RealScalar norm = a.cwiseAbs().maxCoeff();
+
+  BDCSVD<MatrixType> thin(a, ComputeThinU | ComputeThinV);
+  BDCSVD<MatrixType> full(a, ComputeFullU | ComputeFullV);
+  JacobiSVD<MatrixType> jacobi(a);
+  const RealScalar largest = jacobi.singularValues().coeff(0);
+
+  CHECK((thin.singularValues() - jacobi.singularValues()).cwiseAbs().maxCoeff() <= tol * largest);
+  CHECK((thin.singularValues() - full.singularValues()).cwiseAbs().maxCoeff() <= tol * largest);
+  CHECK(orthogonalityError(thin.matrixU()) <= tol);
+  CHECK(orthogonalityError(thin.matrixV()) <= tol);
+  CHECK(orthogonalityError(full.matrixU()) <= tol);
+  CHECK(orthogonalityError(full.matrixV()) <= tol);
+  const MatrixType reconstructed = thin.matrixU() * thin.singularValues().asDiagonal() * thin.matrixV().adjoint();
+  CHECK((reconstructed - a).cwiseAbs().maxCoeff() <= tol * norm);
+}
+
+template<typename MatrixType> void checkSizes()
+{
+  typedef typename MatrixType::Index Index;
+  // the reflectors of the bidiagonalization of a matrix of ones leave entries down to 1e-170 in double
+  const Index ones[][2] = { { 20, 20 }, { 80, 40 }, { 100, 50 }, { 120, 60 }, { 150, 60 }, { 60, 150 }, { 150, 150 } };
+  for(int i = 0; i < 7; ++i)
+    check<MatrixType>(MatrixType::Ones(ones[i][0], ones[i][1]));
+
+  // low rank products
+  const Index products[][3] = { { 100, 5, 80 }, { 200, 30, 200 }, { 40, 1, 90 }, { 120, 17, 64 } };
+  for(int i = 0; i < 4; ++i)
+    check<MatrixType>(MatrixType::Random(products[i][0], products[i][1]) * MatrixType::Random(products[i][1], products[i][2]));
+
+  // a single nonzero, and zero
+  MatrixType a = MatrixType::Zero(50, 40);
+  a(3, 7) = 1;
+  check<MatrixType>(a);
+  check<MatrixType>(MatrixType::Zero(40, 50));
+
+  check<MatrixType>(MatrixType::Random(100, 70));
+  check<MatrixType>(MatrixType::Random(64, 129));
+}
+
+int main()
+{
+  checkSizes<MatrixXd>();
+  checkSizes<MatrixXf>();
+  checkSizes<MatrixXcd>();
+  checkSizes<Matrix<double,Dynamic,Dynamic,RowMajor> >();
+  std::cout << (failures ? "FAILED" : "passed") << "\n";
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,120 @@
+// Round trips through the binary files of the BinaryIO module, and rejection of corrupted files: headers whose
+// sizes overflow must be refused by loadBinary() before it allocates and by MappedMatrixFile::open(), and sparse
+// files with invalid outer or inner indices must be refused by loadBinary() and MappedMatrixFile::canMapSparse().
+//
+// g++ -O2 binaryio.cpp -I.. -o binaryio && ./binaryio
+
+#define EIGEN_YES_I_KNOW_SPARSE_MODULE_IS_NOT_STABLE_YET
+#include <Eigen/Sparse>
+#include <Eigen/BinaryIO>
+#include <iostream>
+#include <cstdio>
+#include <cstddef>
+
+using namespace Eigen;
+
+static int failures = 0;
+
+#define CHECK(...) \
+  if(!(__VA_ARGS__)) { std::cout << "FAILED line " << __LINE__ << ": " #__VA_ARGS__ << "\n"; ++failures; }
+
+static const char* filename = "binaryio_test.bin";
+
+// overwrites sizeof(T) bytes of the file at offset
+template<typename T> void patch(long offset, const T& value)
+{
+  std::FILE* file = std::fopen(filename, "r+b");
+  std::fseek(file, offset, SEEK_SET);
+  std::fwrite(&value, sizeof(T), 1, file);
+  std::fclose(file);
+}
+
+#define HEADER_OFFSET(field) long(offsetof(internal::binary_header, field))
+
+void checkDense()
+{
+  MatrixXd a = MatrixXd::Random(7, 5), b;
+  CHECK(saveBinary(filename, a) && loadBinary(filename, b) && b == a);
+  {
+    MappedMatrixFile file(filename);
+    CHECK(file.isOpen() && file.canMap<MatrixXd>() && file.map<MatrixXd>() == a);
+  }
+
+  // rows*cols overflows
+  patch(HEADER_OFFSET(rows), uint64_t(1) << 33);
+  patch(HEADER_OFFSET(cols), uint64_t(1) << 33);
+  CHECK(!loadBinary(filename, b) && b == a);
+  CHECK(!MappedMatrixFile(filename).isOpen());
+
+  // rows*cols fits, but not rows*cols*sizeof(double) + offset
+  patch(HEADER_OFFSET(rows), uint64_t(1) << 31);
+  patch(HEADER_OFFSET(cols), uint64_t(1) << 30);
+  CHECK(!loadBinary(filename, b) && b == a);
+  CHECK(!MappedMatrixFile(filename).isOpen());
+}
+
+void checkSparse()
+{
+  typedef SparseMatrix<double> SpMat;
+  SpMat a(20, 10), b;
+  for(int j = 0; j < a.cols(); ++j)
+  {
+    a.startVec(j);
+    for(int i = j % 3; i < a.rows(); i += 3)
+      a.insertBack(i, j) = i + 0.5 * j;
+  }
+  a.finalize();
+  const long outerOffset = long(internal::binary_header::align(sizeof(internal::binary_header)));
+  const long innerOffset = long(internal::binary_header::align(outerOffset + (a.cols() + 1) * sizeof(int)));
+
+  CHECK(saveBinary(filename, a) && loadBinary(filename, b) && MatrixXd(b) == MatrixXd(a));
+  SparseMatrix<double,RowMajor> c;
+  CHECK(loadBinary(filename, c) && MatrixXd(c) == MatrixXd(a));
+  {
+    MappedMatrixFile file(filename);
+    CHECK(file.isOpen() && file.canMapSparse<SpMat>() && !file.canMapSparse<SparseMatrix<double,RowMajor> >());
+    CHECK(MatrixXd(file.mapSparse<SpMat>()) == MatrixXd(a));
+  }
+
+  // decreasing outer indices
+  CHECK(saveBinary(filename, a));
+  patch(outerOffset + 3 * long(sizeof(int)), int(1));
+  CHECK(!loadBinary(filename, b));
+  CHECK(!MappedMatrixFile(filename).canMapSparse<SpMat>());
+
+  // the last outer index beyond the number of nonzeros
+  CHECK(saveBinary(filename, a));
+  patch(outerOffset + a.cols() * long(sizeof(int)), int(a.nonZeros() + 1));
+  CHECK(!loadBinary(filename, b));
+  CHECK(!MappedMatrixFile(filename).canMapSparse<SpMat>());
+
+  // an inner index beyond the number of rows, and a negative one
+  CHECK(saveBinary(filename, a));
+  patch(innerOffset + 5 * long(sizeof(int)), int(a.rows()));
+  CHECK(!loadBinary(filename, b));
+  CHECK(!MappedMatrixFile(filename).canMapSparse<SpMat>());
+  patch(innerOffset + 5 * long(sizeof(int)), int(-1));
+  CHECK(!loadBinary(filename, b));
+  CHECK(!MappedMatrixFile(filename).canMapSparse<SpMat>());
+  CHECK(MappedMatrixFile(filename).canMapSparse<SpMat>(false));
+
+  // nonZeros*indexSize overflows
+  CHECK(saveBinary(filename, a));
+  patch(HEADER_OFFSET(rows), uint64_t(1) << 31);
+  patch(HEADER_OFFSET(cols), uint64_t(1) << 31);
+  patch(HEADER_OFFSET(nonZeros), uint64_t(1) << 62);
+  CHECK(!loadBinary(filename, b));
+  CHECK(!MappedMatrixFile(filename).isOpen());
+
+  // the failed loads left b unchanged
+  CHECK(MatrixXd(b) == MatrixXd(a));
+}
+
+int main()
+{
+  checkDense();
+  checkSparse();
+  std::remove(filename);
+  std::cout << (failures ? "FAILED" : "passed") << "\n";
+  return failures ? 1 : 0;
+}
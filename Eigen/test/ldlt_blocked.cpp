@@ -0,0 +1,104 @@
+// The blocked LDLT factorization, used from size 64 on, must pick the same transpositions and the same sign as
+// the unblocked one, for the lower and the upper storage, on positive, negative, indefinite and rank deficient
+// real and complex matrices. Its factors must match the unblocked ones up to rounding when they are well
+// conditioned, and its reconstruction error must stay close to the one of the unblocked factors otherwise.
+//
+// g++ -O2 ldlt_blocked.cpp -I.. -o ldlt_blocked && ./ldlt_blocked
+
+#include <Eigen/Dense>
+#include <iostream>
+
+using namespace Eigen;
+
+static int failures = 0;
+
+#define CHECK(...) \
+  if(!(__VA_ARGS__)) { std::cout << "FAILED line " << __LINE__ << ": " #__VA_ARGS__ << "\n"; ++failures; }
+
+// factorizes a with both algorithms, the blocked one through LDLT, and compares the factors if stable is true
+template<int UpLo, typename MatrixType> void compare(const MatrixType& a, bool stable)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::RealScalar RealScalar;
+  typedef typename MatrixType::Index Index;
+  const Index size = a.rows();
+
+  LDLT<MatrixType,UpLo> ldlt(a);
+
+  MatrixType mat = a;
+  Transpositions<Dynamic> transpositions(size);
+  Matrix<Scalar,Dynamic,1> temp(size);
+  int sign = 0;
+  internal::ldlt_inplace<UpLo>::unblocked(mat, transpositions, temp, &sign);
+
+  CHECK(ldlt.transpositionsP().indices() == transpositions.indices());
+  CHECK(ldlt.isPositive() == (sign == 1) && ldlt.isNegative() == (sign == -1));
+
+  // P^T L D L^* P from the unblocked factors
+  MatrixType L = UpLo == Lower ? MatrixType(mat.template triangularView<UnitLower>())
+                               : MatrixType(mat.adjoint().template triangularView<UnitLower>());
+  MatrixType P = MatrixType::Identity(size, size);
+  P = transpositions * P;
+  MatrixType reference = P.transpose() * L * mat.diagonal().asDiagonal() * L.adjoint() * P;
+
+  const RealScalar tol = RealScalar(100) * NumTraits<RealScalar>::epsilon() * a.cwiseAbs().maxCoeff() * size;
+  const RealScalar error = (ldlt.reconstructedMatrix() - a).cwiseAbs().maxCoeff();
+  CHECK(error <= 4 * (reference - a).cwiseAbs().maxCoeff() + tol);
+  if(stable)
+  {
+    const MatrixType expected = mat.template triangularView<UpLo>();
+    const MatrixType actual = ldlt.matrixLDLT().template triangularView<UpLo>();
+    CHECK((expected - actual).cwiseAbs().maxCoeff() <= tol);
+    CHECK(error <= tol);
+  }
+}
+
+template<typename MatrixType> void check(typename MatrixType::Index size)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::Index Index;
+  typedef typename MatrixType::RealScalar RealScalar;
+  MatrixType b = MatrixType::Random(size, size);
+
+  // positive definite, negative definite
+  MatrixType a = b * b.adjoint() + MatrixType::Identity(size, size) * RealScalar(size);
+  compare<Lower>(a, true);
+  compare<Upper>(a, true);
+  compare<Lower>(MatrixType(-a), true);
+  compare<Upper>(MatrixType(-a), true);
+
+  // indefinite: without 2x2 pivots the factors may grow, so only the reconstruction is checked. The complex
+  // ones are skipped, as the unblocked factorization already fails to reconstruct them.
+  if(!NumTraits<Scalar>::IsComplex)
+  {
+    Matrix<RealScalar,Dynamic,1> d = Matrix<RealScalar,Dynamic,1>::Random(size);
+    a = b * d.asDiagonal() * b.adjoint();
+    compare<Lower>(a, false);
+    compare<Upper>(a, false);
+  }
+
+  // rank deficient, with zero rows and columns spread over the matrix: the diagonal pivoting moves them to the
+  // end, where the factorization stops and leaves the trailing block untouched
+  const Index rank = size / 3 + 1;
+  MatrixType c = MatrixType::Zero(size, rank);
+  for(Index i = 0; i < size; i += 3)
+    c.row(i).setRandom();
+  a = c * c.adjoint();
+  a.diagonal() += c.rowwise().norm().template cast<Scalar>();
+  compare<Lower>(a, true);
+  compare<Upper>(a, true);
+}
+
+int main()
+{
+  const int sizes[] = { 64, 65, 100, 257 };
+  for(int i = 0; i < 4; ++i)
+  {
+    check<MatrixXd>(sizes[i]);
+    check<MatrixXf>(sizes[i]);
+    check<MatrixXcd>(sizes[i]);
+    check<Matrix<double,Dynamic,Dynamic,RowMajor> >(sizes[i]);
+  }
+  std::cout << (failures ? "FAILED" : "passed") << "\n";
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,183 @@
+// Accuracy and special values of the vectorized coefficient-wise functions. The maximal errors of the
+// vectorized exp, log, sin, cos, tanh, logistic, atan, atan2 and pow are measured in ulp against the long
+// double C library on random arguments and compared to the bounds documented in arch/SSE/MathFunctions.h.
+// NaN, infinite and zero arguments must give the results of the C library.
+//
+// g++ -O2 special_functions.cpp -I.. -o special_functions && ./special_functions
+// g++ -O2 -mavx2 -mfma special_functions.cpp -I.. -o special_functions && ./special_functions
+//
+// -DEIGEN_FAST_POW=1 checks the vectorized double pow instead of std::pow.
+
+#include <Eigen/Core>
+#include <iostream>
+#include <limits>
+#include <cmath>
+
+using namespace Eigen;
+
+static int failures = 0;
+
+// distance in ulp between a and the correctly rounded exact value
+template<typename Scalar> double ulpError(Scalar a, long double exact)
+{
+  const Scalar rounded = Scalar(exact);
+  if(a == rounded)
+    return 0;
+  int e;
+  std::frexp(double(std::max(std::fabs(rounded), std::numeric_limits<Scalar>::min())), &e);
+  const long double ulp = std::ldexp(1.0L, e - std::numeric_limits<Scalar>::digits);
+  return double(std::fabs((long double)(a) - (long double)(rounded)) / ulp);
+}
+
+template<typename Scalar> Array<Scalar,Dynamic,1> randomArray(int n, double lo, double hi)
+{
+  return (Array<Scalar,Dynamic,1>::Random(n) + Scalar(1)) * Scalar((hi - lo) / 2) + Scalar(lo);
+}
+
+template<typename Scalar, typename Result, typename Exact>
+void checkAccuracy(const char* name, const Array<Scalar,Dynamic,1>& x, const Result& result, Exact exact, double bound)
+{
+  const Array<Scalar,Dynamic,1> r = result;
+  double maxError = 0;
+  for(int i = 0; i < x.size(); ++i)
+    maxError = std::max(maxError, ulpError(r[i], exact((long double)x[i])));
+  std::cout << "  " << name << ": " << maxError << " ulp\n";
+  if(!(maxError <= bound))
+  {
+    std::cout << "FAILED " << name << ": " << maxError << " ulp > " << bound << "\n";
+    ++failures;
+  }
+}
+
+static long double logisticl(long double x) { return 1 / (1 + std::exp(-x)); }
+static long double cubel(long double x) { return x*x*x; }
+static long double pow40l(long double x) { return std::pow(x, 40.0L); }
+// the exponent of the reference is the rounded 0.7 passed to pow
+template<typename Scalar> long double pow07l(long double x) { return std::pow(x, (long double)Scalar(0.7)); }
+static long double atan2l_(long double x) { return std::atan2(x, 0.75L); }
+
+template<typename Scalar> void checkAllAccuracies(bool fastPow)
+{
+  typedef Array<Scalar,Dynamic,1> ArrayType;
+  const bool isDouble = sizeof(Scalar) == sizeof(double);
+  const int n = 200000;
+  ArrayType x = randomArray<Scalar>(n, -80, 80);
+  checkAccuracy("exp", x, x.exp(), static_cast<long double(*)(long double)>(std::exp), 2);
+  const ArrayType y = x / Scalar(8);
+  checkAccuracy("tanh", y, y.tanh(), static_cast<long double(*)(long double)>(std::tanh), 1);
+  checkAccuracy("logistic", x, x.logistic(), logisticl, isDouble ? 3 : 2);
+  checkAccuracy("atan", x, x.atan(), static_cast<long double(*)(long double)>(std::atan), isDouble ? 1 : 3);
+  const ArrayType c = ArrayType::Constant(n, Scalar(0.75));
+  checkAccuracy("atan2", x, x.atan2(c), atan2l_, isDouble ? 2 : 3);
+  ArrayType p = randomArray<Scalar>(n, 1e-3, 1e3);
+  checkAccuracy("log", p, p.log(), static_cast<long double(*)(long double)>(std::log), 1);
+  if(isDouble)
+  {
+    ArrayType s = randomArray<Scalar>(n, -1e5, 1e5);
+    checkAccuracy("sin", s, s.sin(), static_cast<long double(*)(long double)>(std::sin), 1);
+    checkAccuracy("cos", s, s.cos(), static_cast<long double(*)(long double)>(std::cos), 1);
+  }
+  ArrayType q = randomArray<Scalar>(n, 1e-2, 10);
+  // without EIGEN_FAST_POW the double pow is std::pow, correctly rounded in practice, and with it the
+  // error is bounded by 2 + 2|b log(a)| ulp
+  const bool expLog = isDouble && fastPow;
+  checkAccuracy("pow(x,3)", q, q.pow(Scalar(3)), cubel, expLog ? 2 + 2*3*std::log(100.0) : 1);
+  checkAccuracy("pow(x,0.7)", q, q.pow(Scalar(0.7)), pow07l<Scalar>, expLog ? 2 + 2*0.7*std::log(100.0) : 1);
+  ArrayType r = randomArray<Scalar>(n, 0.5, 2);
+  checkAccuracy("pow(x,40)", r, r.pow(Scalar(40)), pow40l, expLog ? 2 + 2*40*std::log(2.0) : 1);
+}
+
+// a NaN, an infinite or a zero exact value must be returned as is, up to the sign of zero, and the
+// other ones within a few ulp
+template<typename Scalar> bool same(Scalar a, Scalar exact)
+{
+  if(exact != exact)
+    return a != a;
+  if(exact == 0 || std::fabs(exact) > std::numeric_limits<Scalar>::max())
+    return a == exact;
+  return ulpError(a, exact) <= 4;
+}
+
+template<typename Scalar> Scalar logistic(Scalar x) { return 1 / (1 + std::exp(-x)); }
+template<typename Scalar> Scalar atan2(Scalar x) { return std::atan2(x, Scalar(0.75)); }
+
+template<typename Scalar, typename Result, typename Function>
+void checkSpecial(const char* name, const Array<Scalar,Dynamic,1>& x, const Result& result, Function f)
+{
+  const Array<Scalar,Dynamic,1> r = result;
+  for(int i = 0; i < x.size(); ++i)
+  {
+    if(!same(r[i], f(x[i])))
+    {
+      std::cout << "FAILED " << name << "(" << x[i] << ") = " << r[i] << " instead of " << f(x[i]) << "\n";
+      ++failures;
+      return;
+    }
+  }
+}
+
+template<typename Scalar> void checkSpecialValues()
+{
+  typedef Array<Scalar,Dynamic,1> ArrayType;
+  const Scalar inf = std::numeric_limits<Scalar>::infinity();
+  const Scalar nan = std::numeric_limits<Scalar>::quiet_NaN();
+  const Scalar values[] = { nan, inf, -inf, Scalar(0), Scalar(1), Scalar(-1), Scalar(2), Scalar(-2), Scalar(0.5), Scalar(-0.5) };
+  const int n = sizeof(values)/sizeof(values[0]);
+  // 16 copies of the values, so that every value lands in every packet lane
+  ArrayType x(16*n);
+  for(int i = 0; i < x.size(); ++i)
+    x[i] = values[(i + i/n) % n];
+
+  checkSpecial("tanh", x, x.tanh(), static_cast<Scalar(*)(Scalar)>(std::tanh));
+  checkSpecial("logistic", x, x.logistic(), logistic<Scalar>);
+  checkSpecial("atan", x, x.atan(), static_cast<Scalar(*)(Scalar)>(std::atan));
+  checkSpecial("atan2", x, x.atan2(ArrayType::Constant(x.size(), Scalar(0.75))), atan2<Scalar>);
+  // the float exp, log, sin and cos are not covered by the guarantee
+  if(sizeof(Scalar) == sizeof(double))
+  {
+    checkSpecial("exp", x, x.exp(), static_cast<Scalar(*)(Scalar)>(std::exp));
+    const ArrayType absx = x.abs();
+    checkSpecial("log", absx, absx.log(), static_cast<Scalar(*)(Scalar)>(std::log));
+    checkSpecial("sin", x, x.sin(), static_cast<Scalar(*)(Scalar)>(std::sin));
+    checkSpecial("cos", x, x.cos(), static_cast<Scalar(*)(Scalar)>(std::cos));
+  }
+
+  const Scalar exponents[] = { nan, inf, -inf, Scalar(0), Scalar(1), Scalar(-1), Scalar(3), Scalar(-3), Scalar(0.1), Scalar(-0.1), Scalar(2) };
+  for(unsigned int k = 0; k < sizeof(exponents)/sizeof(exponents[0]); ++k)
+  {
+    const Scalar b = exponents[k];
+    const ArrayType p = x.pow(b);
+    for(int i = 0; i < x.size(); ++i)
+    {
+      if(!same(p[i], Scalar(std::pow(x[i], b))))
+      {
+        std::cout << "FAILED pow(" << x[i] << "," << b << ") = " << p[i] << " instead of " << std::pow(x[i], b) << "\n";
+        ++failures;
+        break;
+      }
+    }
+  }
+}
+
+int main()
+{
+#ifdef EIGEN_FAST_POW
+  const bool fastPow = EIGEN_FAST_POW;
+#else
+  const bool fastPow = false;
+#endif
+  std::cout << "SIMD: " << SimdInstructionSetsInUse() << "\n";
+#ifdef EIGEN_VECTORIZE
+  // without vectorization the functions are the ones of the C library
+  std::cout << "float\n";
+  checkAllAccuracies<float>(fastPow);
+  std::cout << "double\n";
+  checkAllAccuracies<double>(fastPow);
+#else
+  (void)fastPow;
+#endif
+  checkSpecialValues<float>();
+  checkSpecialValues<double>();
+  std::cout << (failures ? "FAILED" : "passed") << "\n";
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,102 @@
+// Contractions whose destination is one of their operands, as m = m.contract(n, ...), must give the same
+// results as when they are assigned to a distinct tensor, whether the size of the destination changes or not,
+// and whether the operands are read in place or shuffled first. The per-index accessors of TensorMap must
+// address the same coefficients as the ones of Tensor.
+//
+// g++ -O2 tensor_contraction.cpp -I.. -o tensor_contraction && ./tensor_contraction
+
+#include <Eigen/Tensor>
+#include <iostream>
+
+using namespace Eigen;
+
+static int failures = 0;
+
+#define CHECK(...) \
+  if(!(__VA_ARGS__)) { std::cout << "FAILED line " << __LINE__ << ": " #__VA_ARGS__ << "\n"; ++failures; }
+
+typedef Tensor<double,2> Tensor2;
+typedef Tensor<double,3> Tensor3;
+typedef DSizes<DenseIndex,1> Axes;
+
+template<int N> bool same(const Tensor<double,N>& a, const Tensor<double,N>& b)
+{
+  if(!(a.dimensions() == b.dimensions()))
+    return false;
+  for(DenseIndex i = 0; i < a.size(); ++i)
+    if(std::abs(a.coeff(i) - b.coeff(i)) > 1e-12 * (1 + std::abs(b.coeff(i))))
+      return false;
+  return true;
+}
+
+void checkAliasing()
+{
+  Tensor2 m(50, 50), n(50, 50);
+  m.setRandom();
+  n.setRandom();
+
+  // m read in place as the lhs, then as the rhs, with the same size
+  Tensor2 ref = m.contract(n, Axes(1), Axes(0)), a = m;
+  a = a.contract(n, Axes(1), Axes(0));
+  CHECK(same(a, ref));
+  ref = n.contract(m, Axes(1), Axes(0));
+  a = m;
+  a = n.contract(a, Axes(1), Axes(0));
+  CHECK(same(a, ref));
+
+  // transposed operands
+  ref = m.contract(n, Axes(0), Axes(1));
+  a = m;
+  a = a.contract(n, Axes(0), Axes(1));
+  CHECK(same(a, ref));
+
+  // both operands are the destination
+  ref = m.contract(m, Axes(1), Axes(0));
+  a = m;
+  a = a.contract(a, Axes(1), Axes(0));
+  CHECK(same(a, ref));
+
+  // the size changes
+  Tensor2 p(50, 30);
+  p.setRandom();
+  ref = m.contract(p, Axes(1), Axes(0));
+  a = m;
+  a = a.contract(p, Axes(1), Axes(0));
+  CHECK(same(a, ref));
+
+  // the contracted dimension of the lhs is in the middle, so it is shuffled into a temporary first
+  Tensor3 t(50, 50, 4);
+  t.setRandom();
+  Tensor3 tref = t.contract(m, Axes(1), Axes(0));
+  t = t.contract(m, Axes(1), Axes(0));
+  CHECK(same(t, tref));
+}
+
+void checkMapAccessors()
+{
+  Tensor<float,6> t(2, 3, 4, 2, 3, 2);
+  t.setRandom();
+  TensorMap<Tensor<float,6> > m(t.data(), t.dimensions());
+  CHECK(&m(1, 2, 3, 1, 2, 1) == &t(1, 2, 3, 1, 2, 1));
+  m(1, 0, 2, 1, 0, 1) = 7;
+  CHECK(t(1, 0, 2, 1, 0, 1) == 7);
+
+  TensorMap<const Tensor<float,3> > c(t.data(), 6, 4, 12);
+  CHECK(c(5, 3, 11) == t.coeff(t.size() - 1));
+  TensorMap<Tensor<float,1> > v(t.data(), t.size());
+  CHECK(&v(5) == t.data() + 5);
+  TensorMap<Tensor<float,2> > w(t.data(), 6, 24);
+  CHECK(&w(1, 2) == t.data() + 13);
+  TensorMap<Tensor<float,4> > x(t.data(), 2, 3, 4, 12);
+  CHECK(&x(1, 2, 3, 1) == t.data() + 1 + 2*2 + 3*6 + 1*24);
+  TensorMap<Tensor<float,5> > y(t.data(), 2, 3, 4, 6, 2);
+  CHECK(&y(1, 2, 3, 5, 1) == t.data() + 1 + 2*2 + 3*6 + 5*24 + 1*144);
+}
+
+int main()
+{
+  checkAliasing();
+  checkMapAccessors();
+  std::cout << (failures ? "FAILED" : "passed") << "\n";
+  return failures ? 1 : 0;
+}